@@ -12,9 +12,12 @@
 #include <vector>
 
 #include "base/base64.h"
+#include "base/containers/contains.h"
 #include "base/memory/raw_ptr.h"
 #include "base/path_service.h"
+#include "base/run_loop.h"
 #include "base/strings/stringprintf.h"
+#include "base/test/bind.h"
 #include "base/test/thread_test_helper.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
@@ -325,6 +328,24 @@ void AdBlockServiceTest::WaitForAdBlockServiceThreads() {
   ASSERT_TRUE(tr_helper->Run());
 }
 
+bool AdBlockServiceTest::HasForceHideSelector(const GURL& url,
+                                              const std::string& selector) {
+  auto* ad_block_service = g_brave_browser_process->ad_block_service();
+  absl::optional<base::Value> resources;
+  base::RunLoop run_loop;
+  ad_block_service->GetTaskRunner()->PostTaskAndReply(
+      FROM_HERE, base::BindLambdaForTesting([&]() {
+        resources = ad_block_service->UrlCosmeticResources(url.spec());
+      }),
+      run_loop.QuitClosure());
+  run_loop.Run();
+  if (!resources || !resources->is_dict())
+    return false;
+  const base::Value::List* selectors =
+      resources->GetDict().FindList("force_hide_selectors");
+  return selectors && base::Contains(*selectors, base::Value(selector));
+}
+
 void AdBlockServiceTest::ShieldsDown(const GURL& url) {
   brave_shields::SetBraveShieldsEnabled(content_settings(), false, url);
 }
@@ -831,9 +852,11 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
                                                 "xhr('%s')",
                                                 resource_url.spec().c_str())));
   EXPECT_EQ(browser()->profile()->GetPrefs()->GetUint64(kAdsBlocked), 1ULL);
+  EXPECT_TRUE(HasForceHideSelector(tab_url, "#ad-banner"));
 
   // Disable the list and ensure it is no longer applied
   sub_service_manager->EnableSubscription(subscription_url, false);
+  EXPECT_FALSE(HasForceHideSelector(tab_url, "#ad-banner"));
   {
     const auto subscriptions = sub_service_manager->GetSubscriptions();
     ASSERT_EQ(subscriptions.size(), 1ULL);
@@ -867,12 +890,18 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
     ASSERT_EQ(subscriptions[0].enabled, false);
   }
 
+  // Cosmetic resources cached for the page follow the list being turned
+  // back on and removed
+  sub_service_manager->EnableSubscription(subscription_url, true);
+  EXPECT_TRUE(HasForceHideSelector(tab_url, "#ad-banner"));
+
   // Remove the list and ensure it is completely gone
   sub_service_manager->DeleteSubscription(subscription_url);
   {
     const auto subscriptions = sub_service_manager->GetSubscriptions();
     ASSERT_EQ(subscriptions.size(), 0ULL);
   }
+  EXPECT_FALSE(HasForceHideSelector(tab_url, "#ad-banner"));
 }
 
 // Make sure the state of a list that cannot be fetched is as expected
@@ -2087,6 +2116,39 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticFilteringDynamicCustom) {
   EXPECT_EQ(base::Value(true), result_second.value);
 }
 
+// Test that cosmetic resources computed for a page are not reused once the
+// rules change
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticFilteringRulesUpdated) {
+  ASSERT_TRUE(InstallDefaultAdBlockExtension());
+  UpdateAdBlockInstanceWithRules("b.com###ad-banner");
+
+  GURL tab_url =
+      embedded_test_server()->GetURL("b.com", "/cosmetic_filtering.html");
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), tab_url));
+
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+
+  auto result_first = EvalJs(contents,
+                             R"(async function waitCSSSelector() {
+          if (await checkSelector('#ad-banner', 'display', 'none')) {
+            window.domAutomationController.send(true);
+          } else {
+            console.log('still waiting for css selector');
+            setTimeout(waitCSSSelector, 200);
+          }
+        } waitCSSSelector())",
+                             content::EXECUTE_SCRIPT_USE_MANUAL_REPLY);
+  ASSERT_TRUE(result_first.error.empty());
+  EXPECT_EQ(base::Value(true), result_first.value);
+
+  UpdateAdBlockInstanceWithRules("b.com##.ad");
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), tab_url));
+
+  EXPECT_EQ(true, EvalJs(contents,
+                         "checkSelector('#ad-banner', 'display', 'block')"));
+}
+
 // Test cosmetic filtering ignores generic cosmetic rules in the presence of a
 // `generichide` exception rule, both for elements added dynamically and
 // elements present at page load
@@ -53,6 +53,7 @@ class AdBlockServiceTest : public extensions::ExtensionBrowserTest {
                                        bool enable_list = true);
   void SetSubscriptionIntervals();
   void WaitForAdBlockServiceThreads();
+  bool HasForceHideSelector(const GURL& url, const std::string& selector);
   void ShieldsDown(const GURL& url);
   void DisableAggressiveMode();
   void LoadDAT(base::FilePath path);
@@ -9,13 +9,19 @@
 #include <string>
 #include <utility>
 
+#include "base/bind.h"
 #include "base/feature_list.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/sequenced_task_runner.h"
+#include "brave/browser/brave_browser_process.h"
 #include "brave/components/brave_perf_predictor/browser/perf_predictor_tab_helper.h"
+#include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "brave/components/brave_shields/common/pref_names.h"
 #include "brave/components/constants/pref_names.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/common/renderer_configuration.mojom.h"
 #include "components/prefs/pref_registry_simple.h"
@@ -195,8 +201,33 @@ void BraveShieldsWebContentsObserver::RegisterProfilePrefs(
   registry->RegisterUint64Pref(kFingerprintingBlocked, 0);
 }
 
+void BraveShieldsWebContentsObserver::DidStartNavigation(
+    content::NavigationHandle* navigation_handle) {
+  PrefetchCosmeticResources(navigation_handle);
+}
+
+void BraveShieldsWebContentsObserver::DidRedirectNavigation(
+    content::NavigationHandle* navigation_handle) {
+  PrefetchCosmeticResources(navigation_handle);
+}
+
 void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
     content::NavigationHandle* navigation_handle) {
+  // Hand the frame its cosmetic filtering resources ahead of the commit, so it
+  // doesn't have to block on asking for them. Messages on the frame's
+  // associated interfaces are delivered in order with the commit.
+  auto prefetched =
+      prefetched_cosmetic_resources_.find(navigation_handle->GetNavigationId());
+  if (prefetched != prefetched_cosmetic_resources_.end()) {
+    const GURL& url = prefetched->second.first;
+    absl::optional<base::Value::Dict>& resources = prefetched->second.second;
+    if (resources && url == navigation_handle->GetURL()) {
+      GetBraveShieldsRemote(navigation_handle->GetRenderFrameHost())
+          ->SetCosmeticResources(url.spec(), std::move(*resources));
+    }
+    prefetched_cosmetic_resources_.erase(prefetched);
+  }
+
   // when the main frame navigate away
   content::ReloadType reload_type = navigation_handle->GetReloadType();
   if (navigation_handle->IsInMainFrame() &&
@@ -232,6 +263,58 @@ void BraveShieldsWebContentsObserver::ReadyToCommitNavigation(
           base::Unretained(this)));
 }
 
+void BraveShieldsWebContentsObserver::DidFinishNavigation(
+    content::NavigationHandle* navigation_handle) {
+  prefetched_cosmetic_resources_.erase(navigation_handle->GetNavigationId());
+}
+
+void BraveShieldsWebContentsObserver::PrefetchCosmeticResources(
+    content::NavigationHandle* navigation_handle) {
+  const GURL& url = navigation_handle->GetURL();
+  if (!base::FeatureList::IsEnabled(features::kCosmeticFilteringPrefetch) ||
+      !base::FeatureList::IsEnabled(features::kBraveAdblockCosmeticFiltering) ||
+      navigation_handle->IsSameDocument() || !url.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+
+  // Shields settings follow the top level page, which for a subframe is the
+  // one already committed in the main frame.
+  const GURL& page_url = navigation_handle->IsInMainFrame()
+                             ? url
+                             : web_contents()->GetLastCommittedURL();
+  HostContentSettingsMap* map = HostContentSettingsMapFactory::GetForProfile(
+      web_contents()->GetBrowserContext());
+  if (!map || !GetBraveShieldsEnabled(map, page_url) ||
+      GetCosmeticFilteringControlType(map, page_url) == ControlType::ALLOW) {
+    return;
+  }
+
+  const int64_t navigation_id = navigation_handle->GetNavigationId();
+  prefetched_cosmetic_resources_[navigation_id] = {url, absl::nullopt};
+
+  AdBlockService* ad_block_service = g_brave_browser_process->ad_block_service();
+  ad_block_service->GetTaskRunner()->PostTaskAndReplyWithResult(
+      FROM_HERE,
+      base::BindOnce(&AdBlockService::UrlCosmeticResources,
+                     base::Unretained(ad_block_service), url.spec()),
+      base::BindOnce(
+          &BraveShieldsWebContentsObserver::OnCosmeticResourcesPrefetched,
+          weak_factory_.GetWeakPtr(), navigation_id, url));
+}
+
+void BraveShieldsWebContentsObserver::OnCosmeticResourcesPrefetched(
+    int64_t navigation_id,
+    const GURL& url,
+    absl::optional<base::Value> resources) {
+  auto prefetched = prefetched_cosmetic_resources_.find(navigation_id);
+  // The navigation may have finished, or been redirected, in the meantime.
+  if (prefetched == prefetched_cosmetic_resources_.end() ||
+      prefetched->second.first != url || !resources || !resources->is_dict()) {
+    return;
+  }
+  prefetched->second.second = std::move(resources->GetDict());
+}
+
 void BraveShieldsWebContentsObserver::AllowScriptsOnce(
     const std::vector<std::string>& origins,
     WebContents* contents) {
@@ -9,14 +9,19 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/values.h"
 #include "brave/components/brave_shields/common/brave_shields.mojom.h"
 #include "content/public/browser/render_frame_host_receiver_set.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
 
 namespace content {
 class WebContents;
@@ -63,8 +68,14 @@ class BraveShieldsWebContentsObserver
   void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   void RenderFrameHostChanged(content::RenderFrameHost* old_host,
                               content::RenderFrameHost* new_host) override;
+  void DidStartNavigation(
+      content::NavigationHandle* navigation_handle) override;
+  void DidRedirectNavigation(
+      content::NavigationHandle* navigation_handle) override;
   void ReadyToCommitNavigation(
       content::NavigationHandle* navigation_handle) override;
+  void DidFinishNavigation(
+      content::NavigationHandle* navigation_handle) override;
 
   // brave_shields::mojom::BraveShieldsHost.
   void OnJavaScriptBlocked(const std::u16string& details) override;
@@ -93,6 +104,14 @@ class BraveShieldsWebContentsObserver
   mojo::AssociatedRemote<brave_shields::mojom::BraveShields>&
   GetBraveShieldsRemote(content::RenderFrameHost* rfh);
 
+  // Starts computing the cosmetic filtering resources for the URL
+  // |navigation_handle| is currently headed to, so they can be sent to the
+  // renderer together with the commit.
+  void PrefetchCosmeticResources(content::NavigationHandle* navigation_handle);
+  void OnCosmeticResourcesPrefetched(int64_t navigation_id,
+                                     const GURL& url,
+                                     absl::optional<base::Value> resources);
+
   std::vector<std::string> allowed_script_origins_;
   // We keep a set of the current page's blocked URLs in case the page
   // continually tries to load the same blocked URLs.
@@ -105,6 +124,13 @@ class BraveShieldsWebContentsObserver
   // interface, to prevent binding a new remote each time it's used.
   BraveShieldsRemotesMap brave_shields_remotes_;
 
+  // Cosmetic filtering resources for in-flight navigations by navigation id,
+  // along with the URL they are for. The resources are unset until computed.
+  base::flat_map<int64_t, std::pair<GURL, absl::optional<base::Value::Dict>>>
+      prefetched_cosmetic_resources_;
+
+  base::WeakPtrFactory<BraveShieldsWebContentsObserver> weak_factory_{this};
+
   WEB_CONTENTS_USER_DATA_KEY_DECL();
 };
 
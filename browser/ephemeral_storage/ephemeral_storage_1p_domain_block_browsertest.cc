@@ -20,6 +20,7 @@
 #include "chrome/test/base/ui_test_utils.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "content/public/test/browser_test.h"
+#include "content/public/test/browser_test_utils.h"
 #include "content/public/test/test_navigation_observer.h"
 #include "net/base/features.h"
 #include "services/network/public/mojom/cookie_manager.mojom.h"
@@ -200,6 +201,27 @@ IN_PROC_BROWSER_TEST_F(
             ContentSetting::CONTENT_SETTING_ALLOW);
 }
 
+IN_PROC_BROWSER_TEST_F(
+    EphemeralStorage1pDomainBlockBrowserTest,
+    FirstPartyEphemeralIsNotEnabledIfLargeLocalStorageDataStored) {
+  // Store a few megabytes of local storage data in a.com.
+  WebContents* first_party_tab = LoadURLInNewTab(a_site_simple_url_);
+  ASSERT_TRUE(content::ExecJs(first_party_tab->GetPrimaryMainFrame(),
+                              "localStorage.setItem('large', "
+                              "'x'.repeat(2 * 1024 * 1024));"));
+  // Navigate away to b.com.
+  ASSERT_TRUE(ui_test_utils::NavigateToURL(browser(), b_site_simple_url_));
+  // Ensure nothing is cleaned up even after keep alive.
+  WaitForCleanupAfterKeepAlive();
+
+  NavigateToBlockedDomainAndExpectNotEphemeral();
+  EXPECT_EQ(GetCookieSetting(a_site_simple_url_),
+            ContentSetting::CONTENT_SETTING_ALLOW);
+  EXPECT_EQ(2 * 1024 * 1024,
+            content::EvalJs(first_party_tab->GetPrimaryMainFrame(),
+                            "localStorage.getItem('large').length"));
+}
+
 IN_PROC_BROWSER_TEST_F(
     EphemeralStorage1pDomainBlockBrowserTest,
     FirstPartyEphemeralIsAutoEnabledInAggressiveBlockingMode) {
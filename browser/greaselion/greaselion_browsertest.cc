@@ -23,11 +23,11 @@
 #include "brave/components/constants/brave_paths.h"
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "brave/components/greaselion/browser/greaselion_service.h"
+#include "brave/components/greaselion/browser/greaselion_service_impl.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/test/base/ui_test_utils.h"
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
-#include "extensions/common/file_util.h"
 #include "net/dns/mock_host_resolver.h"
 #include "ui/base/ui_base_switches.h"
 
@@ -37,6 +37,7 @@ using extensions::ExtensionBrowserTest;
 using greaselion::GreaselionDownloadService;
 using greaselion::GreaselionService;
 using greaselion::GreaselionServiceFactory;
+using greaselion::GreaselionServiceImpl;
 
 const char kTestDataDirectory[] = "greaselion-data";
 const char kEmbeddedTestServerDirectory[] = "greaselion";
@@ -562,7 +563,7 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, CleanShutdown) {
   ui_test_utils::WaitForBrowserToClose(browser());
 }
 
-IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, FoldersAreRemovedOnUpdate) {
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, FoldersAreReusedOnUpdate) {
   ASSERT_TRUE(InstallMockExtension());
 
   auto io_runner = base::ThreadPool::CreateSequencedTaskRunner(
@@ -582,7 +583,7 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, FoldersAreRemovedOnUpdate) {
           GreaselionServiceFactory::GetInstallDirectory();
 
       base::FilePath extensions_dir =
-          extensions::file_util::GetInstallTempDir(install_dir);
+          GreaselionServiceImpl::GetCacheDirectory(install_dir);
 
       base::FileEnumerator enumerator(extensions_dir, false,
                                       base::FileEnumerator::DIRECTORIES);
@@ -605,16 +606,19 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, FoldersAreRemovedOnUpdate) {
   size_t start_count = count_folders_on_io_runner();
   EXPECT_GT(start_count, 0ul);
 
-  // Trigger an update to reinstall extension folders and wait for all
-  // extensions to finish loading.
+  // Trigger an update with unchanged rules and wait for it to finish. The
+  // extensions converted before should be kept as they are.
   GreaselionService* greaselion_service =
       GreaselionServiceFactory::GetForBrowserContext(profile());
   ASSERT_TRUE(greaselion_service);
+  std::vector<extensions::ExtensionId> start_ids =
+      greaselion_service->GetExtensionIdsForTesting();
   greaselion_service->UpdateInstalledExtensions();
   GreaselionServiceWaiter(greaselion_service).Wait();
 
   size_t after_update = count_folders_on_io_runner();
   EXPECT_EQ(after_update, start_count);
+  EXPECT_EQ(greaselion_service->GetExtensionIdsForTesting(), start_ids);
 }
 
 #if !BUILDFLAG(IS_MAC)
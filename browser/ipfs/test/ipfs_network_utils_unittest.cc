@@ -8,10 +8,12 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "brave/browser/ipfs/ipfs_blob_context_getter_factory.h"
+#include "build/build_config.h"
 #include "chrome/test/base/testing_profile.h"
 #include "content/public/test/browser_task_environment.h"
 #include "services/network/public/cpp/data_element.h"
@@ -22,6 +24,18 @@
 
 namespace ipfs {
 
+namespace {
+
+std::vector<std::string> GetRelativePaths(
+    const std::vector<ImportFileInfo>& entries) {
+  std::vector<std::string> paths;
+  for (const auto& entry : entries)
+    paths.push_back(entry.relative_path);
+  return paths;
+}
+
+}  // namespace
+
 class IpfsNetwrokUtilsUnitTest : public testing::Test {
  public:
   IpfsNetwrokUtilsUnitTest() = default;
@@ -41,6 +55,19 @@ class IpfsNetwrokUtilsUnitTest : public testing::Test {
     return file_path;
   }
 
+  // Creates |dir|/folder with files a, b, d, sub/c and an empty subfolder,
+  // 20 bytes in total.
+  base::FilePath CreateImportFolder(const base::FilePath& dir) {
+    base::FilePath folder = dir.AppendASCII("folder");
+    EXPECT_TRUE(base::CreateDirectory(folder.AppendASCII("sub")));
+    EXPECT_TRUE(base::CreateDirectory(folder.AppendASCII("empty")));
+    CreateCustomTestFile(folder, "a", "aaaa");
+    CreateCustomTestFile(folder, "b", "bbbb");
+    CreateCustomTestFile(folder, "d", "dddddddddd");
+    CreateCustomTestFile(folder.AppendASCII("sub"), "c", "cc");
+    return folder;
+  }
+
   IpfsBlobContextGetterFactory* blob_getter_factory() {
     return blob_getter_factory_.get();
   }
@@ -125,21 +152,74 @@ TEST_F(IpfsNetwrokUtilsUnitTest, CreateRequestForTextTest) {
   run_loop.Run();
 }
 
-TEST_F(IpfsNetwrokUtilsUnitTest, CreateRequestForFolderTest) {
+TEST_F(IpfsNetwrokUtilsUnitTest, CreateRequestForFileBatchTest) {
   base::ScopedTempDir dir;
   ASSERT_TRUE(dir.CreateUniqueTempDir());
   std::string content = "test\n\rmultiline\n\rcontent";
   std::string filename = "test_name";
   CreateCustomTestFile(dir.GetPath(), filename, content);
-  std::string mime_type = "test/type";
-  std::string mime_boundary = "mime_boundary";
+  auto entries = EnumerateFolderForImport(dir.GetPath(), 1024, 1024);
+  ASSERT_EQ(entries.batches.size(), 1u);
   base::RunLoop run_loop;
   auto upload_callback =
       base::BindOnce(&IpfsNetwrokUtilsUnitTest::ValidateRequest,
                      base::Unretained(this), run_loop.QuitClosure());
-  CreateRequestForFolder(dir.GetPath(), blob_getter_factory(),
-                         std::move(upload_callback));
+  CreateRequestForFileBatch(std::move(entries.batches[0]),
+                            blob_getter_factory(), std::move(upload_callback));
   run_loop.Run();
 }
 
+TEST_F(IpfsNetwrokUtilsUnitTest, EnumerateFolderForImport) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath folder = CreateImportFolder(dir.GetPath());
+  auto entries = EnumerateFolderForImport(folder, 8, 2);
+  EXPECT_EQ(GetRelativePaths(entries.directories),
+            std::vector<std::string>(
+                {"folder", "folder/empty", "folder/sub"}));
+  EXPECT_EQ(entries.total_size, 20);
+
+  // Full batches are closed by size or by count, files larger than a batch
+  // go alone.
+  ASSERT_EQ(entries.batches.size(), 3u);
+  EXPECT_EQ(GetRelativePaths(entries.batches[0]),
+            std::vector<std::string>({"folder/a", "folder/b"}));
+  EXPECT_EQ(GetRelativePaths(entries.batches[1]),
+            std::vector<std::string>({"folder/d"}));
+  EXPECT_EQ(GetRelativePaths(entries.batches[2]),
+            std::vector<std::string>({"folder/sub/c"}));
+
+  entries = EnumerateFolderForImport(folder, 1024, 1024);
+  ASSERT_EQ(entries.batches.size(), 1u);
+  EXPECT_EQ(GetRelativePaths(entries.batches[0]),
+            std::vector<std::string>(
+                {"folder/a", "folder/b", "folder/d", "folder/sub/c"}));
+}
+
+TEST_F(IpfsNetwrokUtilsUnitTest, EnumerateEmptyFolderForImport) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath folder = CreateImportFolder(dir.GetPath());
+  auto entries = EnumerateFolderForImport(folder.AppendASCII("empty"), 8, 2);
+  EXPECT_EQ(GetRelativePaths(entries.directories),
+            std::vector<std::string>({"empty"}));
+  EXPECT_TRUE(entries.batches.empty());
+  EXPECT_EQ(entries.total_size, 0);
+}
+
+#if BUILDFLAG(IS_POSIX)
+TEST_F(IpfsNetwrokUtilsUnitTest, EnumerateFolderForImportSkipsSymlinks) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath folder = CreateImportFolder(dir.GetPath());
+  ASSERT_TRUE(base::CreateSymbolicLink(folder.AppendASCII("a"),
+                                       folder.AppendASCII("link")));
+  auto entries = EnumerateFolderForImport(folder, 1024, 1024);
+  ASSERT_EQ(entries.batches.size(), 1u);
+  EXPECT_EQ(GetRelativePaths(entries.batches[0]),
+            std::vector<std::string>(
+                {"folder/a", "folder/b", "folder/d", "folder/sub/c"}));
+}
+#endif
+
 }  // namespace ipfs
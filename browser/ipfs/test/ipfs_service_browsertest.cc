@@ -3,15 +3,22 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/memory/raw_ptr.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/strings/strcat.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "base/test/bind.h"
 #include "base/test/mock_callback.h"
 #include "base/test/scoped_feature_list.h"
@@ -26,6 +33,7 @@
 #include "brave/components/ipfs/import/imported_data.h"
 #include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_service.h"
+#include "brave/components/ipfs/ipfs_service_observer.h"
 #include "brave/components/ipfs/ipfs_utils.h"
 #include "brave/components/ipfs/pref_names.h"
 #include "chrome/browser/browser_process.h"
@@ -43,6 +51,7 @@
 #include "content/public/test/browser_test.h"
 #include "content/public/test/content_mock_cert_verifier.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/base/url_util.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/dns/public/secure_dns_mode.h"
 #include "net/test/embedded_test_server/http_request.h"
@@ -97,6 +106,26 @@ class FakeIpfsService : public ipfs::IpfsService {
   bool launched_ = false;
 };
 
+class ImportProgressObserver : public ipfs::IpfsServiceObserver {
+ public:
+  void OnImportProgress(const base::FilePath& path,
+                        int64_t uploaded_bytes,
+                        int64_t total_bytes) override {
+    path_ = path;
+    uploaded_bytes_ = uploaded_bytes;
+    total_bytes_ = total_bytes;
+  }
+
+  const base::FilePath& path() const { return path_; }
+  int64_t uploaded_bytes() const { return uploaded_bytes_; }
+  int64_t total_bytes() const { return total_bytes_; }
+
+ private:
+  base::FilePath path_;
+  int64_t uploaded_bytes_ = -1;
+  int64_t total_bytes_ = -1;
+};
+
 }  // namespace
 
 namespace ipfs {
@@ -342,6 +371,83 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
     return nullptr;
   }
 
+  // Answers like the node does for folder imports: each file added gets a
+  // hash, and the destinations of copied files are recorded.
+  std::unique_ptr<net::test_server::HttpResponse> HandleFolderImportRequests(
+      bool fail_first_add,
+      const net::test_server::HttpRequest& request) {
+    const GURL gurl = request.GetURL();
+    auto http_response =
+        std::make_unique<net::test_server::BasicHttpResponse>();
+    http_response->set_code(net::HTTP_OK);
+    http_response->set_content_type("application/json");
+    http_response->set_content("{}");
+
+    base::AutoLock lock(lock_);
+    if (gurl.path_piece() == kImportAddPath) {
+      if (fail_first_add && ++add_requests_ == 1) {
+        // Closes the connection without answering, as a node going down.
+        return std::make_unique<net::test_server::RawHttpResponse>("", "");
+      }
+      const std::string file_content_type =
+          base::StrCat({"Content-Type: ", kFileMimeType});
+      std::vector<base::StringPiece> lines =
+          base::SplitStringPiece(request.content, "\r\n",
+                                 base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+      std::string response;
+      for (size_t i = 0; i + 1 < lines.size(); ++i) {
+        const size_t start = lines[i].find("filename=\"");
+        if (start == base::StringPiece::npos ||
+            lines[i + 1] != file_content_type) {
+          continue;
+        }
+        base::StringPiece name = lines[i].substr(start + 10);
+        name.remove_suffix(1);
+        base::StrAppend(&response, {R"({"Name":")", name, R"(","Hash":"QmFile)",
+                                    base::NumberToString(i),
+                                    R"(","Size":"1"})", "\n"});
+      }
+      http_response->set_content(response);
+      return http_response;
+    }
+
+    if (gurl.path_piece() == kImportCopyPath) {
+      std::string destination;
+      for (net::QueryIterator it(gurl); !it.IsAtEnd(); it.Advance()) {
+        if (it.GetKey() == "arg")
+          destination = it.GetUnescapedValue();
+      }
+      copied_files_.push_back(destination);
+      return http_response;
+    }
+
+    if (gurl.path_piece() == kImportStatPath) {
+      http_response->set_content(
+          R"({"Hash":"QmYbK4SLa","Size":0,"CumulativeSize":567857,)"
+          R"("Blocks":2,"Type":"directory"})");
+      return http_response;
+    }
+
+    if (gurl.path_piece() == kImportMakeDirectoryPath ||
+        gurl.path_piece() == kAPIPublishNameEndpoint) {
+      return http_response;
+    }
+
+    return nullptr;
+  }
+
+  std::vector<std::string> GetCopiedFiles() {
+    base::AutoLock lock(lock_);
+    std::vector<std::string> copied_files = copied_files_;
+    std::sort(copied_files.begin(), copied_files.end());
+    return copied_files;
+  }
+
+  int GetAddRequests() {
+    base::AutoLock lock(lock_);
+    return add_requests_;
+  }
+
   std::unique_ptr<net::test_server::HttpResponse> HandleGetNodeInfo(
       const net::test_server::HttpRequest& request) {
     const GURL gurl = request.GetURL();
@@ -673,6 +779,10 @@ class IpfsServiceBrowserTest : public InProcessBrowserTest {
   std::unique_ptr<net::EmbeddedTestServer> test_server_;
   raw_ptr<IpfsService> ipfs_service_ = nullptr;
   base::test::ScopedFeatureList feature_list_;
+  // Updated by the test server thread.
+  base::Lock lock_;
+  std::vector<std::string> copied_files_;
+  int add_requests_ = 0;
 };
 
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, StartSuccessAndLaunch) {
@@ -1235,27 +1345,53 @@ IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportFileToIpfsSuccess) {
 }
 
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportDirectoryToIpfsSuccess) {
-  std::string expected_response =
-      R"({"Name":"autoplay-whitelist-data", "Size":"567857", "Hash": "QmYbK4SLa"})";
   ResetTestServer(
-      base::BindRepeating(&IpfsServiceBrowserTest::HandleImportRequests,
-                          base::Unretained(this), expected_response));
+      base::BindRepeating(&IpfsServiceBrowserTest::HandleFolderImportRequests,
+                          base::Unretained(this), false));
   auto* folder = FILE_PATH_LITERAL("brave/test/data/autoplay-whitelist-data");
   auto test_path = embedded_test_server()->GetFullPathFromSourceDirectory(
       base::FilePath(folder));
+  ImportProgressObserver observer;
+  ipfs_service()->AddObserver(&observer);
   ipfs_service()->ImportDirectoryToIpfs(
       test_path, std::string(),
       base::BindOnce(&IpfsServiceBrowserTest::OnImportCompletedSuccess,
                      base::Unretained(this)));
   WaitForRequest();
+  ipfs_service()->RemoveObserver(&observer);
+
+  auto copied_files = GetCopiedFiles();
+  ASSERT_EQ(copied_files.size(), 2u);
+  EXPECT_TRUE(base::EndsWith(
+      copied_files[0], "/autoplay-whitelist-data/1/AutoplayWhitelist.dat"));
+  EXPECT_TRUE(base::EndsWith(copied_files[1],
+                             "/autoplay-whitelist-data/manifest.json"));
+  EXPECT_EQ(observer.path(), test_path);
+  EXPECT_GT(observer.total_bytes(), 0);
+  EXPECT_EQ(observer.uploaded_bytes(), observer.total_bytes());
+}
+
+IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest,
+                       ImportDirectoryToIpfsResumesUpload) {
+  ResetTestServer(
+      base::BindRepeating(&IpfsServiceBrowserTest::HandleFolderImportRequests,
+                          base::Unretained(this), true));
+  auto* folder = FILE_PATH_LITERAL("brave/test/data/autoplay-whitelist-data");
+  auto test_path = embedded_test_server()->GetFullPathFromSourceDirectory(
+      base::FilePath(folder));
+  ipfs_service()->ImportDirectoryToIpfs(
+      test_path, std::string(),
+      base::BindOnce(&IpfsServiceBrowserTest::OnImportCompletedSuccess,
+                     base::Unretained(this)));
+  WaitForRequest();
+  EXPECT_EQ(GetAddRequests(), 2);
+  EXPECT_EQ(GetCopiedFiles().size(), 2u);
 }
 
 IN_PROC_BROWSER_TEST_F(IpfsServiceBrowserTest, ImportAndPinDirectorySuccess) {
-  std::string expected_response =
-      R"({"Name":"autoplay-whitelist-data", "Size":"567857", "Hash": "QmYbK4SLa"})";
   ResetTestServer(
-      base::BindRepeating(&IpfsServiceBrowserTest::HandleImportRequests,
-                          base::Unretained(this), expected_response));
+      base::BindRepeating(&IpfsServiceBrowserTest::HandleFolderImportRequests,
+                          base::Unretained(this), false));
   auto* folder = FILE_PATH_LITERAL("brave/test/data/autoplay-whitelist-data");
   auto test_path = embedded_test_server()->GetFullPathFromSourceDirectory(
       base::FilePath(folder));
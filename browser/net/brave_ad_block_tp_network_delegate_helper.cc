@@ -63,11 +63,14 @@ void SetAdblockCnameHostResolverForTesting(
 }
 
 // Used to keep track of state between a primary adblock engine query and one
-// after CNAME uncloaking the request.
+// after CNAME uncloaking the request. The engine fills it in on its task
+// runner; it is only applied to the request's ctx back on the UI thread,
+// since other stages of the request look at the ctx there meanwhile.
 struct EngineFlags {
   bool did_match_rule = false;
   bool did_match_exception = false;
   bool did_match_important = false;
+  std::string mock_data_url;
 };
 
 void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
@@ -197,13 +200,7 @@ EngineFlags ShouldBlockRequestOnTaskRunner(
       url_to_check, ctx->resource_type, source_host,
       ctx->aggressive_blocking || force_aggressive,
       &previous_result.did_match_rule, &previous_result.did_match_exception,
-      &previous_result.did_match_important, &ctx->mock_data_url);
-
-  if (previous_result.did_match_important ||
-      (previous_result.did_match_rule &&
-       !previous_result.did_match_exception)) {
-    ctx->blocked_by = kAdBlocked;
-  }
+      &previous_result.did_match_important, &previous_result.mock_data_url);
 
   return previous_result;
 }
@@ -215,6 +212,12 @@ void OnShouldBlockRequestResult(
     std::shared_ptr<BraveRequestInfo> ctx,
     EngineFlags result) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  ctx->mock_data_url = result.mock_data_url;
+  if (result.did_match_important ||
+      (result.did_match_rule && !result.did_match_exception)) {
+    ctx->blocked_by = kAdBlocked;
+  }
+
   if (ctx->blocked_by == kAdBlocked) {
     brave_shields::BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         ctx->request_url, ctx->frame_tree_node_id, brave_shields::kAds);
@@ -6,10 +6,12 @@
 #include "brave/browser/net/brave_request_handler.h"
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "base/containers/contains.h"
 #include "base/feature_list.h"
+#include "base/trace_event/trace_event.h"
 #include "brave/browser/net/brave_ad_block_csp_network_delegate_helper.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 #include "brave/browser/net/brave_common_static_redirect_network_delegate_helper.h"
@@ -47,6 +49,53 @@
 #include "brave/components/ipfs/features.h"
 #endif
 
+namespace {
+
+constexpr char kTraceCategory[] = "brave.net";
+
+// Stages of OnBeforeURLRequest which others refer to.
+constexpr char kSiteHacksStage[] = "SiteHacks";
+constexpr char kAdBlockStage[] = "AdBlock";
+constexpr char kHttpseStage[] = "HTTPSE";
+
+// At most as many stages per event as there are bits in the masks.
+constexpr size_t kMaxStages = 32;
+
+uint32_t StageBit(size_t index) {
+  return 1u << index;
+}
+
+uint32_t AllStages(size_t count) {
+  return count == kMaxStages ? ~0u : StageBit(count) - 1;
+}
+
+brave::OnBeforeURLRequestCallback AdaptStage(
+    brave::OnBeforeStartTransactionCallback callback) {
+  return base::BindRepeating(
+      [](const brave::OnBeforeStartTransactionCallback& callback,
+         const brave::ResponseCallback& next_callback,
+         std::shared_ptr<brave::BraveRequestInfo> ctx) {
+        return callback.Run(ctx->headers, next_callback, ctx);
+      },
+      std::move(callback));
+}
+
+brave::OnBeforeURLRequestCallback AdaptStage(
+    brave::OnHeadersReceivedCallback callback) {
+  return base::BindRepeating(
+      [](const brave::OnHeadersReceivedCallback& callback,
+         const brave::ResponseCallback& next_callback,
+         std::shared_ptr<brave::BraveRequestInfo> ctx) {
+        return callback.Run(ctx->original_response_headers,
+                            ctx->override_response_headers,
+                            ctx->allowed_unsafe_redirect_url, next_callback,
+                            ctx);
+      },
+      std::move(callback));
+}
+
+}  // namespace
+
 static bool IsInternalScheme(std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK(ctx);
 #if BUILDFLAG(ENABLE_EXTENSIONS)
@@ -56,6 +105,18 @@ static bool IsInternalScheme(std::shared_ptr<brave::BraveRequestInfo> ctx) {
   return ctx->request_url.SchemeIs(content::kChromeUIScheme);
 }
 
+BraveRequestHandler::Stage::Stage(const char* name,
+                                  StageCallback callback,
+                                  uint32_t dependencies)
+    : name(name), callback(std::move(callback)), dependencies(dependencies) {}
+
+BraveRequestHandler::Stage::Stage(const Stage&) = default;
+
+BraveRequestHandler::Stage& BraveRequestHandler::Stage::operator=(
+    const Stage&) = default;
+
+BraveRequestHandler::Stage::~Stage() = default;
+
 BraveRequestHandler::BraveRequestHandler() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   SetupCallbacks();
@@ -63,74 +124,103 @@ BraveRequestHandler::BraveRequestHandler() {
 
 BraveRequestHandler::~BraveRequestHandler() = default;
 
-void BraveRequestHandler::SetupCallbacks() {
-  brave::OnBeforeURLRequestCallback callback =
-      base::BindRepeating(brave::OnBeforeURLRequest_SiteHacksWork);
-  before_url_request_callbacks_.push_back(callback);
-
-  callback = base::BindRepeating(brave::OnBeforeURLRequest_AdBlockTPPreWork);
-  before_url_request_callbacks_.push_back(callback);
-
-  callback = base::BindRepeating(brave::OnBeforeURLRequest_HttpsePreFileWork);
-  before_url_request_callbacks_.push_back(callback);
-
-  callback =
-      base::BindRepeating(brave::OnBeforeURLRequest_CommonStaticRedirectWork);
-  before_url_request_callbacks_.push_back(callback);
+// static
+void BraveRequestHandler::AddStage(std::vector<Stage>* stages,
+                                   const char* name,
+                                   StageCallback callback) {
+  DCHECK_LT(stages->size(), kMaxStages);
+  stages->emplace_back(name, std::move(callback), AllStages(stages->size()));
+}
 
-  callback = base::BindRepeating(
-      decentralized_dns::OnBeforeURLRequest_DecentralizedDnsPreRedirectWork);
-  before_url_request_callbacks_.push_back(callback);
+// static
+void BraveRequestHandler::AddStage(
+    std::vector<Stage>* stages,
+    const char* name,
+    StageCallback callback,
+    std::initializer_list<const char*> dependencies) {
+  DCHECK_LT(stages->size(), kMaxStages);
+  uint32_t mask = 0;
+  for (const char* dependency : dependencies) {
+    auto it = std::find_if(stages->begin(), stages->end(),
+                           [dependency](const Stage& stage) {
+                             return strcmp(stage.name, dependency) == 0;
+                           });
+    DCHECK(it != stages->end()) << dependency << " must be added before "
+                                << name;
+    if (it != stages->end())
+      mask |= StageBit(it - stages->begin());
+  }
+  stages->emplace_back(name, std::move(callback), mask);
+}
 
-  callback = base::BindRepeating(brave_rewards::OnBeforeURLRequest);
-  before_url_request_callbacks_.push_back(callback);
+void BraveRequestHandler::SetupCallbacks() {
+  // Ad blocking only records its verdict and HTTPSE only rewrites
+  // |new_url_spec|, so they (and rewards, which only reads the request) can
+  // be in flight together without the order they complete in making any
+  // difference. Everything else keeps running after all the stages before it.
+  AddStage(&before_url_request_stages_, kSiteHacksStage,
+           base::BindRepeating(brave::OnBeforeURLRequest_SiteHacksWork));
+  AddStage(&before_url_request_stages_, kAdBlockStage,
+           base::BindRepeating(brave::OnBeforeURLRequest_AdBlockTPPreWork),
+           {});
+  // Keeps the URL site hacks may have already set.
+  AddStage(&before_url_request_stages_, kHttpseStage,
+           base::BindRepeating(brave::OnBeforeURLRequest_HttpsePreFileWork),
+           {kSiteHacksStage});
+  AddStage(
+      &before_url_request_stages_, "CommonStaticRedirect",
+      base::BindRepeating(brave::OnBeforeURLRequest_CommonStaticRedirectWork));
+  AddStage(&before_url_request_stages_, "DecentralizedDns",
+           base::BindRepeating(
+               decentralized_dns::
+                   OnBeforeURLRequest_DecentralizedDnsPreRedirectWork));
+  AddStage(&before_url_request_stages_, "Rewards",
+           base::BindRepeating(brave_rewards::OnBeforeURLRequest), {});
 
 #if BUILDFLAG(ENABLE_IPFS)
   if (base::FeatureList::IsEnabled(ipfs::features::kIpfsFeature)) {
-    callback = base::BindRepeating(ipfs::OnBeforeURLRequest_IPFSRedirectWork);
-    before_url_request_callbacks_.push_back(callback);
-    brave::OnHeadersReceivedCallback ipfs_headers_received_callback =
-        base::BindRepeating(ipfs::OnHeadersReceived_IPFSRedirectWork);
-    headers_received_callbacks_.push_back(ipfs_headers_received_callback);
+    AddStage(&before_url_request_stages_, "IPFSRedirect",
+             base::BindRepeating(ipfs::OnBeforeURLRequest_IPFSRedirectWork));
+    AddStage(&headers_received_stages_, "IPFSRedirect",
+             AdaptStage(base::BindRepeating(
+                 ipfs::OnHeadersReceived_IPFSRedirectWork)));
   }
 #endif
 
-  brave::OnBeforeStartTransactionCallback start_transaction_callback =
-      base::BindRepeating(brave::OnBeforeStartTransaction_SiteHacksWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
-
-  start_transaction_callback = base::BindRepeating(
-      brave::OnBeforeStartTransaction_GlobalPrivacyControlWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
-
-  start_transaction_callback =
-      base::BindRepeating(brave::OnBeforeStartTransaction_BraveServiceKey);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  AddStage(&before_start_transaction_stages_, "SiteHacks",
+           AdaptStage(base::BindRepeating(
+               brave::OnBeforeStartTransaction_SiteHacksWork)));
+  AddStage(&before_start_transaction_stages_, "GlobalPrivacyControl",
+           AdaptStage(base::BindRepeating(
+               brave::OnBeforeStartTransaction_GlobalPrivacyControlWork)));
+  AddStage(&before_start_transaction_stages_, "BraveServiceKey",
+           AdaptStage(base::BindRepeating(
+               brave::OnBeforeStartTransaction_BraveServiceKey)));
 
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
-  start_transaction_callback =
-      base::BindRepeating(brave::OnBeforeStartTransaction_ReferralsWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  AddStage(&before_start_transaction_stages_, "Referrals",
+           AdaptStage(base::BindRepeating(
+               brave::OnBeforeStartTransaction_ReferralsWork)));
 #endif
 
   if (base::FeatureList::IsEnabled(
           brave_shields::features::kBraveReduceLanguage)) {
-    start_transaction_callback =
-        base::BindRepeating(brave::OnBeforeStartTransaction_ReduceLanguageWork);
-    before_start_transaction_callbacks_.push_back(start_transaction_callback);
+    AddStage(&before_start_transaction_stages_, "ReduceLanguage",
+             AdaptStage(base::BindRepeating(
+                 brave::OnBeforeStartTransaction_ReduceLanguageWork)));
   }
 
 #if BUILDFLAG(ENABLE_BRAVE_WEBTORRENT)
-  brave::OnHeadersReceivedCallback headers_received_callback =
-      base::BindRepeating(webtorrent::OnHeadersReceived_TorrentRedirectWork);
-  headers_received_callbacks_.push_back(headers_received_callback);
+  AddStage(&headers_received_stages_, "TorrentRedirect",
+           AdaptStage(base::BindRepeating(
+               webtorrent::OnHeadersReceived_TorrentRedirectWork)));
 #endif
 
   if (base::FeatureList::IsEnabled(
           ::brave_shields::features::kBraveAdblockCspRules)) {
-    brave::OnHeadersReceivedCallback headers_received_callback2 =
-        base::BindRepeating(brave::OnHeadersReceived_AdBlockCspWork);
-    headers_received_callbacks_.push_back(headers_received_callback2);
+    AddStage(&headers_received_stages_, "AdBlockCsp",
+             AdaptStage(
+                 base::BindRepeating(brave::OnHeadersReceived_AdBlockCspWork)));
   }
 }
 
@@ -143,13 +233,13 @@ int BraveRequestHandler::OnBeforeURLRequest(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     GURL* new_url) {
-  if (before_url_request_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (before_url_request_stages_.empty() || IsInternalScheme(ctx)) {
     return net::OK;
   }
   ctx->new_url = new_url;
   ctx->event_type = brave::kOnBeforeRequest;
   callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
+  RunReadyStages(ctx);
   return net::ERR_IO_PENDING;
 }
 
@@ -157,13 +247,13 @@ int BraveRequestHandler::OnBeforeStartTransaction(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     net::HttpRequestHeaders* headers) {
-  if (before_start_transaction_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (before_start_transaction_stages_.empty() || IsInternalScheme(ctx)) {
     return net::OK;
   }
   ctx->event_type = brave::kOnBeforeStartTransaction;
   ctx->headers = headers;
   callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
+  RunReadyStages(ctx);
   return net::ERR_IO_PENDING;
 }
 
@@ -179,7 +269,7 @@ int BraveRequestHandler::OnHeadersReceived(
         original_response_headers, override_response_headers);
   }
 
-  if (headers_received_callbacks_.empty() &&
+  if (headers_received_stages_.empty() &&
       !ctx->request_url.SchemeIs(content::kChromeUIScheme)) {
     // Extension scheme not excluded since brave_webtorrent needs it.
     return net::OK;
@@ -191,7 +281,7 @@ int BraveRequestHandler::OnHeadersReceived(
   ctx->override_response_headers = override_response_headers;
   ctx->allowed_unsafe_redirect_url = allowed_unsafe_redirect_url;
 
-  RunNextCallback(ctx);
+  RunReadyStages(ctx);
   return net::ERR_IO_PENDING;
 }
 
@@ -213,9 +303,22 @@ void BraveRequestHandler::RunCallbackForRequestIdentifier(
       FROM_HERE, base::BindOnce(std::move(it->second), rv));
 }
 
-// TODO(iefremov): Merge all callback containers into one and run only one loop
-// instead of many (issues/5574).
-void BraveRequestHandler::RunNextCallback(
+const std::vector<BraveRequestHandler::Stage>& BraveRequestHandler::GetStages(
+    brave::BraveNetworkDelegateEventType event_type) const {
+  switch (event_type) {
+    case brave::kOnBeforeRequest:
+      return before_url_request_stages_;
+    case brave::kOnBeforeStartTransaction:
+      return before_start_transaction_stages_;
+    case brave::kOnHeadersReceived:
+      return headers_received_stages_;
+    default:
+      NOTREACHED();
+      return headers_received_stages_;
+  }
+}
+
+void BraveRequestHandler::RunReadyStages(
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 
@@ -223,85 +326,104 @@ void BraveRequestHandler::RunNextCallback(
     return;
   }
 
-  if (ctx->pending_error.has_value()) {
-    RunCallbackForRequestIdentifier(ctx->request_identifier,
-                                    ctx->pending_error.value());
+  const std::vector<Stage>& stages = GetStages(ctx->event_type);
+  if (stages.empty()) {
+    MaybeFinishStages(ctx);
     return;
   }
 
-  // Continue processing callbacks until we hit one that returns PENDING
-  int rv = net::OK;
-
-  if (ctx->event_type == brave::kOnBeforeRequest) {
-    while (before_url_request_callbacks_.size() !=
-           ctx->next_url_request_index) {
-      brave::OnBeforeURLRequestCallback callback =
-          before_url_request_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::BindRepeating(&BraveRequestHandler::RunNextCallback,
-                              weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
-      }
+  // Stages only depend on earlier ones, so a single pass starts everything
+  // that the stages completing during it make ready.
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const Stage& stage = stages[i];
+    if ((ctx->started_stages & StageBit(i)) ||
+        (stage.dependencies & ~ctx->finished_stages)) {
+      continue;
     }
-  } else if (ctx->event_type == brave::kOnBeforeStartTransaction) {
-    while (before_start_transaction_callbacks_.size() !=
-           ctx->next_url_request_index) {
-      brave::OnBeforeStartTransactionCallback callback =
-          before_start_transaction_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::BindRepeating(&BraveRequestHandler::RunNextCallback,
-                              weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(ctx->headers, next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
-      }
+    ctx->started_stages |= StageBit(i);
+
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN0(
+        kTraceCategory, stage.name,
+        TRACE_ID_WITH_SCOPE(stage.name, TRACE_ID_LOCAL(ctx.get())));
+    brave::ResponseCallback next_callback =
+        base::BindRepeating(&BraveRequestHandler::OnStageComplete,
+                            weak_factory_.GetWeakPtr(), ctx, i);
+    const int rv = stage.callback.Run(next_callback, ctx);
+    // A stage which runs |next_callback| before returning may have finished
+    // the event already.
+    if (ctx->stages_done) {
+      return;
     }
-  } else if (ctx->event_type == brave::kOnHeadersReceived) {
-    while (headers_received_callbacks_.size() != ctx->next_url_request_index) {
-      brave::OnHeadersReceivedCallback callback =
-          headers_received_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::BindRepeating(&BraveRequestHandler::RunNextCallback,
-                              weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(ctx->original_response_headers,
-                        ctx->override_response_headers,
-                        ctx->allowed_unsafe_redirect_url, next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
-      }
+    if (rv == net::ERR_IO_PENDING) {
+      continue;
+    }
+    TRACE_EVENT_NESTABLE_ASYNC_END0(
+        kTraceCategory, stage.name,
+        TRACE_ID_WITH_SCOPE(stage.name, TRACE_ID_LOCAL(ctx.get())));
+    ctx->finished_stages |= StageBit(i);
+    if (rv != net::OK) {
+      FinishStages(ctx, rv);
+      return;
+    }
+    if (MaybeFinishStages(ctx)) {
+      return;
     }
   }
+}
 
-  if (rv != net::OK) {
-    RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+void BraveRequestHandler::OnStageComplete(
+    std::shared_ptr<brave::BraveRequestInfo> ctx,
+    size_t index) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  const Stage& stage = GetStages(ctx->event_type)[index];
+  TRACE_EVENT_NESTABLE_ASYNC_END0(
+      kTraceCategory, stage.name,
+      TRACE_ID_WITH_SCOPE(stage.name, TRACE_ID_LOCAL(ctx.get())));
+  DCHECK(!(ctx->finished_stages & StageBit(index)));
+  ctx->finished_stages |= StageBit(index);
+
+  if (ctx->stages_done || !base::Contains(callbacks_, ctx->request_identifier))
     return;
+  if (!MaybeFinishStages(ctx))
+    RunReadyStages(ctx);
+}
+
+bool BraveRequestHandler::MaybeFinishStages(
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  if (ctx->pending_error.has_value()) {
+    FinishStages(ctx, ctx->pending_error.value());
+    return true;
+  }
+
+  // Nothing the remaining stages do can unblock a request, so there is no
+  // point in waiting for them. Stages still in flight may be writing to other
+  // fields of |ctx|, which is why |new_url_spec| isn't looked at here.
+  if (ctx->event_type == brave::kOnBeforeRequest &&
+      (ctx->blocked_by == brave::kAdBlocked ||
+       ctx->blocked_by == brave::kOtherBlocked) &&
+      !ctx->ShouldMockRequest()) {
+    FinishStages(ctx, net::ERR_BLOCKED_BY_CLIENT);
+    return true;
   }
 
+  if (ctx->finished_stages != AllStages(GetStages(ctx->event_type).size()))
+    return false;
+
   if (ctx->event_type == brave::kOnBeforeRequest) {
     if (!ctx->new_url_spec.empty() &&
         (ctx->new_url_spec != ctx->request_url.spec()) &&
         IsRequestIdentifierValid(ctx->request_identifier)) {
       *ctx->new_url = GURL(ctx->new_url_spec);
     }
-    if (ctx->blocked_by == brave::kAdBlocked ||
-        ctx->blocked_by == brave::kOtherBlocked) {
-      if (!ctx->ShouldMockRequest()) {
-        RunCallbackForRequestIdentifier(ctx->request_identifier,
-                                        net::ERR_BLOCKED_BY_CLIENT);
-        return;
-      }
-    }
   }
+  FinishStages(ctx, net::OK);
+  return true;
+}
+
+void BraveRequestHandler::FinishStages(
+    std::shared_ptr<brave::BraveRequestInfo> ctx,
+    int rv) {
+  DCHECK(!ctx->stages_done);
+  ctx->stages_done = true;
   RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
 }
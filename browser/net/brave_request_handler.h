@@ -6,6 +6,8 @@
 #ifndef BRAVE_BROWSER_NET_BRAVE_REQUEST_HANDLER_H_
 #define BRAVE_BROWSER_NET_BRAVE_REQUEST_HANDLER_H_
 
+#include <cstdint>
+#include <initializer_list>
 #include <map>
 #include <memory>
 #include <string>
@@ -46,13 +48,54 @@ class BraveRequestHandler {
   void RunCallbackForRequestIdentifier(uint64_t request_identifier, int rv);
 
  private:
+  friend class BraveRequestHandlerTest;
+
+  // The hooks of every event are adapted to the signature of the
+  // OnBeforeURLRequest ones and take anything else they need from the ctx.
+  using StageCallback = brave::OnBeforeURLRequestCallback;
+
+  // One hook of an event. A stage starts as soon as the stages it depends on
+  // are finished, so stages which don't touch each other's results can wait
+  // on their task runners at the same time. Stages only depend on stages
+  // added before them, and those which are ready start in the order they
+  // were added.
+  struct Stage {
+    Stage(const char* name, StageCallback callback, uint32_t dependencies);
+    Stage(const Stage&);
+    Stage& operator=(const Stage&);
+    ~Stage();
+
+    // Also the name of the trace event covering the stage.
+    const char* name;
+    StageCallback callback;
+    // Bit i is set if the stage waits for the i-th stage of its event.
+    uint32_t dependencies;
+  };
+
+  // Adds a stage which waits for all the stages added before it.
+  static void AddStage(std::vector<Stage>* stages,
+                       const char* name,
+                       StageCallback callback);
+  // Adds a stage which only waits for the stages named in |dependencies|.
+  static void AddStage(std::vector<Stage>* stages,
+                       const char* name,
+                       StageCallback callback,
+                       std::initializer_list<const char*> dependencies);
+
   void SetupCallbacks();
-  void RunNextCallback(std::shared_ptr<brave::BraveRequestInfo> ctx);
+  const std::vector<Stage>& GetStages(
+      brave::BraveNetworkDelegateEventType event_type) const;
+  void RunReadyStages(std::shared_ptr<brave::BraveRequestInfo> ctx);
+  void OnStageComplete(std::shared_ptr<brave::BraveRequestInfo> ctx,
+                       size_t index);
+  // Returns true if the event has finished, either because all of its stages
+  // have or because the result is already known.
+  bool MaybeFinishStages(std::shared_ptr<brave::BraveRequestInfo> ctx);
+  void FinishStages(std::shared_ptr<brave::BraveRequestInfo> ctx, int rv);
 
-  std::vector<brave::OnBeforeURLRequestCallback> before_url_request_callbacks_;
-  std::vector<brave::OnBeforeStartTransactionCallback>
-      before_start_transaction_callbacks_;
-  std::vector<brave::OnHeadersReceivedCallback> headers_received_callbacks_;
+  std::vector<Stage> before_url_request_stages_;
+  std::vector<Stage> before_start_transaction_stages_;
+  std::vector<Stage> headers_received_stages_;
 
   std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
 
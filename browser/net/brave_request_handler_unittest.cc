@@ -0,0 +1,219 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_request_handler.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "brave/browser/net/url_context.h"
+#include "content/public/test/browser_task_environment.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+
+class BraveRequestHandlerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    handler_ = std::make_unique<BraveRequestHandler>();
+    ctx_ = std::make_shared<brave::BraveRequestInfo>(
+        GURL("https://example.com/"));
+    ctx_->request_identifier = 1;
+  }
+
+  // Returns the dependency mask of the OnBeforeURLRequest stage |name|.
+  uint32_t GetDependencies(const char* name) {
+    for (const auto& stage : handler_->before_url_request_stages_) {
+      if (strcmp(stage.name, name) == 0)
+        return stage.dependencies;
+    }
+    ADD_FAILURE() << "No stage " << name;
+    return 0;
+  }
+
+  // Returns the bit standing for the OnBeforeURLRequest stage |name|.
+  uint32_t GetStageBit(const char* name) {
+    const auto& stages = handler_->before_url_request_stages_;
+    for (size_t i = 0; i < stages.size(); ++i) {
+      if (strcmp(stages[i].name, name) == 0)
+        return 1u << i;
+    }
+    ADD_FAILURE() << "No stage " << name;
+    return 0;
+  }
+
+  // Replaces the OnBeforeURLRequest stages with ones that stay pending until
+  // CompleteStage() is called, laid out like the real ones.
+  void UseFakeStages() {
+    ClearStages();
+    AddFakeStage("SiteHacks");
+    AddFakeStage("AdBlock", {});
+    AddFakeStage("HTTPSE", {"SiteHacks"});
+    AddFakeStage("Rewards", {});
+    AddFakeStage("Redirect");
+  }
+
+  void ClearStages() { handler_->before_url_request_stages_.clear(); }
+
+  // Adds a stage which doesn't depend on any other.
+  void AddIndependentStage(const char* name,
+                           BraveRequestHandler::StageCallback callback) {
+    BraveRequestHandler::AddStage(&handler_->before_url_request_stages_, name,
+                                  std::move(callback), {});
+  }
+
+  void AddFakeStage(const char* name) {
+    BraveRequestHandler::AddStage(&handler_->before_url_request_stages_, name,
+                                  MakeFakeStage(name));
+  }
+
+  void AddFakeStage(const char* name,
+                    std::initializer_list<const char*> dependencies) {
+    BraveRequestHandler::AddStage(&handler_->before_url_request_stages_, name,
+                                  MakeFakeStage(name), dependencies);
+  }
+
+  BraveRequestHandler::StageCallback MakeFakeStage(const char* name) {
+    return base::BindRepeating(
+        [](BraveRequestHandlerTest* test, const std::string& name,
+           const brave::ResponseCallback& next_callback,
+           std::shared_ptr<brave::BraveRequestInfo> ctx) {
+          test->started_.push_back(name);
+          test->pending_[name] = next_callback;
+          return net::ERR_IO_PENDING;
+        },
+        base::Unretained(this), std::string(name));
+  }
+
+  void CompleteStage(const std::string& name) {
+    auto it = pending_.find(name);
+    ASSERT_NE(it, pending_.end()) << name << " was not started";
+    brave::ResponseCallback next_callback = std::move(it->second);
+    pending_.erase(it);
+    next_callback.Run();
+  }
+
+  int Start() {
+    return handler_->OnBeforeURLRequest(
+        ctx_,
+        base::BindOnce(
+            [](BraveRequestHandlerTest* test, int rv) {
+              EXPECT_FALSE(test->result_.has_value());
+              test->result_ = rv;
+            },
+            base::Unretained(this)),
+        &new_url_);
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<BraveRequestHandler> handler_;
+  std::shared_ptr<brave::BraveRequestInfo> ctx_;
+  GURL new_url_;
+  std::vector<std::string> started_;
+  std::map<std::string, brave::ResponseCallback> pending_;
+  absl::optional<int> result_;
+};
+
+TEST_F(BraveRequestHandlerTest, HttpseOnlyWaitsForSiteHacks) {
+  EXPECT_EQ(GetDependencies("HTTPSE"), GetStageBit("SiteHacks"));
+  EXPECT_EQ(GetDependencies("AdBlock"), 0u);
+  EXPECT_EQ(GetDependencies("Rewards"), 0u);
+  // Every other stage waits for all the stages before it.
+  EXPECT_EQ(GetDependencies("SiteHacks"), 0u);
+  EXPECT_EQ(GetDependencies("CommonStaticRedirect"),
+            GetStageBit("CommonStaticRedirect") - 1);
+}
+
+TEST_F(BraveRequestHandlerTest, IndependentStagesRunConcurrently) {
+  UseFakeStages();
+  EXPECT_EQ(Start(), net::ERR_IO_PENDING);
+  // HTTPSE and Redirect wait for SiteHacks, the rest are all in flight.
+  EXPECT_EQ(started_,
+            std::vector<std::string>({"SiteHacks", "AdBlock", "Rewards"}));
+
+  // Completing the independent stages doesn't start anything new.
+  CompleteStage("Rewards");
+  CompleteStage("AdBlock");
+  EXPECT_EQ(started_.size(), 3u);
+
+  CompleteStage("SiteHacks");
+  EXPECT_EQ(started_.back(), "HTTPSE");
+  ctx_->new_url_spec = "https://example.com/upgraded";
+  CompleteStage("HTTPSE");
+  EXPECT_EQ(started_.back(), "Redirect");
+  CompleteStage("Redirect");
+
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_EQ(*result_, net::OK);
+  EXPECT_EQ(new_url_, GURL("https://example.com/upgraded"));
+}
+
+TEST_F(BraveRequestHandlerTest, BlockedRequestFinishesEarly) {
+  UseFakeStages();
+  EXPECT_EQ(Start(), net::ERR_IO_PENDING);
+
+  ctx_->blocked_by = brave::kAdBlocked;
+  CompleteStage("AdBlock");
+  base::RunLoop().RunUntilIdle();
+  // SiteHacks and Rewards are still pending, but the result is known.
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_EQ(*result_, net::ERR_BLOCKED_BY_CLIENT);
+
+  // Stages completing afterwards are ignored and start nothing.
+  CompleteStage("SiteHacks");
+  CompleteStage("Rewards");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(started_,
+            std::vector<std::string>({"SiteHacks", "AdBlock", "Rewards"}));
+  EXPECT_TRUE(new_url_.is_empty());
+}
+
+TEST_F(BraveRequestHandlerTest, StageFinishingEventSynchronously) {
+  ClearStages();
+  AddIndependentStage(
+      "Blocker",
+      base::BindRepeating([](const brave::ResponseCallback& next_callback,
+                             std::shared_ptr<brave::BraveRequestInfo> ctx) {
+        ctx->blocked_by = brave::kAdBlocked;
+        next_callback.Run();
+        return net::ERR_IO_PENDING;
+      }));
+  AddFakeStage("Other", {});
+
+  EXPECT_EQ(Start(), net::ERR_IO_PENDING);
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_EQ(*result_, net::ERR_BLOCKED_BY_CLIENT);
+  // Nothing else starts once the event is over.
+  EXPECT_TRUE(started_.empty());
+}
+
+TEST_F(BraveRequestHandlerTest, MockedRequestWaitsForAllStages) {
+  UseFakeStages();
+  EXPECT_EQ(Start(), net::ERR_IO_PENDING);
+
+  ctx_->blocked_by = brave::kAdBlocked;
+  ctx_->mock_data_url = "data:text/plain,";
+  CompleteStage("AdBlock");
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(result_.has_value());
+
+  CompleteStage("SiteHacks");
+  CompleteStage("Rewards");
+  CompleteStage("HTTPSE");
+  CompleteStage("Redirect");
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(result_.has_value());
+  EXPECT_EQ(*result_, net::OK);
+}
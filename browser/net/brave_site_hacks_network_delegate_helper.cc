@@ -7,19 +7,22 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/containers/fixed_flat_map.h"
 #include "base/containers/fixed_flat_set.h"
+#include "base/containers/flat_map.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_piece.h"
-#include "base/strings/string_split.h"
-#include "base/strings/string_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/constants/url_constants.h"
+#include "brave/components/query_filter/query_filter_util.h"
 #include "content/public/common/referrer.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "net/url_request/url_request.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/common/loader/network_utils.h"
 #include "third_party/blink/public/common/loader/referrer_utils.h"
 #include "third_party/re2/src/re2/re2.h"
@@ -73,40 +76,39 @@ static constexpr auto kConditionalQueryStringTrackers =
         {// https://github.com/brave/brave-browser/issues/9018
          {"mkt_tok", "[uU]nsubscribe"}});
 
+// Compiled once: the conditional trackers are checked for every query string
+// parameter of every request, so don't re-parse their patterns each time.
+const re2::RE2* GetConditionalTrackerRegex(base::StringPiece key) {
+  static const base::NoDestructor<
+      base::flat_map<base::StringPiece, std::unique_ptr<re2::RE2>>>
+      regexes([] {
+        std::vector<std::pair<base::StringPiece, std::unique_ptr<re2::RE2>>>
+            compiled;
+        for (const auto& [name, pattern] : kConditionalQueryStringTrackers) {
+          compiled.emplace_back(
+              name, std::make_unique<re2::RE2>(re2::StringPiece(
+                        pattern.data(), pattern.size())));
+        }
+        return base::flat_map<base::StringPiece, std::unique_ptr<re2::RE2>>(
+            base::sorted_unique, std::move(compiled));
+      }());
+  const auto it = regexes->find(key);
+  return it == regexes->end() ? nullptr : it->second.get();
+}
+
 // Remove tracking query parameters from a GURL, leaving all
 // other parts untouched.
-std::string StripQueryParameter(const std::string& query,
-                                const std::string& spec) {
-  // We are using custom query string parsing code here. See
-  // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
-  // for more information on why this approach was selected.
-  //
-  // Split query string by ampersands, remove tracking parameters,
-  // then join the remaining query parameters, untouched, back into
-  // a single query string.
-  const std::vector<std::string> input_kv_strings =
-      SplitString(query, "&", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  std::vector<std::string> output_kv_strings;
-  int disallowed_count = 0;
-  for (const std::string& kv_string : input_kv_strings) {
-    const std::vector<std::string> pieces = SplitString(
-        kv_string, "=", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-    const std::string& key = pieces.empty() ? "" : pieces[0];
-    if (pieces.size() >= 2 &&
-        (kSimpleQueryStringTrackers.count(key) == 1 ||
-         (kConditionalQueryStringTrackers.count(key) == 1 &&
-          !re2::RE2::PartialMatch(
-              spec, kConditionalQueryStringTrackers.at(key).data())))) {
-      ++disallowed_count;
-    } else {
-      output_kv_strings.push_back(kv_string);
-    }
-  }
-  if (disallowed_count > 0) {
-    return base::JoinString(output_kv_strings, "&");
-  } else {
-    return query;
-  }
+absl::optional<std::string> StripQueryParameter(base::StringPiece query,
+                                                base::StringPiece spec) {
+  return query_filter::StripQueryParameters(
+      query, [spec](base::StringPiece key) {
+        if (kSimpleQueryStringTrackers.contains(key))
+          return true;
+        const re2::RE2* condition = GetConditionalTrackerRegex(key);
+        return condition &&
+               !re2::RE2::PartialMatch(
+                   re2::StringPiece(spec.data(), spec.size()), *condition);
+      });
 }
 
 void ApplyPotentialQueryStringFilter(std::shared_ptr<BraveRequestInfo> ctx) {
@@ -138,15 +140,14 @@ void ApplyPotentialQueryStringFilter(std::shared_ptr<BraveRequestInfo> ctx) {
     return;
   }
 
-  const std::string query = ctx->request_url.query();
-  const std::string spec = ctx->request_url.spec();
-  const std::string clean_query = StripQueryParameter(query, spec);
-  if (clean_query.length() < query.length()) {
+  const absl::optional<std::string> clean_query = StripQueryParameter(
+      ctx->request_url.query_piece(), ctx->request_url.spec());
+  if (clean_query) {
     GURL::Replacements replacements;
-    if (clean_query.empty()) {
+    if (clean_query->empty()) {
       replacements.ClearQuery();
     } else {
-      replacements.SetQueryStr(clean_query);
+      replacements.SetQueryStr(*clean_query);
     }
     ctx->new_url_spec = ctx->request_url.ReplaceComponents(replacements).spec();
   }
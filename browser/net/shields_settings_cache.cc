@@ -0,0 +1,92 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/shields_settings_cache.h"
+
+#include <memory>
+
+#include "base/memory/ptr_util.h"
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_thread.h"
+#include "url/origin.h"
+
+namespace brave {
+
+namespace {
+
+const void* const kShieldsSettingsCacheUserDataKey =
+    &kShieldsSettingsCacheUserDataKey;
+
+// Plenty for the tabs of a profile and the sites they redirect through.
+constexpr size_t kMaxCachedOrigins = 128;
+
+}  // namespace
+
+ShieldsSettingsCache::ShieldsSettingsCache(HostContentSettingsMap* map)
+    : map_(map), settings_(kMaxCachedOrigins) {
+  observation_.Observe(map);
+}
+
+ShieldsSettingsCache::~ShieldsSettingsCache() = default;
+
+// static
+ShieldsSettingsCache* ShieldsSettingsCache::GetForBrowserContext(
+    content::BrowserContext* browser_context) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto* self = static_cast<ShieldsSettingsCache*>(
+      browser_context->GetUserData(kShieldsSettingsCacheUserDataKey));
+  if (!self) {
+    self = new ShieldsSettingsCache(
+        HostContentSettingsMapFactory::GetForProfile(browser_context));
+    browser_context->SetUserData(kShieldsSettingsCacheUserDataKey,
+                                 base::WrapUnique(self));
+  }
+  return self;
+}
+
+const ShieldsSettings& ShieldsSettingsCache::Get(const GURL& url) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Shields settings are scoped to hosts, so every URL of an HTTP(S) origin
+  // has the same ones. Anything else is rare enough to just look up.
+  if (!url.SchemeIsHTTPOrHTTPS()) {
+    uncached_settings_ = Compute(url);
+    return uncached_settings_;
+  }
+
+  const GURL origin = url::Origin::Create(url).GetURL();
+  auto it = settings_.Get(origin);
+  if (it == settings_.end())
+    it = settings_.Put(origin, Compute(origin));
+  return it->second;
+}
+
+void ShieldsSettingsCache::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsTypeSet content_type_set) {
+  settings_.Clear();
+}
+
+ShieldsSettings ShieldsSettingsCache::Compute(const GURL& url) const {
+  ShieldsSettings settings;
+  settings.allow_brave_shields =
+      brave_shields::GetBraveShieldsEnabled(map_.get(), url);
+  settings.allow_ads = brave_shields::GetAdControlType(map_.get(), url) ==
+                       brave_shields::ControlType::ALLOW;
+  // Currently, "aggressive" mode is registered as a cosmetic filtering control
+  // type, even though it can also affect network blocking.
+  settings.aggressive_blocking =
+      brave_shields::GetCosmeticFilteringControlType(map_.get(), url) ==
+      brave_shields::ControlType::BLOCK;
+  settings.allow_http_upgradable_resource =
+      !brave_shields::GetHTTPSEverywhereEnabled(map_.get(), url);
+  settings.allow_referrers =
+      brave_shields::AreReferrersAllowed(map_.get(), url);
+  return settings;
+}
+
+}  // namespace brave
@@ -0,0 +1,71 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
+#define BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
+
+#include "base/containers/lru_cache.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/scoped_observation.h"
+#include "base/supports_user_data.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "url/gurl.h"
+
+namespace content {
+class BrowserContext;
+}
+
+namespace brave {
+
+// Shields settings of a page as seen by the network request pipeline.
+struct ShieldsSettings {
+  bool allow_brave_shields = true;
+  bool allow_ads = false;
+  bool aggressive_blocking = false;
+  bool allow_http_upgradable_resource = false;
+  bool allow_referrers = false;
+};
+
+// Remembers the shields settings of the origins a profile's requests come
+// from, so that a page's subresources and redirects don't each go through the
+// content settings rules again. Everything is forgotten as soon as any content
+// setting of the profile changes. Lives on the UI thread, like the request
+// contexts that read it, so no locking is needed.
+class ShieldsSettingsCache : public base::SupportsUserData::Data,
+                             public content_settings::Observer {
+ public:
+  explicit ShieldsSettingsCache(HostContentSettingsMap* map);
+  ShieldsSettingsCache(const ShieldsSettingsCache&) = delete;
+  ShieldsSettingsCache& operator=(const ShieldsSettingsCache&) = delete;
+  ~ShieldsSettingsCache() override;
+
+  static ShieldsSettingsCache* GetForBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Returns the settings for the origin of |url|.
+  const ShieldsSettings& Get(const GURL& url);
+
+  // content_settings::Observer:
+  void OnContentSettingChanged(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSettingsTypeSet content_type_set) override;
+
+ private:
+  ShieldsSettings Compute(const GURL& url) const;
+
+  scoped_refptr<HostContentSettingsMap> map_;
+  base::LRUCache<GURL, ShieldsSettings> settings_;
+  // For URLs that can't be cached.
+  ShieldsSettings uncached_settings_;
+
+  base::ScopedObservation<HostContentSettingsMap, content_settings::Observer>
+      observation_{this};
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_SHIELDS_SETTINGS_CACHE_H_
@@ -0,0 +1,75 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/shields_settings_cache.h"
+
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+class ShieldsSettingsCacheTest : public testing::Test {
+ public:
+  ShieldsSettingsCacheTest() = default;
+  ~ShieldsSettingsCacheTest() override = default;
+
+  HostContentSettingsMap* map() {
+    return HostContentSettingsMapFactory::GetForProfile(&profile_);
+  }
+
+  ShieldsSettingsCache* cache() {
+    return ShieldsSettingsCache::GetForBrowserContext(&profile_);
+  }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  TestingProfile profile_;
+};
+
+TEST_F(ShieldsSettingsCacheTest, MatchesContentSettings) {
+  const GURL url("https://brave.com/page");
+  EXPECT_EQ(cache(), cache());
+
+  ShieldsSettings settings = cache()->Get(url);
+  EXPECT_EQ(brave_shields::GetBraveShieldsEnabled(map(), url),
+            settings.allow_brave_shields);
+  EXPECT_EQ(brave_shields::GetAdControlType(map(), url) ==
+                brave_shields::ControlType::ALLOW,
+            settings.allow_ads);
+  EXPECT_EQ(brave_shields::AreReferrersAllowed(map(), url),
+            settings.allow_referrers);
+
+  // Other pages of the same origin share the settings.
+  EXPECT_EQ(settings.allow_brave_shields,
+            cache()->Get(GURL("https://brave.com/other")).allow_brave_shields);
+}
+
+TEST_F(ShieldsSettingsCacheTest, UpdatedOnContentSettingChange) {
+  const GURL url("https://brave.com/");
+  EXPECT_TRUE(cache()->Get(url).allow_brave_shields);
+  EXPECT_FALSE(cache()->Get(url).allow_ads);
+
+  brave_shields::SetBraveShieldsEnabled(map(), false, url);
+  EXPECT_FALSE(cache()->Get(url).allow_brave_shields);
+
+  brave_shields::SetBraveShieldsEnabled(map(), true, url);
+  brave_shields::SetAdControlType(map(), brave_shields::ControlType::ALLOW,
+                                  url);
+  EXPECT_TRUE(cache()->Get(url).allow_brave_shields);
+  EXPECT_TRUE(cache()->Get(url).allow_ads);
+
+  // Other origins are not affected.
+  EXPECT_FALSE(cache()->Get(GURL("https://example.com/")).allow_ads);
+}
+
+TEST_F(ShieldsSettingsCacheTest, NonHttpUrl) {
+  EXPECT_FALSE(cache()->Get(GURL("chrome://settings")).allow_brave_shields);
+}
+
+}  // namespace brave
@@ -87,7 +87,6 @@ struct BraveRequestInfo {
   bool is_webtorrent_disabled = false;
   int frame_tree_node_id = 0;
   uint64_t request_identifier = 0;
-  size_t next_url_request_index = 0;
 
   content::BrowserContext* browser_context = nullptr;
   net::HttpRequestHeaders* headers = nullptr;
@@ -135,6 +134,14 @@ struct BraveRequestInfo {
   friend class ::BraveRequestHandler;
 
   GURL* new_url = nullptr;
+
+  // Progress of BraveRequestHandler through the stages of |event_type|, as
+  // bit masks of stage indices.
+  uint32_t started_stages = 0;
+  uint32_t finished_stages = 0;
+  // Set once the result of the event has been reported; stages still in
+  // flight at that point are ignored when they complete.
+  bool stages_done = false;
 };
 
 // ResponseListener
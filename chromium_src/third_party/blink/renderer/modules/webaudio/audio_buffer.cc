@@ -3,7 +3,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-#include "base/callback.h"
+#include "base/containers/span.h"
+#include "brave/third_party/blink/renderer/brave_audio_farbling_helper.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "brave/third_party/blink/renderer/core/farbling/brave_session_cache.h"
 #include "third_party/blink/public/platform/web_content_settings_client.h"
@@ -21,28 +22,27 @@
       DOMFloat32Array* destination_array = array.Get();                        \
       size_t len = destination_array->length();                                \
       if (len > 0) {                                                           \
-        float* destination = destination_array->Data();                        \
-        brave::AudioFarblingCallback audio_farbling_callback =                 \
-            brave::BraveSessionCache::From(*context).GetAudioFarblingCallback( \
-                settings);                                                     \
-        for (unsigned i = 0; i < len; ++i) {                                   \
-          destination[i] = audio_farbling_callback.Run(destination[i], i);     \
+        if (absl::optional<brave::AudioFarblingHelper> audio_farbling_helper = \
+                brave::BraveSessionCache::From(*context)                       \
+                    .GetAudioFarblingHelper(settings)) {                       \
+          audio_farbling_helper->FarbleAudioChannel(                           \
+              base::make_span(destination_array->Data(), len), 0);             \
         }                                                                      \
       }                                                                        \
     }                                                                          \
   }
 
-#define BRAVE_AUDIOBUFFER_COPYFROMCHANNEL                                    \
-  if (ExecutionContext* context = ExecutionContext::From(script_state)) {    \
-    if (WebContentSettingsClient* settings =                                 \
-            brave::GetContentSettingsClientFor(context)) {                   \
-      brave::AudioFarblingCallback audio_farbling_callback =                 \
-          brave::BraveSessionCache::From(*context).GetAudioFarblingCallback( \
-              settings);                                                     \
-      for (unsigned i = 0; i < count; i++) {                                 \
-        dst[i] = audio_farbling_callback.Run(dst[i], i);                     \
-      }                                                                      \
-    }                                                                        \
+#define BRAVE_AUDIOBUFFER_COPYFROMCHANNEL                                      \
+  if (ExecutionContext* context = ExecutionContext::From(script_state)) {      \
+    if (WebContentSettingsClient* settings =                                   \
+            brave::GetContentSettingsClientFor(context)) {                     \
+      if (absl::optional<brave::AudioFarblingHelper> audio_farbling_helper =  \
+              brave::BraveSessionCache::From(*context).GetAudioFarblingHelper( \
+                  settings)) {                                                 \
+        audio_farbling_helper->FarbleAudioChannel(base::make_span(dst, count), \
+                                                  0);                          \
+      }                                                                        \
+    }                                                                          \
   }
 
 #include "src/third_party/blink/renderer/modules/webaudio/audio_buffer.cc"
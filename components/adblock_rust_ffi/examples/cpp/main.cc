@@ -281,6 +281,38 @@ void TestClassId() {
   assert(stylesheet == "[]");
 }
 
+void TestGenericClassIdKeys() {
+  const std::string rules =
+      "###element\n"
+      "##.ads\n"
+      "##.ads > div\n"
+      "###ads > #element\n"
+      "##a[href^=\"test.com\"]\n"
+      "~example.com##.banner\n"
+      "example.com##.specific\n"
+      "#@#.unhidden\n";
+  std::vector<std::string> keys;
+  auto metadata_and_engine = adblock::engineFromBufferWithGenericKeys(
+      rules.data(), rules.size(), &keys);
+  assert(keys == std::vector<std::string>(
+                     {"#ads", "#element", ".ads", ".banner"}));
+
+  // Every class and id the engine has generic rules for is among the keys.
+  std::vector<std::string> classes = std::vector<std::string>({"ads"});
+  std::vector<std::string> ids = std::vector<std::string>({"element"});
+  std::vector<std::string> exceptions = std::vector<std::string>();
+  std::string stylesheet = metadata_and_engine.second->hiddenClassIdSelectors(
+      classes, ids, exceptions);
+  assert(stylesheet.find("\".ads\"") != std::string::npos);
+  assert(stylesheet.find("\".ads > div\"") != std::string::npos);
+  assert(stylesheet.find("\"#element\"") != std::string::npos);
+
+  const std::string empty;
+  metadata_and_engine =
+      adblock::engineFromBufferWithGenericKeys(empty.data(), 0, &keys);
+  assert(keys.empty());
+}
+
 void TestUrlCosmetics() {
   adblock::Engine engine(
       "a.com###element\n"
@@ -434,6 +466,7 @@ int main() {
   TestImportant();
   TestException();
   TestClassId();
+  TestGenericClassIdKeys();
   TestUrlCosmetics();
   TestSubdomainUrlCosmetics();
   TestGenerichide();
@@ -55,6 +55,18 @@ struct C_Engine* engine_create_from_buffer_with_metadata(
     size_t data_size,
     struct C_FilterListMetadata** metadata);
 
+/**
+ * Create a new `Engine`, interpreting `data` as a C string and then parsing as
+ * a filter list in ABP syntax. Also populates metadata from the filter list
+ * into `metadata`, and the class and id keys of its generic hide rules, e.g.
+ * `.ad` or `#banner`, into `generic_keys`, one per line.
+ */
+struct C_Engine* engine_create_from_buffer_with_generic_keys(
+    const char* data,
+    size_t data_size,
+    struct C_FilterListMetadata** metadata,
+    char** generic_keys);
+
 /**
  * Create a new `Engine`, interpreting `rules` as a null-terminated C string and
  * then parsing as a filter list in ABP syntax.
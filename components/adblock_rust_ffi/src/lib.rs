@@ -1,5 +1,6 @@
 use adblock::blocker::Redirection;
 use adblock::engine::Engine;
+use adblock::filters::cosmetic::CosmeticFilterMask;
 use adblock::lists::FilterListMetadata;
 use adblock::resources::{MimeType, Resource, ResourceType};
 use core::ptr;
@@ -103,6 +104,49 @@ pub unsafe extern "C" fn engine_create_with_metadata(rules: *const c_char, metad
     engine_ptr
 }
 
+/// Create a new `Engine`, interpreting `data` as a C string and then parsing as a filter list in
+/// ABP syntax. Also populates metadata from the filter list into `metadata`, and the class and id
+/// keys of its generic hide rules, e.g. `.ad` or `#banner`, into `generic_keys`, one per line.
+#[no_mangle]
+pub unsafe extern "C" fn engine_create_from_buffer_with_generic_keys(
+    data: *const c_char,
+    data_size: size_t,
+    metadata: *mut *mut FilterListMetadata,
+    generic_keys: *mut *mut c_char,
+) -> *mut Engine {
+    let data: &[u8] = std::slice::from_raw_parts(data as *const u8, data_size);
+    let rules = std::str::from_utf8(data).unwrap_or_else(|_| {
+        eprintln!("Failed to parse filter list with invalid UTF-8 content");
+        ""
+    });
+    let mut filter_set = adblock::lists::FilterSet::new(false);
+    let list_metadata = filter_set.add_filter_list(&rules, Default::default());
+    *generic_keys = CString::new(generic_class_id_keys(&filter_set))
+        .unwrap_or_default()
+        .into_raw();
+    *metadata = Box::into_raw(Box::new(list_metadata));
+    Box::into_raw(Box::new(Engine::from_filter_set(filter_set, true)))
+}
+
+/// Returns the keys of the generic hide rules in `filter_set`, one per line. `engine_hidden_class_id_selectors` only returns rules for classes and ids among them.
+/// Rules that are only restricted by negated domains are included, since the engine applies them
+/// generically outside of those domains.
+fn generic_class_id_keys(filter_set: &adblock::lists::FilterSet) -> String {
+    let mut keys: Vec<&str> = filter_set
+        .cosmetic_filters
+        .iter()
+        .filter(|filter| {
+            filter.hostnames.is_none()
+                && filter.entities.is_none()
+                && !filter.mask.contains(CosmeticFilterMask::UNHIDE)
+        })
+        .filter_map(|filter| filter.key.as_deref())
+        .collect();
+    keys.sort_unstable();
+    keys.dedup();
+    keys.join("\n")
+}
+
 fn engine_create_from_str(rules: &str) -> (*mut FilterListMetadata, *mut Engine) {
     let mut filter_set = adblock::lists::FilterSet::new(false);
     let metadata = filter_set.add_filter_list(&rules, Default::default());
@@ -68,6 +68,33 @@ engineFromBufferWithMetadata(const char* data, size_t data_size) {
   return std::make_pair(std::move(metadata), std::move(engine));
 }
 
+std::pair<FilterListMetadata, std::unique_ptr<Engine>>
+engineFromBufferWithGenericKeys(const char* data,
+                                size_t data_size,
+                                std::vector<std::string>* generic_keys) {
+  C_FilterListMetadata* c_metadata;
+  char* c_generic_keys;
+  std::unique_ptr<Engine> engine =
+      std::make_unique<Engine>(engine_create_from_buffer_with_generic_keys(
+          data, data_size, &c_metadata, &c_generic_keys));
+  FilterListMetadata metadata = FilterListMetadata(c_metadata);
+  filter_list_metadata_destroy(c_metadata);
+
+  const std::string keys = std::string(c_generic_keys);
+  c_char_buffer_destroy(c_generic_keys);
+  generic_keys->clear();
+  size_t start = 0;
+  while (start < keys.size()) {
+    size_t end = keys.find('\n', start);
+    if (end == std::string::npos)
+      end = keys.size();
+    generic_keys->push_back(keys.substr(start, end - start));
+    start = end + 1;
+  }
+
+  return std::make_pair(std::move(metadata), std::move(engine));
+}
+
 Engine::Engine(C_Engine* c_engine) : raw(c_engine) {}
 
 Engine::Engine() : raw(engine_create("")) {}
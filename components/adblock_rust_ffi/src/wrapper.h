@@ -107,6 +107,13 @@ std::pair<FilterListMetadata, std::unique_ptr<Engine>> engineWithMetadata(
     const std::string& rules);
 std::pair<FilterListMetadata, std::unique_ptr<Engine>>
 engineFromBufferWithMetadata(const char* data, size_t data_size);
+// Like engineFromBufferWithMetadata(), and also fills |generic_keys| with the
+// class and id keys, e.g. ".ad" or "#banner", of the list's generic hide rules.
+// Engine::hiddenClassIdSelectors() only returns rules for those classes and ids.
+std::pair<FilterListMetadata, std::unique_ptr<Engine>>
+engineFromBufferWithGenericKeys(const char* data,
+                                size_t data_size,
+                                std::vector<std::string>* generic_keys);
 
 }  // namespace adblock
 
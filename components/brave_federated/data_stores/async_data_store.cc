@@ -37,11 +37,30 @@ void AsyncDataStore::AddTrainingInstance(
       .Then(std::move(callback));
 }
 
+void AsyncDataStore::AddTrainingInstances(
+    TrainingInstances training_instances,
+    base::OnceCallback<void(bool)> callback) {
+  data_store_.AsyncCall(&DataStore::AddTrainingInstances)
+      .WithArgs(std::move(training_instances))
+      .Then(std::move(callback));
+}
+
 void AsyncDataStore::LoadTrainingData(
     base::OnceCallback<void(TrainingData)> callback) {
   data_store_.AsyncCall(&DataStore::LoadTrainingData).Then(std::move(callback));
 }
 
+void AsyncDataStore::LoadTrainingMatrix(
+    std::vector<mojom::CovariateType> feature_types,
+    mojom::CovariateType label_type,
+    std::string positive_label_value,
+    base::OnceCallback<void(TrainingMatrix)> callback) {
+  data_store_.AsyncCall(&DataStore::LoadTrainingMatrix)
+      .WithArgs(std::move(feature_types), label_type,
+                std::move(positive_label_value))
+      .Then(std::move(callback));
+}
+
 void AsyncDataStore::PurgeTrainingDataAfterExpirationDate() {
   data_store_.AsyncCall(&DataStore::PurgeTrainingDataAfterExpirationDate);
 }
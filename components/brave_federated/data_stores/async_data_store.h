@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_FEDERATED_DATA_STORES_ASYNC_DATA_STORE_H_
 #define BRAVE_COMPONENTS_BRAVE_FEDERATED_DATA_STORES_ASYNC_DATA_STORE_H_
 
+#include <string>
 #include <vector>
 
 #include "base/callback.h"
@@ -31,7 +32,13 @@ class AsyncDataStore {
   void AddTrainingInstance(
       std::vector<brave_federated::mojom::CovariateInfoPtr> training_instance,
       base::OnceCallback<void(bool)> callback);
+  void AddTrainingInstances(TrainingInstances training_instances,
+                            base::OnceCallback<void(bool)> callback);
   void LoadTrainingData(base::OnceCallback<void(TrainingData)> callback);
+  void LoadTrainingMatrix(std::vector<mojom::CovariateType> feature_types,
+                          mojom::CovariateType label_type,
+                          std::string positive_label_value,
+                          base::OnceCallback<void(TrainingMatrix)> callback);
   void PurgeTrainingDataAfterExpirationDate();
 
  private:
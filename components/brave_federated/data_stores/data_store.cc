@@ -5,12 +5,14 @@
 
 #include "brave/components/brave_federated/data_stores/data_store.h"
 
+#include <limits>
 #include <utility>
 
 #include "base/bind.h"
 #include "base/check.h"
 #include "base/containers/flat_map.h"
 #include "base/numerics/safe_conversions.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "sql/recovery.h"
@@ -59,10 +61,32 @@ void BindCovariateToStatement(
   stmt->BindDouble(4, created_at.ToDoubleT());
 }
 
+float CovariateValueToFloat(brave_federated::mojom::DataType data_type,
+                            const std::string& value) {
+  if (data_type == brave_federated::mojom::DataType::kBool) {
+    if (value == "true")
+      return 1.0f;
+    if (value == "false")
+      return 0.0f;
+  }
+
+  double number;
+  if (data_type != brave_federated::mojom::DataType::kString &&
+      base::StringToDouble(value, &number)) {
+    return static_cast<float>(number);
+  }
+  return std::numeric_limits<float>::quiet_NaN();
+}
+
 }  // namespace
 
 namespace brave_federated {
 
+TrainingMatrix::TrainingMatrix() = default;
+TrainingMatrix::TrainingMatrix(TrainingMatrix&&) = default;
+TrainingMatrix& TrainingMatrix::operator=(TrainingMatrix&&) = default;
+TrainingMatrix::~TrainingMatrix() = default;
+
 DataStore::DataStore(const DataStoreTask data_store_task,
                      const base::FilePath& db_file_path)
     : database_(
@@ -113,19 +137,67 @@ void DataStore::SaveCovariate(
   statement.Run();
 }
 
+bool DataStore::InsertTrainingInstance(
+    const std::vector<brave_federated::mojom::CovariateInfoPtr>&
+        training_instance,
+    int training_instance_id,
+    base::Time created_at) {
+  // The table name is fixed for the lifetime of |database_|, so the statement
+  // can be cached by call site and prepared only once.
+  sql::Statement statement(database_.GetCachedStatement(
+      SQL_FROM_HERE, base::StringPrintf("INSERT INTO %s (training_instance_id, "
+                                        "feature_name, feature_type, "
+                                        "feature_value, created_at) "
+                                        "VALUES (?,?,?,?,?)",
+                                        data_store_task_.name.c_str())
+                         .c_str()));
+
+  for (const auto& covariate : training_instance) {
+    statement.Reset(/*clear_bound_vars=*/true);
+    BindCovariateToStatement(*covariate, training_instance_id, created_at,
+                             &statement);
+    if (!statement.Run())
+      return false;
+  }
+
+  return true;
+}
+
 bool DataStore::AddTrainingInstance(
     const std::vector<brave_federated::mojom::CovariateInfoPtr>
         training_instance) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  const int training_instance_id = GetNextTrainingInstanceId();
-  const base::Time created_at = base::Time::Now();
+  sql::Transaction transaction(&database_);
+  if (!transaction.Begin())
+    return false;
 
-  for (const auto& covariate : training_instance) {
-    SaveCovariate(*covariate, training_instance_id, created_at);
+  if (!InsertTrainingInstance(training_instance, GetNextTrainingInstanceId(),
+                              base::Time::Now())) {
+    return false;
   }
 
-  return true;
+  return transaction.Commit();
+}
+
+bool DataStore::AddTrainingInstances(
+    const TrainingInstances training_instances) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  sql::Transaction transaction(&database_);
+  if (!transaction.Begin())
+    return false;
+
+  int training_instance_id = GetNextTrainingInstanceId();
+  const base::Time created_at = base::Time::Now();
+  for (const auto& training_instance : training_instances) {
+    if (!InsertTrainingInstance(training_instance, training_instance_id++,
+                                created_at)) {
+      return false;
+    }
+  }
+
+  return transaction.Commit();
 }
 
 TrainingData DataStore::LoadTrainingData() {
@@ -152,6 +224,75 @@ TrainingData DataStore::LoadTrainingData() {
   return training_instances;
 }
 
+TrainingMatrix DataStore::LoadTrainingMatrix(
+    const std::vector<mojom::CovariateType>& feature_types,
+    mojom::CovariateType label_type,
+    const std::string& positive_label_value) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+
+  TrainingMatrix matrix;
+  matrix.feature_types = feature_types;
+  const size_t num_columns = feature_types.size();
+
+  // Column of each covariate type in a row, or -1 if it isn't a feature.
+  std::vector<int> columns(
+      static_cast<size_t>(mojom::CovariateType::kMaxValue) + 1, -1);
+  for (size_t i = 0; i < num_columns; ++i)
+    columns[static_cast<size_t>(feature_types[i])] = static_cast<int>(i);
+
+  // Covariates of a training instance are inserted together, so ordering by
+  // id keeps them next to each other.
+  sql::Statement statement(database_.GetUniqueStatement(
+      base::StringPrintf("SELECT training_instance_id, feature_name, "
+                         "feature_type, feature_value FROM %s ORDER BY id",
+                         data_store_task_.name.c_str())
+          .c_str()));
+
+  constexpr float kMissingValue = std::numeric_limits<float>::quiet_NaN();
+  // The row being filled in, and whether it has a label yet.
+  int current_training_instance_id = -1;
+  bool has_label = false;
+  size_t row_start = 0;
+  const auto finish_row = [&]() {
+    if (!has_label)
+      matrix.features.resize(row_start);
+  };
+
+  while (statement.Step()) {
+    const int training_instance_id = statement.ColumnInt(0);
+    if (training_instance_id != current_training_instance_id) {
+      finish_row();
+      current_training_instance_id = training_instance_id;
+      has_label = false;
+      row_start = matrix.features.size();
+      matrix.features.resize(row_start + num_columns, kMissingValue);
+    }
+
+    const int type = statement.ColumnInt(1);
+    if (type < 0 || static_cast<size_t>(type) >= columns.size())
+      continue;
+    if (static_cast<mojom::CovariateType>(type) == label_type) {
+      if (!has_label) {
+        matrix.labels.push_back(
+            statement.ColumnString(3) == positive_label_value ? 1.0f : 0.0f);
+        has_label = true;
+      }
+      continue;
+    }
+
+    const int column = columns[type];
+    if (column == -1)
+      continue;
+    matrix.features[row_start + column] = CovariateValueToFloat(
+        static_cast<mojom::DataType>(statement.ColumnInt(2)),
+        statement.ColumnString(3));
+  }
+  finish_row();
+
+  DCHECK_EQ(matrix.features.size(), matrix.num_rows() * num_columns);
+  return matrix;
+}
+
 bool DataStore::DeleteTrainingData() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
@@ -167,33 +308,61 @@ bool DataStore::DeleteTrainingData() {
 void DataStore::PurgeTrainingDataAfterExpirationDate() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
-  sql::Statement delete_statement(database_.GetUniqueStatement(
-      base::StringPrintf(" DELETE FROM %s WHERE created_at < ? OR id NOT IN "
-                         "(SELECT id FROM %s ORDER BY id DESC LIMIT ?)",
-                         data_store_task_.name.c_str(),
+  sql::Transaction transaction(&database_);
+  if (!transaction.Begin())
+    return;
+
+  // Both deletes are range scans: one over the created_at index, the other
+  // over the primary key, which grows with every record.
+  sql::Statement delete_expired_statement(database_.GetUniqueStatement(
+      base::StringPrintf("DELETE FROM %s WHERE created_at < ?",
                          data_store_task_.name.c_str())
           .c_str()));
   base::Time expiration_threshold =
       base::Time::Now() - data_store_task_.max_retention_days;
-  delete_statement.BindDouble(0, expiration_threshold.ToDoubleT());
-  delete_statement.BindInt(1, data_store_task_.max_number_of_records);
-  delete_statement.Run();
+  delete_expired_statement.BindDouble(0, expiration_threshold.ToDoubleT());
+
+  sql::Statement delete_oldest_statement(database_.GetUniqueStatement(
+      base::StringPrintf("DELETE FROM %s WHERE id <= (SELECT id FROM %s "
+                         "ORDER BY id DESC LIMIT 1 OFFSET ?)",
+                         data_store_task_.name.c_str(),
+                         data_store_task_.name.c_str())
+          .c_str()));
+  delete_oldest_statement.BindInt(0, data_store_task_.max_number_of_records);
+
+  if (delete_expired_statement.Run() && delete_oldest_statement.Run())
+    transaction.Commit();
 }
 
 bool DataStore::MaybeCreateTable() {
-  if (database_.DoesTableExist(data_store_task_.name)) {
-    return true;
+  const char* table_name = data_store_task_.name.c_str();
+  sql::Transaction transaction(&database_);
+  if (!transaction.Begin())
+    return false;
+
+  if (!database_.DoesTableExist(data_store_task_.name) &&
+      !database_.Execute(
+          base::StringPrintf(
+              "CREATE TABLE %s (id INTEGER PRIMARY KEY AUTOINCREMENT, "
+              "training_instance_id INTEGER NOT NULL, feature_name INTEGER "
+              "NOT NULL, feature_type INTEGER NOT NULL, "
+              "feature_value TEXT NOT NULL, created_at DOUBLE NOT NULL)",
+              table_name)
+              .c_str())) {
+    return false;
   }
 
-  sql::Transaction transaction(&database_);
-  return transaction.Begin() &&
+  // Tables created before these indexes were added get them here as well.
+  return database_.Execute(
+             base::StringPrintf("CREATE INDEX IF NOT EXISTS "
+                                "%s_training_instance_id_index ON %s "
+                                "(training_instance_id)",
+                                table_name, table_name)
+                 .c_str()) &&
          database_.Execute(
-             base::StringPrintf(
-                 "CREATE TABLE %s (id INTEGER PRIMARY KEY AUTOINCREMENT, "
-                 "training_instance_id INTEGER NOT NULL, feature_name INTEGER "
-                 "NOT NULL, feature_type INTEGER NOT NULL, "
-                 "feature_value TEXT NOT NULL, created_at DOUBLE NOT NULL)",
-                 data_store_task_.name.c_str())
+             base::StringPrintf("CREATE INDEX IF NOT EXISTS "
+                                "%s_created_at_index ON %s (created_at)",
+                                table_name, table_name)
                  .c_str()) &&
          transaction.Commit();
 }
@@ -18,6 +18,24 @@
 namespace brave_federated {
 
 using TrainingData = base::flat_map<int, std::vector<mojom::CovariateInfoPtr>>;
+using TrainingInstances = std::vector<std::vector<mojom::CovariateInfoPtr>>;
+
+// Training data laid out for a model: one row of |feature_types.size()|
+// feature values per training instance, plus its label. Feature values which
+// are missing or not numeric are NaN.
+struct TrainingMatrix {
+  TrainingMatrix();
+  TrainingMatrix(TrainingMatrix&&);
+  TrainingMatrix& operator=(TrainingMatrix&&);
+  ~TrainingMatrix();
+
+  size_t num_rows() const { return labels.size(); }
+
+  std::vector<mojom::CovariateType> feature_types;
+  // Row-major, |num_rows()| x |feature_types.size()|.
+  std::vector<float> features;
+  std::vector<float> labels;
+};
 
 struct DataStoreTask {
   int id = 0;
@@ -44,9 +62,18 @@ class DataStore {
   bool AddTrainingInstance(
       const std::vector<brave_federated::mojom::CovariateInfoPtr>
           training_instance);
+  // Adds all |training_instances| in a single transaction.
+  bool AddTrainingInstances(const TrainingInstances training_instances);
 
   bool DeleteTrainingData();
   TrainingData LoadTrainingData();
+  // Loads the covariates of |feature_types| as features. An instance's label
+  // is 1 if its |label_type| covariate has |positive_label_value|, 0 otherwise;
+  // instances without that covariate are left out.
+  TrainingMatrix LoadTrainingMatrix(
+      const std::vector<mojom::CovariateType>& feature_types,
+      mojom::CovariateType label_type,
+      const std::string& positive_label_value);
   void PurgeTrainingDataAfterExpirationDate();
 
  protected:
@@ -58,6 +85,11 @@ class DataStore {
 
  private:
   bool MaybeCreateTable();
+  bool InsertTrainingInstance(
+      const std::vector<brave_federated::mojom::CovariateInfoPtr>&
+          training_instance,
+      int training_instance_id,
+      base::Time created_at);
 
   SEQUENCE_CHECKER(sequence_checker_);
 };
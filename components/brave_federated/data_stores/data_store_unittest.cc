@@ -3,6 +3,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <cmath>
 #include <memory>
 #include <string>
 #include <utility>
@@ -10,6 +11,7 @@
 #include "base/check.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/time/time.h"
 #include "brave/components/brave_federated/data_stores/data_store.h"
 #include "content/public/test/browser_task_environment.h"
@@ -181,6 +183,81 @@ TEST_F(DataStoreTest, DeleteLogs) {
   EXPECT_EQ(0, RecordCount());
 }
 
+TEST_F(DataStoreTest, AddTrainingInstances) {
+  TrainingData training_data = TrainingDataFromTestInfo();
+  TrainingInstances training_instances;
+  for (auto& training_instance_pair : training_data)
+    training_instances.push_back(std::move(training_instance_pair.second));
+
+  EXPECT_TRUE(data_store_->AddTrainingInstances(std::move(training_instances)));
+  EXPECT_EQ(4, RecordCount());
+  EXPECT_EQ(2, TrainingInstanceCount());
+  EXPECT_EQ(3, data_store_->GetNextTrainingInstanceId());
+}
+
+TEST_F(DataStoreTest, LoadTrainingMatrix) {
+  TrainingInstances training_instances;
+  for (const char* label : {"clicked", "dismissed", "clicked"}) {
+    std::vector<mojom::CovariateInfoPtr> training_instance;
+    training_instance.push_back(mojom::CovariateInfo::New(
+        mojom::CovariateType::kNotificationAdEvent, mojom::DataType::kString,
+        label));
+    training_instance.push_back(mojom::CovariateInfo::New(
+        mojom::CovariateType::kAverageClickthroughRate,
+        mojom::DataType::kDouble, "0.5"));
+    training_instance.push_back(mojom::CovariateInfo::New(
+        mojom::CovariateType::kLastNotificationAdWasClicked,
+        mojom::DataType::kBool, "true"));
+    training_instances.push_back(std::move(training_instance));
+  }
+  // Instances without a label are left out.
+  std::vector<mojom::CovariateInfoPtr> unlabeled_instance;
+  unlabeled_instance.push_back(mojom::CovariateInfo::New(
+      mojom::CovariateType::kAverageClickthroughRate, mojom::DataType::kDouble,
+      "0.25"));
+  training_instances.push_back(std::move(unlabeled_instance));
+  ASSERT_TRUE(data_store_->AddTrainingInstances(std::move(training_instances)));
+
+  const TrainingMatrix matrix = data_store_->LoadTrainingMatrix(
+      {mojom::CovariateType::kAverageClickthroughRate,
+       mojom::CovariateType::kLastNotificationAdWasClicked,
+       mojom::CovariateType::kNumberOfClickedLinkEvents},
+      mojom::CovariateType::kNotificationAdEvent, "clicked");
+
+  ASSERT_EQ(3u, matrix.num_rows());
+  ASSERT_EQ(9u, matrix.features.size());
+  EXPECT_EQ(std::vector<float>({1.0f, 0.0f, 1.0f}), matrix.labels);
+  for (size_t row = 0; row < matrix.num_rows(); ++row) {
+    EXPECT_EQ(0.5f, matrix.features[row * 3]);
+    EXPECT_EQ(1.0f, matrix.features[row * 3 + 1]);
+    // Missing covariates are NaN.
+    EXPECT_TRUE(std::isnan(matrix.features[row * 3 + 2]));
+  }
+}
+
+TEST_F(DataStoreTest, PurgeTrainingDataOverMaxNumberOfRecords) {
+  TrainingInstances training_instances;
+  for (int i = 0; i < 30; ++i) {
+    std::vector<mojom::CovariateInfoPtr> training_instance;
+    training_instance.push_back(mojom::CovariateInfo::New(
+        mojom::CovariateType::kNumberOfClickedLinkEvents, mojom::DataType::kInt,
+        base::NumberToString(i)));
+    training_instance.push_back(mojom::CovariateInfo::New(
+        mojom::CovariateType::kNumberOfClosedTabEvents, mojom::DataType::kInt,
+        base::NumberToString(i)));
+    training_instances.push_back(std::move(training_instance));
+  }
+  ASSERT_TRUE(data_store_->AddTrainingInstances(std::move(training_instances)));
+  EXPECT_EQ(60, RecordCount());
+
+  data_store_->PurgeTrainingDataAfterExpirationDate();
+
+  // The newest records are kept.
+  EXPECT_EQ(50, RecordCount());
+  EXPECT_EQ(25, TrainingInstanceCount());
+  EXPECT_EQ(31, data_store_->GetNextTrainingInstanceId());
+}
+
 TEST_F(DataStoreTest, PurgeTrainingDataAfterExpirationDate) {
   InitializeDataStore();
   EXPECT_EQ(4, RecordCount());
@@ -5,6 +5,7 @@
 
 #include "brave/components/brave_shields/browser/ad_block_engine.h"
 
+#include <atomic>
 #include <set>
 #include <string>
 #include <utility>
@@ -28,6 +29,10 @@ using namespace net::registry_controlled_domains;  // NOLINT
 
 namespace {
 
+// Engines are created on the UI thread but otherwise used on the adblock task
+// runner.
+std::atomic<uint64_t> g_generation{0};
+
 std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   std::string filter_option = "";
   switch (resource_type) {
@@ -100,7 +105,9 @@ namespace brave_shields {
 
 AdBlockEngine::AdBlockEngine() : ad_block_client_(new adblock::Engine()) {}
 
-AdBlockEngine::~AdBlockEngine() = default;
+AdBlockEngine::~AdBlockEngine() {
+  BumpGeneration();
+}
 
 void AdBlockEngine::ShouldStartRequest(const GURL& url,
                                        blink::mojom::ResourceType resource_type,
@@ -160,10 +167,12 @@ void AdBlockEngine::EnableTag(const std::string& tag, bool enabled) {
     ad_block_client_->removeTag(tag);
     tags_.erase(tag);
   }
+  BumpGeneration();
 }
 
 void AdBlockEngine::AddResources(const std::string& resources) {
   ad_block_client_->addResources(resources);
+  BumpGeneration();
 }
 
 bool AdBlockEngine::TagExists(const std::string& tag) {
@@ -208,6 +217,7 @@ void AdBlockEngine::UpdateAdBlockClient(
   ad_block_client_ = std::move(ad_block_client);
   AddResources(resources_json);
   AddKnownTagsToAdBlockInstance();
+  BumpGeneration();
   if (test_observer_) {
     test_observer_->OnEngineUpdated();
   }
@@ -221,8 +231,11 @@ void AdBlockEngine::AddKnownTagsToAdBlockInstance() {
 adblock::FilterListMetadata AdBlockEngine::OnListSourceLoaded(
     const DATFileDataBuffer& filters,
     const std::string& resources_json) {
-  auto metadata_and_engine = adblock::engineFromBufferWithMetadata(
-      reinterpret_cast<const char*>(filters.data()), filters.size());
+  std::vector<std::string> generic_class_id_keys;
+  auto metadata_and_engine = adblock::engineFromBufferWithGenericKeys(
+      reinterpret_cast<const char*>(filters.data()), filters.size(),
+      &generic_class_id_keys);
+  generic_class_id_keys_ = std::move(generic_class_id_keys);
   UpdateAdBlockClient(std::move(metadata_and_engine.second), resources_json);
   return std::move(metadata_and_engine.first);
 }
@@ -237,6 +250,7 @@ void AdBlockEngine::OnDATLoaded(const DATFileDataBuffer& dat_buf,
   auto client = std::make_unique<adblock::Engine>();
   client->deserialize(reinterpret_cast<const char*>(&dat_buf.front()),
                       dat_buf.size());
+  generic_class_id_keys_ = absl::nullopt;
 
   UpdateAdBlockClient(std::move(client), resources_json);
 }
@@ -249,4 +263,14 @@ void AdBlockEngine::RemoveObserverForTest() {
   test_observer_ = nullptr;
 }
 
+// static
+uint64_t AdBlockEngine::GetGeneration() {
+  return g_generation.load(std::memory_order_relaxed);
+}
+
+// static
+void AdBlockEngine::BumpGeneration() {
+  g_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
 }  // namespace brave_shields
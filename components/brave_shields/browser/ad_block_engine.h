@@ -68,6 +68,13 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // The keys, e.g. ".ad" or "#banner", of the engine's generic hide rules;
+  // HiddenClassIdSelectors() finds nothing for other classes and ids. Not known
+  // for engines deserialized from a DAT file.
+  const absl::optional<std::vector<std::string>>& generic_class_id_keys()
+      const {
+    return generic_class_id_keys_;
+  }
 
   absl::optional<adblock::FilterListMetadata> Load(
       bool deserialize,
@@ -82,6 +89,13 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   void AddObserverForTest(TestObserver* observer);
   void RemoveObserverForTest();
 
+  // Changes whenever the rules of any engine change or an engine goes away, so
+  // that results computed from the engines can be cached until then.
+  static uint64_t GetGeneration();
+  // Also used when the set of engines in use changes without any engine
+  // changing, e.g. when a filter list subscription is turned off.
+  static void BumpGeneration();
+
  protected:
   void AddKnownTagsToAdBlockInstance();
   void UpdateAdBlockClient(std::unique_ptr<adblock::Engine> ad_block_client,
@@ -102,6 +116,9 @@ class AdBlockEngine : public base::SupportsWeakPtr<AdBlockEngine> {
   friend class ::PerfPredictorTabHelperTest;
 
   std::set<std::string> tags_;
+  // The empty engine every AdBlockEngine starts with has no rules.
+  absl::optional<std::vector<std::string>> generic_class_id_keys_{
+      absl::in_place};
 
   raw_ptr<TestObserver> test_observer_ = nullptr;
 };
@@ -339,6 +339,18 @@ base::Value::List AdBlockRegionalServiceManager::HiddenClassIdSelectors(
   return first_value;
 }
 
+bool AdBlockRegionalServiceManager::AppendGenericClassIdKeys(
+    std::vector<std::string>* keys) {
+  base::AutoLock lock(regional_services_lock_);
+  for (const auto& regional_service : regional_services_) {
+    const auto& service_keys = regional_service.second->generic_class_id_keys();
+    if (!service_keys)
+      return false;
+    keys->insert(keys->end(), service_keys->begin(), service_keys->end());
+  }
+  return true;
+}
+
 void AdBlockRegionalServiceManager::SetFilterListCatalog(
     std::vector<FilterListCatalogEntry> catalog) {
   filter_list_catalog_ = std::move(catalog);
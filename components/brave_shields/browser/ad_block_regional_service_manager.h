@@ -79,6 +79,9 @@ class AdBlockRegionalServiceManager
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Appends the generic_class_id_keys() of every engine in use to |keys|.
+  // Returns false if they aren't known for one of them.
+  bool AppendGenericClassIdKeys(std::vector<std::string>* keys);
 
   void Init(AdBlockResourceProvider* resource_provider,
             AdBlockFilterListCatalogProvider* catalog_provider);
@@ -26,6 +26,7 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service_manager.h"
+#include "brave/components/brave_shields/browser/generic_class_id_filter.h"
 #include "brave/components/brave_shields/common/adblock_domain_resolver.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/brave_shields/common/features.h"
@@ -50,6 +51,16 @@ const char kAdBlockComponentBase64PublicKey[] =
     "q+SDNXROG554RnU4BnDJaNETTkDTZ0Pn+rmLmp1qY5Si0yGsfHkrv3FS3vdxVozO"
     "PQIDAQAB";
 
+// Enough for the frames of a few pages loading at the same time.
+constexpr size_t kCosmeticResourcesCacheSize = 32;
+
+absl::optional<base::Value> CloneResources(
+    const absl::optional<base::Value>& resources) {
+  if (!resources)
+    return absl::nullopt;
+  return resources->Clone();
+}
+
 std::string g_ad_block_component_id_(kAdBlockComponentId);
 std::string g_ad_block_component_base64_public_key_(
     kAdBlockComponentBase64PublicKey);
@@ -190,6 +201,23 @@ absl::optional<std::string> AdBlockService::GetCspDirectives(
 absl::optional<base::Value> AdBlockService::UrlCosmeticResources(
     const std::string& url) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  const uint64_t generation = AdBlockEngine::GetGeneration();
+  if (generation != cosmetic_resources_generation_) {
+    cosmetic_resources_cache_.Clear();
+    cosmetic_resources_generation_ = generation;
+  }
+
+  auto it = cosmetic_resources_cache_.Get(url);
+  if (it != cosmetic_resources_cache_.end())
+    return CloneResources(it->second);
+
+  absl::optional<base::Value> resources = ComputeUrlCosmeticResources(url);
+  cosmetic_resources_cache_.Put(url, CloneResources(resources));
+  return resources;
+}
+
+absl::optional<base::Value> AdBlockService::ComputeUrlCosmeticResources(
+    const std::string& url) {
   absl::optional<base::Value> resources =
       default_service()->UrlCosmeticResources(url);
 
@@ -271,6 +299,30 @@ base::Value::Dict AdBlockService::HiddenClassIdSelectors(
   return result;
 }
 
+const absl::optional<std::vector<uint8_t>>&
+AdBlockService::GetGenericClassIdFilter() {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  const uint64_t generation = AdBlockEngine::GetGeneration();
+  if (generic_class_id_filter_generation_ == generation)
+    return generic_class_id_filter_;
+  generic_class_id_filter_generation_ = generation;
+
+  std::vector<std::string> keys;
+  const auto& default_keys = default_service()->generic_class_id_keys();
+  const auto& custom_keys = custom_filters_service()->generic_class_id_keys();
+  if (!default_keys || !custom_keys ||
+      !regional_service_manager()->AppendGenericClassIdKeys(&keys) ||
+      !subscription_service_manager()->AppendGenericClassIdKeys(&keys)) {
+    generic_class_id_filter_ = absl::nullopt;
+    return generic_class_id_filter_;
+  }
+  keys.insert(keys.end(), default_keys->begin(), default_keys->end());
+  keys.insert(keys.end(), custom_keys->begin(), custom_keys->end());
+
+  generic_class_id_filter_ = BuildGenericClassIdFilter(keys);
+  return generic_class_id_filter_;
+}
+
 AdBlockRegionalServiceManager* AdBlockService::regional_service_manager() {
   if (!regional_service_manager_) {
     regional_service_manager_ =
@@ -332,7 +384,8 @@ AdBlockService::AdBlockService(
       task_runner_(task_runner),
       custom_filters_service_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
       default_service_(nullptr, base::OnTaskRunnerDeleter(task_runner_)),
-      subscription_service_manager_(std::move(subscription_service_manager)) {
+      subscription_service_manager_(std::move(subscription_service_manager)),
+      cosmetic_resources_cache_(kCosmeticResourcesCacheSize) {
   // Initializes adblock-rust's domain resolution implementation
   adblock::SetDomainResolver(AdBlockServiceDomainResolver);
 
@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/lru_cache.h"
 #include "base/memory/raw_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
@@ -114,11 +115,18 @@ class AdBlockService {
       const GURL& url,
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
+  // Results are cached per URL until the rules of any engine change, so that
+  // frames of the same site, and a navigation whose resources were prefetched,
+  // don't run the engines again.
   absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
   base::Value::Dict HiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Returns the generic class and id filter (see generic_class_id_filter.h) of
+  // all engines in use, or absl::nullopt if the keys of some engine aren't
+  // known. Rebuilt once AdBlockEngine::GetGeneration() changes.
+  const absl::optional<std::vector<uint8_t>>& GetGenericClassIdFilter();
 
   AdBlockRegionalServiceManager* regional_service_manager();
   AdBlockEngine* custom_filters_service();
@@ -144,6 +152,9 @@ class AdBlockService {
 
   AdBlockResourceProvider* resource_provider();
 
+  absl::optional<base::Value> ComputeUrlCosmeticResources(
+      const std::string& url);
+
   void UseSourceProvidersForTest(AdBlockFiltersProvider* source_provider,
                                  AdBlockResourceProvider* resource_provider);
   void UseCustomSourceProvidersForTest(
@@ -179,6 +190,17 @@ class AdBlockService {
   std::unique_ptr<SourceProviderObserver> default_service_observer_;
   std::unique_ptr<SourceProviderObserver> custom_filters_service_observer_;
 
+  // Recent UrlCosmeticResources() results, valid while
+  // AdBlockEngine::GetGeneration() stays at |cosmetic_resources_generation_|.
+  // Only used on |task_runner_|.
+  base::LRUCache<std::string, absl::optional<base::Value>>
+      cosmetic_resources_cache_;
+  uint64_t cosmetic_resources_generation_ = 0;
+
+  // Only used on |task_runner_|.
+  absl::optional<std::vector<uint8_t>> generic_class_id_filter_;
+  absl::optional<uint64_t> generic_class_id_filter_generation_;
+
   SEQUENCE_CHECKER(sequence_checker_);
 
   base::WeakPtrFactory<AdBlockService> weak_factory_{this};
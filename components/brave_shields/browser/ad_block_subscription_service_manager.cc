@@ -292,6 +292,8 @@ void AdBlockSubscriptionServiceManager::EnableSubscription(const GURL& sub_url,
   info->enabled = enabled;
 
   UpdateSubscriptionPrefs(sub_url, *info);
+  // Cached cosmetic resources may include the list's rules, or lack them.
+  AdBlockEngine::BumpGeneration();
 }
 
 void AdBlockSubscriptionServiceManager::DeleteSubscription(
@@ -310,6 +312,8 @@ void AdBlockSubscriptionServiceManager::DeleteSubscription(
     subscription_filters_providers_.erase(it2);
   }
   ClearSubscriptionPrefs(sub_url);
+  // The engine itself is destroyed later on the adblock task runner.
+  AdBlockEngine::BumpGeneration();
 
   base::ThreadPool::PostTask(
       FROM_HERE,
@@ -596,6 +600,22 @@ base::Value::List AdBlockSubscriptionServiceManager::HiddenClassIdSelectors(
   return first_value;
 }
 
+bool AdBlockSubscriptionServiceManager::AppendGenericClassIdKeys(
+    std::vector<std::string>* keys) {
+  base::AutoLock lock(subscription_services_lock_);
+  for (const auto& subscription_service : subscription_services_) {
+    auto info = GetInfo(subscriptions_, subscription_service.first);
+    if (!info || !info->enabled)
+      continue;
+    const auto& service_keys =
+        subscription_service.second->generic_class_id_keys();
+    if (!service_keys)
+      return false;
+    keys->insert(keys->end(), service_keys->begin(), service_keys->end());
+  }
+  return true;
+}
+
 void AdBlockSubscriptionServiceManager::OnSubscriptionDownloaded(
     const GURL& sub_url) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
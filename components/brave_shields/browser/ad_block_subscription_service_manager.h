@@ -112,6 +112,9 @@ class AdBlockSubscriptionServiceManager {
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Appends the generic_class_id_keys() of every engine in use to |keys|.
+  // Returns false if they aren't known for one of them.
+  bool AppendGenericClassIdKeys(std::vector<std::string>* keys);
 
   AdBlockSubscriptionDownloadManager* download_manager() {
     return download_manager_.get();
@@ -0,0 +1,75 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/generic_class_id_filter.h"
+
+#include <algorithm>
+
+#include "base/strings/utf_string_conversions.h"
+
+namespace brave_shields {
+
+namespace {
+
+// About 1% false positives with kHashCount hashes.
+constexpr size_t kBitsPerKey = 10;
+constexpr uint8_t kHashCount = 7;
+constexpr size_t kMinBits = 64;
+
+struct KeyHashes {
+  uint32_t h1;
+  uint32_t h2;
+};
+
+KeyHashes HashKey(base::StringPiece key) {
+  uint32_t h1 = 0x811c9dc5u;
+  for (char16_t unit : base::UTF8ToUTF16(key)) {
+    h1 ^= unit;
+    h1 *= 0x01000193u;
+  }
+
+  uint32_t h2 = h1;
+  h2 ^= h2 >> 16;
+  h2 *= 0x85ebca6bu;
+  h2 ^= h2 >> 13;
+  h2 *= 0xc2b2ae35u;
+  h2 ^= h2 >> 16;
+  return {h1, h2 | 1};
+}
+
+}  // namespace
+
+std::vector<uint8_t> BuildGenericClassIdFilter(
+    const std::vector<std::string>& keys) {
+  const size_t bits =
+      (std::max(keys.size() * kBitsPerKey, kMinBits) + 7) & ~size_t{7};
+  std::vector<uint8_t> filter(1 + bits / 8);
+  filter[0] = kHashCount;
+  for (const std::string& key : keys) {
+    const KeyHashes hashes = HashKey(key);
+    for (uint32_t i = 0; i < kHashCount; ++i) {
+      const uint32_t bit = (hashes.h1 + i * hashes.h2) % bits;
+      filter[1 + bit / 8] |= 1 << (bit % 8);
+    }
+  }
+  return filter;
+}
+
+bool GenericClassIdFilterMayContain(const std::vector<uint8_t>& filter,
+                                    base::StringPiece key) {
+  if (filter.size() < 2)
+    return true;
+
+  const size_t bits = (filter.size() - 1) * 8;
+  const KeyHashes hashes = HashKey(key);
+  for (uint32_t i = 0; i < filter[0]; ++i) {
+    const uint32_t bit = (hashes.h1 + i * hashes.h2) % bits;
+    if (!(filter[1 + bit / 8] & (1 << (bit % 8))))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,35 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_GENERIC_CLASS_ID_FILTER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_GENERIC_CLASS_ID_FILTER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+
+namespace brave_shields {
+
+// A Bloom filter of the keys, e.g. ".ad" or "#banner", of generic hide rules.
+// Renderers only ask for the rules of classes and ids the filter may contain,
+// so the ones no rule mentions never leave the renderer.
+//
+// The first byte holds the number of hash functions and the rest is the bit
+// array, least significant bit first. A key is hashed as UTF-16 code units with
+// 32-bit FNV-1a (h1) and the murmur3 finalizer of h1, made odd (h2); the i-th
+// bit is (h1 + i * h2) mod 2^32 mod the number of bits. content_cosmetic.ts
+// checks keys against the filter the same way, so this must stay in sync.
+std::vector<uint8_t> BuildGenericClassIdFilter(
+    const std::vector<std::string>& keys);
+
+bool GenericClassIdFilterMayContain(const std::vector<uint8_t>& filter,
+                                    base::StringPiece key);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_GENERIC_CLASS_ID_FILTER_H_
@@ -0,0 +1,55 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/generic_class_id_filter.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(GenericClassIdFilterTest, ContainsEveryKey) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 5000; ++i) {
+    keys.push_back(".ad-" + base::NumberToString(i));
+    keys.push_back("#banner-" + base::NumberToString(i));
+  }
+  keys.push_back(".r\xC3\xA9klam");
+  const std::vector<uint8_t> filter = BuildGenericClassIdFilter(keys);
+
+  for (const std::string& key : keys)
+    EXPECT_TRUE(GenericClassIdFilterMayContain(filter, key)) << key;
+}
+
+TEST(GenericClassIdFilterTest, RejectsMostOtherKeys) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 5000; ++i)
+    keys.push_back(".ad-" + base::NumberToString(i));
+  const std::vector<uint8_t> filter = BuildGenericClassIdFilter(keys);
+
+  int false_positives = 0;
+  for (int i = 0; i < 10000; ++i) {
+    if (GenericClassIdFilterMayContain(filter,
+                                       ".content-" + base::NumberToString(i)))
+      ++false_positives;
+  }
+  // About 1% is expected.
+  EXPECT_LT(false_positives, 300);
+
+  // Classes and ids are told apart by their prefix.
+  EXPECT_FALSE(GenericClassIdFilterMayContain(
+      BuildGenericClassIdFilter({".ad"}), "#ad"));
+}
+
+TEST(GenericClassIdFilterTest, EmptyFilter) {
+  const std::vector<uint8_t> filter = BuildGenericClassIdFilter({});
+  EXPECT_FALSE(GenericClassIdFilterMayContain(filter, ".ad"));
+  EXPECT_FALSE(GenericClassIdFilterMayContain(filter, "#ad"));
+}
+
+}  // namespace brave_shields
@@ -66,6 +66,11 @@ const base::Feature kBraveDarkModeBlock{"BraveDarkModeBlock",
 // load the cosmetic filter rules using sync ipc
 const base::Feature kCosmeticFilteringSyncLoad{
     "CosmeticFilterSyncLoad", base::FEATURE_ENABLED_BY_DEFAULT};
+// When enabled, the browser computes the cosmetic filter rules for a frame
+// while its navigation is in flight and hands them to the renderer along with
+// the commit, so the frame doesn't have to ask for them.
+const base::Feature kCosmeticFilteringPrefetch{
+    "CosmeticFilteringPrefetch", base::FEATURE_ENABLED_BY_DEFAULT};
 
 // Enables extra TRACE_EVENTs in content filter js. The feature is
 // primary designed for local debugging.
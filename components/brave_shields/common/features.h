@@ -27,6 +27,7 @@ extern const base::Feature kBraveExtensionNetworkBlocking;
 extern const base::Feature kBraveReduceLanguage;
 extern const base::Feature kBraveDarkModeBlock;
 extern const base::Feature kCosmeticFilteringSyncLoad;
+extern const base::Feature kCosmeticFilteringPrefetch;
 extern const base::Feature kCosmeticFilteringExtraPerfMetrics;
 extern const base::Feature kCosmeticFilteringJsPerformance;
 extern const base::FeatureParam<std::string>
@@ -16,6 +16,7 @@
 #include "base/callback_forward.h"
 #include "base/callback_helpers.h"
 #include "base/containers/flat_set.h"
+#include "base/files/file_path.h"
 #include "base/guid.h"
 #include "base/time/time.h"
 #include "base/values.h"
@@ -44,6 +45,13 @@
 
 namespace brave_news {
 
+namespace {
+
+const base::FilePath::CharType kCombinedFeedFileName[] =
+    FILE_PATH_LITERAL("Brave News Feed");
+
+}  // namespace
+
 bool IsPublisherEnabled(const mojom::Publisher* publisher) {
   if (!publisher)
     return false;
@@ -78,7 +86,8 @@ BraveNewsController::BraveNewsController(
     PrefService* prefs,
     brave_ads::AdsService* ads_service,
     history::HistoryService* history_service,
-    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory)
+    scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory,
+    const base::FilePath& profile_path)
     : prefs_(prefs),
       ads_service_(ads_service),
       api_request_helper_(GetNetworkTrafficAnnotationTag(), url_loader_factory),
@@ -96,7 +105,8 @@ BraveNewsController::BraveNewsController(
                        &direct_feed_controller_,
                        history_service,
                        &api_request_helper_,
-                       prefs_),
+                       prefs_,
+                       profile_path.Append(kCombinedFeedFileName)),
       channels_controller_(prefs_, &publishers_controller_),
       weak_ptr_factory_(this) {
   DCHECK(prefs_);
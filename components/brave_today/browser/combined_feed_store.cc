@@ -0,0 +1,82 @@
+// Copyright (c) 2022 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "brave/components/brave_today/browser/combined_feed_store.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/task/thread_pool.h"
+
+namespace brave_news {
+
+namespace {
+
+// The file holds the etag on its first line, followed by the feed body.
+// Header values can't contain line breaks, so the etag never does either.
+constexpr char kEtagSeparator = '\n';
+
+absl::optional<StoredCombinedFeed> LoadFromFile(const base::FilePath& path) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    return absl::nullopt;
+  }
+  auto separator = contents.find(kEtagSeparator);
+  if (separator == std::string::npos || separator == 0 ||
+      separator + 1 == contents.size()) {
+    VLOG(1) << "Ignoring malformed stored feed " << path;
+    return absl::nullopt;
+  }
+  StoredCombinedFeed feed;
+  feed.etag = contents.substr(0, separator);
+  feed.body = contents.substr(separator + 1);
+  return feed;
+}
+
+void SaveToFile(const base::FilePath& path, StoredCombinedFeed feed) {
+  if (feed.etag.empty() || feed.body.empty() ||
+      feed.etag.find(kEtagSeparator) != std::string::npos) {
+    base::DeleteFile(path);
+    return;
+  }
+  // Written atomically, so that a crash can't leave a truncated feed behind
+  // for the server to confirm.
+  if (!base::CreateDirectory(path.DirName()) ||
+      !base::ImportantFileWriter::WriteFileAtomically(
+          path, feed.etag + kEtagSeparator + feed.body)) {
+    VLOG(1) << "Could not store feed to " << path;
+  }
+}
+
+}  // namespace
+
+CombinedFeedStore::CombinedFeedStore(const base::FilePath& path)
+    : path_(path),
+      task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+
+CombinedFeedStore::~CombinedFeedStore() = default;
+
+void CombinedFeedStore::Load(LoadCombinedFeedCallback callback) {
+  task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&LoadFromFile, path_), std::move(callback));
+}
+
+void CombinedFeedStore::Save(StoredCombinedFeed feed) {
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&SaveToFile, path_, std::move(feed)));
+}
+
+void CombinedFeedStore::Clear() {
+  task_runner_->PostTask(
+      FROM_HERE, base::BindOnce(base::IgnoreResult(&base::DeleteFile), path_));
+}
+
+}  // namespace brave_news
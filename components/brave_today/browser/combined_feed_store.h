@@ -0,0 +1,56 @@
+// Copyright (c) 2022 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef BRAVE_COMPONENTS_BRAVE_TODAY_BROWSER_COMBINED_FEED_STORE_H_
+#define BRAVE_COMPONENTS_BRAVE_TODAY_BROWSER_COMBINED_FEED_STORE_H_
+
+#include <string>
+
+#include "base/callback_forward.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace brave_news {
+
+// The last combined feed downloaded from the Brave News servers, along with
+// the etag it came with.
+struct StoredCombinedFeed {
+  std::string etag;
+  std::string body;
+};
+
+using LoadCombinedFeedCallback =
+    base::OnceCallback<void(absl::optional<StoredCombinedFeed>)>;
+
+// Keeps the last combined feed on disk, so that after a restart the feed can
+// be served right away and then revalidated with a conditional request.
+// All file access happens on a background sequence, in the order the calls
+// were made.
+class CombinedFeedStore {
+ public:
+  explicit CombinedFeedStore(const base::FilePath& path);
+  ~CombinedFeedStore();
+  CombinedFeedStore(const CombinedFeedStore&) = delete;
+  CombinedFeedStore& operator=(const CombinedFeedStore&) = delete;
+
+  // Runs |callback| with the stored feed, or absl::nullopt if nothing usable
+  // is stored.
+  void Load(LoadCombinedFeedCallback callback);
+  void Save(StoredCombinedFeed feed);
+  void Clear();
+
+ private:
+  const base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+};
+
+}  // namespace brave_news
+
+#endif  // BRAVE_COMPONENTS_BRAVE_TODAY_BROWSER_COMBINED_FEED_STORE_H_
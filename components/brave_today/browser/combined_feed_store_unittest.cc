@@ -0,0 +1,84 @@
+// Copyright (c) 2022 The Brave Authors. All rights reserved.
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "brave/components/brave_today/browser/combined_feed_store.h"
+
+#include <string>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/task_environment.h"
+#include "base/test/test_future.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_news {
+
+class BraveNewsCombinedFeedStoreTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.GetPath().AppendASCII("Brave News Feed");
+  }
+
+ protected:
+  absl::optional<StoredCombinedFeed> Load(CombinedFeedStore& store) {
+    base::test::TestFuture<absl::optional<StoredCombinedFeed>> future;
+    store.Load(future.GetCallback());
+    return future.Take();
+  }
+
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+};
+
+TEST_F(BraveNewsCombinedFeedStoreTest, NothingStored) {
+  CombinedFeedStore store(path_);
+  EXPECT_FALSE(Load(store));
+}
+
+TEST_F(BraveNewsCombinedFeedStoreTest, LoadsSavedFeed) {
+  {
+    CombinedFeedStore store(path_);
+    store.Save({"\"etag-1\"", "[{\"title\": \"one\"}]"});
+    task_environment_.RunUntilIdle();
+  }
+
+  // A new store, as after a restart, sees the feed saved before.
+  CombinedFeedStore store(path_);
+  auto feed = Load(store);
+  ASSERT_TRUE(feed);
+  EXPECT_EQ(feed->etag, "\"etag-1\"");
+  EXPECT_EQ(feed->body, "[{\"title\": \"one\"}]");
+
+  store.Save({"\"etag-2\"", "[]"});
+  feed = Load(store);
+  ASSERT_TRUE(feed);
+  EXPECT_EQ(feed->etag, "\"etag-2\"");
+  EXPECT_EQ(feed->body, "[]");
+}
+
+TEST_F(BraveNewsCombinedFeedStoreTest, Clear) {
+  CombinedFeedStore store(path_);
+  store.Save({"\"etag\"", "[]"});
+  store.Clear();
+  EXPECT_FALSE(Load(store));
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+TEST_F(BraveNewsCombinedFeedStoreTest, FeedWithoutEtagIsNotStored) {
+  CombinedFeedStore store(path_);
+  store.Save({"\"etag\"", "[]"});
+  store.Save({"", "[]"});
+  EXPECT_FALSE(Load(store));
+}
+
+TEST_F(BraveNewsCombinedFeedStoreTest, IgnoresMalformedFile) {
+  ASSERT_TRUE(base::WriteFile(path_, "no separator"));
+  CombinedFeedStore store(path_);
+  EXPECT_FALSE(Load(store));
+}
+
+}  // namespace brave_news
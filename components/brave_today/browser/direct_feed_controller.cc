@@ -36,6 +36,8 @@
 #include "components/prefs/scoped_user_pref_update.h"
 #include "net/base/load_flags.h"
 #include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
 #include "services/network/public/cpp/resource_request.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "services/network/public/cpp/simple_url_loader.h"
@@ -338,6 +340,13 @@ void DirectFeedController::DownloadAllContent(
   auto feed_content_handler = base::BarrierCallback<Articles>(
       publishers.size(), std::move(all_done_handler));
   base::flat_set<GURL> direct_feed_urls;
+  for (auto& publisher : publishers) {
+    direct_feed_urls.insert(publisher->feed_source);
+  }
+  // Forget feeds which are no longer subscribed to.
+  base::EraseIf(cached_feeds_, [&direct_feed_urls](const auto& cached_feed) {
+    return !direct_feed_urls.contains(cached_feed.first);
+  });
   for (auto& publisher : publishers) {
     VLOG(1) << "Downloading feed content from "
             << publisher->feed_source.spec();
@@ -399,6 +408,17 @@ void DirectFeedController::DownloadFeed(const GURL& feed_url,
   request->load_flags = net::LOAD_DO_NOT_SAVE_COOKIES;
   request->credentials_mode = network::mojom::CredentialsMode::kOmit;
   request->method = net::HttpRequestHeaders::kGetMethod;
+  auto cached_feed = cached_feeds_.find(feed_url);
+  if (cached_feed != cached_feeds_.end()) {
+    if (!cached_feed->second.etag.empty()) {
+      request->headers.SetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                 cached_feed->second.etag);
+    }
+    if (!cached_feed->second.last_modified.empty()) {
+      request->headers.SetHeader(net::HttpRequestHeaders::kIfModifiedSince,
+                                 cached_feed->second.last_modified);
+    }
+  }
   auto url_loader = network::SimpleURLLoader::Create(
       std::move(request), GetNetworkTrafficAnnotationTag());
   url_loader->SetRetryOptions(
@@ -422,19 +442,32 @@ void DirectFeedController::OnResponse(
   // Parse response data
   auto* loader = iter->get();
   auto response_code = -1;
-  base::flat_map<std::string, std::string> headers;
+  CachedFeed validators;
   if (loader->ResponseInfo()) {
     auto headers_list = loader->ResponseInfo()->headers;
     if (headers_list) {
       response_code = headers_list->response_code();
+      headers_list->GetNormalizedHeader("etag", &validators.etag);
+      headers_list->GetNormalizedHeader("last-modified",
+                                        &validators.last_modified);
     }
   }
   url_loaders_.erase(iter);
+  auto result = std::make_unique<DirectFeedResponse>(DirectFeedResponse());
+  result->url = feed_url;
+  // The feed hasn't changed since it was last parsed.
+  auto cached_feed = cached_feeds_.find(feed_url);
+  if (response_code == net::HTTP_NOT_MODIFIED &&
+      cached_feed != cached_feeds_.end()) {
+    VLOG(1) << feed_url.spec() << " not modified";
+    result->success = true;
+    result->data = cached_feed->second.data;
+    std::move(callback).Run(std::move(result));
+    return;
+  }
   // Validate if we get a feed
   std::string body_content = response_body ? *response_body : "";
   // TODO(petemill): handle any url redirects and change the stored feed url?
-  auto result = std::make_unique<DirectFeedResponse>(DirectFeedResponse());
-  result->url = feed_url;
   if (response_code < 200 || response_code >= 300 || body_content.empty()) {
     VLOG(1) << feed_url.spec()
             << " invalid response, status: " << response_code;
@@ -443,18 +476,26 @@ void DirectFeedController::OnResponse(
   }
 
   // Response is valid, but still might not be a feed
-  ParseFeedDataOffMainThread(feed_url, std::move(body_content),
-                             base::BindOnce(
-                                 [](DownloadFeedCallback callback,
-                                    std::unique_ptr<DirectFeedResponse> result,
-                                    absl::optional<FeedData> data) {
-                                   if (data) {
-                                     result->success = true;
-                                     result->data = data.value();
-                                   }
-                                   std::move(callback).Run(std::move(result));
-                                 },
-                                 std::move(callback), std::move(result)));
+  ParseFeedDataOffMainThread(
+      feed_url, std::move(body_content),
+      base::BindOnce(
+          [](base::WeakPtr<DirectFeedController> controller,
+             DownloadFeedCallback callback, CachedFeed validators,
+             std::unique_ptr<DirectFeedResponse> result,
+             absl::optional<FeedData> data) {
+            if (data) {
+              result->success = true;
+              result->data = data.value();
+              if (controller && (!validators.etag.empty() ||
+                                 !validators.last_modified.empty())) {
+                validators.data = std::move(data.value());
+                controller->cached_feeds_[result->url] = std::move(validators);
+              }
+            }
+            std::move(callback).Run(std::move(result));
+          },
+          weak_ptr_factory_.GetWeakPtr(), std::move(callback),
+          std::move(validators), std::move(result)));
 }
 
 }  // namespace brave_news
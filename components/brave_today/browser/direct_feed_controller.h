@@ -12,7 +12,9 @@
 #include <vector>
 
 #include "base/callback_forward.h"
+#include "base/containers/flat_map.h"
 #include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
 #include "brave/components/brave_today/common/brave_news.mojom-forward.h"
 #include "brave/components/brave_today/common/brave_news.mojom-shared.h"
 #include "brave/components/brave_today/common/brave_news.mojom.h"
@@ -78,6 +80,13 @@ class DirectFeedController {
  private:
   using SimpleURLLoaderList =
       std::list<std::unique_ptr<network::SimpleURLLoader>>;
+  // The last successfully parsed version of a feed, along with the validators
+  // it was served with.
+  struct CachedFeed {
+    std::string etag;
+    std::string last_modified;
+    FeedData data;
+  };
   void DownloadFeedContent(const GURL& feed_url,
                            const std::string& publisher_id,
                            GetArticlesCallback callback);
@@ -90,6 +99,10 @@ class DirectFeedController {
   raw_ptr<PrefService> prefs_;
   SimpleURLLoaderList url_loaders_;
   scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory_;
+  // Feeds are requested conditionally on what is cached here, and a feed
+  // which hasn't changed doesn't need to be downloaded or parsed again.
+  base::flat_map<GURL, CachedFeed> cached_feeds_;
+  base::WeakPtrFactory<DirectFeedController> weak_ptr_factory_{this};
 };
 
 }  // namespace brave_news
@@ -17,6 +17,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/feature_list.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
@@ -95,43 +96,149 @@ bool Take(
   return (results->size() == count);
 }
 
-// Like Take<T> except selects randomly instead of in order.
-template <class T>
-void TakeRandom(
-    size_t count,
-    std::list<mojo::StructPtr<T>>* articles,
-    std::vector<mojom::FeedItemPtr>* results,
-    std::function<mojom::FeedItemPtr(mojo::StructPtr<T>)> create = FromArticle,
-    std::function<bool(T*)> predicate = {[](T* a) { return true; }}) {
-  auto it = articles->begin();
-  std::vector<typename std::list<mojo::StructPtr<T>>::iterator>
-      matching_iterators;
-  while (it != articles->end()) {
-    auto should_take = predicate(it->get());
-    if (should_take) {
-      matching_iterators.push_back(it);
+// The articles of a feed, in ascending order of score, from which the pages
+// take their content. Taking an article only leaves a hole behind, and every
+// way of choosing articles walks its own precomputed list of candidates, so
+// filling a page doesn't need to scan all the articles that are left.
+class ArticlePool {
+ public:
+  ArticlePool(std::vector<mojom::ArticlePtr> articles, base::Time recent_limit)
+      : articles_(std::move(articles)),
+        remaining_(articles_.size()),
+        random_(std::random_device()()) {
+    std::stable_sort(articles_.begin(), articles_.end(),
+                     [](const mojom::ArticlePtr& a, const mojom::ArticlePtr& b) {
+                       return a->data->score < b->data->score;
+                     });
+    for (size_t i = 0; i < articles_.size(); ++i) {
+      const auto& data = articles_[i]->data;
+      all_.indices.push_back(i);
+      by_category_[data->category_name].indices.push_back(i);
+      by_publisher_[data->publisher_id].indices.push_back(i);
+      if (!data->publisher_id.empty()) {
+        with_publisher_.indices.push_back(i);
+      }
+      if (data->publish_time >= recent_limit) {
+        recent_.push_back(i);
+      }
     }
-    it++;
   }
-  std::random_device rd;
-  std::mt19937 g(rd());
-  std::shuffle(matching_iterators.begin(), matching_iterators.end(), g);
-  if (matching_iterators.size() > count) {
-    matching_iterators.resize(count);
+  ArticlePool(const ArticlePool&) = delete;
+  ArticlePool& operator=(const ArticlePool&) = delete;
+
+  size_t size() const { return remaining_; }
+
+  // Like Take<T>, adds articles in order until |results| holds |count| items.
+  void Take(size_t count, std::vector<mojom::FeedItemPtr>* results) {
+    TakeFrom(all_, count, results);
   }
-  for (auto& matching_iterator : matching_iterators) {
-    auto a = std::make_move_iterator(matching_iterator);
-    auto item = create(*a);
-    results->emplace_back(std::move(item));
-    articles->erase(matching_iterator);
+
+  void TakeFromCategory(size_t count,
+                        const std::string& category_name,
+                        std::vector<mojom::FeedItemPtr>* results) {
+    auto it = by_category_.find(category_name);
+    if (it != by_category_.end()) {
+      TakeFrom(it->second, count, results);
+    }
+  }
+
+  // Takes from the publisher of the first article which has one.
+  void TakeFromFirstPublisher(size_t count,
+                              std::vector<mojom::FeedItemPtr>* results) {
+    std::string publisher_id;
+    if (auto index = Peek(with_publisher_)) {
+      publisher_id = articles_[*index]->data->publisher_id;
+    }
+    auto it = by_publisher_.find(publisher_id);
+    if (it != by_publisher_.end()) {
+      TakeFrom(it->second, count, results);
+    }
+  }
+
+  // Adds up to |count| articles chosen at random among the recent ones.
+  void TakeRandomRecent(size_t count,
+                        std::vector<mojom::FeedItemPtr>* results) {
+    size_t taken = 0;
+    while (taken < count && !recent_.empty()) {
+      std::uniform_int_distribution<size_t> distribution(0,
+                                                         recent_.size() - 1);
+      size_t position = distribution(random_);
+      size_t index = recent_[position];
+      recent_[position] = recent_.back();
+      recent_.pop_back();
+      // Already taken in some other way.
+      if (!articles_[index]) {
+        continue;
+      }
+      results->push_back(FromArticle(TakeAt(index)));
+      ++taken;
+    }
   }
-}
+
+  mojom::ArticlePtr TakeFirstInCategory(const std::string& category_name) {
+    auto it = by_category_.find(category_name);
+    if (it == by_category_.end()) {
+      return nullptr;
+    }
+    auto index = Peek(it->second);
+    return index ? TakeAt(*index) : nullptr;
+  }
+
+ private:
+  // Indices of articles in order of score, and how far they have been taken.
+  struct Queue {
+    std::vector<size_t> indices;
+    size_t next = 0;
+  };
+
+  // Returns the first article of |queue| which is still in the pool.
+  absl::optional<size_t> Peek(Queue& queue) {
+    while (queue.next < queue.indices.size()) {
+      size_t index = queue.indices[queue.next];
+      if (articles_[index]) {
+        return index;
+      }
+      ++queue.next;
+    }
+    return absl::nullopt;
+  }
+
+  void TakeFrom(Queue& queue,
+                size_t count,
+                std::vector<mojom::FeedItemPtr>* results) {
+    while (results->size() < count) {
+      auto index = Peek(queue);
+      if (!index) {
+        break;
+      }
+      results->push_back(FromArticle(TakeAt(*index)));
+    }
+  }
+
+  mojom::ArticlePtr TakeAt(size_t index) {
+    DCHECK(articles_[index]);
+    --remaining_;
+    return std::move(articles_[index]);
+  }
+
+  // Articles which have been taken are left null.
+  std::vector<mojom::ArticlePtr> articles_;
+  size_t remaining_;
+  Queue all_;
+  Queue with_publisher_;
+  base::flat_map<std::string, Queue> by_category_;
+  base::flat_map<std::string, Queue> by_publisher_;
+  // Recent articles in no particular order, some of which may have been taken
+  // since.
+  std::vector<size_t> recent_;
+  std::mt19937 random_;
+};
 
 // Decides which content to take for a specific item in the feed.
 // Items approximately correspond to "cards" in the UI, although an item
 // could be 2 cards (e.g. HEADLINE_PAIRED) or multiple
 // articles (e.g. CATEGORY_GROUP).
-void BuildFeedPageItem(std::list<mojom::ArticlePtr>* articles,
+void BuildFeedPageItem(ArticlePool* articles,
                        std::list<mojom::PromotedArticlePtr>* promoted_articles,
                        std::list<mojom::DealPtr>* deals,
                        const std::string& deal_category_name,
@@ -142,18 +249,12 @@ void BuildFeedPageItem(std::list<mojom::ArticlePtr>* articles,
   if (is_random) {
     // Additional difference for is_random is that we only consider items from
     // the last 48hrs.
-    base::Time time_limit = base::Time::Now() - base::Days(2);
-    auto match_is_recent = [time_limit](mojom::Article* article) {
-      return (article->data->publish_time >= time_limit);
-    };
     switch (page_item->card_type) {
       case CardType::HEADLINE:
-        TakeRandom<mojom::Article>(1u, articles, &page_item->items, FromArticle,
-                                   match_is_recent);
+        articles->TakeRandomRecent(1u, &page_item->items);
         break;
       case CardType::HEADLINE_PAIRED:
-        TakeRandom<mojom::Article>(2u, articles, &page_item->items, FromArticle,
-                                   match_is_recent);
+        articles->TakeRandomRecent(2u, &page_item->items);
         break;
       default:
         VLOG(1) << "Card Type not handled for is_random: "
@@ -164,35 +265,18 @@ void BuildFeedPageItem(std::list<mojom::ArticlePtr>* articles,
   // Not having enough articles is the only real reason to abandon a page.
   switch (page_item->card_type) {
     case CardType::HEADLINE:
-      Take<mojom::Article>(1u, articles, &page_item->items, FromArticle);
+      articles->Take(1u, &page_item->items);
       break;
     case CardType::HEADLINE_PAIRED:
-      Take<mojom::Article>(2u, articles, &page_item->items, FromArticle);
+      articles->Take(2u, &page_item->items);
       break;
     case CardType::CATEGORY_GROUP:
-      Take<mojom::Article>(
-          3u, articles, &page_item->items, FromArticle,
-          [article_category_name](mojom::Article* article) {
-            return (article->data->category_name == article_category_name);
-          });
+      articles->TakeFromCategory(3u, article_category_name, &page_item->items);
       break;
-    case CardType::PUBLISHER_GROUP: {
+    case CardType::PUBLISHER_GROUP:
       // Choose the first publisher available
-      std::string publisher_id;
-      for (auto& article : *articles) {
-        if (article->data->publisher_id.empty()) {
-          continue;
-        }
-        publisher_id = article.get()->data->publisher_id;
-        break;
-      }
-      Take<mojom::Article>(
-          3u, articles, &page_item->items, FromArticle,
-          [publisher_id](mojom::Article* article) {
-            return (article->data->publisher_id == publisher_id);
-          });
+      articles->TakeFromFirstPublisher(3u, &page_item->items);
       break;
-    }
     case CardType::DEALS:
       Take<mojom::Deal>(3u, deals, &page_item->items, FromDeal,
                         [deal_category_name](mojom::Deal* deal) {
@@ -291,7 +375,7 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
   Channels channels =
       ChannelsController::GetChannelsFromPublishers(locale, *publishers, prefs);
 
-  std::list<mojom::ArticlePtr> articles;
+  std::vector<mojom::ArticlePtr> articles;
   std::list<mojom::PromotedArticlePtr> promoted_articles;
   std::list<mojom::DealPtr> deals;
   std::hash<std::string> hasher;
@@ -334,10 +418,7 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
   VLOG(1) << "Got articles # " << articles.size();
   VLOG(1) << "Got deals # " << deals.size();
   VLOG(1) << "Got promoted articles # " << promoted_articles.size();
-  // Sort by score, ascending
-  articles.sort([](mojom::ArticlePtr& a, mojom::ArticlePtr& b) {
-    return (a.get()->data->score < b.get()->data->score);
-  });
+  // Sort by score, ascending. Articles are sorted by |article_pool| below.
   promoted_articles.sort(
       [](mojom::PromotedArticlePtr& a, mojom::PromotedArticlePtr& b) {
         return (a.get()->data->score < b.get()->data->score);
@@ -391,19 +472,11 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
               return (deal_category_counts.at(a) < deal_category_counts.at(b));
             });
   VLOG(1) << "Got deal categories # " << deal_category_names_by_priority.size();
+  ArticlePool article_pool(std::move(articles),
+                           base::Time::Now() - base::Days(2));
   // Get first headline
-  std::list<mojom::ArticlePtr>::iterator featured_article_it;
-  for (featured_article_it = articles.begin();
-       featured_article_it != articles.end(); featured_article_it++) {
-    if (featured_article_it->get()->data->category_name == "Top News") {
-      break;
-    }
-  }
-  if (featured_article_it != articles.end()) {
-    auto item = *std::make_move_iterator(featured_article_it);
-    auto article = mojom::FeedItem::NewArticle(std::move(item));
-    feed->featured_item = std::move(article);
-    articles.erase(featured_article_it);
+  if (auto featured_article = article_pool.TakeFirstInCategory("Top News")) {
+    feed->featured_item = FromArticle(std::move(featured_article));
   }
   // Generate as many pages of content as possible
   // Make the pages
@@ -412,7 +485,7 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
   auto category_it = category_names_by_priority.begin();
   auto deal_category_it = deal_category_names_by_priority.begin();
   while (cur_page++ < max_pages) {
-    if (articles.size() == 0) {
+    if (article_pool.size() == 0) {
       // No more pages of content
       break;
     }
@@ -426,7 +499,7 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
     for (auto card_type : page_content_order) {
       auto feed_page_item = mojom::FeedPageItem::New();
       feed_page_item->card_type = card_type;
-      BuildFeedPageItem(&articles, &promoted_articles, &deals,
+      BuildFeedPageItem(&article_pool, &promoted_articles, &deals,
                         deal_category_name, article_category_name, false,
                         &feed_page_item);
       feed_page->items.push_back(std::move(feed_page_item));
@@ -434,7 +507,7 @@ bool BuildFeed(const std::vector<mojom::FeedItemPtr>& feed_items,
     for (auto card_type : random_content_order) {
       auto feed_page_item = mojom::FeedPageItem::New();
       feed_page_item->card_type = card_type;
-      BuildFeedPageItem(&articles, &promoted_articles, &deals,
+      BuildFeedPageItem(&article_pool, &promoted_articles, &deals,
                         deal_category_name, article_category_name, true,
                         &feed_page_item);
       feed_page->items.push_back(std::move(feed_page_item));
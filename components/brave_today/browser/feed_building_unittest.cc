@@ -175,6 +175,49 @@ TEST_F(BraveNewsFeedBuildingTest, BuildFeed) {
             "https://www.example.com/an-article/");
 }
 
+TEST_F(BraveNewsFeedBuildingTest, BuildFeedPlacesEveryArticleOnce) {
+  Publishers publisher_list;
+  PopulatePublishers(&publisher_list);
+  const std::vector<std::string> publisher_ids = {"111", "222", "333"};
+  const std::vector<std::string> categories = {"Top News", "Technology",
+                                               "Sports", ""};
+
+  constexpr size_t kArticleCount = 5000;
+  std::vector<mojom::FeedItemPtr> feed_items;
+  for (size_t i = 0; i < kArticleCount; ++i) {
+    // Half of the articles are recent enough to be picked at random.
+    base::Time publish_time =
+        base::Time::Now() - (i % 2 ? base::Hours(1) : base::Days(5));
+    feed_items.push_back(mojom::FeedItem::NewArticle(
+        mojom::Article::New(mojom::FeedItemMetadata::New(
+            categories[i % categories.size()], publish_time, "Title",
+            "Description",
+            GURL("https://www.example.com/" + std::to_string(i)), "",
+            mojom::Image::NewImageUrl(GURL("https://www.example.com/img")),
+            publisher_ids[i % publisher_ids.size()], "Publisher",
+            static_cast<double>((i * 7919) % kArticleCount), ""))));
+  }
+
+  mojom::Feed feed;
+  ASSERT_TRUE(BuildFeed(feed_items, {}, &publisher_list, &feed,
+                        profile_.GetPrefs(), "en_US"));
+
+  ASSERT_TRUE(feed.featured_item);
+  EXPECT_EQ(feed.featured_item->get_article()->data->category_name,
+            "Top News");
+  std::unordered_set<std::string> urls = {
+      feed.featured_item->get_article()->data->url.spec()};
+  for (const auto& page : feed.pages) {
+    for (const auto& page_item : page->items) {
+      for (const auto& item : page_item->items) {
+        ASSERT_TRUE(item->is_article());
+        EXPECT_TRUE(urls.insert(item->get_article()->data->url.spec()).second);
+      }
+    }
+  }
+  EXPECT_EQ(urls.size(), kArticleCount);
+}
+
 TEST_F(BraveNewsFeedBuildingTest, RemovesDefaultOffItems) {
   Publishers publisher_list;
   PopulatePublishers(&publisher_list);
@@ -29,6 +29,9 @@
 #include "components/history/core/browser/history_service.h"
 #include "components/history/core/browser/history_types.h"
 #include "components/prefs/pref_service.h"
+#include "mojo/public/cpp/bindings/clone_traits.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_status_code.h"
 
 namespace brave_news {
 
@@ -53,14 +56,16 @@ FeedController::FeedController(
     DirectFeedController* direct_feed_controller,
     history::HistoryService* history_service,
     api_request_helper::APIRequestHelper* api_request_helper,
-    PrefService* prefs)
+    PrefService* prefs,
+    const base::FilePath& combined_feed_path)
     : prefs_(prefs),
       publishers_controller_(publishers_controller),
       direct_feed_controller_(direct_feed_controller),
       history_service_(history_service),
       api_request_helper_(api_request_helper),
       on_current_update_complete_(new base::OneShotEvent()),
-      publishers_observation_(this) {
+      publishers_observation_(this),
+      combined_feed_store_(combined_feed_path) {
   publishers_observation_.Observe(publishers_controller);
 }
 
@@ -262,6 +267,10 @@ void FeedController::UpdateIfRemoteChanged() {
 
 void FeedController::ClearCache() {
   ResetFeed();
+  current_feed_etag_.clear();
+  combined_feed_items_.reset();
+  revalidate_after_update_ = false;
+  combined_feed_store_.Clear();
 }
 
 void FeedController::OnPublishersUpdated(PublishersController* controller) {
@@ -270,46 +279,98 @@ void FeedController::OnPublishersUpdated(PublishersController* controller) {
 }
 
 void FeedController::FetchCombinedFeed(GetFeedItemsCallback callback) {
+  // Pick up the feed stored by a previous session first, so that it can be
+  // served without waiting for the network.
+  if (!is_combined_feed_loaded_) {
+    combined_feed_store_.Load(base::BindOnce(
+        &FeedController::OnCombinedFeedLoaded, weak_ptr_factory_.GetWeakPtr(),
+        std::move(callback)));
+    return;
+  }
   publishers_controller_->GetLocale(base::BindOnce(
       [](FeedController* controller, GetFeedItemsCallback callback,
          const std::string& locale) {
-        // Handle the response
-        auto response_handler = base::BindOnce(
-            [](FeedController* controller, GetFeedItemsCallback callback,
-               api_request_helper::APIRequestResult api_request_result) {
-              std::string etag;
-              if (api_request_result.headers().contains(kEtagHeaderKey)) {
-                etag = api_request_result.headers().at(kEtagHeaderKey);
-              }
-              VLOG(1) << "Downloaded feed, status: "
-                      << api_request_result.response_code()
-                      << " etag: " << etag;
-              // Handle bad response
-              if (api_request_result.response_code() != 200 ||
-                  api_request_result.body().empty()) {
-                LOG(ERROR) << "Bad response from brave news feed.json. Status: "
-                           << api_request_result.response_code();
-                std::move(callback).Run({});
-                return;
-              }
-              // Only mark cache time of remote request if
-              // parsing was successful
-              controller->current_feed_etag_ = etag;
-              FeedItems feed_items;
-              ParseFeedItems(api_request_result.body(), &feed_items);
-              std::move(callback).Run(std::move(feed_items));
-            },
-            base::Unretained(controller), std::move(callback));
+        auto headers = brave::private_cdn_headers;
+        if (controller->HasCombinedFeed()) {
+          headers[net::HttpRequestHeaders::kIfNoneMatch] =
+              controller->current_feed_etag_;
+        }
         // Send the request
         GURL feed_url(GetFeedUrl(locale));
         VLOG(1) << "Making feed request to " << feed_url.spec();
-        controller->api_request_helper_->Request("GET", feed_url, "", "", true,
-                                                 std::move(response_handler),
-                                                 brave::private_cdn_headers);
+        controller->api_request_helper_->Request(
+            "GET", feed_url, "", "", true,
+            base::BindOnce(&FeedController::OnCombinedFeedResponse,
+                           controller->weak_ptr_factory_.GetWeakPtr(),
+                           std::move(callback)),
+            headers);
       },
       base::Unretained(this), std::move(callback)));
 }
 
+void FeedController::OnCombinedFeedLoaded(
+    GetFeedItemsCallback callback,
+    absl::optional<StoredCombinedFeed> stored_feed) {
+  is_combined_feed_loaded_ = true;
+  if (stored_feed && !HasCombinedFeed()) {
+    FeedItems feed_items;
+    if (ParseFeedItems(stored_feed->body, &feed_items)) {
+      VLOG(1) << "Serving stored feed, etag: " << stored_feed->etag;
+      current_feed_etag_ = std::move(stored_feed->etag);
+      combined_feed_items_ = mojo::Clone(feed_items);
+      // The stored feed may be out of date, so check it with the server once
+      // the feed built from it is ready.
+      revalidate_after_update_ = true;
+      std::move(callback).Run(std::move(feed_items));
+      return;
+    }
+    LOG(ERROR) << "Could not parse stored brave news feed";
+    combined_feed_store_.Clear();
+  }
+  FetchCombinedFeed(std::move(callback));
+}
+
+void FeedController::OnCombinedFeedResponse(
+    GetFeedItemsCallback callback,
+    api_request_helper::APIRequestResult api_request_result) {
+  std::string etag;
+  if (api_request_result.headers().contains(kEtagHeaderKey)) {
+    etag = api_request_result.headers().at(kEtagHeaderKey);
+  }
+  VLOG(1) << "Downloaded feed, status: " << api_request_result.response_code()
+          << " etag: " << etag;
+  if (api_request_result.response_code() == net::HTTP_NOT_MODIFIED &&
+      HasCombinedFeed()) {
+    std::move(callback).Run(mojo::Clone(*combined_feed_items_));
+    return;
+  }
+  // Handle bad response
+  if (api_request_result.response_code() != 200 ||
+      api_request_result.body().empty()) {
+    LOG(ERROR) << "Bad response from brave news feed.json. Status: "
+               << api_request_result.response_code();
+    std::move(callback).Run({});
+    return;
+  }
+  // Only mark cache time of remote request if
+  // parsing was successful
+  current_feed_etag_ = etag;
+  combined_feed_items_.reset();
+  FeedItems feed_items;
+  if (ParseFeedItems(api_request_result.body(), &feed_items) &&
+      !etag.empty()) {
+    combined_feed_items_ = mojo::Clone(feed_items);
+    combined_feed_store_.Save({etag, api_request_result.body()});
+  } else {
+    combined_feed_store_.Clear();
+  }
+  std::move(callback).Run(std::move(feed_items));
+}
+
+bool FeedController::HasCombinedFeed() const {
+  return !current_feed_etag_.empty() && combined_feed_items_;
+}
+
 void FeedController::GetOrFetchFeed(base::OnceClosure callback) {
   VLOG(1) << "getorfetch feed(oc) start: "
           << on_current_update_complete_->is_signaled();
@@ -339,6 +400,12 @@ void FeedController::NotifyUpdateDone() {
   // can be waited for.
   is_update_in_progress_ = false;
   on_current_update_complete_ = std::make_unique<base::OneShotEvent>();
+  // A feed served from disk is revalidated in the background; the NTP picks
+  // up a newer one through IsFeedUpdateAvailable.
+  if (revalidate_after_update_) {
+    revalidate_after_update_ = false;
+    UpdateIfRemoteChanged();
+  }
 }
 
 }  // namespace brave_news
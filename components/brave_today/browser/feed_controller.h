@@ -10,15 +10,19 @@
 #include <string>
 #include <vector>
 
+#include "base/files/file_path.h"
 #include "base/memory/raw_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/one_shot_event.h"
 #include "base/scoped_observation.h"
 #include "brave/components/api_request_helper/api_request_helper.h"
+#include "brave/components/brave_today/browser/combined_feed_store.h"
 #include "brave/components/brave_today/browser/direct_feed_controller.h"
 #include "brave/components/brave_today/browser/publishers_controller.h"
 #include "brave/components/brave_today/common/brave_news.mojom.h"
 #include "components/history/core/browser/history_service.h"
 #include "components/prefs/pref_service.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace history {
 class HistoryService;
@@ -36,7 +40,8 @@ class FeedController : public PublishersController::Observer {
                  DirectFeedController* direct_feed_controller,
                  history::HistoryService* history_service,
                  api_request_helper::APIRequestHelper* api_request_helper,
-                 PrefService* prefs);
+                 PrefService* prefs,
+                 const base::FilePath& combined_feed_path);
   ~FeedController() override;
   FeedController(const FeedController&) = delete;
   FeedController& operator=(const FeedController&) = delete;
@@ -67,6 +72,12 @@ class FeedController : public PublishersController::Observer {
 
  private:
   void FetchCombinedFeed(GetFeedItemsCallback callback);
+  void OnCombinedFeedLoaded(GetFeedItemsCallback callback,
+                            absl::optional<StoredCombinedFeed> stored_feed);
+  void OnCombinedFeedResponse(
+      GetFeedItemsCallback callback,
+      api_request_helper::APIRequestResult api_request_result);
+  bool HasCombinedFeed() const;
   void GetOrFetchFeed(base::OnceClosure callback);
   void ResetFeed();
   void NotifyUpdateDone();
@@ -89,6 +100,17 @@ class FeedController : public PublishersController::Observer {
   mojom::Feed current_feed_;
   std::string current_feed_etag_;
   bool is_update_in_progress_ = false;
+
+  CombinedFeedStore combined_feed_store_;
+  bool is_combined_feed_loaded_ = false;
+  // The combined feed matching |current_feed_etag_|, reused when the server
+  // reports that the feed hasn't changed.
+  absl::optional<FeedItems> combined_feed_items_;
+  // Set when the combined feed was served from the store of a previous
+  // session, so that it is checked with the server once the update is done.
+  bool revalidate_after_update_ = false;
+
+  base::WeakPtrFactory<FeedController> weak_ptr_factory_{this};
 };
 
 }  // namespace brave_news
@@ -0,0 +1,241 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_wallet/browser/blockchain_list_snapshot.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/pickle.h"
+#include "url/gurl.h"
+
+namespace brave_wallet {
+
+namespace {
+
+// Bump whenever the layout below or the output of the parsers changes, so
+// that snapshots written by an older browser are parsed again.
+constexpr int kSnapshotVersion = 1;
+
+enum class SnapshotType {
+  kTokenList = 1,
+  kChainList = 2,
+};
+
+void WriteHeader(SnapshotType type,
+                 const std::string& json_hash,
+                 base::Pickle& pickle) {
+  pickle.WriteInt(kSnapshotVersion);
+  pickle.WriteInt(static_cast<int>(type));
+  pickle.WriteString(json_hash);
+}
+
+bool ReadHeader(SnapshotType type,
+                const std::string& json_hash,
+                base::PickleIterator& iter) {
+  int version;
+  int snapshot_type;
+  std::string snapshot_hash;
+  return iter.ReadInt(&version) && version == kSnapshotVersion &&
+         iter.ReadInt(&snapshot_type) &&
+         snapshot_type == static_cast<int>(type) &&
+         iter.ReadString(&snapshot_hash) && snapshot_hash == json_hash;
+}
+
+void WriteCoin(mojom::CoinType coin, base::Pickle& pickle) {
+  pickle.WriteInt(static_cast<int>(coin));
+}
+
+bool ReadCoin(base::PickleIterator& iter, mojom::CoinType* coin) {
+  int value;
+  if (!iter.ReadInt(&value))
+    return false;
+  *coin = static_cast<mojom::CoinType>(value);
+  return mojom::IsKnownEnumValue(*coin);
+}
+
+void WriteStrings(const std::vector<std::string>& strings,
+                  base::Pickle& pickle) {
+  pickle.WriteUInt32(strings.size());
+  for (const auto& string : strings) {
+    pickle.WriteString(string);
+  }
+}
+
+bool ReadStrings(base::PickleIterator& iter, std::vector<std::string>* result) {
+  uint32_t size;
+  if (!iter.ReadUInt32(&size))
+    return false;
+  for (uint32_t i = 0; i < size; ++i) {
+    std::string string;
+    if (!iter.ReadString(&string))
+      return false;
+    result->push_back(std::move(string));
+  }
+  return true;
+}
+
+void WriteToken(const mojom::BlockchainToken& token, base::Pickle& pickle) {
+  pickle.WriteString(token.contract_address);
+  pickle.WriteString(token.name);
+  pickle.WriteString(token.logo);
+  pickle.WriteBool(token.is_erc20);
+  pickle.WriteBool(token.is_erc721);
+  pickle.WriteString(token.symbol);
+  pickle.WriteInt(token.decimals);
+  pickle.WriteBool(token.visible);
+  pickle.WriteString(token.token_id);
+  pickle.WriteString(token.coingecko_id);
+  pickle.WriteString(token.chain_id);
+  WriteCoin(token.coin, pickle);
+}
+
+mojom::BlockchainTokenPtr ReadToken(base::PickleIterator& iter) {
+  auto token = mojom::BlockchainToken::New();
+  if (!iter.ReadString(&token->contract_address) ||
+      !iter.ReadString(&token->name) || !iter.ReadString(&token->logo) ||
+      !iter.ReadBool(&token->is_erc20) || !iter.ReadBool(&token->is_erc721) ||
+      !iter.ReadString(&token->symbol) || !iter.ReadInt(&token->decimals) ||
+      !iter.ReadBool(&token->visible) || !iter.ReadString(&token->token_id) ||
+      !iter.ReadString(&token->coingecko_id) ||
+      !iter.ReadString(&token->chain_id) || !ReadCoin(iter, &token->coin)) {
+    return nullptr;
+  }
+  return token;
+}
+
+void WriteNetwork(const mojom::NetworkInfo& network, base::Pickle& pickle) {
+  pickle.WriteString(network.chain_id);
+  pickle.WriteString(network.chain_name);
+  WriteStrings(network.block_explorer_urls, pickle);
+  WriteStrings(network.icon_urls, pickle);
+  pickle.WriteInt(network.active_rpc_endpoint_index);
+  pickle.WriteUInt32(network.rpc_endpoints.size());
+  for (const auto& rpc_endpoint : network.rpc_endpoints) {
+    pickle.WriteString(rpc_endpoint.possibly_invalid_spec());
+  }
+  pickle.WriteString(network.symbol);
+  pickle.WriteString(network.symbol_name);
+  pickle.WriteInt(network.decimals);
+  WriteCoin(network.coin, pickle);
+  pickle.WriteBool(network.is_eip1559);
+}
+
+mojom::NetworkInfoPtr ReadNetwork(base::PickleIterator& iter) {
+  auto network = mojom::NetworkInfo::New();
+  uint32_t rpc_endpoints_size;
+  if (!iter.ReadString(&network->chain_id) ||
+      !iter.ReadString(&network->chain_name) ||
+      !ReadStrings(iter, &network->block_explorer_urls) ||
+      !ReadStrings(iter, &network->icon_urls) ||
+      !iter.ReadInt(&network->active_rpc_endpoint_index) ||
+      !iter.ReadUInt32(&rpc_endpoints_size)) {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < rpc_endpoints_size; ++i) {
+    std::string spec;
+    if (!iter.ReadString(&spec))
+      return nullptr;
+    network->rpc_endpoints.emplace_back(spec);
+  }
+  if (!iter.ReadString(&network->symbol) ||
+      !iter.ReadString(&network->symbol_name) ||
+      !iter.ReadInt(&network->decimals) || !ReadCoin(iter, &network->coin) ||
+      !iter.ReadBool(&network->is_eip1559)) {
+    return nullptr;
+  }
+  return network;
+}
+
+}  // namespace
+
+std::string SerializeTokenListSnapshot(const std::string& json_hash,
+                                       const TokenListMap& token_list) {
+  base::Pickle pickle;
+  WriteHeader(SnapshotType::kTokenList, json_hash, pickle);
+  pickle.WriteUInt32(token_list.size());
+  for (const auto& [key, tokens] : token_list) {
+    pickle.WriteString(key);
+    pickle.WriteUInt32(tokens.size());
+    for (const auto& token : tokens) {
+      WriteToken(*token, pickle);
+    }
+  }
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+bool DeserializeTokenListSnapshot(base::span<const uint8_t> snapshot,
+                                  const std::string& json_hash,
+                                  TokenListMap* token_list) {
+  DCHECK(token_list);
+
+  base::Pickle pickle(reinterpret_cast<const char*>(snapshot.data()),
+                      snapshot.size());
+  base::PickleIterator iter(pickle);
+  uint32_t lists_size;
+  if (!ReadHeader(SnapshotType::kTokenList, json_hash, iter) ||
+      !iter.ReadUInt32(&lists_size)) {
+    return false;
+  }
+
+  TokenListMap result;
+  for (uint32_t i = 0; i < lists_size; ++i) {
+    std::string key;
+    uint32_t tokens_size;
+    if (!iter.ReadString(&key) || !iter.ReadUInt32(&tokens_size))
+      return false;
+    std::vector<mojom::BlockchainTokenPtr> tokens;
+    for (uint32_t j = 0; j < tokens_size; ++j) {
+      auto token = ReadToken(iter);
+      if (!token)
+        return false;
+      tokens.push_back(std::move(token));
+    }
+    result[key] = std::move(tokens);
+  }
+
+  *token_list = std::move(result);
+  return true;
+}
+
+std::string SerializeChainListSnapshot(const std::string& json_hash,
+                                       const ChainList& chain_list) {
+  base::Pickle pickle;
+  WriteHeader(SnapshotType::kChainList, json_hash, pickle);
+  pickle.WriteUInt32(chain_list.size());
+  for (const auto& network : chain_list) {
+    WriteNetwork(*network, pickle);
+  }
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+bool DeserializeChainListSnapshot(base::span<const uint8_t> snapshot,
+                                  const std::string& json_hash,
+                                  ChainList* chain_list) {
+  DCHECK(chain_list);
+
+  base::Pickle pickle(reinterpret_cast<const char*>(snapshot.data()),
+                      snapshot.size());
+  base::PickleIterator iter(pickle);
+  uint32_t networks_size;
+  if (!ReadHeader(SnapshotType::kChainList, json_hash, iter) ||
+      !iter.ReadUInt32(&networks_size)) {
+    return false;
+  }
+
+  ChainList result;
+  for (uint32_t i = 0; i < networks_size; ++i) {
+    auto network = ReadNetwork(iter);
+    if (!network)
+      return false;
+    result.push_back(std::move(network));
+  }
+
+  *chain_list = std::move(result);
+  return true;
+}
+
+}  // namespace brave_wallet
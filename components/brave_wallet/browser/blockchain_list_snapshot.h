@@ -0,0 +1,35 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_BLOCKCHAIN_LIST_SNAPSHOT_H_
+#define BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_BLOCKCHAIN_LIST_SNAPSHOT_H_
+
+#include <string>
+
+#include "base/containers/span.h"
+#include "brave/components/brave_wallet/browser/blockchain_list_parser.h"
+
+namespace brave_wallet {
+
+// Binary snapshots of what ParseTokenList and ParseChainList return for a
+// data file, so that the file does not need to be sanitized and parsed again
+// on every start. A snapshot records the SHA-256 hash of the JSON it was
+// built from and is only accepted for the same JSON.
+
+std::string SerializeTokenListSnapshot(const std::string& json_hash,
+                                       const TokenListMap& token_list);
+bool DeserializeTokenListSnapshot(base::span<const uint8_t> snapshot,
+                                  const std::string& json_hash,
+                                  TokenListMap* token_list);
+
+std::string SerializeChainListSnapshot(const std::string& json_hash,
+                                       const ChainList& chain_list);
+bool DeserializeChainListSnapshot(base::span<const uint8_t> snapshot,
+                                  const std::string& json_hash,
+                                  ChainList* chain_list);
+
+}  // namespace brave_wallet
+
+#endif  // BRAVE_COMPONENTS_BRAVE_WALLET_BROWSER_BLOCKCHAIN_LIST_SNAPSHOT_H_
@@ -0,0 +1,113 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "brave/components/brave_wallet/browser/blockchain_list_parser.h"
+#include "brave/components/brave_wallet/browser/blockchain_list_snapshot.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_wallet {
+
+namespace {
+
+const char kJsonHash[] = "json-hash";
+
+base::span<const uint8_t> AsBytes(const std::string& snapshot) {
+  return base::as_bytes(base::make_span(snapshot));
+}
+
+TokenListMap GetTokenList() {
+  TokenListMap token_list;
+  token_list["ethereum.0x1"].push_back(mojom::BlockchainToken::New(
+      "0x0D8775F648430679A709E98d2b0Cb6250d2887EF", "Basic Attention Token",
+      "bat.svg", true, false, "BAT", 18, true, "", "basic-attention-token",
+      "0x1", mojom::CoinType::ETH));
+  token_list["ethereum.0x1"].push_back(mojom::BlockchainToken::New(
+      "0x06012c8cf97BEaD5deAe237070F9587f8E7A266d", "Crypto Kitties",
+      "CryptoKitties-Kitty-13733.svg", false, true, "CK", 0, true, "", "",
+      "0x1", mojom::CoinType::ETH));
+  token_list["solana.0x65"].push_back(mojom::BlockchainToken::New(
+      "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v", "USD Coin",
+      "EPjFWdd5AufqSSqeM2qN1xzybapC8G4wEGGkZwyTDt1v.png", false, false, "USDC",
+      6, true, "", "usd-coin", "0x65", mojom::CoinType::SOL));
+  token_list["ethereum.0x2"];
+  return token_list;
+}
+
+ChainList GetChainList() {
+  ChainList chain_list;
+  chain_list.push_back(mojom::NetworkInfo::New(
+      "0x1", "Ethereum Mainnet", std::vector<std::string>{"https://etherscan.io"},
+      std::vector<std::string>{}, 1,
+      std::vector<GURL>{GURL("https://api.mycryptoapi.com/eth"),
+                        GURL("https://cloudflare-eth.com")},
+      "ETH", "Ether", 18, mojom::CoinType::ETH, false));
+  chain_list.push_back(mojom::NetworkInfo::New(
+      "0x89", "Polygon Mainnet", std::vector<std::string>{},
+      std::vector<std::string>{"polygon.png"}, 0,
+      std::vector<GURL>{GURL("https://polygon-rpc.com")}, "MATIC", "MATIC",
+      18, mojom::CoinType::ETH, true));
+  return chain_list;
+}
+
+}  // namespace
+
+TEST(BlockchainListSnapshotUnitTest, TokenListRoundTrip) {
+  const TokenListMap token_list = GetTokenList();
+  const std::string snapshot =
+      SerializeTokenListSnapshot(kJsonHash, token_list);
+
+  TokenListMap result;
+  ASSERT_TRUE(
+      DeserializeTokenListSnapshot(AsBytes(snapshot), kJsonHash, &result));
+  EXPECT_EQ(result, token_list);
+}
+
+TEST(BlockchainListSnapshotUnitTest, ChainListRoundTrip) {
+  const ChainList chain_list = GetChainList();
+  const std::string snapshot =
+      SerializeChainListSnapshot(kJsonHash, chain_list);
+
+  ChainList result;
+  ASSERT_TRUE(
+      DeserializeChainListSnapshot(AsBytes(snapshot), kJsonHash, &result));
+  EXPECT_EQ(result, chain_list);
+}
+
+TEST(BlockchainListSnapshotUnitTest, RejectsOtherJson) {
+  const std::string token_snapshot =
+      SerializeTokenListSnapshot(kJsonHash, GetTokenList());
+  TokenListMap token_list;
+  EXPECT_FALSE(DeserializeTokenListSnapshot(AsBytes(token_snapshot),
+                                            "other-hash", &token_list));
+  EXPECT_TRUE(token_list.empty());
+
+  const std::string chain_snapshot =
+      SerializeChainListSnapshot(kJsonHash, GetChainList());
+  ChainList chain_list;
+  EXPECT_FALSE(DeserializeChainListSnapshot(AsBytes(chain_snapshot),
+                                            "other-hash", &chain_list));
+  EXPECT_TRUE(chain_list.empty());
+
+  // A snapshot of one kind of list is never read as the other.
+  EXPECT_FALSE(DeserializeChainListSnapshot(AsBytes(token_snapshot), kJsonHash,
+                                            &chain_list));
+}
+
+TEST(BlockchainListSnapshotUnitTest, RejectsTruncatedSnapshot) {
+  const std::string snapshot =
+      SerializeTokenListSnapshot(kJsonHash, GetTokenList());
+  TokenListMap token_list;
+  EXPECT_FALSE(DeserializeTokenListSnapshot(
+      AsBytes(snapshot).first(snapshot.size() - 1), kJsonHash, &token_list));
+  EXPECT_FALSE(DeserializeTokenListSnapshot({}, kJsonHash, &token_list));
+  EXPECT_TRUE(token_list.empty());
+}
+
+}  // namespace brave_wallet
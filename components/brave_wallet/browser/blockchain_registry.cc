@@ -7,7 +7,6 @@
 
 #include <utility>
 
-#include "base/ranges/algorithm.h"
 #include "base/strings/stringprintf.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
@@ -15,6 +14,12 @@
 
 namespace brave_wallet {
 
+BlockchainRegistry::TokenListIndex::TokenListIndex() = default;
+BlockchainRegistry::TokenListIndex::TokenListIndex(TokenListIndex&&) = default;
+BlockchainRegistry::TokenListIndex&
+BlockchainRegistry::TokenListIndex::operator=(TokenListIndex&&) = default;
+BlockchainRegistry::TokenListIndex::~TokenListIndex() = default;
+
 BlockchainRegistry::BlockchainRegistry() = default;
 BlockchainRegistry::~BlockchainRegistry() = default;
 
@@ -36,12 +41,59 @@ void BlockchainRegistry::Bind(
 
 void BlockchainRegistry::UpdateTokenList(TokenListMap token_list_map) {
   token_list_map_ = std::move(token_list_map);
+  token_list_indexes_.clear();
+  for (const auto& [key, tokens] : token_list_map_) {
+    token_list_indexes_[key] = BuildTokenListIndex(tokens);
+  }
 }
 
 void BlockchainRegistry::UpdateTokenList(
     const std::string key,
     std::vector<mojom::BlockchainTokenPtr> list) {
   token_list_map_[key] = std::move(list);
+  token_list_indexes_[key] = BuildTokenListIndex(token_list_map_[key]);
+}
+
+// static
+BlockchainRegistry::TokenListIndex BlockchainRegistry::BuildTokenListIndex(
+    const std::vector<mojom::BlockchainTokenPtr>& tokens) {
+  std::vector<std::pair<base::StringPiece, size_t>> by_address;
+  std::vector<std::pair<base::StringPiece, size_t>> by_symbol;
+  by_address.reserve(tokens.size());
+  by_symbol.reserve(tokens.size());
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    by_address.emplace_back(tokens[i]->contract_address, i);
+    by_symbol.emplace_back(tokens[i]->symbol, i);
+  }
+
+  // flat_map keeps the first of duplicate keys, which is the token a linear
+  // search would have found.
+  TokenListIndex index;
+  index.by_address =
+      base::flat_map<base::StringPiece, size_t>(std::move(by_address));
+  index.by_symbol =
+      base::flat_map<base::StringPiece, size_t>(std::move(by_symbol));
+  return index;
+}
+
+const mojom::BlockchainTokenPtr* BlockchainRegistry::FindToken(
+    const std::string& chain_id,
+    mojom::CoinType coin,
+    base::flat_map<base::StringPiece, size_t> TokenListIndex::*index,
+    const std::string& value) const {
+  const auto key = GetTokenListKey(coin, chain_id);
+  auto tokens_it = token_list_map_.find(key);
+  auto index_it = token_list_indexes_.find(key);
+  if (tokens_it == token_list_map_.end() ||
+      index_it == token_list_indexes_.end()) {
+    return nullptr;
+  }
+
+  const auto& positions = index_it->second.*index;
+  auto position_it = positions.find(value);
+  if (position_it == positions.end())
+    return nullptr;
+  return &tokens_it->second[position_it->second];
 }
 
 void BlockchainRegistry::UpdateChainList(ChainList chains) {
@@ -59,39 +111,18 @@ mojom::BlockchainTokenPtr BlockchainRegistry::GetTokenByAddress(
     const std::string& chain_id,
     mojom::CoinType coin,
     const std::string& address) {
-  const auto key = GetTokenListKey(coin, chain_id);
-  if (!token_list_map_.contains(key))
-    return nullptr;
-
-  const auto& tokens = token_list_map_[key];
-  auto token_it = base::ranges::find_if(
-      tokens, [&](const mojom::BlockchainTokenPtr& current_token) {
-        return current_token->contract_address == address;
-      });
-  return token_it == tokens.end() ? nullptr : token_it->Clone();
+  const auto* token =
+      FindToken(chain_id, coin, &TokenListIndex::by_address, address);
+  return token ? token->Clone() : nullptr;
 }
 
 void BlockchainRegistry::GetTokenBySymbol(const std::string& chain_id,
                                           mojom::CoinType coin,
                                           const std::string& symbol,
                                           GetTokenBySymbolCallback callback) {
-  const auto key = GetTokenListKey(coin, chain_id);
-  if (!token_list_map_.contains(key)) {
-    std::move(callback).Run(nullptr);
-    return;
-  }
-  const auto& tokens = token_list_map_[key];
-  auto token_it = base::ranges::find_if(
-      tokens, [&](const mojom::BlockchainTokenPtr& current_token) {
-        return current_token->symbol == symbol;
-      });
-
-  if (token_it == tokens.end()) {
-    std::move(callback).Run(nullptr);
-    return;
-  }
-
-  std::move(callback).Run(token_it->Clone());
+  const auto* token =
+      FindToken(chain_id, coin, &TokenListIndex::by_symbol, symbol);
+  std::move(callback).Run(token ? token->Clone() : nullptr);
 }
 
 void BlockchainRegistry::GetAllTokens(const std::string& chain_id,
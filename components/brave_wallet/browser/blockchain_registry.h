@@ -9,7 +9,9 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/memory/singleton.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/brave_wallet/browser/blockchain_list_parser.h"
 #include "brave/components/brave_wallet/common/brave_wallet.mojom.h"
 #include "build/build_config.h"
@@ -68,7 +70,29 @@ class BlockchainRegistry : public mojom::BlockchainRegistry {
   std::vector<mojom::BlockchainTokenPtr>* GetTokenListFromChainId(
       const std::string& chain_id);
 
+  // Position of the first token with a given contract address or symbol in
+  // one of the lists of |token_list_map_|. Keys point into the tokens of the
+  // list, so the index is rebuilt whenever the list is replaced.
+  struct TokenListIndex {
+    TokenListIndex();
+    TokenListIndex(TokenListIndex&&);
+    TokenListIndex& operator=(TokenListIndex&&);
+    ~TokenListIndex();
+
+    base::flat_map<base::StringPiece, size_t> by_address;
+    base::flat_map<base::StringPiece, size_t> by_symbol;
+  };
+
+  static TokenListIndex BuildTokenListIndex(
+      const std::vector<mojom::BlockchainTokenPtr>& tokens);
+  const mojom::BlockchainTokenPtr* FindToken(
+      const std::string& chain_id,
+      mojom::CoinType coin,
+      base::flat_map<base::StringPiece, size_t> TokenListIndex::*index,
+      const std::string& value) const;
+
   TokenListMap token_list_map_;
+  base::flat_map<std::string, TokenListIndex> token_list_indexes_;
   ChainList chain_list_;
   friend struct base::DefaultSingletonTraits<BlockchainRegistry>;
 
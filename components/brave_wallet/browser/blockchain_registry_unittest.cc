@@ -4,11 +4,16 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "base/logging.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/bind.h"
 #include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/brave_wallet/browser/blockchain_list_parser.h"
 #include "brave/components/brave_wallet/browser/blockchain_registry.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -401,6 +406,128 @@ TEST(BlockchainRegistryUnitTest, GetTokenBySymbol) {
   run_loop5.Run();
 }
 
+TEST(BlockchainRegistryUnitTest, UpdateTokenListForKey) {
+  base::test::TaskEnvironment task_environment;
+  auto* registry = BlockchainRegistry::GetInstance();
+  const std::string key =
+      GetTokenListKey(mojom::CoinType::SOL, mojom::kSolanaMainnet);
+
+  // The first token with a symbol wins, as with a linear search.
+  auto other_usdc = usdc.Clone();
+  other_usdc->contract_address = "OtherUsdc1111111111111111111111111111111111";
+  std::vector<mojom::BlockchainTokenPtr> tokens;
+  tokens.push_back(tsla.Clone());
+  tokens.push_back(usdc.Clone());
+  tokens.push_back(std::move(other_usdc));
+  registry->UpdateTokenList(key, std::move(tokens));
+
+  base::RunLoop run_loop;
+  registry->GetTokenBySymbol(
+      mojom::kSolanaMainnet, mojom::CoinType::SOL, "USDC",
+      base::BindLambdaForTesting([&](mojom::BlockchainTokenPtr token) {
+        EXPECT_EQ(token, usdc);
+        run_loop.Quit();
+      }));
+  run_loop.Run();
+  EXPECT_EQ(registry->GetTokenByAddress(mojom::kSolanaMainnet,
+                                        mojom::CoinType::SOL,
+                                        tsla->contract_address),
+            tsla);
+
+  // Replacing the list drops the tokens that are no longer in it.
+  tokens.clear();
+  tokens.push_back(wrapped_sol.Clone());
+  registry->UpdateTokenList(key, std::move(tokens));
+  EXPECT_FALSE(registry->GetTokenByAddress(
+      mojom::kSolanaMainnet, mojom::CoinType::SOL, tsla->contract_address));
+  EXPECT_EQ(registry->GetTokenByAddress(mojom::kSolanaMainnet,
+                                        mojom::CoinType::SOL,
+                                        wrapped_sol->contract_address),
+            wrapped_sol);
+}
+
+TEST(BlockchainRegistryUnitTest, DISABLED_BenchmarkTokenLookups) {
+  constexpr int kTokens = 20000;
+  constexpr int kIterations = 20;
+  base::test::TaskEnvironment task_environment;
+  auto* registry = BlockchainRegistry::GetInstance();
+  const std::string key =
+      GetTokenListKey(mojom::CoinType::SOL, mojom::kSolanaMainnet);
+
+  // The production lists come with the wallet data component, so build one
+  // of the same size, roughly that of the Solana list with its coingecko ids.
+  std::vector<mojom::BlockchainTokenPtr> tokens;
+  std::vector<mojom::BlockchainTokenPtr> linear_tokens;
+  for (int i = 0; i < kTokens; ++i) {
+    auto token = tsla.Clone();
+    token->contract_address =
+        base::StringPrintf("%08dDuMRRzZxAt913CCdNZCu2eGsDD9kZTrsj2DAZ", i);
+    token->symbol = base::StringPrintf("TKN%d", i);
+    token->coingecko_id = base::StringPrintf("token-%d", i);
+    linear_tokens.push_back(token.Clone());
+    tokens.push_back(std::move(token));
+  }
+
+  base::ElapsedTimer update_timer;
+  registry->UpdateTokenList(key, std::move(tokens));
+  LOG(INFO) << "UpdateTokenList: " << update_timer.Elapsed() << " for "
+            << kTokens << " tokens, index of "
+            << 2 * kTokens * sizeof(std::pair<base::StringPiece, size_t>)
+            << " bytes";
+
+  size_t found = 0;
+  base::ElapsedTimer address_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& token : linear_tokens) {
+      if (registry->GetTokenByAddress(mojom::kSolanaMainnet,
+                                      mojom::CoinType::SOL,
+                                      token->contract_address)) {
+        ++found;
+      }
+    }
+  }
+  const base::TimeDelta address_elapsed = address_timer.Elapsed();
+
+  base::ElapsedTimer symbol_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& token : linear_tokens) {
+      registry->GetTokenBySymbol(
+          mojom::kSolanaMainnet, mojom::CoinType::SOL, token->symbol,
+          base::BindLambdaForTesting([&](mojom::BlockchainTokenPtr result) {
+            if (result)
+              ++found;
+          }));
+    }
+  }
+  const base::TimeDelta symbol_elapsed = symbol_timer.Elapsed();
+  EXPECT_EQ(found, 2u * kIterations * kTokens);
+
+  // The linear search the index replaced, over every 100th token so that it
+  // finishes in reasonable time.
+  size_t linear_lookups = 0;
+  base::ElapsedTimer linear_timer;
+  for (size_t i = 0; i < linear_tokens.size(); i += 100) {
+    const std::string& address = linear_tokens[i]->contract_address;
+    EXPECT_NE(base::ranges::find_if(linear_tokens,
+                                    [&address](const auto& token) {
+                                      return token->contract_address ==
+                                             address;
+                                    }),
+              linear_tokens.end());
+    ++linear_lookups;
+  }
+  const base::TimeDelta linear_elapsed = linear_timer.Elapsed();
+
+  LOG(INFO) << "GetTokenByAddress: "
+            << address_elapsed / (kIterations * kTokens) << " per lookup";
+  LOG(INFO) << "GetTokenBySymbol: "
+            << symbol_elapsed / (kIterations * kTokens) << " per lookup";
+  LOG(INFO) << "Linear search: " << linear_elapsed / linear_lookups
+            << " per lookup";
+
+  registry->UpdateTokenList(key, std::vector<mojom::BlockchainTokenPtr>());
+}
+
 TEST(BlockchainRegistryUnitTest, GetBuyTokens) {
   base::test::TaskEnvironment task_environment;
   auto* registry = BlockchainRegistry::GetInstance();
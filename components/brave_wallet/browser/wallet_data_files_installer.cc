@@ -14,12 +14,14 @@
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/logging.h"
 #include "base/task/task_runner_util.h"
 #include "base/task/thread_pool.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/brave_on_demand_updater.h"
 #include "brave/components/brave_wallet/browser/blockchain_list_parser.h"
+#include "brave/components/brave_wallet/browser/blockchain_list_snapshot.h"
 #include "brave/components/brave_wallet/browser/blockchain_registry.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_constants.h"
 #include "brave/components/brave_wallet/browser/brave_wallet_utils.h"
@@ -52,7 +54,30 @@ static_assert(std::size(kWalletDataFilesSha2Hash) == crypto::kSHA256Length,
 
 absl::optional<base::Version> last_installed_wallet_version;
 
+// Every data file gets a binary snapshot of its parsed contents next to it,
+// written the first time the file is parsed and used instead of the JSON as
+// long as the file doesn't change.
+base::FilePath GetSnapshotPath(const base::FilePath& json_path) {
+  return json_path.AddExtensionASCII("snapshot");
+}
+
+void WriteSnapshot(const base::FilePath& snapshot_path,
+                   const std::string& snapshot) {
+  if (!base::WriteFile(snapshot_path, snapshot)) {
+    VLOG(1) << "Can't write snapshot: " << snapshot_path;
+  }
+}
+
+void UpdateTokenListRegistry(TokenListMap lists) {
+  for (auto& list_pair : lists) {
+    BlockchainRegistry::GetInstance()->UpdateTokenList(
+        list_pair.first, std::move(list_pair.second));
+  }
+}
+
 void OnSanitizedTokenList(mojom::CoinType coin,
+                          const base::FilePath& snapshot_path,
+                          const std::string& json_hash,
                           data_decoder::JsonSanitizer::Result result) {
   TokenListMap lists;
   if (result.error) {
@@ -69,13 +94,13 @@ void OnSanitizedTokenList(mojom::CoinType coin,
     return;
   }
 
-  for (auto& list_pair : lists) {
-    BlockchainRegistry::GetInstance()->UpdateTokenList(
-        list_pair.first, std::move(list_pair.second));
-  }
+  WriteSnapshot(snapshot_path, SerializeTokenListSnapshot(json_hash, lists));
+  UpdateTokenListRegistry(std::move(lists));
 }
 
-void OnSanitizedChainList(data_decoder::JsonSanitizer::Result result) {
+void OnSanitizedChainList(const base::FilePath& snapshot_path,
+                          const std::string& json_hash,
+                          data_decoder::JsonSanitizer::Result result) {
   ChainList chains;
   if (result.error) {
     VLOG(1) << "TokenList JSON validation error:" << *result.error;
@@ -91,6 +116,7 @@ void OnSanitizedChainList(data_decoder::JsonSanitizer::Result result) {
     return;
   }
 
+  WriteSnapshot(snapshot_path, SerializeChainListSnapshot(json_hash, chains));
   BlockchainRegistry::GetInstance()->UpdateChainList(std::move(chains));
 }
 
@@ -105,9 +131,20 @@ void HandleParseTokenList(base::FilePath absolute_install_dir,
     return;
   }
 
+  const base::FilePath snapshot_path = GetSnapshotPath(token_list_json_path);
+  const std::string json_hash = crypto::SHA256HashString(token_list_json);
+  base::MemoryMappedFile snapshot;
+  TokenListMap lists;
+  if (snapshot.Initialize(snapshot_path) &&
+      DeserializeTokenListSnapshot(snapshot.bytes(), json_hash, &lists)) {
+    UpdateTokenListRegistry(std::move(lists));
+    return;
+  }
+
   data_decoder::JsonSanitizer::Sanitize(
       std::move(token_list_json),
-      base::BindOnce(&OnSanitizedTokenList, coin_type));
+      base::BindOnce(&OnSanitizedTokenList, coin_type, snapshot_path,
+                     json_hash));
 }
 
 void HandleParseChainList(base::FilePath absolute_install_dir,
@@ -120,8 +157,19 @@ void HandleParseChainList(base::FilePath absolute_install_dir,
     return;
   }
 
-  data_decoder::JsonSanitizer::Sanitize(std::move(chain_list_json),
-                                        base::BindOnce(&OnSanitizedChainList));
+  const base::FilePath snapshot_path = GetSnapshotPath(chain_list_json_path);
+  const std::string json_hash = crypto::SHA256HashString(chain_list_json);
+  base::MemoryMappedFile snapshot;
+  ChainList chains;
+  if (snapshot.Initialize(snapshot_path) &&
+      DeserializeChainListSnapshot(snapshot.bytes(), json_hash, &chains)) {
+    BlockchainRegistry::GetInstance()->UpdateChainList(std::move(chains));
+    return;
+  }
+
+  data_decoder::JsonSanitizer::Sanitize(
+      std::move(chain_list_json),
+      base::BindOnce(&OnSanitizedChainList, snapshot_path, json_hash));
 }
 
 void ParseTokenListAndUpdateRegistry(const base::FilePath& install_dir) {
@@ -6,8 +6,11 @@
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
+#include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/containers/contains.h"
 #include "base/json/values_util.h"
@@ -64,25 +67,110 @@ Rule CloneRule(const Rule& original_rule) {
               original_rule.session_model);
 }
 
-bool IsActive(const Rule& cookie_rule, const std::vector<Rule>& shield_rules) {
+// Key of the shields rules index: the registrable domain of the pattern's host,
+// or an empty string if it has none (wildcard hosts, IP addresses, public
+// suffixes).
+std::string GetShieldsRuleIndexKey(const ContentSettingsPattern& pattern) {
+  if (pattern.MatchesAllHosts())
+    return std::string();
+  return net::registry_controlled_domains::GetDomainAndRegistry(
+      pattern.GetHost(),
+      net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+}
+
+// Shields rules indexed by GetShieldsRuleIndexKey() of their primary pattern.
+// A pattern can only be as specific as another one if its host is the same
+// host or a subdomain of it, so a cookie rule only has to be checked against
+// the shields rules of its own registrable domain and those without one.
+class ShieldsRuleIndex {
+ public:
+  explicit ShieldsRuleIndex(const std::vector<Rule>& shield_rules)
+      : shield_rules_(shield_rules) {
+    for (size_t i = 0; i < shield_rules_.size(); ++i) {
+      const std::string key =
+          GetShieldsRuleIndexKey(shield_rules_[i].primary_pattern);
+      if (key.empty()) {
+        unindexed_rules_.push_back(i);
+      } else {
+        rules_by_domain_[key].push_back(i);
+      }
+    }
+  }
+  ShieldsRuleIndex(const ShieldsRuleIndex&) = delete;
+  ShieldsRuleIndex& operator=(const ShieldsRuleIndex&) = delete;
+
+  // Returns the first shields rule, in the order they were given, whose
+  // primary pattern is identical to or more specific than |pattern|.
+  const Rule* FindFirstCovering(const ContentSettingsPattern& pattern) const {
+    const std::string key = GetShieldsRuleIndexKey(pattern);
+    if (key.empty()) {
+      for (const Rule& shield_rule : shield_rules_) {
+        if (Covers(shield_rule, pattern))
+          return &shield_rule;
+      }
+      return nullptr;
+    }
+
+    static const base::NoDestructor<std::vector<size_t>> kNoRules;
+    auto it = rules_by_domain_.find(key);
+    const std::vector<size_t>& domain_rules =
+        it == rules_by_domain_.end() ? *kNoRules : it->second;
+    // Both lists are sorted, so merging them keeps the original order.
+    auto domain_it = domain_rules.begin();
+    auto unindexed_it = unindexed_rules_.begin();
+    while (domain_it != domain_rules.end() ||
+           unindexed_it != unindexed_rules_.end()) {
+      size_t index;
+      if (unindexed_it == unindexed_rules_.end() ||
+          (domain_it != domain_rules.end() && *domain_it < *unindexed_it)) {
+        index = *domain_it++;
+      } else {
+        index = *unindexed_it++;
+      }
+      if (Covers(shield_rules_[index], pattern))
+        return &shield_rules_[index];
+    }
+    return nullptr;
+  }
+
+ private:
+  static bool Covers(const Rule& shield_rule,
+                     const ContentSettingsPattern& pattern) {
+    auto compare = shield_rule.primary_pattern.Compare(pattern);
+    return compare == ContentSettingsPattern::IDENTITY ||
+           compare == ContentSettingsPattern::SUCCESSOR;
+  }
+
+  const std::vector<Rule>& shield_rules_;
+  std::unordered_map<std::string, std::vector<size_t>> rules_by_domain_;
+  std::vector<size_t> unindexed_rules_;
+};
+
+bool IsActive(const Rule& cookie_rule, const ShieldsRuleIndex& shield_rules) {
   // don't include default rules in the iterator
   if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
       cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard()) {
     return false;
   }
 
-  for (const auto& shield_rule : shield_rules) {
-    auto primary_compare =
-        shield_rule.primary_pattern.Compare(cookie_rule.secondary_pattern);
-    if (primary_compare == ContentSettingsPattern::IDENTITY ||
-        primary_compare == ContentSettingsPattern::SUCCESSOR) {
-      return ValueToContentSetting(shield_rule.value) != CONTENT_SETTING_BLOCK;
-    }
-  }
+  const Rule* shield_rule =
+      shield_rules.FindFirstCovering(cookie_rule.secondary_pattern);
+  if (shield_rule)
+    return ValueToContentSetting(shield_rule->value) != CONTENT_SETTING_BLOCK;
 
   return true;
 }
 
+// Adds |rule| to |rules|, where the rules are keyed by their patterns. Like
+// with OriginIdentifierValueMap, a later rule for the same patterns replaces
+// an earlier one.
+void SetRule(std::map<BravePrefProvider::PatternPair, Rule>* rules,
+             Rule rule) {
+  BravePrefProvider::PatternPair patterns(rule.primary_pattern,
+                                          rule.secondary_pattern);
+  rules->insert_or_assign(std::move(patterns), std::move(rule));
+}
+
 }  // namespace
 
 // static
@@ -529,17 +617,12 @@ bool BravePrefProvider::SetWebsiteSetting(
     ContentSettingsType content_type,
     base::Value&& in_value,
     const ContentSettingConstraints& constraints) {
-  const auto rule_matcher =
-      [&primary_pattern = std::as_const(primary_pattern),
-       &secondary_pattern = std::as_const(secondary_pattern),
-       &in_value = std::as_const(in_value)](const Rule& rule) {
-        return rule.primary_pattern == primary_pattern &&
-               rule.secondary_pattern == secondary_pattern &&
-               rule.value != in_value;
-      };
   const auto cookie_is_found_in =
-      [&rule_matcher](const std::vector<Rule>& rules) {
-        return base::ranges::any_of(rules, rule_matcher);
+      [patterns = PatternPair(primary_pattern, secondary_pattern),
+       &in_value = std::as_const(in_value)](
+          const std::map<PatternPair, Rule>& rules) {
+        auto it = rules.find(patterns);
+        return it != rules.end() && it->second.value != in_value;
       };
 
   if (content_type == ContentSettingsType::COOKIES) {
@@ -624,10 +707,8 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
 void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
                                           bool incognito) {
   std::vector<Rule> rules;
-  auto old_rules = std::move(brave_cookie_rules_[incognito]);
-  auto old_shields_down_rules = std::move(brave_shield_down_rules_[incognito]);
-
-  brave_cookie_rules_[incognito].clear();
+  std::map<PatternPair, Rule> brave_cookie_rules;
+  std::map<PatternPair, Rule> brave_shield_down_rules;
 
   // kGoogleLoginControlType preference adds an exception for
   // accounts.google.com to access cookies in 3p context to allow login using
@@ -649,7 +730,7 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
              ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
              SessionModel::Durable);
     rules.emplace_back(CloneRule(google_auth_rule));
-    brave_cookie_rules_[incognito].emplace_back(CloneRule(google_auth_rule));
+    SetRule(&brave_cookie_rules, CloneRule(google_auth_rule));
 
     const auto firebase_rule =
         Rule(ContentSettingsPattern::FromString(kFirebasePattern),
@@ -657,7 +738,7 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
              ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
              SessionModel::Durable);
     rules.emplace_back(CloneRule(firebase_rule));
-    brave_cookie_rules_[incognito].emplace_back(CloneRule(firebase_rule));
+    SetRule(&brave_cookie_rules, CloneRule(firebase_rule));
   }
   // non-pref based exceptions should go in the cookie_settings_base.cc
   // chromium_src override
@@ -683,14 +764,15 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
 
   // add brave cookies after checking shield status
   {
+    const ShieldsRuleIndex shield_rule_index(shield_rules);
     auto brave_cookies_iterator = PrefProvider::GetRuleIterator(
         ContentSettingsType::BRAVE_COOKIES, incognito);
     // Matching cookie rules against shield rules.
     while (brave_cookies_iterator && brave_cookies_iterator->HasNext()) {
       auto rule = brave_cookies_iterator->Next();
-      if (IsActive(rule, shield_rules)) {
+      if (IsActive(rule, shield_rule_index)) {
         rules.emplace_back(CloneRule(rule));
-        brave_cookie_rules_[incognito].emplace_back(CloneRule(rule));
+        SetRule(&brave_cookie_rules, CloneRule(rule));
       }
     }
   }
@@ -710,59 +792,78 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
                          shield_rule.primary_pattern,
                          ContentSettingToValue(CONTENT_SETTING_ALLOW),
                          base::Time(), SessionModel::Durable);
-      brave_shield_down_rules_[incognito].emplace_back(
-          Rule(ContentSettingsPattern::Wildcard(), shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
-               SessionModel::Durable));
-      brave_cookie_rules_[incognito].emplace_back(
-          Rule(ContentSettingsPattern::Wildcard(), shield_rule.primary_pattern,
-               ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
-               SessionModel::Durable));
+      SetRule(&brave_shield_down_rules,
+              Rule(ContentSettingsPattern::Wildcard(),
+                   shield_rule.primary_pattern,
+                   ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
+                   SessionModel::Durable));
+      SetRule(&brave_cookie_rules,
+              Rule(ContentSettingsPattern::Wildcard(),
+                   shield_rule.primary_pattern,
+                   ContentSettingToValue(CONTENT_SETTING_ALLOW), base::Time(),
+                   SessionModel::Durable));
     }
   }
 
   // get the list of changes
+  const std::map<PatternPair, Rule>& old_rules = brave_cookie_rules_[incognito];
   std::vector<Rule> brave_cookie_updates;
-  for (const auto& new_rule : brave_cookie_rules_[incognito]) {
-    auto match =
-        base::ranges::find_if(old_rules, [&new_rule](const auto& old_rule) {
-          // we want an exact match here because any change to the rule
-          // is an update
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern &&
-                 ValueToContentSetting(new_rule.value) ==
-                     ValueToContentSetting(old_rule.value);
-        });
-    if (match == old_rules.end()) {
+  for (const auto& [patterns, new_rule] : brave_cookie_rules) {
+    auto match = old_rules.find(patterns);
+    // we want an exact match here because any change to the rule
+    // is an update
+    if (match == old_rules.end() ||
+        ValueToContentSetting(new_rule.value) !=
+            ValueToContentSetting(match->second.value)) {
       brave_cookie_updates.emplace_back(CloneRule(new_rule));
     }
   }
 
   // find any removed rules
-  for (const auto& old_rule : old_rules) {
-    auto match = base::ranges::find_if(
-        brave_cookie_rules_[incognito], [&old_rule](const auto& new_rule) {
-          // we only care about the patterns here because we're looking
-          // for deleted rules, not changed rules
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern;
-        });
-    if (match == brave_cookie_rules_[incognito].end()) {
+  for (const auto& [patterns, old_rule] : old_rules) {
+    // we only care about the patterns here because we're looking
+    // for deleted rules, not changed rules
+    if (!base::Contains(brave_cookie_rules, patterns)) {
       brave_cookie_updates.emplace_back(
           old_rule.primary_pattern, old_rule.secondary_pattern, base::Value(),
           old_rule.expiration, old_rule.session_model);
     }
   }
+  brave_cookie_rules_[incognito] = std::move(brave_cookie_rules);
+  brave_shield_down_rules_[incognito] = std::move(brave_shield_down_rules);
+
+  // Only touch the cookie rules which actually changed, so readers on other
+  // threads aren't held up by the lock for a rebuild of the whole map, and
+  // unchanged rules keep their last modified time.
+  std::map<PatternPair, Rule> effective_rules;
+  for (auto& rule : rules) {
+    SetRule(&effective_rules, std::move(rule));
+  }
+  std::map<PatternPair, Rule>& old_effective_rules =
+      effective_cookie_rules_[incognito];
   {
     base::AutoLock auto_lock(lock_);
-    cookie_rules_[incognito].clear();
-    for (auto&& r : rules) {
+    for (const auto& [patterns, old_rule] : old_effective_rules) {
+      if (!base::Contains(effective_rules, patterns)) {
+        cookie_rules_[incognito].DeleteValue(patterns.first, patterns.second,
+                                             ContentSettingsType::COOKIES);
+      }
+    }
+    for (const auto& [patterns, rule] : effective_rules) {
+      auto old_rule = old_effective_rules.find(patterns);
+      if (old_rule != old_effective_rules.end() &&
+          old_rule->second.value == rule.value &&
+          old_rule->second.expiration == rule.expiration &&
+          old_rule->second.session_model == rule.session_model) {
+        continue;
+      }
       cookie_rules_[incognito].SetValue(
-          r.primary_pattern, r.secondary_pattern, ContentSettingsType::COOKIES,
+          patterns.first, patterns.second, ContentSettingsType::COOKIES,
           store_last_modified_ ? base::Time::Now() : base::Time(),
-          std::move(r.value), {r.expiration, r.session_model});
+          rule.value.Clone(), {rule.expiration, rule.session_model});
     }
   }
+  old_effective_rules = std::move(effective_rules);
 
   // Notify brave cookie changes as ContentSettingsType::COOKIES
   if (initialized_ && (content_type == ContentSettingsType::BRAVE_COOKIES ||
@@ -773,6 +874,10 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
 
 void BravePrefProvider::NotifyChanges(const std::vector<Rule>& rules,
                                       bool incognito) {
+  // The cookie rules are already up to date, so there is nothing to rebuild
+  // when these come back to OnContentSettingChanged().
+  base::AutoReset<bool> notifying_cookie_changes(&notifying_cookie_changes_,
+                                                 true);
   for (const auto& rule : rules) {
     Notify(rule.primary_pattern, rule.secondary_pattern,
            ContentSettingsType::COOKIES);
@@ -793,6 +898,10 @@ void BravePrefProvider::OnContentSettingChanged(
     const ContentSettingsPattern& primary_pattern,
     const ContentSettingsPattern& secondary_pattern,
     ContentSettingsType content_type) {
+  if (content_type == ContentSettingsType::COOKIES &&
+      notifying_cookie_changes_) {
+    return;
+  }
   if (content_type == ContentSettingsType::COOKIES ||
       content_type == ContentSettingsType::BRAVE_COOKIES ||
       content_type == ContentSettingsType::BRAVE_SHIELDS) {
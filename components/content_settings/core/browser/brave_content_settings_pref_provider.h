@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
@@ -25,6 +26,8 @@ namespace content_settings {
 class BravePrefProvider : public PrefProvider,
                           public Observer {
  public:
+  using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
+
   BravePrefProvider(PrefService* prefs,
                     bool off_the_record,
                     bool store_last_modified,
@@ -102,8 +105,15 @@ class BravePrefProvider : public PrefProvider,
   mutable base::Lock lock_;
   std::map<bool /* is_incognito */, OriginIdentifierValueMap> cookie_rules_
       GUARDED_BY(lock_);
-  std::map<bool /* is_incognito */, std::vector<Rule>> brave_cookie_rules_;
-  std::map<bool /* is_incognito */, std::vector<Rule>> brave_shield_down_rules_;
+  // The rules of |cookie_rules_|, to only apply what changed on updates.
+  std::map<bool /* is_incognito */, std::map<PatternPair, Rule>>
+      effective_cookie_rules_;
+  std::map<bool /* is_incognito */, std::map<PatternPair, Rule>>
+      brave_cookie_rules_;
+  std::map<bool /* is_incognito */, std::map<PatternPair, Rule>>
+      brave_shield_down_rules_;
+  // Set while our own cookie change notifications are sent.
+  bool notifying_cookie_changes_ = false;
 
   bool initialized_;
   bool store_last_modified_;
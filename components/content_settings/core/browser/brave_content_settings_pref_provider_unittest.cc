@@ -8,6 +8,7 @@
 
 #include "base/json/values_util.h"
 #include "base/memory/raw_ptr.h"
+#include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/constants/pref_names.h"
@@ -733,4 +734,54 @@ TEST_F(BravePrefProviderTest, EnsureNoWildcardEntries) {
   provider.ShutdownOnUIThread();
 }
 
+TEST_F(BravePrefProviderTest, CookieRulesFollowShieldsRules) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+  const GURL first_party_url("https://first.com");
+  const GURL url("https://example.com");
+  const auto pattern = ContentSettingsPattern::FromString("[*.]example.com");
+
+  // Shields exceptions for other sites don't affect the cookie rule.
+  for (int i = 0; i < 100; ++i) {
+    provider.SetWebsiteSetting(
+        ContentSettingsPattern::FromString(
+            base::StringPrintf("[*.]site%d.com", i)),
+        ContentSettingsPattern::Wildcard(), ContentSettingsType::BRAVE_SHIELDS,
+        ContentSettingToValue(i % 2 ? CONTENT_SETTING_BLOCK
+                                    : CONTENT_SETTING_ALLOW),
+        {});
+  }
+  provider.SetWebsiteSetting(ContentSettingsPattern::Wildcard(), pattern,
+                             ContentSettingsType::BRAVE_COOKIES,
+                             ContentSettingToValue(CONTENT_SETTING_BLOCK), {});
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            TestUtils::GetContentSetting(&provider, first_party_url, url,
+                                         ContentSettingsType::COOKIES, false));
+
+  // Shields down replaces it with an allow rule.
+  provider.SetWebsiteSetting(pattern, ContentSettingsPattern::Wildcard(),
+                             ContentSettingsType::BRAVE_SHIELDS,
+                             ContentSettingToValue(CONTENT_SETTING_BLOCK), {});
+  EXPECT_EQ(CONTENT_SETTING_ALLOW,
+            TestUtils::GetContentSetting(&provider, first_party_url, url,
+                                         ContentSettingsType::COOKIES, false));
+
+  // And shields up brings it back.
+  provider.SetWebsiteSetting(pattern, ContentSettingsPattern::Wildcard(),
+                             ContentSettingsType::BRAVE_SHIELDS, base::Value(),
+                             {});
+  EXPECT_EQ(CONTENT_SETTING_BLOCK,
+            TestUtils::GetContentSetting(&provider, first_party_url, url,
+                                         ContentSettingsType::COOKIES, false));
+
+  provider.SetWebsiteSetting(ContentSettingsPattern::Wildcard(), pattern,
+                             ContentSettingsType::BRAVE_COOKIES, base::Value(),
+                             {});
+  EXPECT_EQ(CONTENT_SETTING_DEFAULT,
+            TestUtils::GetContentSetting(&provider, first_party_url, url,
+                                         ContentSettingsType::COOKIES, false));
+  provider.ShutdownOnUIThread();
+}
+
 }  //  namespace content_settings
@@ -359,6 +359,21 @@ void BraveContentSettingsAgentImpl::SetReduceLanguageEnabled(bool enabled) {
   reduce_language_enabled_ = enabled;
 }
 
+void BraveContentSettingsAgentImpl::SetCosmeticResources(
+    const std::string& url,
+    base::Value::Dict resources) {
+  cosmetic_resources_url_ = url;
+  cosmetic_resources_ = std::move(resources);
+}
+
+absl::optional<base::Value::Dict>
+BraveContentSettingsAgentImpl::TakeCosmeticResources(const GURL& url) {
+  if (!cosmetic_resources_ || cosmetic_resources_url_ != url.spec())
+    return absl::nullopt;
+  cosmetic_resources_url_.clear();
+  return std::exchange(cosmetic_resources_, absl::nullopt);
+}
+
 void BraveContentSettingsAgentImpl::BindBraveShieldsReceiver(
     mojo::PendingAssociatedReceiver<brave_shields::mojom::BraveShields>
         pending_receiver) {
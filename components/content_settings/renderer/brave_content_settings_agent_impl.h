@@ -13,6 +13,7 @@
 
 #include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
+#include "base/values.h"
 #include "brave/components/brave_shields/common/brave_shields.mojom.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "components/content_settings/core/common/content_settings.h"
@@ -21,7 +22,7 @@
 #include "mojo/public/cpp/bindings/associated_receiver_set.h"
 #include "mojo/public/cpp/bindings/associated_remote.h"
 #include "mojo/public/cpp/bindings/pending_associated_receiver.h"
-
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace blink {
@@ -47,6 +48,10 @@ class BraveContentSettingsAgentImpl
 
   bool IsFirstPartyCosmeticFilteringEnabled(const GURL& url) override;
 
+  // Returns the cosmetic filtering resources the browser sent ahead of the
+  // commit of a navigation to |url|, if any. They are only handed out once.
+  absl::optional<base::Value::Dict> TakeCosmeticResources(const GURL& url);
+
  protected:
   bool AllowScript(bool enabled_per_settings) override;
   bool AllowScriptFromSource(bool enabled_per_settings,
@@ -81,6 +86,8 @@ class BraveContentSettingsAgentImpl
   void SetAllowScriptsFromOriginsOnce(
       const std::vector<std::string>& origins) override;
   void SetReduceLanguageEnabled(bool enabled) override;
+  void SetCosmeticResources(const std::string& url,
+                            base::Value::Dict resources) override;
 
   void BindBraveShieldsReceiver(
       mojo::PendingAssociatedReceiver<brave_shields::mojom::BraveShields>
@@ -101,6 +108,11 @@ class BraveContentSettingsAgentImpl
   // Status of "reduce language identifiability" feature.
   bool reduce_language_enabled_;
 
+  // Cosmetic filtering resources received from the browser for the navigation
+  // to |cosmetic_resources_url_|, until the frame picks them up.
+  std::string cosmetic_resources_url_;
+  absl::optional<base::Value::Dict> cosmetic_resources_;
+
   base::flat_map<url::Origin, blink::WebSecurityOrigin>
       cached_ephemeral_storage_origins_;
 
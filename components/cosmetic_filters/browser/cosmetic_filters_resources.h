@@ -38,10 +38,15 @@ class CosmeticFiltersResources final
 
   // Sends back to renderer a response about rules that has to be applied
   // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
+  void GetGenericClassIdFilter(
+      uint64_t known_generation,
+      GetGenericClassIdFilterCallback callback) override;
+
   // Sends the renderer a response including whether or not to apply cosmetic
   // filtering to first party elements along with an initial set of rules and
   // scripts to apply for the given URL.
@@ -5,6 +5,7 @@
 
 #include "brave/components/cosmetic_filters/renderer/cosmetic_filters_js_handler.h"
 
+#include <cstring>
 #include <utility>
 
 #include "base/bind.h"
@@ -151,6 +152,28 @@ int MakeUniquePerfId() {
 
 constexpr const char TRACE_CATEGORY[] = "brave.adblock";
 
+// The generic class and id filter last received from the browser, shared by
+// all frames of the renderer.
+struct GenericClassIdFilter {
+  uint64_t generation = 0;
+  absl::optional<std::vector<uint8_t>> filter;
+};
+
+GenericClassIdFilter& GetGenericClassIdFilter() {
+  static base::NoDestructor<GenericClassIdFilter> filter;
+  return *filter;
+}
+
+void OnGenericClassIdFilter(uint64_t generation,
+                            absl::optional<std::vector<uint8_t>> filter) {
+  GenericClassIdFilter& cached = GetGenericClassIdFilter();
+  // Replies for other frames may arrive out of order; generations only grow.
+  if (generation <= cached.generation)
+    return;
+  cached.generation = generation;
+  cached.filter = std::move(filter);
+}
+
 }  // namespace
 
 namespace cosmetic_filters {
@@ -207,12 +230,13 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
 CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids) {
   if (!EnsureConnected())
     return;
 
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      classes, ids, exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
 }
@@ -226,6 +250,20 @@ bool CosmeticFiltersJSHandler::OnIsFirstParty(const std::string& url_string) {
       url, url_, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
 }
 
+v8::Local<v8::Value> CosmeticFiltersJSHandler::OnGetGenericClassIdFilter(
+    gin::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  const auto& filter = GetGenericClassIdFilter().filter;
+  if (!filter)
+    return v8::Null(isolate);
+
+  v8::Local<v8::ArrayBuffer> buffer =
+      v8::ArrayBuffer::New(isolate, filter->size());
+  if (!filter->empty())
+    memcpy(buffer->GetBackingStore()->Data(), filter->data(), filter->size());
+  return buffer;
+}
+
 void CosmeticFiltersJSHandler::AddJavaScriptObjectToFrame(
     v8::Local<v8::Context> context) {
   v8::Isolate* isolate = blink::MainThreadIsolate();
@@ -282,6 +320,10 @@ void CosmeticFiltersJSHandler::BindFunctionsToObject(
       isolate, javascript_object, "isFirstPartyUrl",
       base::BindRepeating(&CosmeticFiltersJSHandler::OnIsFirstParty,
                           base::Unretained(this)));
+  BindFunctionToObject(
+      isolate, javascript_object, "getGenericClassIdFilter",
+      base::BindRepeating(&CosmeticFiltersJSHandler::OnGetGenericClassIdFilter,
+                          base::Unretained(this)));
 
   if (perf_tracker_) {
     BindFunctionToObject(
@@ -361,6 +403,25 @@ bool CosmeticFiltersJSHandler::ProcessURL(
   enabled_1st_party_cf_ =
       content_settings->IsFirstPartyCosmeticFilteringEnabled(url_);
 
+  // Refreshes the filter for the documents that start from now on, in case
+  // the engines have changed.
+  cosmetic_filters_resources_->GetGenericClassIdFilter(
+      GetGenericClassIdFilter().generation,
+      base::BindOnce(&OnGenericClassIdFilter));
+
+  // The browser usually sends the resources along with the navigation commit,
+  // in which case there's nothing to wait for.
+  resources_dict_ = content_settings->TakeCosmeticResources(url_);
+  UMA_HISTOGRAM_BOOLEAN("Brave.CosmeticFilters.UrlCosmeticResourcesPrefetched",
+                        resources_dict_.has_value());
+  if (resources_dict_) {
+    TRACE_EVENT1("brave.adblock", "UrlCosmeticResourcesPrefetched", "url",
+                 url_.spec());
+    if (callback.has_value())
+      std::move(callback.value()).Run();
+    return true;
+  }
+
   if (callback.has_value()) {
     SCOPED_UMA_HISTOGRAM_TIMER_MICROS(
         "Brave.CosmeticFilters.UrlCosmeticResources");
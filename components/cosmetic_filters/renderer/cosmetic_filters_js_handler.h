@@ -20,6 +20,10 @@
 #include "url/gurl.h"
 #include "v8/include/v8.h"
 
+namespace gin {
+class Arguments;
+}  // namespace gin
+
 namespace cosmetic_filters {
 
 // CosmeticFiltersJSHandler class is responsible for JS execution inside a
@@ -37,7 +41,8 @@ class CosmeticFiltersJSHandler {
   void AddJavaScriptObjectToFrame(v8::Local<v8::Context> context);
   // Fetches an initial set of resources to inject into the page if cosmetic
   // filtering is enabled, and returns whether or not to proceed with cosmetic
-  // filtering.
+  // filtering. Resources the browser already sent along with the navigation
+  // are used without asking for them again.
   bool ProcessURL(const GURL& url, absl::optional<base::OnceClosure> callback);
   void ApplyRules(bool de_amp_enabled);
 
@@ -60,13 +65,17 @@ class CosmeticFiltersJSHandler {
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
   // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids);
 
   void OnUrlCosmeticResources(base::OnceClosure callback,
                               base::Value result);
   void CSSRulesRoutine(const base::Value::Dict& resources_dict);
   void OnHiddenClassIdSelectors(base::Value::Dict result);
   bool OnIsFirstParty(const std::string& url_string);
+  // Returns the generic class and id filter as an ArrayBuffer, or null if the
+  // renderer has none (yet).
+  v8::Local<v8::Value> OnGetGenericClassIdFilter(gin::Arguments* args);
   int OnEventBegin(const std::string& event_name);
   void OnEventEnd(const std::string& event_name, int);
 
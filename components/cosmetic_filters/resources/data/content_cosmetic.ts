@@ -40,6 +40,12 @@ let fetchNewClassIdRulesTimeoutId: number | undefined
 const queriedIds = new Set<string>()
 const queriedClasses = new Set<string>()
 
+// The browser's filter of the classes and ids that have generic hide rules,
+// see components/brave_shields/browser/generic_class_id_filter.h. Classes and
+// ids it rules out are never sent. Undefined until the renderer has a filter,
+// in which case everything is sent.
+let genericClassIdFilter: Uint8Array | undefined
+
 // Each of these get setup once the mutation observer starts running.
 let notYetQueriedClasses: string[] = []
 let notYetQueriedIds: string[] = []
@@ -144,6 +150,61 @@ const ShouldThrottleFetchNewClassIdsRules = (): boolean => {
   return false
 }
 
+const loadGenericClassIdFilter = () => {
+  if (genericClassIdFilter !== undefined) {
+    return
+  }
+  // Callback to c++ renderer process
+  // @ts-expect-error
+  const filter: ArrayBuffer | null = cf_worker.getGenericClassIdFilter()
+  if (filter) {
+    genericClassIdFilter = new Uint8Array(filter)
+  }
+}
+
+// Must match GenericClassIdFilterMayContain() in generic_class_id_filter.cc.
+const mayHaveGenericRules = (key: string): boolean => {
+  const filter = genericClassIdFilter
+  if (!filter || filter.length < 2) {
+    return true
+  }
+  let h1 = 0x811c9dc5
+  for (let i = 0; i < key.length; i++) {
+    h1 = Math.imul(h1 ^ key.charCodeAt(i), 0x01000193)
+  }
+  let h2 = Math.imul(h1 ^ (h1 >>> 16), 0x85ebca6b)
+  h2 = Math.imul(h2 ^ (h2 >>> 13), 0xc2b2ae35)
+  h2 = (h2 ^ (h2 >>> 16)) | 1
+  const bits = (filter.length - 1) * 8
+  for (let i = 0; i < filter[0]; i++) {
+    const bit = ((h1 + Math.imul(i, h2)) >>> 0) % bits
+    if (!(filter[1 + (bit >>> 3)] & (1 << (bit & 7)))) {
+      return false
+    }
+  }
+  return true
+}
+
+const queueClass = (className: string) => {
+  if (!className || queriedClasses.has(className)) {
+    return
+  }
+  queriedClasses.add(className)
+  if (mayHaveGenericRules('.' + className)) {
+    notYetQueriedClasses.push(className)
+  }
+}
+
+const queueId = (id: string) => {
+  if (!id || queriedIds.has(id)) {
+    return
+  }
+  queriedIds.add(id)
+  if (mayHaveGenericRules('#' + id)) {
+    notYetQueriedIds.push(id)
+  }
+}
+
 const fetchNewClassIdRules = () => {
   if ((!notYetQueriedClasses || notYetQueriedClasses.length === 0) &&
     (!notYetQueriedIds || notYetQueriedIds.length === 0)) {
@@ -151,10 +212,7 @@ const fetchNewClassIdRules = () => {
   }
   // Callback to c++ renderer process
   // @ts-expect-error
-  cf_worker.hiddenClassIdSelectors(
-      JSON.stringify({
-        classes: notYetQueriedClasses, ids: notYetQueriedIds
-      }))
+  cf_worker.hiddenClassIdSelectors(notYetQueriedClasses, notYetQueriedIds)
   notYetQueriedClasses = []
   notYetQueriedIds = []
 }
@@ -187,6 +245,7 @@ const handleMutations: MutationCallback = (mutations: MutationRecord[]) => {
   // @ts-expect-error
   const eventId: number | undefined = cf_worker.onHandleMutationsBegin?.()
 
+  loadGenericClassIdFilter()
   let mutationScore = 0
   for (const aMutation of mutations) {
     if (aMutation.type === 'attributes') {
@@ -197,20 +256,13 @@ const handleMutations: MutationCallback = (mutations: MutationRecord[]) => {
         case 'class':
           mutationScore += changedElm.classList.length
           for (const aClassName of changedElm.classList.values()) {
-            if (!queriedClasses.has(aClassName)) {
-              notYetQueriedClasses.push(aClassName)
-              queriedClasses.add(aClassName)
-            }
+            queueClass(aClassName)
           }
           break
 
         case 'id':
-          const mutatedId = changedElm.id
           mutationScore++
-          if (!queriedIds.has(mutatedId)) {
-            notYetQueriedIds.push(mutatedId)
-            queriedIds.add(mutatedId)
-          }
+          queueId(changedElm.id)
           break
       }
     } else if (aMutation.addedNodes.length > 0) {
@@ -220,19 +272,12 @@ const handleMutations: MutationCallback = (mutations: MutationRecord[]) => {
           continue
         }
         mutationScore++
-        const id = element.id
-        if (id && !queriedIds.has(id)) {
-          notYetQueriedIds.push(id)
-          queriedIds.add(id)
-        }
+        queueId(element.id)
         const classList = element.classList
         if (classList) {
           mutationScore += classList.length
           for (const className of classList.values()) {
-            if (className && !queriedClasses.has(className)) {
-              notYetQueriedClasses.push(className)
-              queriedClasses.add(className)
-            }
+            queueClass(className)
           }
         }
       }
@@ -592,18 +637,15 @@ const querySelectors = () => {
   // @ts-expect-error
   const eventId: number | undefined = cf_worker.onQuerySelectorsBegin?.()
 
+  loadGenericClassIdFilter()
   const elmWithClassOrId = document.querySelectorAll('[class],[id]')
   for (const elm of elmWithClassOrId) {
     for (const aClassName of elm.classList.values()) {
-      if (aClassName && !queriedClasses.has(aClassName)) {
-        notYetQueriedClasses.push(aClassName)
-        queriedClasses.add(aClassName)
-      }
+      queueClass(aClassName)
     }
     const elmId = elm.getAttribute('id')
-    if (elmId && !queriedIds.has(elmId)) {
-      notYetQueriedIds.push(elmId)
-      queriedIds.add(elmId)
+    if (elmId) {
+      queueId(elmId)
     }
   }
 
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
 #include "brave/components/de_amp/browser/de_amp_throttle.h"
 #include "brave/components/de_amp/browser/de_amp_util.h"
@@ -68,22 +69,29 @@ void DeAmpURLLoader::OnBodyReadable(MojoResult) {
     ForwardBodyToClient();
     return;
   }
-  if (!CheckBufferedBody(kMaxBytesToCheck - buffered_body_.size())) {
+  const size_t previous_size = buffered_body_.size();
+  if (!CheckBufferedBody(kMaxBytesToCheck - read_bytes_)) {
     return;
   }
-  if (MaybeRedirectToCanonicalLink()) {
+  // Only the newly read bytes are scanned; the detector keeps track of any
+  // tag that straddles two reads.
+  const AmpDetector::Result result = amp_detector_.Append(
+      base::StringPiece(buffered_body_).substr(previous_size));
+  if (result == AmpDetector::Result::kFoundCanonicalLink &&
+      MaybeRedirectToCanonicalLink()) {
     // Only abort if we know we're successfully going to the canonical URL
     Abort();
     return;
   }
-  // If we were not redirected and we didn't find AMP, or
-  // if we did find AMP previously and we've already read more bytes than
-  // max, complete the load.
-  if (!found_amp_ || read_bytes_ >= kMaxBytesToCheck) {
-    found_amp_ = false;  // reset
+  // Complete the load once we know the page is not AMP, once we found a
+  // canonical link we're not going to follow, or once we've already read
+  // more bytes than max.
+  if (result != AmpDetector::Result::kNeedMoreData ||
+      read_bytes_ >= kMaxBytesToCheck) {
     CompleteLoading(std::move(buffered_body_));
     return;
   }
+  PassThroughBufferedBody();
   body_consumer_watcher_.ArmOrNotify();
 }
 
@@ -92,37 +100,39 @@ bool DeAmpURLLoader::MaybeRedirectToCanonicalLink() {
     return false;
   }
 
-  // If we are not already on an AMP page, check if this chunk has the AMP HTML
-  if (!found_amp_ && !CheckIfAmpPage(buffered_body_)) {
+  DCHECK(amp_detector_.found_amp());
+  const GURL canonical_url(amp_detector_.canonical_link());
+  // Validate the found canonical AMP URL
+  if (!VerifyCanonicalAmpUrl(canonical_url, response_url_)) {
+    VLOG(2) << __func__ << " canonical link verification failed "
+            << canonical_url;
     return false;
   }
-
-  found_amp_ = true;  // If we get to this point, we know we have an AMP page
-
-  auto canonical_link = FindCanonicalAmpUrl(buffered_body_);
-  if (!canonical_link.has_value()) {
-    VLOG(2) << __func__ << canonical_link.error();
+  // Attempt to go to the canonical URL
+  VLOG(2) << __func__ << " de-amping and loading " << canonical_url;
+  if (!de_amp_throttle_->OpenCanonicalURL(canonical_url, response_url_)) {
+    VLOG(2) << __func__ << " failed to open canonical url: " << canonical_url;
     return false;
   }
+  return true;
+}
 
-  bool redirected = false;
-  const GURL canonical_url(canonical_link.value());
-  // Validate the found canonical AMP URL
-  if (VerifyCanonicalAmpUrl(canonical_url, response_url_)) {
-    // Attempt to go to the canonical URL
-    VLOG(2) << __func__ << " de-amping and loading " << canonical_url;
-    if (de_amp_throttle_->OpenCanonicalURL(canonical_url, response_url_)) {
-      redirected = true;
-    } else {
-      VLOG(2) << __func__ << " failed to open canonical url: " << canonical_url;
-    }
-  } else {
-    VLOG(2) << __func__ << " canonical link verification failed "
-            << canonical_url;
+// Bytes that the detector has already inspected don't need to stay in
+// |buffered_body_| until the decision is made. Move as many as the pipe
+// accepts right away so they are ready for the client as soon as the
+// throttle resumes; whatever doesn't fit is sent by CompleteLoading().
+void DeAmpURLLoader::PassThroughBufferedBody() {
+  if (buffered_body_.empty() || !body_producer_handle_)
+    return;
+  uint32_t bytes_written = buffered_body_.size();
+  MojoResult result = body_producer_handle_->WriteData(
+      buffered_body_.data(), &bytes_written, MOJO_WRITE_DATA_FLAG_NONE);
+  if (result == MOJO_RESULT_OK) {
+    buffered_body_.erase(0, bytes_written);
   }
-  // At this point we've either redirected, or we should stop trying
-  found_amp_ = false;
-  return redirected;
+  // MOJO_RESULT_SHOULD_WAIT: the pipe is full, keep buffering.
+  // MOJO_RESULT_FAILED_PRECONDITION: the consumer went away, which
+  // SendBufferedBodyToClient() will notice and abort on.
 }
 
 void DeAmpURLLoader::OnBodyWritable(MojoResult r) {
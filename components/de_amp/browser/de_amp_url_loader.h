@@ -13,6 +13,7 @@
 #include "base/memory/weak_ptr.h"
 #include "base/task/sequenced_task_runner.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
+#include "brave/components/de_amp/browser/de_amp_util.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "services/network/public/mojom/url_loader.mojom.h"
@@ -45,10 +46,11 @@ class DeAmpURLLoader : public body_sniffer::BodySnifferURLLoader {
   void OnBodyReadable(MojoResult) override;
   void OnBodyWritable(MojoResult) override;
   bool MaybeRedirectToCanonicalLink();
+  void PassThroughBufferedBody();
   void ForwardBodyToClient();
 
   base::WeakPtr<DeAmpThrottle> de_amp_throttle_;
-  bool found_amp_ = false;
+  AmpDetector amp_detector_;
 };
 
 }  // namespace de_amp
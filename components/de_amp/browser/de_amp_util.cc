@@ -7,6 +7,7 @@
 
 #include "base/feature_list.h"
 #include "base/no_destructor.h"
+#include "base/strings/string_util.h"
 #include "brave/components/de_amp/common/features.h"
 #include "brave/components/de_amp/common/pref_names.h"
 #include "components/prefs/pref_service.h"
@@ -37,6 +38,51 @@ RE2::Options InitRegexOptions() {
   return opt;
 }
 
+const re2::RE2& GetDetectAmpRegex() {
+  static const base::NoDestructor<re2::RE2> kDetectAmpRegex(
+      kDetectAmpPattern, InitRegexOptions());
+  return *kDetectAmpRegex;
+}
+
+const re2::RE2& GetFindCanonicalLinkTagRegex() {
+  static const base::NoDestructor<re2::RE2> kFindCanonicalLinkTagRegex(
+      kFindCanonicalLinkTagPattern, InitRegexOptions());
+  return *kFindCanonicalLinkTagRegex;
+}
+
+const re2::RE2& GetFindCanonicalHrefInTagRegex() {
+  static const base::NoDestructor<re2::RE2> kFindCanonicalHrefInTagRegex(
+      kFindCanonicalHrefInTagPattern, InitRegexOptions());
+  return *kFindCanonicalHrefInTagRegex;
+}
+
+// Same set of characters as \s in RE2.
+bool IsRegexWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+// Reads the element name of the tag opened by the '<' at |pos|, skipping
+// whitespace before the name as the patterns above do. On success |name_end|
+// is the index of the first character after the name. Returns false if
+// |buffer| ends before that character is available.
+bool ReadTagName(base::StringPiece buffer,
+                 size_t pos,
+                 base::StringPiece* name,
+                 size_t* name_end) {
+  DCHECK_EQ('<', buffer[pos]);
+  size_t start = pos + 1;
+  while (start < buffer.size() && IsRegexWhitespace(buffer[start]))
+    ++start;
+  size_t end = start;
+  while (end < buffer.size() && base::IsAsciiAlphaNumeric(buffer[end]))
+    ++end;
+  if (end == buffer.size())
+    return false;
+  *name = buffer.substr(start, end - start);
+  *name_end = end;
+  return true;
+}
+
 }  // namespace
 
 bool IsDeAmpEnabled(PrefService* prefs) {
@@ -53,20 +99,17 @@ bool VerifyCanonicalAmpUrl(const GURL& canonical_link,
 }
 
 bool CheckIfAmpPage(const std::string& body) {
-  auto opt = InitRegexOptions();
   // The order of running these regexes is important:
   // we first get the relevant HTML tag and then find the info.
-  static const base::NoDestructor<re2::RE2> kGetHtmlTagRegex(kGetHtmlTagPattern,
-                                                             opt);
-  static const base::NoDestructor<re2::RE2> kDetectAmpRegex(kDetectAmpPattern,
-                                                            opt);
+  static const base::NoDestructor<re2::RE2> kGetHtmlTagRegex(
+      kGetHtmlTagPattern, InitRegexOptions());
 
   std::string html_tag;
   if (!RE2::PartialMatch(body, *kGetHtmlTagRegex, &html_tag)) {
     // Early exit if we can't find HTML tag - malformed document (or error)
     return false;
   }
-  if (!RE2::PartialMatch(html_tag, *kDetectAmpRegex)) {
+  if (!RE2::PartialMatch(html_tag, GetDetectAmpRegex())) {
     // Not AMP
     return false;
   }
@@ -75,22 +118,16 @@ bool CheckIfAmpPage(const std::string& body) {
 
 base::expected<std::string, std::string> FindCanonicalAmpUrl(
     const std::string& body) {
-  auto opt = InitRegexOptions();
   // The order of running these regexes is important
-  static const base::NoDestructor<re2::RE2> kFindCanonicalLinkTagRegex(
-      kFindCanonicalLinkTagPattern, opt);
-  static const base::NoDestructor<re2::RE2> kFindCanonicalHrefInTagRegex(
-      kFindCanonicalHrefInTagPattern, opt);
-
   std::string link_tag;
-  if (!RE2::PartialMatch(body, *kFindCanonicalLinkTagRegex, &link_tag)) {
+  if (!RE2::PartialMatch(body, GetFindCanonicalLinkTagRegex(), &link_tag)) {
     // Can't find link tag, exit
     return base::unexpected("Couldn't find link tag");
   }
   std::string canonical_url;
   // Find href in canonical link tag
   // Check there is only 1 href captured, else fail
-  if (!RE2::PartialMatch(link_tag, *kFindCanonicalHrefInTagRegex,
+  if (!RE2::PartialMatch(link_tag, GetFindCanonicalHrefInTagRegex(),
                          &canonical_url)) {
     // Didn't find canonical link, potentially try again
     return base::unexpected("Couldn't find canonical URL in link tag");
@@ -98,4 +135,109 @@ base::expected<std::string, std::string> FindCanonicalAmpUrl(
   return canonical_url;
 }
 
+AmpDetector::AmpDetector() = default;
+AmpDetector::~AmpDetector() = default;
+
+AmpDetector::Result AmpDetector::Append(base::StringPiece data) {
+  if (result_ != Result::kNeedMoreData)
+    return result_;
+
+  pending_.append(data.data(), data.size());
+  while (result_ == Result::kNeedMoreData) {
+    if (!(found_amp_ ? ScanForCanonicalLink() : ScanForHtmlTag()))
+      break;
+  }
+  // Everything before the scan position has been inspected for good.
+  pending_.erase(0, scan_position_);
+  scan_position_ = 0;
+  return result_;
+}
+
+bool AmpDetector::ScanForHtmlTag() {
+  while (true) {
+    const size_t pos = pending_.find('<', scan_position_);
+    if (pos == std::string::npos) {
+      scan_position_ = pending_.size();
+      return false;
+    }
+    base::StringPiece name;
+    size_t name_end;
+    if (!ReadTagName(pending_, pos, &name, &name_end)) {
+      scan_position_ = pos;
+      return false;
+    }
+    if (base::EqualsCaseInsensitiveASCII(name, "head") ||
+        base::EqualsCaseInsensitiveASCII(name, "body")) {
+      // The document has started without an AMP <html> root.
+      result_ = Result::kNotAmp;
+      return true;
+    }
+    if (!base::EqualsCaseInsensitiveASCII(name, "html")) {
+      scan_position_ = pos + 1;
+      continue;
+    }
+    if (!IsRegexWhitespace(pending_[name_end])) {
+      // An attribute-less <html> can't carry the AMP marker.
+      if (pending_[name_end] == '>' || pending_[name_end] == '/') {
+        result_ = Result::kNotAmp;
+        return true;
+      }
+      scan_position_ = pos + 1;
+      continue;
+    }
+    const size_t tag_end = pending_.find('>', name_end);
+    if (tag_end == std::string::npos) {
+      scan_position_ = pos;
+      return false;
+    }
+    const base::StringPiece html_tag(pending_.data() + pos, tag_end - pos + 1);
+    if (!RE2::PartialMatch(html_tag, GetDetectAmpRegex())) {
+      result_ = Result::kNotAmp;
+      return true;
+    }
+    found_amp_ = true;
+    scan_position_ = tag_end + 1;
+    return true;
+  }
+}
+
+bool AmpDetector::ScanForCanonicalLink() {
+  while (true) {
+    const size_t pos = pending_.find('<', scan_position_);
+    if (pos == std::string::npos) {
+      scan_position_ = pending_.size();
+      return false;
+    }
+    base::StringPiece name;
+    size_t name_end;
+    if (!ReadTagName(pending_, pos, &name, &name_end)) {
+      scan_position_ = pos;
+      return false;
+    }
+    if (!base::EqualsCaseInsensitiveASCII(name, "link") ||
+        !IsRegexWhitespace(pending_[name_end])) {
+      scan_position_ = pos + 1;
+      continue;
+    }
+    const size_t tag_end = pending_.find('>', name_end);
+    if (tag_end == std::string::npos) {
+      scan_position_ = pos;
+      return false;
+    }
+    scan_position_ = tag_end + 1;
+    // Both patterns stop at the first '>' so matching against the single tag
+    // is equivalent to matching against the whole body.
+    const base::StringPiece tag(pending_.data() + pos, tag_end - pos + 1);
+    std::string link_tag;
+    if (!RE2::PartialMatch(tag, GetFindCanonicalLinkTagRegex(), &link_tag))
+      continue;
+    if (!RE2::PartialMatch(link_tag, GetFindCanonicalHrefInTagRegex(),
+                           &canonical_link_)) {
+      continue;
+    }
+    result_ = Result::kFoundCanonicalLink;
+    return true;
+  }
+}
+
 }  // namespace de_amp
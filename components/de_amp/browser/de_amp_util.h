@@ -8,6 +8,7 @@
 
 #include <string>
 
+#include "base/strings/string_piece.h"
 #include "base/types/expected.h"
 #include "components/prefs/pref_service.h"
 #include "url/gurl.h"
@@ -26,6 +27,46 @@ base::expected<std::string, std::string> FindCanonicalAmpUrl(
 
 // Validation check for canonical URL
 bool VerifyCanonicalAmpUrl(const GURL& canonical_url, const GURL& original_url);
+
+// Incremental version of CheckIfAmpPage + FindCanonicalAmpUrl for streamed
+// bodies. Each call to Append() resumes scanning where the previous call
+// stopped, so the total work is linear in the body size no matter how it is
+// chunked. Only the bytes of a tag that is still incomplete are retained.
+class AmpDetector {
+ public:
+  enum class Result {
+    // Haven't seen the <html> tag yet, or this is an AMP page and the
+    // canonical <link> hasn't arrived yet.
+    kNeedMoreData,
+    // The document root (or the first <head>/<body>) is not an AMP <html>.
+    kNotAmp,
+    // AMP page with a canonical link, available via canonical_link().
+    kFoundCanonicalLink,
+  };
+
+  AmpDetector();
+  AmpDetector(const AmpDetector&) = delete;
+  AmpDetector& operator=(const AmpDetector&) = delete;
+  ~AmpDetector();
+
+  Result Append(base::StringPiece data);
+
+  Result result() const { return result_; }
+  bool found_amp() const { return found_amp_; }
+  const std::string& canonical_link() const { return canonical_link_; }
+
+ private:
+  // Returns false if more data is needed to make progress.
+  bool ScanForHtmlTag();
+  bool ScanForCanonicalLink();
+
+  std::string pending_;
+  size_t scan_position_ = 0;
+  bool found_amp_ = false;
+  Result result_ = Result::kNeedMoreData;
+  std::string canonical_link_;
+};
+
 }  // namespace de_amp
 
 #endif  // BRAVE_COMPONENTS_DE_AMP_BROWSER_DE_AMP_UTIL_H_
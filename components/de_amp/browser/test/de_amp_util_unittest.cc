@@ -4,15 +4,48 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/de_amp/browser/de_amp_util.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/strings/string_piece.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace de_amp {
 
 /** Test helpers */
+// Feeds |body| to an AmpDetector |chunk_size| bytes at a time, so that tags
+// get split across Append() calls at every possible position.
+void CheckAmpDetectorResult(const std::string& expected_link,
+                            const std::string& body,
+                            const bool expected_detect_amp,
+                            const bool expected_find_canonical,
+                            size_t chunk_size) {
+  SCOPED_TRACE(testing::Message() << "chunk size " << chunk_size);
+  AmpDetector detector;
+  base::StringPiece remaining(body);
+  while (!remaining.empty() &&
+         detector.result() == AmpDetector::Result::kNeedMoreData) {
+    detector.Append(remaining.substr(0, chunk_size));
+    remaining.remove_prefix(std::min(chunk_size, remaining.size()));
+  }
+  EXPECT_EQ(expected_detect_amp, detector.found_amp());
+  if (expected_find_canonical) {
+    EXPECT_EQ(AmpDetector::Result::kFoundCanonicalLink, detector.result());
+    EXPECT_EQ(expected_link, detector.canonical_link());
+  } else {
+    EXPECT_NE(AmpDetector::Result::kFoundCanonicalLink, detector.result());
+  }
+}
+
 void CheckFindCanonicalLinkResult(const std::string& expected_link,
                                   const std::string& body,
                                   const bool expected_detect_amp,
                                   const bool expected_find_canonical) {
+  for (size_t chunk_size : {size_t{1}, size_t{7}, body.size()}) {
+    CheckAmpDetectorResult(expected_link, body, expected_detect_amp,
+                           expected_find_canonical, chunk_size);
+  }
   const bool actual_detect_amp = CheckIfAmpPage(body);
   EXPECT_EQ(expected_detect_amp, actual_detect_amp);
   if (expected_detect_amp) {  // Only check for canonical link if this is an AMP
@@ -24,6 +57,7 @@ void CheckFindCanonicalLinkResult(const std::string& expected_link,
     }
   }
 }
+
 void CheckCheckCanonicalLinkResult(const std::string& canonical_link,
                                    const std::string& original,
                                    const bool expected) {
@@ -242,4 +276,26 @@ TEST(DeAmpUtilUnitTest, CanonicalLinkIsRelative) {
   CheckCheckCanonicalLinkResult("abc", "https://amp.xyz.com", false);
 }
 
+TEST(DeAmpUtilUnitTest, AmpDetectorStopsAtNonAmpRoot) {
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNeedMoreData,
+            detector.Append("<!doctype html>\n<ht"));
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Append("ml lang=\"en\"><head>"));
+  // Later data is not inspected once a decision has been made.
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Append("<html amp><link rel=\"canonical\" "
+                            "href=\"https://abc.com\"/>"));
+  EXPECT_FALSE(detector.found_amp());
+}
+
+TEST(DeAmpUtilUnitTest, AmpDetectorNoHtmlTag) {
+  AmpDetector detector;
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            detector.Append("<!doctype html><head><title>x</title></head>"));
+  AmpDetector attributeless;
+  EXPECT_EQ(AmpDetector::Result::kNotAmp,
+            attributeless.Append("<!doctype html><HTML><head>"));
+}
+
 }  // namespace de_amp
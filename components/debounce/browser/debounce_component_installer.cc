@@ -11,7 +11,6 @@
 #include "base/base_paths.h"
 #include "base/bind.h"
 #include "base/command_line.h"
-#include "base/containers/flat_set.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/task/thread_pool.h"
@@ -51,14 +50,22 @@ void DebounceComponentInstaller::OnDATFileDataReady(
     LOG(WARNING) << parsed_rules.error();
     return;
   }
-  rules_.clear();
-  host_cache_.clear();
-  rules_ = std::move(parsed_rules.value().first);
-  host_cache_ = parsed_rules.value().second;
+  rules_by_etldp1_.clear();
+  rules_ = std::move(parsed_rules.value());
+  rules_by_etldp1_ = DebounceRule::BuildIndex(rules_);
   for (Observer& observer : observers_)
     observer.OnRulesReady(this);
 }
 
+const std::vector<const DebounceRule*>*
+DebounceComponentInstaller::GetRulesForETLDPlusOne(
+    const std::string& etldp1) const {
+  auto it = rules_by_etldp1_.find(etldp1);
+  if (it == rules_by_etldp1_.end())
+    return nullptr;
+  return &it->second;
+}
+
 void DebounceComponentInstaller::OnComponentReady(
     const std::string& component_id,
     const base::FilePath& install_dir,
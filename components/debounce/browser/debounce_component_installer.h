@@ -10,7 +10,6 @@
 #include <string>
 #include <vector>
 
-#include "base/containers/flat_set.h"
 #include "base/files/file_path.h"
 #include "base/json/json_value_converter.h"
 #include "base/memory/weak_ptr.h"
@@ -44,7 +43,10 @@ class DebounceComponentInstaller
   const std::vector<std::unique_ptr<DebounceRule>>& rules() const {
     return rules_;
   }
-  const base::flat_set<std::string>& host_cache() const { return host_cache_; }
+  // Returns the rules that may apply to URLs on |etldp1|, in file order, or
+  // nullptr if there are none.
+  const std::vector<const DebounceRule*>* GetRulesForETLDPlusOne(
+      const std::string& etldp1) const;
 
   // implementation of brave_component_updater::LocalDataFilesObserver
   void OnComponentReady(const std::string& component_id,
@@ -71,7 +73,8 @@ class DebounceComponentInstaller
 
   base::ObserverList<Observer> observers_;
   std::vector<std::unique_ptr<DebounceRule>> rules_;
-  base::flat_set<std::string> host_cache_;
+  // Points into |rules_|; rebuilt whenever |rules_| changes.
+  DebounceRuleIndex rules_by_etldp1_;
   base::FilePath resource_dir_;
 
   base::WeakPtrFactory<DebounceComponentInstaller> weak_factory_{this};
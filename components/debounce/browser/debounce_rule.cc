@@ -5,6 +5,9 @@
 
 #include "brave/components/debounce/browser/debounce_rule.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -120,9 +123,7 @@ const std::string DebounceRule::GetETLDForDebounce(const std::string& host) {
 }
 
 // static
-base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                         base::flat_set<std::string>>,
-               std::string>
+base::expected<std::vector<std::unique_ptr<DebounceRule>>, std::string>
 DebounceRule::ParseRules(const std::string& contents) {
   if (contents.empty()) {
     return base::unexpected("Could not obtain debounce configuration");
@@ -131,25 +132,62 @@ DebounceRule::ParseRules(const std::string& contents) {
   if (!root) {
     return base::unexpected("Failed to parse debounce configuration");
   }
-  std::vector<std::string> hosts;
   std::vector<std::unique_ptr<DebounceRule>> rules;
   base::JSONValueConverter<DebounceRule> converter;
   for (base::Value& it : root->GetList()) {
     std::unique_ptr<DebounceRule> rule = std::make_unique<DebounceRule>();
     if (!converter.Convert(it, rule.get()))
       continue;
-    for (const URLPattern& pattern : rule->include_pattern_set()) {
-      if (!pattern.host().empty()) {
-        const std::string etldp1 =
-            DebounceRule::GetETLDForDebounce(pattern.host());
-        if (!etldp1.empty())
-          hosts.push_back(std::move(etldp1));
+    rule->CompileParamRegex();
+    rules.push_back(std::move(rule));
+  }
+  return rules;
+}
+
+// static
+DebounceRuleIndex DebounceRule::BuildIndex(
+    const std::vector<std::unique_ptr<DebounceRule>>& rules) {
+  // Rule positions per eTLD+1, plus the positions of rules that can match
+  // any eTLD+1. Positions keep the merged lists in file order, which matters
+  // because the first rule that applies wins.
+  std::map<std::string, std::vector<size_t>> positions_by_etldp1;
+  std::vector<size_t> wildcard_positions;
+  for (size_t i = 0; i < rules.size(); ++i) {
+    bool is_wildcard = false;
+    for (const URLPattern& pattern : rules[i]->include_pattern_set()) {
+      const std::string etldp1 =
+          pattern.host().empty() ? std::string()
+                                 : GetETLDForDebounce(pattern.host());
+      if (etldp1.empty()) {
+        // Either any host or something like "*.co.uk", which spans many
+        // eTLD+1s.
+        is_wildcard = true;
+        continue;
       }
+      std::vector<size_t>& positions = positions_by_etldp1[etldp1];
+      if (positions.empty() || positions.back() != i)
+        positions.push_back(i);
     }
-    rules.push_back(std::move(rule));
+    if (is_wildcard)
+      wildcard_positions.push_back(i);
+  }
+
+  std::vector<DebounceRuleIndex::value_type> entries;
+  entries.reserve(positions_by_etldp1.size());
+  for (auto& [etldp1, positions] : positions_by_etldp1) {
+    std::vector<size_t> merged;
+    merged.reserve(positions.size() + wildcard_positions.size());
+    std::set_union(positions.begin(), positions.end(),
+                   wildcard_positions.begin(), wildcard_positions.end(),
+                   std::back_inserter(merged));
+    std::vector<const DebounceRule*> etldp1_rules;
+    etldp1_rules.reserve(merged.size());
+    for (size_t position : merged)
+      etldp1_rules.push_back(rules[position].get());
+    entries.emplace_back(etldp1, std::move(etldp1_rules));
   }
-  return std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                   base::flat_set<std::string>>(std::move(rules), hosts);
+  // |entries| is already sorted since it comes from a std::map.
+  return DebounceRuleIndex(base::sorted_unique, std::move(entries));
 }
 
 bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
@@ -169,29 +207,36 @@ bool DebounceRule::CheckPrefForRule(const PrefService* prefs) const {
   return true;
 }
 
-bool DebounceRule::ValidateAndParsePatternRegex(
-    const std::string& pattern,
-    const std::string& path,
-    std::string* parsed_value) const {
-  if (pattern.length() > kMaxLengthRegexPattern) {
+void DebounceRule::CompileParamRegex() {
+  if (action_ != kDebounceRegexPath)
+    return;
+  if (param_.length() > kMaxLengthRegexPattern) {
     VLOG(1) << "Debounce regex pattern exceeds max length: "
             << kMaxLengthRegexPattern;
-    return false;
+    return;
   }
   re2::RE2::Options options;
   options.set_max_mem(kMaxMemoryPerRegexPattern);
-  const re2::RE2 pattern_regex(pattern, options);
+  auto pattern_regex = std::make_unique<re2::RE2>(param_, options);
 
-  if (!pattern_regex.ok()) {
-    VLOG(1) << "Debounce rule has param: " << pattern
+  if (!pattern_regex->ok()) {
+    VLOG(1) << "Debounce rule has param: " << param_
             << " which is an invalid regex pattern";
-    return false;
+    return;
   }
-  if (pattern_regex.NumberOfCapturingGroups() < 1) {
-    VLOG(1) << "Debounce rule has param: " << pattern
+  if (pattern_regex->NumberOfCapturingGroups() < 1) {
+    VLOG(1) << "Debounce rule has param: " << param_
             << " which captures < 1 groups";
-    return false;
+    return;
   }
+  param_regex_ = std::move(pattern_regex);
+}
+
+bool DebounceRule::ParsePathWithParamRegex(const std::string& path,
+                                           std::string* parsed_value) const {
+  if (!param_regex_)
+    return false;
+  const re2::RE2& pattern_regex = *param_regex_;
 
   // Get matching capture groups by applying regex to the path
   size_t number_of_capturing_groups =
@@ -250,7 +295,7 @@ bool DebounceRule::Apply(const GURL& original_url,
     // Important: Apply param regex to ONLY the path of original URL.
     auto path = original_url.path();
 
-    if (!ValidateAndParsePatternRegex(param_, path, &unescaped_value)) {
+    if (!ParsePathWithParamRegex(path, &unescaped_value)) {
       VLOG(1) << "Debounce regex parsing failed";
       return false;
     }
@@ -8,10 +8,9 @@
 
 #include <memory>
 #include <string>
-#include <utility>
 #include <vector>
 
-#include "base/containers/flat_set.h"
+#include "base/containers/flat_map.h"
 #include "base/json/json_value_converter.h"
 #include "base/strings/escape.h"
 #include "base/types/expected.h"
@@ -21,6 +20,10 @@
 
 class GURL;
 
+namespace re2 {
+class RE2;
+}  // namespace re2
+
 namespace debounce {
 
 enum DebounceAction {
@@ -36,9 +39,17 @@ enum DebouncePrependScheme {
   kDebounceSchemePrependHttps
 };
 
+class DebounceRule;
+
+// Maps an eTLD+1 to the rules that may apply to URLs on it, in file order.
+using DebounceRuleIndex =
+    base::flat_map<std::string, std::vector<const DebounceRule*>>;
+
 class DebounceRule {
  public:
   DebounceRule();
+  DebounceRule(const DebounceRule&) = delete;
+  DebounceRule& operator=(const DebounceRule&) = delete;
   ~DebounceRule();
 
   // Registers the mapping between JSON field names and the members in this
@@ -49,10 +60,15 @@ class DebounceRule {
                                   DebounceAction* field);
   static bool ParsePrependScheme(base::StringPiece value,
                                  DebouncePrependScheme* field);
-  static base::expected<std::pair<std::vector<std::unique_ptr<DebounceRule>>,
-                                  base::flat_set<std::string>>,
+  static base::expected<std::vector<std::unique_ptr<DebounceRule>>,
                         std::string>
   ParseRules(const std::string& contents);
+  // Builds the eTLD+1 index over |rules|, which must outlive it. Rules with an
+  // include pattern that isn't tied to a single eTLD+1 (e.g. "*://*/*") are
+  // added to every entry, so that the index yields exactly the rules that
+  // could match a URL on that eTLD+1.
+  static DebounceRuleIndex BuildIndex(
+      const std::vector<std::unique_ptr<DebounceRule>>& rules);
   static const std::string GetETLDForDebounce(const std::string& host);
   static bool GetURLPatternSetFromValue(const base::Value* value,
                                         extensions::URLPatternSet* result);
@@ -66,15 +82,18 @@ class DebounceRule {
 
  private:
   bool CheckPrefForRule(const PrefService* prefs) const;
-  bool ValidateAndParsePatternRegex(const std::string& pattern,
-                                    const std::string& path,
-                                    std::string* parsed_value) const;
+  // Compiles |param_| for kDebounceRegexPath rules. Called once at parse time.
+  void CompileParamRegex();
+  bool ParsePathWithParamRegex(const std::string& path,
+                               std::string* parsed_value) const;
   extensions::URLPatternSet include_pattern_set_;
   extensions::URLPatternSet exclude_pattern_set_;
   DebounceAction action_;
   DebouncePrependScheme prepend_scheme_;
   std::string param_;
   std::string pref_;
+  // Null if |param_| is not a usable regex.
+  std::unique_ptr<re2::RE2> param_regex_;
 };
 
 }  // namespace debounce
@@ -9,10 +9,9 @@
 #include <string>
 #include <vector>
 
-#include "base/containers/contains.h"
-#include "base/containers/flat_set.h"
 #include "base/logging.h"
 #include "brave/components/debounce/browser/debounce_component_installer.h"
+#include "brave/components/debounce/browser/debounce_rule.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "url/origin.h"
 
@@ -27,19 +26,15 @@ DebounceService::~DebounceService() = default;
 
 bool DebounceService::Debounce(const GURL& original_url,
                                GURL* final_url) const {
-  // Check host cache to see if this URL needs to have any debounce rules
-  // applied.
-  const base::flat_set<std::string>& host_cache =
-      component_installer_->host_cache();
+  // Only the rules indexed under this URL's eTLD+1 can possibly apply.
   const std::string etldp1 =
       DebounceRule::GetETLDForDebounce(original_url.host());
-  if (!base::Contains(host_cache, etldp1))
+  const std::vector<const DebounceRule*>* rules =
+      component_installer_->GetRulesForETLDPlusOne(etldp1);
+  if (!rules)
     return false;
 
-  const std::vector<std::unique_ptr<DebounceRule>>& rules =
-      component_installer_->rules();
-
-  for (const std::unique_ptr<DebounceRule>& rule : rules) {
+  for (const DebounceRule* rule : *rules) {
     if (rule->Apply(original_url, final_url, prefs_)) {
       if (original_url != *final_url) {
         return true;
@@ -4,9 +4,18 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "brave/components/debounce/browser/debounce_rule.h"
+
+#include "base/base_paths.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
 #include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/path_service.h"
+#include "base/timer/elapsed_timer.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/testing_pref_service.h"
+#include "extensions/common/url_pattern.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 #include "url/gurl.h"
@@ -17,7 +26,7 @@ namespace debounce {
 std::vector<std::unique_ptr<DebounceRule>> StringToRules(std::string contents) {
   auto parsed = DebounceRule::ParseRules(contents);
   EXPECT_TRUE(parsed.has_value());
-  return std::move(parsed.value().first);
+  return std::move(parsed.value());
 }
 
 void CheckApplyResult(DebounceRule* rule,
@@ -445,4 +454,127 @@ TEST(DebounceRuleUnitTest, CatchMultiplePathsForSameInclude) {
   }
 }
 
+TEST(DebounceRuleUnitTest, IndexByETLDPlusOne) {
+  const std::string contents = R"json(
+
+      [{
+          "include": ["*://a.test.com/*"],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }, {
+          "include": ["*://*/*?wildcard=*"],
+          "exclude": [],
+          "action": "redirect",
+          "param": "wildcard"
+      }, {
+          "include": ["*://*.co.uk/*", "*://b.test.com/*", "*://c.test.com/*"],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }, {
+          "include": ["*://other.org/*"],
+          "exclude": [],
+          "action": "redirect",
+          "param": "url"
+      }]
+
+      )json";
+  std::vector<std::unique_ptr<DebounceRule>> rules = StringToRules(contents);
+  ASSERT_EQ(4u, rules.size());
+  DebounceRuleIndex index = DebounceRule::BuildIndex(rules);
+
+  // Only eTLD+1s named by a rule are indexed, wildcard rules are merged into
+  // each entry in file order and a rule is listed once per entry.
+  ASSERT_EQ(2u, index.size());
+  EXPECT_EQ(
+      (std::vector<const DebounceRule*>{rules[0].get(), rules[1].get(),
+                                        rules[2].get()}),
+      index["test.com"]);
+  EXPECT_EQ(
+      (std::vector<const DebounceRule*>{rules[1].get(), rules[2].get(),
+                                        rules[3].get()}),
+      index["other.org"]);
+}
+
+// Compares walking every rule with using the eTLD+1 index. Uses the rules
+// file passed with --debounce-rules-file, e.g. the production debounce.json
+// from the component, and falls back to the browser test data. Run manually
+// with --gtest_also_run_disabled_tests.
+TEST(DebounceRuleUnitTest, DISABLED_BenchmarkIndexedDispatch) {
+  constexpr int kIterations = 100;
+  base::FilePath rules_path =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          "debounce-rules-file");
+  if (rules_path.empty()) {
+    ASSERT_TRUE(base::PathService::Get(base::DIR_SOURCE_ROOT, &rules_path));
+    rules_path = rules_path.AppendASCII("brave/test/data/debounce-data/1")
+                     .AppendASCII("debounce.json");
+  }
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(rules_path, &contents));
+  std::vector<std::unique_ptr<DebounceRule>> rules = StringToRules(contents);
+  DebounceRuleIndex index = DebounceRule::BuildIndex(rules);
+  TestingPrefServiceSimple prefs;
+
+  // One URL per include pattern host, plus the same amount of navigations to
+  // hosts no rule cares about.
+  std::vector<GURL> urls;
+  for (const std::unique_ptr<DebounceRule>& rule : rules) {
+    for (const URLPattern& pattern : rule->include_pattern_set()) {
+      if (pattern.host().empty())
+        continue;
+      urls.emplace_back("https://www." + pattern.host() +
+                        "/links/1/https://brave.com/?url=https://brave.com/");
+      urls.emplace_back("https://unrelated-" + pattern.host() + ".example/");
+    }
+  }
+  ASSERT_FALSE(urls.empty());
+
+  size_t linear_matches = 0;
+  base::ElapsedTimer linear_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const GURL& url : urls) {
+      // The former host cache check.
+      if (!index.contains(DebounceRule::GetETLDForDebounce(url.host())))
+        continue;
+      GURL final_url;
+      for (const std::unique_ptr<DebounceRule>& rule : rules) {
+        if (rule->Apply(url, &final_url, &prefs) && url != final_url) {
+          ++linear_matches;
+          break;
+        }
+      }
+    }
+  }
+  const base::TimeDelta linear_time = linear_timer.Elapsed();
+
+  size_t indexed_matches = 0;
+  base::ElapsedTimer indexed_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const GURL& url : urls) {
+      auto it = index.find(DebounceRule::GetETLDForDebounce(url.host()));
+      if (it == index.end())
+        continue;
+      GURL final_url;
+      for (const DebounceRule* rule : it->second) {
+        if (rule->Apply(url, &final_url, &prefs) && url != final_url) {
+          ++indexed_matches;
+          break;
+        }
+      }
+    }
+  }
+  const base::TimeDelta indexed_time = indexed_timer.Elapsed();
+
+  EXPECT_EQ(linear_matches, indexed_matches);
+  const size_t navigations = urls.size() * kIterations;
+  LOG(INFO) << rules.size() << " rules, " << index.size() << " eTLD+1s, "
+            << navigations << " navigations";
+  LOG(INFO) << "all rules: "
+            << linear_time.InMicrosecondsF() / navigations << " us/navigation";
+  LOG(INFO) << "indexed: " << indexed_time.InMicrosecondsF() / navigations
+            << " us/navigation";
+}
+
 }  // namespace debounce
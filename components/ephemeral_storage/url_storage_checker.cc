@@ -7,11 +7,10 @@
 
 #include <utility>
 
+#include "base/containers/contains.h"
 #include "components/services/storage/public/mojom/local_storage_control.mojom.h"
+#include "components/services/storage/public/mojom/storage_usage_info.mojom.h"
 #include "content/public/browser/storage_partition.h"
-#include "mojo/public/cpp/bindings/pending_remote.h"
-#include "mojo/public/cpp/bindings/receiver.h"
-#include "mojo/public/cpp/bindings/remote.h"
 #include "services/network/public/mojom/cookie_manager.mojom.h"
 
 namespace ephemeral_storage {
@@ -22,6 +21,7 @@ UrlStorageChecker::UrlStorageChecker(
     Callback callback)
     : storage_partition_(storage_partition),
       url_(url),
+      storage_key_(url::Origin::Create(url)),
       callback_(std::move(callback)) {
   DCHECK(storage_partition_);
   DCHECK(url_.is_valid());
@@ -31,35 +31,52 @@ UrlStorageChecker::UrlStorageChecker(
 UrlStorageChecker::~UrlStorageChecker() = default;
 
 void UrlStorageChecker::StartCheck() {
+  pending_checks_ = 2;
   storage_partition_->GetCookieManagerForBrowserProcess()->GetCookieList(
       url_, net::CookieOptions::MakeAllInclusive(),
       net::CookiePartitionKeyCollection::ContainsAll(),
       base::BindOnce(&UrlStorageChecker::OnGetCookieList, this));
+  // LocalStorageControl has no per-storage-key query, and a bound StorageArea
+  // only offers Get() of a known key or GetAll() of its whole contents. Usage
+  // is the cheaper of the two: one metadata entry per storage key in the
+  // partition (also covering areas with data not committed to disk yet), with
+  // no values loaded. That is linear in the number of origins, which is fine
+  // for a check that only runs when 1PES is considered for a URL, but it
+  // shouldn't be moved onto a per-navigation path.
+  storage_partition_->GetLocalStorageControl()->GetUsage(
+      base::BindOnce(&UrlStorageChecker::OnGetLocalStorageUsage, this));
 }
 
 void UrlStorageChecker::OnGetCookieList(
     const std::vector<net::CookieWithAccessResult>& included_cookies,
     const std::vector<net::CookieWithAccessResult>& excluded_cookies) {
-  if (!included_cookies.empty()) {
-    std::move(callback_).Run(false);
-    return;
-  }
+  OnCheckDone(!included_cookies.empty());
+}
 
-  storage_partition_->GetLocalStorageControl()->BindStorageArea(
-      blink::StorageKey(url::Origin::Create(url_)),
-      local_storage_area_.BindNewPipeAndPassReceiver());
-  local_storage_area_->GetAll(
-      {}, base::BindOnce(&UrlStorageChecker::OnGetLocalStorageData, this));
+void UrlStorageChecker::OnGetLocalStorageUsage(
+    std::vector<storage::mojom::StorageUsageInfoPtr> usage_infos) {
+  OnCheckDone(base::Contains(
+      usage_infos, storage_key_,
+      [](const storage::mojom::StorageUsageInfoPtr& usage_info) {
+        return usage_info->storage_key;
+      }));
 }
 
-void UrlStorageChecker::OnGetLocalStorageData(
-    std::vector<blink::mojom::KeyValuePtr> local_storage_data) {
-  if (!local_storage_data.empty()) {
+void UrlStorageChecker::OnCheckDone(bool has_data) {
+  DCHECK_GT(pending_checks_, 0);
+  --pending_checks_;
+  if (!callback_) {
+    return;
+  }
+
+  if (has_data) {
     std::move(callback_).Run(false);
     return;
   }
 
-  std::move(callback_).Run(true);
+  if (pending_checks_ == 0) {
+    std::move(callback_).Run(true);
+  }
 }
 
 }  // namespace ephemeral_storage
@@ -11,9 +11,9 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_refptr.h"
-#include "mojo/public/cpp/bindings/remote.h"
+#include "components/services/storage/public/mojom/storage_usage_info.mojom-forward.h"
 #include "net/cookies/canonical_cookie.h"
-#include "third_party/blink/public/mojom/dom_storage/storage_area.mojom.h"
+#include "third_party/blink/public/common/storage_key/storage_key.h"
 #include "url/gurl.h"
 
 namespace content {
@@ -22,7 +22,13 @@ class StoragePartition;
 
 namespace ephemeral_storage {
 
-// Performs cookies and localStorage data existence check for a URL.
+// Performs cookies and localStorage data existence check for a URL. Both
+// checks run at the same time and the result is reported as soon as one of
+// them finds data. localStorage is checked with the usage metadata of the
+// storage service, so the contents of an origin's storage area are never
+// loaded or copied over. There is no per-storage-key usage query, so the
+// check is linear in the number of origins with localStorage; it's meant for
+// the occasional 1PES decision, not for every navigation.
 class UrlStorageChecker : public base::RefCounted<UrlStorageChecker> {
  public:
   using Callback = base::OnceCallback<void(bool is_storage_empty)>;
@@ -41,14 +47,16 @@ class UrlStorageChecker : public base::RefCounted<UrlStorageChecker> {
       const std::vector<net::CookieWithAccessResult>& included_cookies,
       const std::vector<net::CookieWithAccessResult>& excluded_cookies);
 
-  void OnGetLocalStorageData(
-      std::vector<blink::mojom::KeyValuePtr> local_storage_data);
+  void OnGetLocalStorageUsage(
+      std::vector<storage::mojom::StorageUsageInfoPtr> usage_infos);
+
+  void OnCheckDone(bool has_data);
 
   content::StoragePartition* storage_partition_ = nullptr;
   GURL url_;
+  blink::StorageKey storage_key_;
   Callback callback_;
-
-  mojo::Remote<blink::mojom::StorageArea> local_storage_area_;
+  int pending_checks_ = 0;
 };
 
 }  // namespace ephemeral_storage
@@ -6,7 +6,9 @@
 #include "brave/components/greaselion/browser/greaselion_service_impl.h"
 
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,16 +18,20 @@
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/containers/contains.h"
+#include "base/containers/cxx20_erase.h"
 #include "base/feature_list.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/one_shot_event.h"
 #include "base/ranges/algorithm.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/task_runner_util.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "base/version.h"
 #include "brave/components/brave_component_updater/browser/features.h"
@@ -35,6 +41,7 @@
 #include "brave/components/version_info//version_info.h"
 #include "chrome/browser/extensions/extension_service.h"
 #include "components/version_info/version_info.h"
+#include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "extensions/browser/computed_hashes.h"
 #include "extensions/browser/extension_registry.h"
@@ -55,6 +62,18 @@ namespace {
 
 constexpr char kRunAtDocumentStart[] = "document_start";
 
+// Converted extensions are kept in the cache directory under a key derived
+// from everything that goes into them. Bump the version when the conversion
+// changes, so that extensions converted by older browsers aren't reused.
+constexpr char kCacheDirectoryName[] = "Cache";
+constexpr char kCacheVersion[] = "1";
+// Cached extensions which no profile has used for this long are deleted.
+constexpr base::TimeDelta kCacheEntryLifetime = base::Days(30);
+
+// The cache directory is shared by all profiles, so expired entries are only
+// deleted once per browser run, before any profile has used the cache.
+bool g_expired_cache_entries_deleted = false;
+
 bool ShouldComputeHashesForResource(
     const base::FilePath& relative_resource_path) {
   std::vector<base::FilePath::StringType> components =
@@ -62,26 +81,156 @@ bool ShouldComputeHashesForResource(
   return !components.empty() && components[0] != extensions::kMetadataFolder;
 }
 
+// Greaselion scripts are not signed, but the public key for an extension
+// doubles as its unique identity, and we need one of those, so we add the
+// rule name to a known Brave domain and hash the result to create a
+// public key.
+std::string GetPublicKey(const std::string& script_name) {
+  char raw[crypto::kSHA256Length] = {0};
+  std::string key;
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
+      !base::FeatureList::IsEnabled(
+          brave_component_updater::kUseDevUpdaterUrl)) {
+    crypto::SHA256HashString(BUILDFLAG(UPDATER_DEV_ENDPOINT) + script_name, raw,
+                             crypto::kSHA256Length);
+  } else {
+    crypto::SHA256HashString(BUILDFLAG(UPDATER_PROD_ENDPOINT) + script_name,
+                             raw, crypto::kSHA256Length);
+  }
+  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
+  return key;
+}
+
+// Adds |value| to |hash| with its length first, so that consecutive values
+// can't be confused with each other.
+void HashValue(crypto::SecureHash* hash, base::StringPiece value) {
+  const uint64_t size = value.size();
+  hash->Update(&size, sizeof(size));
+  hash->Update(value.data(), value.size());
+}
+
+// Returns a key identifying the extension a rule is converted to: a hash of
+// the rule and of the contents of its scripts and messages. Returns an empty
+// string if any of those files can't be read.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+std::string GetCacheKey(const greaselion::GreaselionRule& rule) {
+  std::unique_ptr<crypto::SecureHash> hash =
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+  HashValue(hash.get(), kCacheVersion);
+  HashValue(hash.get(), rule.name());
+  HashValue(hash.get(), GetPublicKey(rule.name()));
+  HashValue(hash.get(), rule.run_at());
+  for (const auto& url_pattern : rule.url_patterns())
+    HashValue(hash.get(), url_pattern);
+
+  for (const auto& script : rule.scripts()) {
+    std::string contents;
+    if (!base::ReadFileToString(script, &contents)) {
+      LOG(ERROR) << "Could not read Greaselion script at path: "
+                 << script.LossyDisplayName();
+      return std::string();
+    }
+    HashValue(hash.get(), script.BaseName().AsUTF8Unsafe());
+    HashValue(hash.get(), contents);
+  }
+
+  if (!rule.messages().empty()) {
+    std::vector<base::FilePath> message_files;
+    base::FileEnumerator enumerator(rule.messages(), true,
+                                    base::FileEnumerator::FILES);
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      message_files.push_back(path);
+    }
+    std::sort(message_files.begin(), message_files.end());
+    for (const auto& path : message_files) {
+      base::FilePath relative_path;
+      std::string contents;
+      if (!rule.messages().AppendRelativePath(path, &relative_path) ||
+          !base::ReadFileToString(path, &contents)) {
+        LOG(ERROR) << "Could not read Greaselion messages at path: "
+                   << path.LossyDisplayName();
+        return std::string();
+      }
+      HashValue(hash.get(), relative_path.AsUTF8Unsafe());
+      HashValue(hash.get(), contents);
+    }
+  }
+
+  uint8_t digest[crypto::kSHA256Length];
+  hash->Finish(digest, sizeof(digest));
+  return base::HexEncode(digest, sizeof(digest));
+}
+
+// Keeps a cache entry from expiring while it's in use.
+void TouchCacheEntry(const base::FilePath& path) {
+  const base::Time now = base::Time::Now();
+  base::TouchFile(path, now, now);
+}
+
+std::vector<std::string> GetCacheKeysOnTaskRunner(
+    const std::vector<greaselion::GreaselionRule>& rules,
+    const base::FilePath& install_dir) {
+  const base::FilePath cache_dir =
+      greaselion::GreaselionServiceImpl::GetCacheDirectory(install_dir);
+  std::vector<std::string> keys;
+  for (const auto& rule : rules) {
+    keys.push_back(GetCacheKey(rule));
+    // The extensions of unchanged rules stay loaded without going through
+    // LoadCachedExtension(), so their entries are touched here instead.
+    const base::FilePath path = cache_dir.AppendASCII(keys.back());
+    if (!keys.back().empty() && base::DirectoryExists(path))
+      TouchCacheEntry(path);
+  }
+  return keys;
+}
+
+scoped_refptr<Extension> LoadCachedExtension(const base::FilePath& path) {
+  std::string error;
+  scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
+      path, ManifestLocation::kComponent, Extension::NO_FLAGS, &error);
+  if (!extension.get()) {
+    LOG(ERROR) << "Could not load Greaselion extension";
+    LOG(ERROR) << error;
+    base::DeletePathRecursively(path);
+    return nullptr;
+  }
+  TouchCacheEntry(path);
+  return extension;
+}
+
 // Wraps a Greaselion rule in a component. The component is stored as
-// an unpacked extension in the user data dir. Returns a valid
+// an unpacked extension in the cache directory in the user data dir, where
+// it is reused as long as |cache_key| stays the same. Returns a valid
 // extension that the caller should take ownership of, or nullptr.
 //
 // NOTE: This function does file IO and should not be called on the UI thread.
-absl::optional<greaselion::GreaselionServiceImpl::GreaselionConvertedExtension>
-ConvertGreaselionRuleToExtensionOnTaskRunner(
+scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
     const greaselion::GreaselionRule& rule,
-    const base::FilePath& install_dir) {
+    const base::FilePath& install_dir,
+    const std::string& cache_key) {
+  const base::FilePath cache_dir =
+      greaselion::GreaselionServiceImpl::GetCacheDirectory(install_dir)
+          .AppendASCII(cache_key);
+  if (base::DirectoryExists(cache_dir)) {
+    if (auto extension = LoadCachedExtension(cache_dir))
+      return extension;
+  }
+
   base::FilePath install_temp_dir =
       extensions::file_util::GetInstallTempDir(install_dir);
   if (install_temp_dir.empty()) {
     LOG(ERROR) << "Could not get path to profile temp directory";
-    return absl::nullopt;
+    return nullptr;
   }
 
   base::ScopedTempDir temp_dir;
   if (!temp_dir.CreateUniqueTempDirUnderPath(install_temp_dir)) {
     LOG(ERROR) << "Could not create Greaselion temp directory";
-    return absl::nullopt;
+    return nullptr;
   }
 
   // Create the manifest
@@ -92,25 +241,8 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   root.SetByDottedPath(extensions::manifest_keys::kManifestVersion, 2);
 
   // Create the public key.
-  // Greaselion scripts are not signed, but the public key for an extension
-  // doubles as its unique identity, and we need one of those, so we add the
-  // rule name to a known Brave domain and hash the result to create a
-  // public key.
-  char raw[crypto::kSHA256Length] = {0};
-  std::string key;
   std::string script_name = rule.name();
-  const base::CommandLine& command_line =
-      *base::CommandLine::ForCurrentProcess();
-  if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
-      !base::FeatureList::IsEnabled(
-          brave_component_updater::kUseDevUpdaterUrl)) {
-    crypto::SHA256HashString(BUILDFLAG(UPDATER_DEV_ENDPOINT) + script_name, raw,
-                             crypto::kSHA256Length);
-  } else {
-    crypto::SHA256HashString(BUILDFLAG(UPDATER_PROD_ENDPOINT) + script_name,
-                             raw, crypto::kSHA256Length);
-  }
-  base::Base64Encode(base::StringPiece(raw, crypto::kSHA256Length), &key);
+  std::string key = GetPublicKey(script_name);
 
   root.SetByDottedPath(extensions::manifest_keys::kName, script_name);
   root.SetByDottedPath(extensions::manifest_keys::kVersion, "1.0");
@@ -157,7 +289,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
   // files to disk.
   if (!serializer.Serialize(base::Value(std::move(root)))) {
     LOG(ERROR) << "Could not write Greaselion manifest";
-    return absl::nullopt;
+    return nullptr;
   }
 
   // Copy the messages directory to our extension directory.
@@ -167,7 +299,7 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
             temp_dir.GetPath().AppendASCII("_locales"), true)) {
       LOG(ERROR) << "Could not copy Greaselion messages directory at path: "
                  << rule.messages().LossyDisplayName();
-      return absl::nullopt;
+      return nullptr;
     }
   }
 
@@ -177,41 +309,47 @@ ConvertGreaselionRuleToExtensionOnTaskRunner(
                         temp_dir.GetPath().Append(script.BaseName()))) {
       LOG(ERROR) << "Could not copy Greaselion script at path: "
           << script.LossyDisplayName();
-      return absl::nullopt;
+      return nullptr;
     }
   }
 
-  std::string error;
-  scoped_refptr<Extension> extension = extensions::file_util::LoadExtension(
-      temp_dir.GetPath(), ManifestLocation::kComponent, Extension::NO_FLAGS,
-      &error);
-  if (!extension.get()) {
-    LOG(ERROR) << "Could not load Greaselion extension";
-    LOG(ERROR) << error;
-    return absl::nullopt;
-  }
-
   // Calculate and write computed hashes.
   absl::optional<extensions::ComputedHashes::Data> computed_hashes_data =
       extensions::ComputedHashes::Compute(
-          extension->path(),
+          temp_dir.GetPath(),
           extension_misc::kContentVerificationDefaultBlockSize,
           extensions::IsCancelledCallback(),
           base::BindRepeating(&ShouldComputeHashesForResource));
   if (computed_hashes_data) {
     extensions::ComputedHashes(std::move(*computed_hashes_data))
         .WriteToFile(
-            extensions::file_util::GetComputedHashesPath(extension->path()));
+            extensions::file_util::GetComputedHashesPath(temp_dir.GetPath()));
+  }
+
+  // Move the extension into the cache. If that fails because another profile
+  // has just converted the same rule, use its copy instead; |temp_dir|
+  // deletes ours.
+  if ((!base::CreateDirectory(cache_dir.DirName()) ||
+       !base::Move(temp_dir.GetPath(), cache_dir)) &&
+      !base::DirectoryExists(cache_dir)) {
+    LOG(ERROR) << "Could not move Greaselion extension to: "
+               << cache_dir.LossyDisplayName();
+    return nullptr;
   }
 
-  // Take ownership of this temporary directory; the service will delete it on
-  // exit
-  return std::make_pair(extension, temp_dir.Take());
+  return LoadCachedExtension(cache_dir);
 }
 
-void DeleteExtensionDirs(const std::vector<base::FilePath>& extension_dirs) {
-  for (const auto& extension_dir : extension_dirs) {
-    base::DeletePathRecursively(extension_dir);
+// Deletes the cached extensions which haven't been used for a while, e.g.
+// those of rules which have since changed.
+void DeleteExpiredCacheEntries(const base::FilePath& cache_dir) {
+  const base::Time expiry_time = base::Time::Now() - kCacheEntryLifetime;
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (enumerator.GetInfo().GetLastModifiedTime() < expiry_time)
+      base::DeletePathRecursively(path);
   }
 }
 
@@ -244,15 +382,28 @@ GreaselionServiceImpl::GreaselionServiceImpl(
     state_[static_cast<GreaselionFeature>(i)] = false;
   // Static-value features
   state_[GreaselionFeature::SUPPORTS_MINIMUM_BRAVE_VERSION] = true;
+  // This runs ahead of any cache key computation or conversion on
+  // |task_runner_|, so no entry is in use yet. Entries used later on are kept
+  // fresh by every update, and aren't deleted before the next browser run.
+  if (!g_expired_cache_entries_deleted) {
+    g_expired_cache_entries_deleted = true;
+    task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&DeleteExpiredCacheEntries,
+                                  GetCacheDirectory(install_directory_)));
+  }
 }
 
 GreaselionServiceImpl::~GreaselionServiceImpl() = default;
 
+// static
+base::FilePath GreaselionServiceImpl::GetCacheDirectory(
+    const base::FilePath& install_directory) {
+  return install_directory.AppendASCII(kCacheDirectoryName);
+}
+
 void GreaselionServiceImpl::Shutdown() {
   download_service_->RemoveObserver(this);
   extension_registry_->RemoveObserver(this);
-  task_runner_->PostTask(FROM_HERE,
-                         base::BindOnce(&DeleteExtensionDirs, extension_dirs_));
 }
 
 bool GreaselionServiceImpl::IsGreaselionExtension(const std::string& id) {
@@ -270,83 +421,122 @@ void GreaselionServiceImpl::UpdateInstalledExtensions() {
     return;
   }
   update_in_progress_ = true;
-  if (greaselion_extensions_.empty()) {
-    // No Greaselion extensions are currently installed, so we can move on to
-    // the install phase immediately.
-    CreateAndInstallExtensions();
+
+  std::vector<GreaselionRule> rules;
+  for (const std::unique_ptr<GreaselionRule>& rule :
+       *download_service_->rules()) {
+    if (rule->Matches(state_, browser_version_) &&
+        rule->has_unknown_preconditions() == false) {
+      rules.push_back(*rule);
+    }
+  }
+  if (rules.empty()) {
+    // No rules match, so there is nothing to read from disk; all that's left
+    // to do is unloading whatever is installed.
+    OnCacheKeysComputed(std::move(rules), std::vector<std::string>());
     return;
   }
 
-  // Make a copy of greaselion_extensions_ to iterate while the original vector
-  // changes.
-  std::vector<extensions::ExtensionId> extensions = greaselion_extensions_;
-  for (auto id : extensions) {
-    // We need to unload all the Greaselion extensions that are already
-    // installed. OnExtensionUnloaded will be called on each extension, where we
-    // will update the greaselion_extensions_ set. Once it's empty, that
-    // callback will call CreateAndInstallExtensions().
-    extension_service_->UnloadExtension(
-        id, extensions::UnloadedExtensionReason::UPDATE);
-  }
+  // The cache keys hash the scripts of every rule, so they must be computed on
+  // the extension file task runner, which was passed in in the constructor.
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&GetCacheKeysOnTaskRunner, rules, install_directory_),
+      base::BindOnce(&GreaselionServiceImpl::OnCacheKeysComputed,
+                     weak_factory_.GetWeakPtr(), rules));
 }
 
-void GreaselionServiceImpl::CreateAndInstallExtensions() {
-  DCHECK(greaselion_extensions_.empty());
+void GreaselionServiceImpl::OnCacheKeysComputed(
+    std::vector<GreaselionRule> rules,
+    std::vector<std::string> cache_keys) {
+  DCHECK_EQ(rules.size(), cache_keys.size());
   DCHECK(update_in_progress_);
   all_rules_installed_successfully_ = true;
-  pending_installs_ = 0;
-
-  // At this point, any GL extensions that were previously loaded have now been
-  // unloaded. We can now clean up their corresponding temp folders.
-  if (!extension_dirs_.empty()) {
-    task_runner_->PostTask(
-        FROM_HERE,
-        base::BindOnce(&DeleteExtensionDirs, std::move(extension_dirs_)));
+  pending_conversions_.clear();
+
+  // Only the rules whose extensions changed (or weren't installed yet) have to
+  // be converted; the extensions of all the others stay loaded.
+  std::set<std::string> wanted_cache_keys;
+  for (size_t i = 0; i < rules.size(); ++i) {
+    if (cache_keys[i].empty()) {
+      all_rules_installed_successfully_ = false;
+      LOG(ERROR) << "Could not load Greaselion script";
+      continue;
+    }
+    if (!wanted_cache_keys.insert(cache_keys[i]).second)
+      continue;
+    if (!base::Contains(installed_extensions_, cache_keys[i]))
+      pending_conversions_.emplace_back(cache_keys[i], std::move(rules[i]));
   }
 
-  std::vector<std::unique_ptr<GreaselionRule>>* rules =
-      download_service_->rules();
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
-      pending_installs_ += 1;
+  for (auto it = installed_extensions_.begin();
+       it != installed_extensions_.end();) {
+    if (base::Contains(wanted_cache_keys, it->first)) {
+      ++it;
+      continue;
     }
+    pending_unloads_.insert(it->second);
+    it = installed_extensions_.erase(it);
   }
+
+  if (pending_unloads_.empty()) {
+    CreateAndInstallExtensions();
+    return;
+  }
+
+  // A changed rule keeps its extension ID, so the old extension has to be
+  // unloaded before the new one is added. OnExtensionUnloaded will be called
+  // on each extension, where we will update the pending_unloads_ set. Once
+  // it's empty, that callback will call CreateAndInstallExtensions(). Make a
+  // copy of pending_unloads_ to iterate while the original set changes.
+  std::set<extensions::ExtensionId> unloads = pending_unloads_;
+  for (const auto& id : unloads) {
+    extension_service_->UnloadExtension(
+        id, extensions::UnloadedExtensionReason::UPDATE);
+  }
+}
+
+void GreaselionServiceImpl::CreateAndInstallExtensions() {
+  DCHECK(pending_unloads_.empty());
+  DCHECK(update_in_progress_);
+  pending_installs_ = pending_conversions_.size();
   if (!pending_installs_) {
-    // no rules match, nothing else to do
+    // everything is up to date, nothing else to do
     MaybeNotifyObservers();
     return;
   }
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_, browser_version_) &&
-        rule->has_unknown_preconditions() == false) {
-      // Convert script file to component extension. This must run on extension
-      // file task runner, which was passed in in the constructor.
-      GreaselionRule rule_copy(*rule);
-      base::PostTaskAndReplyWithResult(
-          task_runner_.get(), FROM_HERE,
-          base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
-                         rule_copy, install_directory_),
-          base::BindOnce(&GreaselionServiceImpl::PostConvert,
-                         weak_factory_.GetWeakPtr()));
-    }
+
+  std::vector<std::pair<std::string, GreaselionRule>> conversions;
+  conversions.swap(pending_conversions_);
+  for (auto& conversion : conversions) {
+    // Convert script file to component extension, or reuse the one converted
+    // earlier. This must run on extension file task runner, which was passed
+    // in in the constructor.
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE,
+        base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
+                       std::move(conversion.second), install_directory_,
+                       conversion.first),
+        base::BindOnce(&GreaselionServiceImpl::PostConvert,
+                       weak_factory_.GetWeakPtr(), conversion.first));
   }
 }
 
 void GreaselionServiceImpl::PostConvert(
-    absl::optional<GreaselionConvertedExtension> converted_extension) {
-  if (!converted_extension) {
+    const std::string& cache_key,
+    scoped_refptr<extensions::Extension> extension) {
+  if (!extension) {
     all_rules_installed_successfully_ = false;
     pending_installs_ -= 1;
     MaybeNotifyObservers();
     LOG(ERROR) << "Could not load Greaselion script";
   } else {
-    greaselion_extensions_.push_back(converted_extension->first->id());
-    extension_dirs_.push_back(converted_extension->second);
+    greaselion_extensions_.push_back(extension->id());
+    installed_extensions_[cache_key] = extension->id();
     extension_system_->ready().Post(
-        FROM_HERE, base::BindOnce(&GreaselionServiceImpl::Install,
-                                  weak_factory_.GetWeakPtr(),
-                                  std::move(converted_extension->first)));
+        FROM_HERE,
+        base::BindOnce(&GreaselionServiceImpl::Install,
+                       weak_factory_.GetWeakPtr(), std::move(extension)));
   }
 }
 
@@ -377,7 +567,13 @@ void GreaselionServiceImpl::OnExtensionUnloaded(
     return;
   }
   greaselion_extensions_.erase(index);
-  if (update_in_progress_ && greaselion_extensions_.empty()) {
+  // Forget about extensions unloaded behind our back, so that the next update
+  // installs them again.
+  base::EraseIf(installed_extensions_, [&extension](const auto& installed) {
+    return installed.second == extension->id();
+  });
+  if (pending_unloads_.erase(extension->id()) && update_in_progress_ &&
+      pending_unloads_.empty()) {
     // It's time!
     CreateAndInstallExtensions();
   }
@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_GREASELION_BROWSER_GREASELION_SERVICE_IMPL_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -20,7 +21,6 @@
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "brave/components/greaselion/browser/greaselion_service.h"
 #include "extensions/common/extension_id.h"
-#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
 
 namespace base {
@@ -49,6 +49,11 @@ class GreaselionServiceImpl : public GreaselionService,
   GreaselionServiceImpl& operator=(const GreaselionServiceImpl&) = delete;
   ~GreaselionServiceImpl() override;
 
+  // Returns the directory converted extensions are kept in between updates
+  // and browser restarts.
+  static base::FilePath GetCacheDirectory(
+      const base::FilePath& install_directory);
+
   // KeyedService overrides
   void Shutdown() override;
 
@@ -68,14 +73,13 @@ class GreaselionServiceImpl : public GreaselionService,
                            const extensions::Extension* extension,
                            extensions::UnloadedExtensionReason reason) override;
 
-  using GreaselionConvertedExtension =
-      std::pair<scoped_refptr<extensions::Extension>, base::FilePath>;
-
  private:
   void SetBrowserVersionForTesting(const base::Version& version) override;
+  void OnCacheKeysComputed(std::vector<GreaselionRule> rules,
+                           std::vector<std::string> cache_keys);
   void CreateAndInstallExtensions();
-  void PostConvert(
-      absl::optional<GreaselionConvertedExtension> converted_extension);
+  void PostConvert(const std::string& cache_key,
+                   scoped_refptr<extensions::Extension> extension);
   void Install(scoped_refptr<extensions::Extension> extension);
   void MaybeNotifyObservers();
 
@@ -98,7 +102,13 @@ class GreaselionServiceImpl : public GreaselionService,
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   base::ObserverList<GreaselionService::Observer> observers_;
   std::vector<extensions::ExtensionId> greaselion_extensions_;
-  std::vector<base::FilePath> extension_dirs_;
+  // The extensions of the current rules, by cache key; see GetCacheKey().
+  std::map<std::string, extensions::ExtensionId> installed_extensions_;
+  // Extensions of rules which changed or no longer apply, waiting to be
+  // unloaded before the update can go on.
+  std::set<extensions::ExtensionId> pending_unloads_;
+  // Rules to convert once |pending_unloads_| is empty, with their cache keys.
+  std::vector<std::pair<std::string, GreaselionRule>> pending_conversions_;
   base::Version browser_version_;
   base::WeakPtrFactory<GreaselionServiceImpl> weak_factory_;
 };
@@ -6,6 +6,7 @@
 #include "brave/components/ipfs/import/ipfs_import_worker_base.h"
 
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include "base/command_line.h"
@@ -17,6 +18,7 @@
 #include "base/strings/stringprintf.h"
 #include "base/task/task_runner_util.h"
 #include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/time/time.h"
 #include "brave/components/ipfs/ipfs_constants.h"
 #include "brave/components/ipfs/ipfs_json_parser.h"
@@ -52,6 +54,33 @@ std::string TimeFormatDate(const base::Time& time) {
                             exploded_time.month, exploded_time.day_of_month);
 }
 
+// Folders are uploaded in batches of at most this many bytes and files.
+constexpr int64_t kMaxBatchSize = 16 * 1024 * 1024;
+constexpr size_t kMaxBatchFiles = 256;
+// Requests to the local node uploading batches at the same time.
+constexpr size_t kMaxConcurrentUploads = 3;
+// Batches are retried with an exponential backoff while the node can't be
+// reached, long enough for it to restart.
+constexpr int kMaxUploadRetries = 5;
+constexpr base::TimeDelta kUploadRetryDelay = base::Seconds(1);
+
+// Collects the hashes of the files in an /api/v0/add response by name.
+bool ParseAddedFiles(const std::string& response_body,
+                     std::unordered_map<std::string, std::string>* hashes) {
+  DCHECK(hashes);
+  for (const auto& item :
+       base::SplitStringPiece(response_body, "\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    ipfs::ImportedData imported_item;
+    if (!IPFSJSONParser::GetImportResponseFromJSON(std::string(item),
+                                                   &imported_item)) {
+      return false;
+    }
+    (*hashes)[imported_item.filename] = imported_item.hash;
+  }
+  return true;
+}
+
 }  // namespace
 
 namespace ipfs {
@@ -95,11 +124,18 @@ void IpfsImportWorkerBase::ImportFile(const base::FilePath upload_file_path,
 }
 
 void IpfsImportWorkerBase::ImportFolder(const base::FilePath folder_path) {
-  auto upload_callback = base::BindOnce(&IpfsImportWorkerBase::UploadData,
-                                        weak_factory_.GetWeakPtr());
   data_->filename = folder_path.BaseName().MaybeAsASCII();
-  CreateRequestForFolder(folder_path, blob_context_getter_factory_,
-                         std::move(upload_callback));
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock()},
+      base::BindOnce(&EnumerateFolderForImport, folder_path, kMaxBatchSize,
+                     kMaxBatchFiles),
+      base::BindOnce(&IpfsImportWorkerBase::OnFolderEnumerated,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void IpfsImportWorkerBase::SetProgressCallback(
+    ImportProgressCallback callback) {
+  progress_callback_ = std::move(callback);
 }
 
 void IpfsImportWorkerBase::ImportText(const std::string& text,
@@ -282,6 +318,205 @@ void IpfsImportWorkerBase::OnContentPublished(
                                 : IPFS_IMPORT_ERROR_PUBLISH_FAILED);
 }
 
+IpfsImportWorkerBase::FileBatch::FileBatch() = default;
+IpfsImportWorkerBase::FileBatch::FileBatch(FileBatch&&) = default;
+IpfsImportWorkerBase::FileBatch& IpfsImportWorkerBase::FileBatch::operator=(
+    FileBatch&&) = default;
+IpfsImportWorkerBase::FileBatch::~FileBatch() = default;
+
+void IpfsImportWorkerBase::OnFolderEnumerated(ImportFolderEntries entries) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!server_endpoint_.is_valid())
+    return NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
+
+  folder_directory_ = kImportDirectory;
+  folder_directory_ += TimeFormatDate(base::Time::Now());
+  folder_directory_ += "/";
+  for (const auto& directory : entries.directories) {
+    GURL url = net::AppendQueryParameter(
+        server_endpoint_.Resolve(kImportMakeDirectoryPath), "parents", "true");
+    url = net::AppendQueryParameter(
+        url, "arg", folder_directory_ + directory.relative_path);
+    mfs_requests_.emplace(url, IPFS_IMPORT_ERROR_MKDIR_FAILED);
+  }
+
+  total_size_ = entries.total_size;
+  for (auto& files : entries.batches) {
+    FileBatch batch;
+    for (const auto& file : files)
+      batch.size += file.info.GetSize();
+    batch.files = std::move(files);
+    batches_.push_back(std::move(batch));
+  }
+
+  StartMfsRequest();
+  StartBatchUploads();
+}
+
+void IpfsImportWorkerBase::StartBatchUploads() {
+  while (active_uploads_ < kMaxConcurrentUploads &&
+         next_batch_ < batches_.size()) {
+    active_uploads_++;
+    UploadBatch(next_batch_++);
+  }
+}
+
+void IpfsImportWorkerBase::UploadBatch(size_t index) {
+  CreateRequestForFileBatch(
+      batches_[index].files, blob_context_getter_factory_,
+      base::BindOnce(&IpfsImportWorkerBase::OnBatchRequestCreated,
+                     weak_factory_.GetWeakPtr(), index));
+}
+
+void IpfsImportWorkerBase::OnBatchRequestCreated(
+    size_t index,
+    std::unique_ptr<network::ResourceRequest> request) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (!request)
+    return NotifyImportCompleted(IPFS_IMPORT_ERROR_REQUEST_EMPTY);
+
+  GURL url = net::AppendQueryParameter(server_endpoint_.Resolve(kImportAddPath),
+                                       "stream-channels", "true");
+  url = net::AppendQueryParameter(url, "pin", "false");
+  url = net::AppendQueryParameter(url, "progress", "false");
+
+  auto& batch = batches_[index];
+  DCHECK(!batch.url_loader);
+  batch.url_loader = CreateURLLoader(url, "POST", std::move(request));
+  batch.url_loader->SetOnUploadProgressCallback(
+      base::BindRepeating(&IpfsImportWorkerBase::OnBatchUploadProgress,
+                          weak_factory_.GetWeakPtr(), index));
+  batch.url_loader->DownloadToStringOfUnboundedSizeUntilCrashAndDie(
+      url_loader_factory_.get(),
+      base::BindOnce(&IpfsImportWorkerBase::OnBatchUploaded,
+                     weak_factory_.GetWeakPtr(), index));
+}
+
+void IpfsImportWorkerBase::OnBatchUploadProgress(size_t index,
+                                                 uint64_t position,
+                                                 uint64_t total) {
+  if (!total)
+    return;
+  // The request carries multipart headers as well, count file bytes only.
+  SetBatchUploadedSize(
+      index, static_cast<int64_t>(static_cast<double>(position) / total *
+                                  batches_[index].size));
+}
+
+void IpfsImportWorkerBase::SetBatchUploadedSize(size_t index, int64_t size) {
+  auto& batch = batches_[index];
+  uploaded_size_ += size - batch.uploaded_size;
+  batch.uploaded_size = size;
+  if (progress_callback_)
+    progress_callback_.Run(uploaded_size_, total_size_);
+}
+
+void IpfsImportWorkerBase::OnBatchUploaded(
+    size_t index,
+    std::unique_ptr<std::string> response_body) {
+  auto& batch = batches_[index];
+  auto url_loader = std::move(batch.url_loader);
+  if (!url_loader->ResponseInfo()) {
+    // The node didn't answer at all, it may be restarting.
+    if (batch.retries >= kMaxUploadRetries)
+      return NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
+    SetBatchUploadedSize(index, 0);
+    base::SequencedTaskRunnerHandle::Get()->PostDelayedTask(
+        FROM_HERE,
+        base::BindOnce(&IpfsImportWorkerBase::UploadBatch,
+                       weak_factory_.GetWeakPtr(), index),
+        kUploadRetryDelay * (1 << batch.retries));
+    batch.retries++;
+    return;
+  }
+
+  std::unordered_map<std::string, std::string> hashes;
+  if (url_loader->NetError() != net::OK || !response_body ||
+      !ParseAddedFiles(*response_body, &hashes)) {
+    return NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
+  }
+  for (const auto& file : batch.files) {
+    auto it = hashes.find(file.relative_path);
+    if (it == hashes.end() || it->second.empty())
+      return NotifyImportCompleted(IPFS_IMPORT_ERROR_ADD_FAILED);
+    GURL url =
+        net::AppendQueryParameter(server_endpoint_.Resolve(kImportCopyPath),
+                                  "arg", "/ipfs/" + it->second);
+    url = net::AppendQueryParameter(url, "arg",
+                                    folder_directory_ + file.relative_path);
+    mfs_requests_.emplace(url, IPFS_IMPORT_ERROR_MOVE_FAILED);
+  }
+  batch.files.clear();
+  SetBatchUploadedSize(index, batch.size);
+  active_uploads_--;
+  uploaded_batches_++;
+
+  StartMfsRequest();
+  StartBatchUploads();
+}
+
+void IpfsImportWorkerBase::StartMfsRequest() {
+  if (url_loader_ || mfs_requests_.empty())
+    return;
+  auto [url, error_state] = std::move(mfs_requests_.front());
+  mfs_requests_.pop();
+
+  url_loader_ = std::make_unique<api_request_helper::APIRequestHelper>(
+      GetIpfsNetworkTrafficAnnotationTag(), url_loader_factory_);
+  url_loader_->Request(
+      "POST", url, std::string(), std::string(), false,
+      base::BindOnce(&IpfsImportWorkerBase::OnMfsRequestComplete,
+                     base::Unretained(this), error_state),
+      {{net::HttpRequestHeaders::kOrigin,
+        url::Origin::Create(url).Serialize()}});
+}
+
+void IpfsImportWorkerBase::OnMfsRequestComplete(
+    ImportState error_state,
+    api_request_helper::APIRequestResult response) {
+  url_loader_.reset();
+  if (!response.Is2XXResponseCode()) {
+    VLOG(1) << "response_code:" << response.response_code()
+            << " response_body:" << response.body();
+    return NotifyImportCompleted(error_state);
+  }
+  if (!mfs_requests_.empty())
+    return StartMfsRequest();
+  if (uploaded_batches_ == batches_.size())
+    StatImportedFolder();
+}
+
+void IpfsImportWorkerBase::StatImportedFolder() {
+  DCHECK(!url_loader_);
+  GURL url =
+      net::AppendQueryParameter(server_endpoint_.Resolve(kImportStatPath),
+                                "arg", folder_directory_ + data_->filename);
+
+  url_loader_ = std::make_unique<api_request_helper::APIRequestHelper>(
+      GetIpfsNetworkTrafficAnnotationTag(), url_loader_factory_);
+  url_loader_->Request(
+      "POST", url, std::string(), std::string(), false,
+      base::BindOnce(&IpfsImportWorkerBase::OnImportedFolderStat,
+                     base::Unretained(this)),
+      {{net::HttpRequestHeaders::kOrigin,
+        url::Origin::Create(url).Serialize()}});
+}
+
+void IpfsImportWorkerBase::OnImportedFolderStat(
+    api_request_helper::APIRequestResult response) {
+  url_loader_.reset();
+  if (!response.Is2XXResponseCode() ||
+      !IPFSJSONParser::GetFileStatFromJSON(response.body(), data_.get())) {
+    VLOG(1) << "response_code:" << response.response_code()
+            << " response_body:" << response.body();
+    return NotifyImportCompleted(IPFS_IMPORT_ERROR_MOVE_FAILED);
+  }
+  data_->directory = folder_directory_;
+  if (!key_to_publish_.empty())
+    return PublishContent();
+  NotifyImportCompleted(IPFS_IMPORT_SUCCESS);
+}
+
 void IpfsImportWorkerBase::NotifyImportCompleted(ipfs::ImportState state) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   data_->state = state;
@@ -44,6 +44,13 @@ namespace ipfs {
 //   3. Creates target directory for import using IPFS api(/api/v0/files/mkdir)
 //   4. Moves objects to target directory using IPFS api(/api/v0/files/cp)
 //   5. Publishes objects under passed IPNS key(/api/v0/name/publish)
+// Folders are imported in a pipeline instead: the files are split into
+// batches which are uploaded over a few concurrent requests, and each batch
+// is copied into the target directory (/api/v0/files/cp) as soon as it is
+// added, while the next ones are still uploading. Batches that fail because
+// the node can't be reached are uploaded again after a delay, so an import
+// picks up where it stopped when the node restarts. The folder hash is taken
+// from the target directory (/api/v0/files/stat) at the end.
 class IpfsImportWorkerBase {
  public:
   IpfsImportWorkerBase(
@@ -64,6 +71,9 @@ class IpfsImportWorkerBase {
   void ImportText(const std::string& text, const std::string& host);
   void ImportFolder(const base::FilePath folder_path);
 
+  // Reports the bytes uploaded so far by a folder import.
+  void SetProgressCallback(ImportProgressCallback callback);
+
  protected:
   scoped_refptr<network::SharedURLLoaderFactory> GetUrlLoaderFactory();
 
@@ -84,6 +94,35 @@ class IpfsImportWorkerBase {
   void PublishContent();
   void OnContentPublished(api_request_helper::APIRequestResult response);
 
+  void OnFolderEnumerated(ImportFolderEntries entries);
+  void StartBatchUploads();
+  void UploadBatch(size_t index);
+  void OnBatchRequestCreated(size_t index,
+                             std::unique_ptr<network::ResourceRequest> request);
+  void OnBatchUploadProgress(size_t index, uint64_t position, uint64_t total);
+  void OnBatchUploaded(size_t index,
+                       std::unique_ptr<std::string> response_body);
+  void SetBatchUploadedSize(size_t index, int64_t size);
+  void StartMfsRequest();
+  void OnMfsRequestComplete(ImportState error_state,
+                            api_request_helper::APIRequestResult response);
+  void StatImportedFolder();
+  void OnImportedFolderStat(api_request_helper::APIRequestResult response);
+
+  // Files of a folder import uploaded with a single request.
+  struct FileBatch {
+    FileBatch();
+    FileBatch(FileBatch&&);
+    FileBatch& operator=(FileBatch&&);
+    ~FileBatch();
+
+    std::vector<ImportFileInfo> files;
+    int64_t size = 0;
+    int64_t uploaded_size = 0;
+    int retries = 0;
+    std::unique_ptr<network::SimpleURLLoader> url_loader;
+  };
+
   ImportCompletedCallback callback_;
   std::unique_ptr<ipfs::ImportedData> data_;
 
@@ -93,6 +132,19 @@ class IpfsImportWorkerBase {
   std::unique_ptr<network::SimpleURLLoader> simple_url_loader_;
   GURL server_endpoint_;
   std::string key_to_publish_;
+
+  ImportProgressCallback progress_callback_;
+  // MFS directory the folder is imported into.
+  std::string folder_directory_;
+  std::vector<FileBatch> batches_;
+  size_t next_batch_ = 0;
+  size_t active_uploads_ = 0;
+  size_t uploaded_batches_ = 0;
+  int64_t total_size_ = 0;
+  int64_t uploaded_size_ = 0;
+  // MFS requests run one at a time and in order, since the node serializes
+  // them anyway. Each is paired with the state reported if it fails.
+  base::queue<std::pair<GURL, ImportState>> mfs_requests_;
   base::WeakPtrFactory<IpfsImportWorkerBase> weak_factory_;
 };
 
@@ -296,6 +296,42 @@ bool IPFSJSONParser::GetImportResponseFromJSON(const std::string& json,
   return true;
 }
 
+// static
+// Response Format for /api/v0/files/stat
+// {
+//   "Hash":"QmYbK4SLaSvTKKAKvNZMwyzYPy4P3GqBPN6CZzbS73FxxU",
+//   "Size":0,
+//   "CumulativeSize":567857,
+//   "Blocks":2,
+//   "Type":"directory"
+// }
+bool IPFSJSONParser::GetFileStatFromJSON(const std::string& json,
+                                         ipfs::ImportedData* data) {
+  auto records_v = base::JSONReader::ReadAndReturnValueWithError(
+      json, base::JSON_PARSE_CHROMIUM_EXTENSIONS |
+                base::JSONParserOptions::JSON_PARSE_RFC);
+  if (!records_v.has_value()) {
+    VLOG(1) << "Invalid response, could not parse JSON, JSON is: " << json
+            << " error is:" << records_v.error().message;
+    return false;
+  }
+
+  const auto* response_dict = records_v->GetIfDict();
+  if (!response_dict) {
+    VLOG(1) << "Invalid response, could not parse JSON, JSON is: " << json;
+    return false;
+  }
+  const std::string* hash = response_dict->FindString("Hash");
+  const auto size_value = response_dict->FindDouble("CumulativeSize");
+  if (!hash || !size_value) {
+    VLOG(1) << "Invalid response, missing required keys in value dictionary.";
+    return false;
+  }
+  data->hash = *hash;
+  data->size = static_cast<int64_t>(*size_value);
+  return true;
+}
+
 // static
 // Response Format for /api/v0/key/list
 // {"Keys" : [
@@ -29,6 +29,8 @@ class IPFSJSONParser {
                                            std::string* error);
   static bool GetImportResponseFromJSON(const std::string& json,
                                         ipfs::ImportedData* data);
+  static bool GetFileStatFromJSON(const std::string& json,
+                                  ipfs::ImportedData* data);
   static bool GetParseKeysFromJSON(
       const std::string& json,
       std::unordered_map<std::string, std::string>* keys);
@@ -166,6 +166,28 @@ TEST_F(IPFSJSONParserTest, GetImportResponseFromJSON) {
   ASSERT_EQ(failed2.size, -1);
 }
 
+TEST_F(IPFSJSONParserTest, GetFileStatFromJSON) {
+  ipfs::ImportedData success;
+  ASSERT_TRUE(IPFSJSONParser::GetFileStatFromJSON(R"({
+    "Hash":"QmYbK4SLaSvTKKAKvNZMwyzYPy4P3GqBPN6CZzbS73FxxU",
+    "Size":0,
+    "CumulativeSize":567857,
+    "Blocks":2,
+    "Type":"directory"
+    })",
+                                                  &success));
+  EXPECT_EQ(success.hash, "QmYbK4SLaSvTKKAKvNZMwyzYPy4P3GqBPN6CZzbS73FxxU");
+  EXPECT_EQ(success.size, 567857);
+
+  ipfs::ImportedData failed;
+  ASSERT_FALSE(IPFSJSONParser::GetFileStatFromJSON(
+      R"({"Message":"file does not exist","Code":0,"Type":"error"})",
+      &failed));
+  EXPECT_EQ(failed.hash, "");
+  EXPECT_EQ(failed.size, -1);
+  ASSERT_FALSE(IPFSJSONParser::GetFileStatFromJSON(R"()", &failed));
+}
+
 TEST_F(IPFSJSONParserTest, GetParseKeysFromJSON) {
   std::unordered_map<std::string, std::string> parsed_keys;
   std::string response = R"({"Keys" : [)"
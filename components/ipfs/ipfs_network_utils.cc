@@ -5,7 +5,9 @@
 
 #include "brave/components/ipfs/ipfs_network_utils.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,6 +17,8 @@
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/guid.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
 #include "base/task/thread_pool.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
@@ -35,16 +39,6 @@
 namespace {
 
 #if BUILDFLAG(ENABLE_IPFS_LOCAL_NODE)
-struct ImportFileInfo {
-  ImportFileInfo(base::FilePath full_path,
-                 base::FileEnumerator::FileInfo information) {
-    path = full_path;
-    info = information;
-  }
-  base::FilePath path;
-  base::FileEnumerator::FileInfo info;
-};
-
 bool GetRelativePathComponent(const base::FilePath& parent,
                               const base::FilePath& child,
                               base::FilePath::StringType* out) {
@@ -113,27 +107,41 @@ std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithFile(
   return blob_builder;
 }
 
-std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithFolder(
-    base::FilePath upload_path,
+// Sorts entries so that everything under a directory comes right after it.
+bool IsBeforeInTree(const ipfs::ImportFileInfo& a,
+                    const ipfs::ImportFileInfo& b) {
+  return a.path.GetComponents() < b.path.GetComponents();
+}
+
+std::unique_ptr<storage::BlobDataBuilder> BuildBlobWithFileBatch(
     std::string mime_boundary,
-    std::vector<ImportFileInfo> files) {
+    std::vector<ipfs::ImportFileInfo> files) {
   auto blob_builder =
       std::make_unique<storage::BlobDataBuilder>(base::GenerateGUID());
+  std::set<std::string> added_directories;
   for (const auto& info : files) {
     std::string data_header;
-    base::FilePath::StringType relative_path;
-    GetRelativePathComponent(upload_path, info.path, &relative_path);
-
-    std::string mime_type = info.info.IsDirectory() ? ipfs::kDirectoryMimeType
-                                                    : ipfs::kFileMimeType;
+    // Each file has to follow the directories it is in.
+    std::vector<base::StringPiece> components = base::SplitStringPiece(
+        info.relative_path, "/", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+    std::string directory;
+    for (size_t i = 0; i + 1 < components.size(); ++i) {
+      if (!directory.empty())
+        directory += "/";
+      directory.append(components[i].data(), components[i].size());
+      if (!added_directories.insert(directory).second)
+        continue;
+      data_header.append("\r\n");
+      ipfs::AddMultipartHeaderForUploadWithFileName(
+          ipfs::kFileValueName, directory, std::string(), mime_boundary,
+          ipfs::kDirectoryMimeType, &data_header);
+    }
     data_header.append("\r\n");
     ipfs::AddMultipartHeaderForUploadWithFileName(
-        ipfs::kFileValueName, base::FilePath(relative_path).MaybeAsASCII(),
-        info.path.MaybeAsASCII(), mime_boundary, mime_type, &data_header);
+        ipfs::kFileValueName, info.relative_path, info.path.MaybeAsASCII(),
+        mime_boundary, ipfs::kFileMimeType, &data_header);
     blob_builder->AppendData(data_header);
-    if (mime_type == ipfs::kFileMimeType) {
-      blob_builder->AppendFile(info.path, 0, info.info.GetSize(), base::Time());
-    }
+    blob_builder->AppendFile(info.path, 0, info.info.GetSize(), base::Time());
   }
 
   std::string post_data_footer = "\r\n";
@@ -270,31 +278,76 @@ void CreateRequestForFile(
       std::move(request_callback));
 }
 
-std::vector<ImportFileInfo> EnumerateDirectoryFiles(base::FilePath dir_path) {
+ImportFileInfo::ImportFileInfo(base::FilePath full_path,
+                               base::FileEnumerator::FileInfo information,
+                               std::string relative)
+    : path(std::move(full_path)),
+      info(std::move(information)),
+      relative_path(std::move(relative)) {}
+ImportFileInfo::ImportFileInfo(const ImportFileInfo&) = default;
+ImportFileInfo& ImportFileInfo::operator=(const ImportFileInfo&) = default;
+ImportFileInfo::~ImportFileInfo() = default;
+
+ImportFolderEntries::ImportFolderEntries() = default;
+ImportFolderEntries::ImportFolderEntries(ImportFolderEntries&&) = default;
+ImportFolderEntries& ImportFolderEntries::operator=(ImportFolderEntries&&) =
+    default;
+ImportFolderEntries::~ImportFolderEntries() = default;
+
+ImportFolderEntries EnumerateFolderForImport(const base::FilePath& folder_path,
+                                             int64_t max_batch_size,
+                                             size_t max_batch_files) {
+  ImportFolderEntries entries;
+  entries.directories.emplace_back(folder_path,
+                                   base::FileEnumerator::FileInfo(),
+                                   folder_path.BaseName().MaybeAsASCII());
   std::vector<ImportFileInfo> files;
+  const base::FilePath parent_path = folder_path.DirName();
   base::FileEnumerator file_enum(
-      dir_path, true,
+      folder_path, true,
       base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
   for (base::FilePath enum_path = file_enum.Next(); !enum_path.empty();
        enum_path = file_enum.Next()) {
     // Skip symlinks.
     if (base::IsLink(enum_path))
       continue;
-    files.emplace_back(enum_path, file_enum.GetInfo());
+    base::FilePath::StringType relative_path;
+    GetRelativePathComponent(parent_path, enum_path, &relative_path);
+    ImportFileInfo info(enum_path, file_enum.GetInfo(),
+                        base::FilePath(relative_path).MaybeAsASCII());
+    if (info.info.IsDirectory())
+      entries.directories.push_back(std::move(info));
+    else
+      files.push_back(std::move(info));
   }
 
-  return files;
+  std::sort(entries.directories.begin(), entries.directories.end(),
+            &IsBeforeInTree);
+  // Batches are runs of neighbouring files, so each of them only touches a
+  // few directories.
+  std::sort(files.begin(), files.end(), &IsBeforeInTree);
+  int64_t batch_size = 0;
+  for (auto& file : files) {
+    const int64_t file_size = file.info.GetSize();
+    if (entries.batches.empty() ||
+        entries.batches.back().size() >= max_batch_files ||
+        batch_size + file_size > max_batch_size) {
+      entries.batches.emplace_back();
+      batch_size = 0;
+    }
+    entries.batches.back().push_back(std::move(file));
+    batch_size += file_size;
+    entries.total_size += file_size;
+  }
+  return entries;
 }
 
-void CreateRequestForFileList(
-    ResourceRequestGetter request_callback,
-    ipfs::BlobContextGetterFactory* blob_context_getter_factory,
-    const base::FilePath& folder_path,
-    std::vector<ImportFileInfo> files) {
+void CreateRequestForFileBatch(std::vector<ImportFileInfo> files,
+                               ipfs::BlobContextGetterFactory* context_factory,
+                               ResourceRequestGetter request_callback) {
   std::string mime_boundary = net::GenerateMimeMultipartBoundary();
   auto blob_builder_callback =
-      base::BindOnce(&BuildBlobWithFolder, folder_path.DirName(), mime_boundary,
-                     std::move(files));
+      base::BindOnce(&BuildBlobWithFileBatch, mime_boundary, std::move(files));
 
   std::string content_type = ipfs::kIPFSImportMultipartContentType;
   content_type += " boundary=";
@@ -303,20 +356,10 @@ void CreateRequestForFileList(
   content::GetIOThreadTaskRunner({})->PostTaskAndReplyWithResult(
       FROM_HERE,
       base::BindOnce(&CreateResourceRequest, std::move(blob_builder_callback),
-                     content_type, blob_context_getter_factory),
+                     content_type, context_factory),
       std::move(request_callback));
 }
 
-void CreateRequestForFolder(const base::FilePath& folder_path,
-                            ipfs::BlobContextGetterFactory* context_factory,
-                            ResourceRequestGetter request_callback) {
-  base::ThreadPool::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::MayBlock()},
-      base::BindOnce(&EnumerateDirectoryFiles, folder_path),
-      base::BindOnce(&CreateRequestForFileList, std::move(request_callback),
-                     context_factory, folder_path));
-}
-
 void CreateRequestForText(const std::string& text,
                           const std::string& filename,
                           ipfs::BlobContextGetterFactory* context_factory,
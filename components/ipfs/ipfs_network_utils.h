@@ -8,19 +8,17 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
 #include "brave/components/ipfs/blob_context_getter_factory.h"
 #include "brave/components/ipfs/buildflags/buildflags.h"
 #include "services/network/public/cpp/resource_request.h"
 #include "services/network/public/cpp/simple_url_loader.h"
 #include "url/gurl.h"
 
-namespace base {
-class FilePath;
-}  // namespace base
-
 namespace net {
 struct NetworkTrafficAnnotationTag;
 }  // namespace net
@@ -65,9 +63,48 @@ void CreateRequestForFile(const base::FilePath& upload_file_path,
                           ResourceRequestGetter request_callback,
                           size_t file_size);
 
-void CreateRequestForFolder(const base::FilePath& folder_path,
-                            BlobContextGetterFactory* context_getter_factory,
-                            ResourceRequestGetter request_callback);
+struct ImportFileInfo {
+  ImportFileInfo(base::FilePath full_path,
+                 base::FileEnumerator::FileInfo information,
+                 std::string relative);
+  ImportFileInfo(const ImportFileInfo&);
+  ImportFileInfo& operator=(const ImportFileInfo&);
+  ~ImportFileInfo();
+
+  base::FilePath path;
+  base::FileEnumerator::FileInfo info;
+  // Path relative to the parent of the imported folder, '/' separated.
+  std::string relative_path;
+};
+
+// The contents of a folder to import. Files are split into batches which are
+// uploaded with separate requests, so that large folders don't have to go
+// through a single request.
+struct ImportFolderEntries {
+  ImportFolderEntries();
+  ImportFolderEntries(ImportFolderEntries&&);
+  ImportFolderEntries& operator=(ImportFolderEntries&&);
+  ~ImportFolderEntries();
+
+  // The folder itself and all its subdirectories, parents first.
+  std::vector<ImportFileInfo> directories;
+  std::vector<std::vector<ImportFileInfo>> batches;
+  int64_t total_size = 0;
+};
+
+// Enumerates |folder_path| skipping symlinks. Each batch holds at most
+// |max_batch_files| files and at most |max_batch_size| bytes, unless it is a
+// single file larger than that.
+ImportFolderEntries EnumerateFolderForImport(const base::FilePath& folder_path,
+                                             int64_t max_batch_size,
+                                             size_t max_batch_files);
+
+// Creates an /api/v0/add request for a batch returned by
+// EnumerateFolderForImport. Parent directories of the files are added to the
+// request as well, so the node gets them in the layout it expects.
+void CreateRequestForFileBatch(std::vector<ImportFileInfo> files,
+                               BlobContextGetterFactory* context_getter_factory,
+                               ResourceRequestGetter request_callback);
 
 void CreateRequestForText(const std::string& text,
                           const std::string& filename,
@@ -449,9 +449,20 @@ void IpfsService::ImportDirectoryToIpfs(const base::FilePath& folder,
   importers_[hash] = std::make_unique<IpfsImportWorkerBase>(
       blob_context_getter_factory_.get(), url_loader_factory_.get(),
       server_endpoint_, std::move(import_completed_callback), key);
+  importers_[hash]->SetProgressCallback(
+      base::BindRepeating(&IpfsService::NotifyImportProgress,
+                          weak_factory_.GetWeakPtr(), folder));
   importers_[hash]->ImportFolder(folder);
 }
 
+void IpfsService::NotifyImportProgress(const base::FilePath& path,
+                                       int64_t uploaded_bytes,
+                                       int64_t total_bytes) {
+  for (auto& observer : observers_) {
+    observer.OnImportProgress(path, uploaded_bytes, total_bytes);
+  }
+}
+
 void IpfsService::ImportTextToIpfs(const std::string& text,
                                    const std::string& host,
                                    ipfs::ImportCompletedCallback callback) {
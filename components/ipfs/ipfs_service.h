@@ -183,6 +183,9 @@ class IpfsService : public KeyedService,
   // Launches the ipfs service in an utility process.
   void LaunchIfNotRunning(const base::FilePath& executable_path);
 #if BUILDFLAG(ENABLE_IPFS_LOCAL_NODE)
+  void NotifyImportProgress(const base::FilePath& path,
+                            int64_t uploaded_bytes,
+                            int64_t total_bytes);
   static bool WaitUntilExecutionFinished(base::Process process);
   void ExecuteNodeCommand(const base::CommandLine& command_line,
                           const base::FilePath& data,
@@ -17,6 +17,7 @@
 #include "base/observer_list.h"
 #include "base/timer/timer.h"
 #include "base/values.h"
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
 #include "components/prefs/pref_change_registrar.h"
 
 namespace component_updater {
@@ -64,6 +65,9 @@ class NTPBackgroundImagesService {
   NTPBackgroundImagesData* GetBackgroundImagesData() const;
   NTPSponsoredImagesData* GetBrandedImagesData(bool super_referral) const;
 
+  // Images of the installed components, shared by all profiles.
+  NTPImageCache* image_cache() { return &image_cache_; }
+
   bool test_data_used() const { return test_data_used_; }
 
   bool IsSuperReferral() const;
@@ -163,6 +167,7 @@ class NTPBackgroundImagesService {
   base::ObserverList<Observer>::Unchecked observer_list_;
   std::unique_ptr<NTPSponsoredImagesData> si_images_data_;
   std::unique_ptr<NTPSponsoredImagesData> sr_images_data_;
+  NTPImageCache image_cache_;
   PrefChangeRegistrar pref_change_registrar_;
   // This is only used for registration during initial(first) SR component
   // download. After initial download is done, it's cached to
@@ -0,0 +1,137 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/debug/alias.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/task/thread_pool.h"
+
+namespace ntp_background_images {
+
+namespace {
+
+// Image bytes backed by a memory mapped file, handed out without copying.
+class MappedImage : public base::RefCountedMemory {
+ public:
+  explicit MappedImage(std::unique_ptr<base::MemoryMappedFile> file)
+      : file_(std::move(file)) {}
+
+  MappedImage(const MappedImage&) = delete;
+  MappedImage& operator=(const MappedImage&) = delete;
+
+  // base::RefCountedMemory overrides:
+  const unsigned char* front() const override { return file_->data(); }
+  size_t size() const override { return file_->length(); }
+
+ private:
+  ~MappedImage() override {
+    // Closing the file may block, and the last reference can be dropped on
+    // any thread.
+    base::ThreadPool::PostTask(
+        FROM_HERE, {base::MayBlock(), base::TaskPriority::BEST_EFFORT},
+        base::BindOnce([](std::unique_ptr<base::MemoryMappedFile> file) {},
+                       std::move(file_)));
+  }
+
+  std::unique_ptr<base::MemoryMappedFile> file_;
+};
+
+scoped_refptr<base::RefCountedMemory> MapImageFile(
+    const base::FilePath& path) {
+  auto file = std::make_unique<base::MemoryMappedFile>();
+  if (!file->Initialize(path) || !file->length())
+    return nullptr;
+
+  // Fault the pages in here, so that whoever reads the image later doesn't
+  // end up waiting for the disk.
+  constexpr size_t kPageSize = 4096;
+  unsigned char sum = 0;
+  for (size_t offset = 0; offset < file->length(); offset += kPageSize)
+    sum += file->data()[offset];
+  base::debug::Alias(&sum);
+
+  return base::MakeRefCounted<MappedImage>(std::move(file));
+}
+
+}  // namespace
+
+NTPImageCache::NTPImageCache(size_t max_size)
+    : max_size_(max_size), images_(decltype(images_)::NO_AUTO_EVICT) {}
+
+NTPImageCache::~NTPImageCache() = default;
+
+void NTPImageCache::GetImage(const base::FilePath& path,
+                             GetImageCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = images_.Get(path);
+  if (it != images_.end()) {
+    std::move(callback).Run(it->second);
+    return;
+  }
+
+  // A load may already be in flight, e.g. one started by Preload().
+  const bool loading = pending_loads_.count(path);
+  pending_loads_[path].push_back(std::move(callback));
+  if (!loading)
+    LoadImage(path);
+}
+
+void NTPImageCache::Preload(const base::FilePath& path) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (path.empty() || images_.Peek(path) != images_.end() ||
+      pending_loads_.count(path)) {
+    return;
+  }
+
+  pending_loads_[path];
+  LoadImage(path);
+}
+
+void NTPImageCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  images_.Clear();
+  size_ = 0;
+  generation_++;
+}
+
+void NTPImageCache::LoadImage(const base::FilePath& path) {
+  base::ThreadPool::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&MapImageFile, path),
+      base::BindOnce(&NTPImageCache::OnImageLoaded, weak_factory_.GetWeakPtr(),
+                     path, generation_));
+}
+
+void NTPImageCache::OnImageLoaded(const base::FilePath& path,
+                                  int generation,
+                                  scoped_refptr<base::RefCountedMemory> image) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (image && generation == generation_ && image->size() <= max_size_) {
+    auto existing = images_.Peek(path);
+    if (existing != images_.end())
+      size_ -= existing->second->size();
+    images_.Put(path, image);
+    size_ += image->size();
+    while (size_ > max_size_ && !images_.empty()) {
+      auto oldest = images_.rbegin();
+      size_ -= oldest->second->size();
+      images_.Erase(oldest);
+    }
+  }
+
+  auto node = pending_loads_.extract(path);
+  if (node.empty())
+    return;
+  for (auto& callback : node.mapped())
+    std::move(callback).Run(image);
+}
+
+}  // namespace ntp_background_images
@@ -0,0 +1,77 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
+#define BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
+
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/lru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+
+namespace base {
+class RefCountedMemory;
+}  // namespace base
+
+namespace ntp_background_images {
+
+// Keeps the images shown on the new tab page mapped into memory, so that
+// opening a new tab doesn't read the same wallpaper from disk again. The
+// mapped bytes of all cached images are kept under a budget; the least
+// recently used images are dropped first.
+class NTPImageCache {
+ public:
+  using GetImageCallback =
+      base::OnceCallback<void(scoped_refptr<base::RefCountedMemory>)>;
+
+  // Large enough for a few full-size wallpapers and their logos.
+  static constexpr size_t kDefaultMaxSize = 32 * 1024 * 1024;
+
+  explicit NTPImageCache(size_t max_size = kDefaultMaxSize);
+  ~NTPImageCache();
+
+  NTPImageCache(const NTPImageCache&) = delete;
+  NTPImageCache& operator=(const NTPImageCache&) = delete;
+
+  // Runs |callback| with the contents of |path|, or with nullptr if it can't
+  // be read. The callback runs synchronously when the image is cached.
+  void GetImage(const base::FilePath& path, GetImageCallback callback);
+
+  // Loads |path| into the cache ahead of the new tab page asking for it.
+  void Preload(const base::FilePath& path);
+
+  // Drops all images, e.g. because the component they came from was updated.
+  // Loads still in flight are not cached when they finish.
+  void Clear();
+
+  size_t size() const { return size_; }
+
+ private:
+  void LoadImage(const base::FilePath& path);
+  void OnImageLoaded(const base::FilePath& path,
+                     int generation,
+                     scoped_refptr<base::RefCountedMemory> image);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  const size_t max_size_;
+  size_t size_ = 0;
+  // Bumped by Clear() to tell loads started before apart from later ones.
+  int generation_ = 0;
+  base::LRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>
+      images_;
+  // Callbacks waiting for an image to be loaded, by path.
+  std::map<base::FilePath, std::vector<GetImageCallback>> pending_loads_;
+  base::WeakPtrFactory<NTPImageCache> weak_factory_{this};
+};
+
+}  // namespace ntp_background_images
+
+#endif  // BRAVE_COMPONENTS_NTP_BACKGROUND_IMAGES_BROWSER_NTP_IMAGE_CACHE_H_
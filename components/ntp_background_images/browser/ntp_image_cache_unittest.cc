@@ -0,0 +1,140 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/run_loop.h"
+#include "base/test/bind.h"
+#include "base/test/task_environment.h"
+#include "build/build_config.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ntp_background_images {
+
+class NTPImageCacheTest : public testing::Test {
+ public:
+  NTPImageCacheTest() = default;
+
+  void SetUp() override { ASSERT_TRUE(temp_dir_.CreateUniqueTempDir()); }
+
+  base::FilePath WriteImage(const std::string& name,
+                            const std::string& contents) {
+    base::FilePath path = temp_dir_.GetPath().AppendASCII(name);
+    EXPECT_TRUE(base::WriteFile(path, contents));
+    return path;
+  }
+
+  // Replaces the file rather than writing to it, like component updates do,
+  // so that mapped images keep their contents.
+  void ReplaceImage(const base::FilePath& path, const std::string& contents) {
+    base::FilePath new_path = path.AddExtensionASCII("new");
+    ASSERT_TRUE(base::WriteFile(new_path, contents));
+    ASSERT_TRUE(base::ReplaceFile(new_path, path, nullptr));
+  }
+
+  // Returns the image contents, or "null" if there are none.
+  std::string GetImage(NTPImageCache* cache, const base::FilePath& path) {
+    std::string result;
+    base::RunLoop run_loop;
+    cache->GetImage(
+        path, base::BindLambdaForTesting(
+                  [&](scoped_refptr<base::RefCountedMemory> data) {
+                    result = data ? std::string(data->front_as<char>(),
+                                                data->size())
+                                  : "null";
+                    run_loop.Quit();
+                  }));
+    run_loop.Run();
+    return result;
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(NTPImageCacheTest, ServesCachedImages) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("wallpaper.jpg", "wallpaper");
+  EXPECT_EQ("wallpaper", GetImage(&cache, path));
+  EXPECT_EQ(9u, cache.size());
+
+  // Windows doesn't allow replacing files which are mapped.
+#if !BUILDFLAG(IS_WIN)
+  // The file isn't read again while the image is cached.
+  ReplaceImage(path, "changed");
+  EXPECT_EQ("wallpaper", GetImage(&cache, path));
+#endif
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+#if !BUILDFLAG(IS_WIN)
+  EXPECT_EQ("changed", GetImage(&cache, path));
+#endif
+
+  EXPECT_EQ("null",
+            GetImage(&cache, temp_dir_.GetPath().AppendASCII("missing.jpg")));
+}
+
+TEST_F(NTPImageCacheTest, EvictsLeastRecentlyUsed) {
+  NTPImageCache cache(10);
+  const base::FilePath first = WriteImage("first.jpg", "aaaa");
+  const base::FilePath second = WriteImage("second.jpg", "bbbb");
+  const base::FilePath third = WriteImage("third.jpg", "cccc");
+  const base::FilePath large = WriteImage("large.jpg", "large image");
+
+  EXPECT_EQ("aaaa", GetImage(&cache, first));
+  EXPECT_EQ("bbbb", GetImage(&cache, second));
+  EXPECT_EQ("aaaa", GetImage(&cache, first));
+  EXPECT_EQ("cccc", GetImage(&cache, third));
+  EXPECT_EQ(8u, cache.size());
+
+#if !BUILDFLAG(IS_WIN)
+  // |second| was used least recently, so it went first.
+  ReplaceImage(first, "AAAA");
+  ReplaceImage(second, "BBBB");
+  EXPECT_EQ("aaaa", GetImage(&cache, first));
+  EXPECT_EQ("BBBB", GetImage(&cache, second));
+#endif
+
+  // Images over the budget are served but not cached.
+  EXPECT_EQ("large image", GetImage(&cache, large));
+  EXPECT_EQ(8u, cache.size());
+}
+
+TEST_F(NTPImageCacheTest, Preload) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("wallpaper.jpg", "wallpaper");
+  cache.Preload(path);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(9u, cache.size());
+
+#if !BUILDFLAG(IS_WIN)
+  ReplaceImage(path, "changed");
+#endif
+  EXPECT_EQ("wallpaper", GetImage(&cache, path));
+}
+
+TEST_F(NTPImageCacheTest, GetImageWhilePreloading) {
+  NTPImageCache cache;
+  const base::FilePath path = WriteImage("wallpaper.jpg", "wallpaper");
+  // The new tab page asks for the image right after it was preloaded; both
+  // share a single load.
+  cache.Preload(path);
+  EXPECT_EQ("wallpaper", GetImage(&cache, path));
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(9u, cache.size());
+
+  EXPECT_EQ("wallpaper", GetImage(&cache, path));
+  EXPECT_EQ(9u, cache.size());
+}
+
+}  // namespace ntp_background_images
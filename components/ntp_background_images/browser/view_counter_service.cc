@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "brave/components/brave_rewards/common/pref_names.h"
 #include "brave/components/ntp_background_images/browser/features.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_data.h"
+#include "brave/components/ntp_background_images/browser/ntp_image_cache.h"
 #include "brave/components/ntp_background_images/browser/ntp_p3a_helper.h"
 #include "brave/components/ntp_background_images/browser/ntp_sponsored_images_data.h"
 #include "brave/components/ntp_background_images/browser/url_constants.h"
@@ -332,6 +334,7 @@ void ViewCounterService::RegisterPageView() {
   service_->CheckNTPSIComponentUpdateIfNeeded();
   model_.RegisterPageView();
   MaybePrefetchNewTabPageAd();
+  PreloadNextWallpaper();
 }
 
 void ViewCounterService::BrandedWallpaperLogoClicked(
@@ -435,6 +438,42 @@ void ViewCounterService::MaybePrefetchNewTabPageAd() {
   ads_service_->PrefetchNewTabPageAd();
 }
 
+void ViewCounterService::PreloadNextWallpaper() {
+  NTPImageCache* image_cache = service_->image_cache();
+  if (ShouldShowBrandedWallpaper()) {
+    // When ads pick the wallpaper, it isn't known until the ad is shown.
+    NTPSponsoredImagesData* images_data = GetCurrentBrandedWallpaperData();
+    const bool should_frequency_cap_ads =
+        ads_service_ && ads_service_->IsEnabled();
+    if (should_frequency_cap_ads && !images_data->IsSuperReferral())
+      return;
+
+    size_t campaign_index;
+    size_t background_index;
+    std::tie(campaign_index, background_index) =
+        model_.GetCurrentBrandedImageIndex();
+    if (campaign_index >= images_data->campaigns.size())
+      return;
+    const auto& campaign = images_data->campaigns[campaign_index];
+    if (background_index >= campaign.backgrounds.size())
+      return;
+    const auto& background = campaign.backgrounds[background_index];
+    image_cache->Preload(background.image_file);
+    image_cache->Preload(background.logo.image_file);
+    return;
+  }
+
+  if (!IsBackgroundWallpaperActive() || ShouldShowCustomBackground())
+    return;
+
+  auto* data = GetCurrentWallpaperData();
+  if (!data)
+    return;
+  const size_t index = model_.current_wallpaper_image_index();
+  if (index < data->backgrounds.size())
+    image_cache->Preload(data->backgrounds[index].image_file);
+}
+
 void ViewCounterService::UpdateP3AValues() const {
   uint64_t new_tab_count = new_tab_count_state_->GetHighestValueInWeek();
   p3a_utils::RecordToHistogramBucket("Brave.NTP.NewTabsCreated",
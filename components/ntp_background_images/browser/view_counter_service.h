@@ -156,6 +156,8 @@ class ViewCounterService : public KeyedService,
   void ResetModel();
 
   void MaybePrefetchNewTabPageAd();
+  // Loads the images of the wallpaper the next new tab page will show.
+  void PreloadNextWallpaper();
 
   void UpdateP3AValues() const;
 
@@ -0,0 +1,24 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/query_filter/query_filter_util.h"
+
+namespace query_filter {
+
+absl::optional<base::StringPiece> GetStrippableKey(base::StringPiece pair) {
+  // Equivalent to splitting |pair| on '=' with base::SPLIT_WANT_NONEMPTY and
+  // requiring at least two pieces, without materializing the pieces.
+  const size_t key_start = pair.find_first_not_of('=');
+  if (key_start == base::StringPiece::npos)
+    return absl::nullopt;
+  const size_t key_end = pair.find('=', key_start);
+  if (key_end == base::StringPiece::npos)
+    return absl::nullopt;
+  if (pair.find_first_not_of('=', key_end) == base::StringPiece::npos)
+    return absl::nullopt;
+  return pair.substr(key_start, key_end - key_start);
+}
+
+}  // namespace query_filter
@@ -0,0 +1,71 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_QUERY_FILTER_QUERY_FILTER_UTIL_H_
+#define BRAVE_COMPONENTS_QUERY_FILTER_QUERY_FILTER_UTIL_H_
+
+#include <string>
+
+#include "base/strings/string_piece.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace query_filter {
+
+// Returns the key of a single "key=value" query string pair if the pair is
+// eligible for stripping, i.e. it has both a non-empty key and a non-empty
+// value. Leading and repeated '=' characters are ignored, so "=key=value" and
+// "key==value" yield "key" while "key" and "key=" yield nothing.
+absl::optional<base::StringPiece> GetStrippableKey(base::StringPiece pair);
+
+// Removes tracking parameters from |query| (without the leading '?'), leaving
+// all other pairs untouched and in their original order.
+//
+// We are using custom query string parsing code here. See
+// https://github.com/brave/brave-core/pull/13726#discussion_r897712350
+// for more information on why this approach was selected.
+//
+// The query is tokenized in a single pass: every '&'-separated pair whose key
+// satisfies |should_strip| is dropped and the others are appended to the
+// result as they are. Nothing is allocated until the first tracker is found,
+// and absl::nullopt is returned if the query doesn't need to change.
+template <typename Predicate>
+absl::optional<std::string> StripQueryParameters(base::StringPiece query,
+                                                 Predicate&& should_strip) {
+  absl::optional<std::string> result;
+  size_t kept_end = 0;
+  bool first_kept = true;
+  size_t pair_start = 0;
+  while (pair_start <= query.size()) {
+    size_t pair_end = query.find('&', pair_start);
+    if (pair_end == base::StringPiece::npos)
+      pair_end = query.size();
+    const base::StringPiece pair =
+        query.substr(pair_start, pair_end - pair_start);
+    const absl::optional<base::StringPiece> key = GetStrippableKey(pair);
+    if (key && should_strip(*key)) {
+      if (!result) {
+        // Copy everything that was kept so far, minus the separator that
+        // preceded this pair.
+        result.emplace();
+        result->reserve(query.size());
+        result->append(query.data(), kept_end);
+      }
+    } else {
+      if (result) {
+        if (!first_kept)
+          result->push_back('&');
+        result->append(pair.data(), pair.size());
+      }
+      kept_end = pair_end;
+      first_kept = false;
+    }
+    pair_start = pair_end + 1;
+  }
+  return result;
+}
+
+}  // namespace query_filter
+
+#endif  // BRAVE_COMPONENTS_QUERY_FILTER_QUERY_FILTER_UTIL_H_
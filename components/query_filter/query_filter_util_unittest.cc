@@ -0,0 +1,67 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/query_filter/query_filter_util.h"
+
+#include <string>
+
+#include "base/containers/fixed_flat_set.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace query_filter {
+
+namespace {
+
+constexpr auto kTestTrackers =
+    base::MakeFixedFlatSet<base::StringPiece>({"fbclid", "second"});
+
+std::string Strip(base::StringPiece query) {
+  return StripQueryParameters(query,
+                              [](base::StringPiece key) {
+                                return kTestTrackers.contains(key);
+                              })
+      .value_or(std::string(query));
+}
+
+}  // namespace
+
+TEST(QueryFilterUtilTest, GetStrippableKey) {
+  EXPECT_EQ(GetStrippableKey("key=value"), "key");
+  EXPECT_EQ(GetStrippableKey("=key=value"), "key");
+  EXPECT_EQ(GetStrippableKey("key==value"), "key");
+  EXPECT_EQ(GetStrippableKey("key=value=more"), "key");
+  EXPECT_EQ(GetStrippableKey("key"), absl::nullopt);
+  EXPECT_EQ(GetStrippableKey("key="), absl::nullopt);
+  EXPECT_EQ(GetStrippableKey("key=="), absl::nullopt);
+  EXPECT_EQ(GetStrippableKey("=value"), absl::nullopt);
+  EXPECT_EQ(GetStrippableKey("=="), absl::nullopt);
+  EXPECT_EQ(GetStrippableKey(""), absl::nullopt);
+}
+
+TEST(QueryFilterUtilTest, StripQueryParameters) {
+  EXPECT_EQ(Strip("fbclid=11&param1=1&second=2"), "param1=1");
+  EXPECT_EQ(Strip("param1=1&fbclid=11&second=2"), "param1=1");
+  EXPECT_EQ(Strip("param1=1&fbclid=11&param2=2"), "param1=1&param2=2");
+  EXPECT_EQ(Strip("fbclid=11&fbclid2=ok&&param1=1&foo;bar=yes&second=2"),
+            "fbclid2=ok&&param1=1&foo;bar=yes");
+  EXPECT_EQ(
+      Strip("fbclid=11&fbclid=11&fbclid=22&param1=1&second=2&second=2"),
+      "param1=1");
+  EXPECT_EQ(Strip("&fbclid=1&"), "&");
+  EXPECT_EQ(Strip("fbclid=&fbclid&=fbclid"), "fbclid=&fbclid&=fbclid");
+  EXPECT_EQ(Strip("fbclid=11"), "");
+  EXPECT_EQ(Strip("param1=1"), "param1=1");
+  EXPECT_EQ(Strip(""), "");
+}
+
+TEST(QueryFilterUtilTest, NoCopyWhenUnchanged) {
+  EXPECT_EQ(StripQueryParameters("a=1&b=2&&c",
+                                 [](base::StringPiece) { return false; }),
+            absl::nullopt);
+  EXPECT_EQ(StripQueryParameters("a=1", [](base::StringPiece) { return true; }),
+            "");
+}
+
+}  // namespace query_filter
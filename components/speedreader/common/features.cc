@@ -21,6 +21,11 @@ const base::Feature kSpeedreaderFeature {
 const base::Feature kSpeedreaderPanelV2{"SpeedreaderPanelV2",
                                         base::FEATURE_DISABLED_BY_DEFAULT};
 
+// Feed the rewriter as body chunks arrive instead of buffering the whole
+// document before distilling it.
+const base::Feature kSpeedreaderStreamingDistill{
+    "SpeedreaderStreamingDistill", base::FEATURE_DISABLED_BY_DEFAULT};
+
 const base::FeatureParam<int> kSpeedreaderMinOutLengthParam{
     &kSpeedreaderFeature, "min_out_length", 1000};
 
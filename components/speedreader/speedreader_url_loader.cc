@@ -12,12 +12,17 @@
 #include "base/bind.h"
 #include "base/check.h"
 #include "base/command_line.h"
+#include "base/feature_list.h"
 #include "base/files/file_util.h"
 #include "base/memory/weak_ptr.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/string_piece.h"
 #include "base/task/task_traits.h"
 #include "base/task/thread_pool.h"
+#include "base/time/time.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/components/body_sniffer/body_sniffer_throttle.h"
+#include "brave/components/speedreader/common/features.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_result_delegate.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
@@ -51,6 +56,76 @@ void MaybeSaveDistilledDataForDebug(const GURL& url,
 
 }  // namespace
 
+// Keeps a Rewriter alive on a dedicated sequence so that chunks can be pumped
+// into it while the rest of the body is still on the network.
+class SpeedReaderURLLoader::DistillPump {
+ public:
+  DistillPump(std::unique_ptr<Rewriter> rewriter,
+              const GURL& response_url,
+              const std::string& stylesheet)
+      : rewriter_(std::move(rewriter)),
+        response_url_(response_url),
+        stylesheet_(stylesheet) {}
+  DistillPump(const DistillPump&) = delete;
+  DistillPump& operator=(const DistillPump&) = delete;
+  ~DistillPump() = default;
+
+  void Pump(std::string chunk) { Write(chunk); }
+
+  // Returns the distilled page, or |data| (the original body) if the page is
+  // not readable. If nothing was pumped yet the whole of |data| is written
+  // first, which is the non-streaming behavior.
+  std::string Finish(std::string data) {
+    if (!pumped_)
+      Write(data);
+
+    base::ElapsedTimer timer;
+    std::string result = FinishInternal(std::move(data));
+    const base::TimeDelta finalize_time = timer.Elapsed();
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", pump_time_ + finalize_time);
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill.Pump", pump_time_);
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill.Finalize", finalize_time);
+    return result;
+  }
+
+ private:
+  void Write(base::StringPiece chunk) {
+    base::ElapsedTimer timer;
+    pumped_ = true;
+    // After an error the rewriter is poisoned and ignores further writes.
+    if (rewriter_->Write(chunk.data(), chunk.length()) != 0)
+      failed_ = true;
+    pump_time_ += timer.Elapsed();
+  }
+
+  std::string FinishInternal(std::string data) {
+    // Error occurred
+    if (failed_) {
+      return data;
+    }
+
+    rewriter_->End();
+    const std::string& transformed = rewriter_->GetOutput();
+
+    // TODO(brave-browser/issues/10372): would be better to pass
+    // explicit signal back from rewriter to indicate if content was
+    // found
+    if (transformed.length() < 1024) {
+      return data;
+    }
+    MaybeSaveDistilledDataForDebug(response_url_, data, stylesheet_,
+                                   transformed);
+    return stylesheet_ + transformed;
+  }
+
+  std::unique_ptr<Rewriter> rewriter_;
+  const GURL response_url_;
+  const std::string stylesheet_;
+  bool pumped_ = false;
+  bool failed_ = false;
+  base::TimeDelta pump_time_;
+};
+
 // static
 std::tuple<mojo::PendingRemote<network::mojom::URLLoader>,
            mojo::PendingReceiver<network::mojom::URLLoaderClient>,
@@ -103,18 +178,36 @@ SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   DCHECK_EQ(State::kLoading, state_);
 
+  if (!distill_pump_ && rewriter_service_ &&
+      base::FeatureList::IsEnabled(kSpeedreaderStreamingDistill)) {
+    StartDistillPump();
+  }
+
+  const size_t previous_size = buffered_body_.size();
   if (!BodySnifferURLLoader::CheckBufferedBody(kReadBufferSize)) {
     return;
   }
 
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  if (distill_pump_) {
+    // The original bytes stay in |buffered_body_| in case the page turns out
+    // not to be readable.
+    distill_pump_.AsyncCall(&DistillPump::Pump)
+        .WithArgs(buffered_body_.substr(previous_size));
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
 
+void SpeedReaderURLLoader::StartDistillPump() {
+  DCHECK(!distill_pump_);
+  distill_pump_.emplace(
+      base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::USER_BLOCKING, base::MayBlock()}),
+      rewriter_service_->MakeRewriter(response_url_,
+                                      speedreader_service_->GetThemeName()),
+      response_url_, rewriter_service_->GetContentStylesheet());
+}
+
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
   DCHECK_EQ(State::kSending, state_);
   if (bytes_remaining_in_buffer_ > 0) {
@@ -135,49 +228,24 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   bytes_remaining_in_buffer_ = body.size();
 
   if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::ThreadPool::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::TaskPriority::USER_BLOCKING, base::MayBlock()},
-        base::BindOnce(
-            [](const GURL& response_url, std::string data,
-               std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto{
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-              MaybeSaveDistilledDataForDebug(response_url, data, stylesheet,
-                                             transformed);
-              return stylesheet + transformed;
-            },
-            response_url_, std::move(body),
-            rewriter_service_->MakeRewriter(
-                response_url_, speedreader_service_->GetThemeName()),
-            rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(
-            [](base::WeakPtr<SpeedReaderURLLoader> self, std::string result) {
-              if (self) {
-                self->BodySnifferURLLoader::CompleteLoading(std::move(result));
-              }
-            },
-            weak_factory_.GetWeakPtr()));
+    // Offload heavy distilling to another thread. In streaming mode most of
+    // the work has already been done there while the body was loading.
+    if (!distill_pump_)
+      StartDistillPump();
+    distill_pump_.AsyncCall(&DistillPump::Finish)
+        .WithArgs(std::move(body))
+        .Then(base::BindOnce(&SpeedReaderURLLoader::OnDistillComplete,
+                             weak_factory_.GetWeakPtr()));
     return;
   }
   BodySnifferURLLoader::CompleteLoading(std::move(body));
 }
 
+void SpeedReaderURLLoader::OnDistillComplete(std::string result) {
+  distill_pump_.Reset();
+  BodySnifferURLLoader::CompleteLoading(std::move(result));
+}
+
 void SpeedReaderURLLoader::OnCompleteSending() {
   // TODO(keur, iefremov): This API could probably be improved with an enum
   // indicating distill success, distill fail, load from cache.
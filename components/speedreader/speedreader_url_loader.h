@@ -13,6 +13,7 @@
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/task/single_thread_task_runner.h"
+#include "base/threading/sequence_bound.h"
 #include "brave/components/body_sniffer/body_sniffer_url_loader.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
@@ -43,7 +44,11 @@ class SpeedReaderThrottle;
 //               kCompleted.
 // kLoading: Receives the body from the source loader and distills the page.
 //            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
+//            is finished. With kSpeedreaderStreamingDistill every chunk is
+//            also pumped into the rewriter as it arrives, so only the
+//            finalization is left once the body is complete. The kept body
+//            is what gets sent if the page turns out not to be readable.
+//            When all body has been received and distilling is
 //            done, this loader will dispatch queued messages like
 //            OnStartLoadingResponseBody() to the destination
 //            loader client, and then the state is changed to kSending.
@@ -85,6 +90,12 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
 
   void CompleteLoading(std::string body) override;
   void OnCompleteSending() override;
+  void StartDistillPump();
+  void OnDistillComplete(std::string result);
+
+  // Owns the Rewriter on a background sequence, see the .cc file.
+  class DistillPump;
+
   base::WeakPtr<SpeedreaderResultDelegate> delegate_;
 
   GURL response_url_;
@@ -93,6 +104,10 @@ class SpeedReaderURLLoader : public body_sniffer::BodySnifferURLLoader {
   raw_ptr<SpeedreaderRewriterService> rewriter_service_ = nullptr;
   raw_ptr<SpeedreaderService> speedreader_service_ = nullptr;
 
+  // Created as soon as the body starts loading in streaming mode, otherwise
+  // once the whole body has been buffered.
+  base::SequenceBound<DistillPump> distill_pump_;
+
   base::WeakPtrFactory<SpeedReaderURLLoader> weak_factory_{this};
 };
 
@@ -5,6 +5,7 @@
 
 #include "brave/components/tor/tor_control.h"
 
+#include <cstring>
 #include <utility>
 #include <vector>
 
@@ -43,14 +44,6 @@ const net::NetworkTrafficAnnotationTag tor_control_traffic_annotation =
 
 const size_t kTorBufferSize = 4096;
 
-constexpr char kGetVersionCmd[] = "GETINFO version";
-constexpr char kGetVersionReply[] = "version=";
-constexpr char kGetSOCKSListenersCmd[] = "GETINFO net/listeners/socks";
-constexpr char kGetSOCKSListenersReply[] = "net/listeners/socks=";
-constexpr char kGetCircuitEstablishedCmd[] =
-    "GETINFO status/circuit-established";
-constexpr char kGetCircuitEstablishedReply[] = "status/circuit-established=";
-
 static std::string escapify(const char* buf, int len) {
   std::ostringstream s;
   for (int i = 0; i < len; i++) {
@@ -93,7 +86,6 @@ TorControl::TorControl(base::WeakPtr<TorControl::Delegate> delegate,
       writing_(false),
       reading_(false),
       read_start_(-1),
-      read_cr_(false),
       delegate_(delegate) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
   DETACH_FROM_SEQUENCE(io_sequence_checker_);
@@ -195,8 +187,8 @@ void TorControl::Connected(std::vector<uint8_t> cookie, int rv) {
 //      we're ready.
 //
 void TorControl::Authenticated(bool error,
-                               const std::string& status,
-                               const std::string& reply) {
+                               base::StringPiece status,
+                               base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   if (!error) {
     if (status != "250" || reply != "OK")
@@ -229,40 +221,60 @@ void TorControl::Authenticated(bool error,
 void TorControl::Subscribe(TorControlEvent event,
                            base::OnceCallback<void(bool error)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
+  Subscribe(std::vector<TorControlEvent>{event}, std::move(callback));
+}
+
+// Subscribe(events, callback)
+//
+//      Subscribe to all of the events at once, with a single
+//      SETEVENTS for those not yet subscribed to.
+//
+void TorControl::Subscribe(std::vector<TorControlEvent> events,
+                           base::OnceCallback<void(bool error)> callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
   io_task_runner_->PostTask(
       FROM_HERE,
       base::BindOnce(&TorControl::DoSubscribe, weak_ptr_factory_.GetWeakPtr(),
-                     event, std::move(callback)));
+                     std::move(events), std::move(callback)));
 }
 
-void TorControl::DoSubscribe(TorControlEvent event,
+void TorControl::DoSubscribe(std::vector<TorControlEvent> events,
                              base::OnceCallback<void(bool error)> callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (async_events_[event]++ != 0) {
+  // Only events we weren't subscribed to yet need a SETEVENTS.  If it
+  // fails, the whole batch is rolled back, since the caller won't
+  // unsubscribe from any of it.
+  bool added = false;
+  for (TorControlEvent event : events) {
+    if (async_events_[event]++ == 0)
+      added = true;
+  }
+  if (!added) {
     bool error = false;
     std::move(callback).Run(error);
     return;
   }
 
-  async_events_[event] = 1;
   DoCmd(SetEventsCmd(), base::DoNothing(),
         base::BindOnce(&TorControl::Subscribed, weak_ptr_factory_.GetWeakPtr(),
-                       event, std::move(callback)));
+                       std::move(events), std::move(callback)));
 }
 
-void TorControl::Subscribed(TorControlEvent event,
+void TorControl::Subscribed(std::vector<TorControlEvent> events,
                             base::OnceCallback<void(bool error)> callback,
                             bool error,
-                            const std::string& status,
-                            const std::string& reply) {
+                            base::StringPiece status,
+                            base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   if (!error) {
     if (status != "250")
       error = true;
   }
   if (error) {
-    if (--async_events_[event] == 0)
-      async_events_.erase(event);
+    for (TorControlEvent event : events) {
+      if (--async_events_[event] == 0)
+        async_events_.erase(event);
+    }
   }
   std::move(callback).Run(error);
 }
@@ -308,8 +320,8 @@ void TorControl::DoUnsubscribe(TorControlEvent event,
 void TorControl::Unsubscribed(TorControlEvent event,
                               base::OnceCallback<void(bool error)> callback,
                               bool error,
-                              const std::string& status,
-                              const std::string& reply) {
+                              base::StringPiece status,
+                              base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   DCHECK_EQ(async_events_.count(event), 0u);
   if (!error) {
@@ -371,150 +383,65 @@ void TorControl::DoCmd(std::string cmd,
   }
 }
 
-// GetVersion(callback)
+// GetInfo(keys, callback)
 //
-//      Get the Tor version and call callback(error, version).
+//      Get the values of all keys with one GETINFO command and call
+//      callback(error, values).  Tor answers with a KEY=VALUE line per
+//      key, in the order asked for.
 //
-void TorControl::GetVersion(
-    base::OnceCallback<void(bool error, const std::string& version)> callback) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
-  std::unique_ptr<std::string> version = std::make_unique<std::string>();
-  std::string* version_p = version.get();
-  io_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(
-          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(), kGetVersionCmd,
-          base::BindRepeating(&TorControl::GetVersionLine,
-                              weak_ptr_factory_.GetWeakPtr(), version_p),
-          base::BindOnce(&TorControl::GetVersionDone,
-                         weak_ptr_factory_.GetWeakPtr(), std::move(version),
-                         std::move(callback))));
-}
-
-void TorControl::GetVersionLine(std::string* version,
-                                const std::string& status,
-                                const std::string& reply) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (status != "250" ||
-      !base::StartsWith(reply, kGetVersionReply,
-                        base::CompareCase::SENSITIVE) ||
-      !version->empty()) {
-    VLOG(0) << "tor: unexpected " << kGetVersionCmd << " reply";
-    return;
-  }
-  *version = reply.substr(strlen(kGetVersionReply));
-}
-
-void TorControl::GetVersionDone(
-    std::unique_ptr<std::string> version,
-    base::OnceCallback<void(bool error, const std::string& version)> callback,
-    bool error,
-    const std::string& status,
-    const std::string& reply) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (error || status != "250" || reply != "OK" || version->empty()) {
-    std::move(callback).Run(true, "");
-    return;
-  }
-  std::move(callback).Run(false, *version);
-}
-
-void TorControl::GetSOCKSListeners(
-    base::OnceCallback<
-        void(bool error, const std::vector<std::string>& listeners)> callback) {
+void TorControl::GetInfo(
+    std::vector<std::string> keys,
+    base::OnceCallback<void(bool error,
+                            const std::map<std::string, std::string>& values)>
+        callback) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
-  std::unique_ptr<std::vector<std::string>> listeners =
-      std::make_unique<std::vector<std::string>>();
-  std::vector<std::string>* listeners_p = listeners.get();
+  DCHECK(!keys.empty());
+  const std::string cmd = "GETINFO " + base::JoinString(keys, " ");
+  auto values = std::make_unique<std::map<std::string, std::string>>();
+  std::map<std::string, std::string>* values_p = values.get();
   io_task_runner_->PostTask(
       FROM_HERE,
       base::BindOnce(
-          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(),
-          kGetSOCKSListenersCmd,
-          base::BindRepeating(&TorControl::GetSOCKSListenersLine,
-                              weak_ptr_factory_.GetWeakPtr(), listeners_p),
-          base::BindOnce(&TorControl::GetSOCKSListenersDone,
-                         weak_ptr_factory_.GetWeakPtr(), std::move(listeners),
-                         std::move(callback))));
+          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(), cmd,
+          base::BindRepeating(&TorControl::GetInfoLine,
+                              weak_ptr_factory_.GetWeakPtr(), values_p),
+          base::BindOnce(&TorControl::GetInfoDone,
+                         weak_ptr_factory_.GetWeakPtr(), std::move(keys),
+                         std::move(values), std::move(callback))));
 }
 
-void TorControl::GetSOCKSListenersLine(std::vector<std::string>* listeners,
-                                       const std::string& status,
-                                       const std::string& reply) {
+void TorControl::GetInfoLine(std::map<std::string, std::string>* values,
+                             base::StringPiece status,
+                             base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (status != "250" || !base::StartsWith(reply, kGetSOCKSListenersReply,
-                                           base::CompareCase::SENSITIVE)) {
-    VLOG(0) << "tor: unexpected " << kGetSOCKSListenersCmd << " reply";
+  const size_t eq = reply.find('=');
+  if (status != "250" || eq == base::StringPiece::npos) {
+    VLOG(0) << "tor: unexpected GETINFO reply";
     return;
   }
-  listeners->push_back(reply.substr(strlen(kGetSOCKSListenersReply)));
+  values->emplace(std::string(reply.substr(0, eq)),
+                  std::string(reply.substr(eq + 1)));
 }
 
-void TorControl::GetSOCKSListenersDone(
-    std::unique_ptr<std::vector<std::string>> listeners,
-    base::OnceCallback<
-        void(bool error, const std::vector<std::string>& listeners)> callback,
+void TorControl::GetInfoDone(
+    std::vector<std::string> keys,
+    std::unique_ptr<std::map<std::string, std::string>> values,
+    base::OnceCallback<void(bool error,
+                            const std::map<std::string, std::string>& values)>
+        callback,
     bool error,
-    const std::string& status,
-    const std::string& reply) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (error || status != "250" || reply != "OK" || listeners->empty()) {
-    std::move(callback).Run(true, std::vector<std::string>());
-    return;
-  }
-  std::move(callback).Run(false, *listeners);
-}
-
-void TorControl::GetCircuitEstablished(
-    base::OnceCallback<void(bool error, bool established)> callback) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(owner_sequence_checker_);
-  std::unique_ptr<std::string> established = std::make_unique<std::string>();
-  std::string* established_p = established.get();
-  io_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(
-          &TorControl::DoCmd, weak_ptr_factory_.GetWeakPtr(),
-          kGetCircuitEstablishedCmd,
-          base::BindRepeating(&TorControl::GetCircuitEstablishedLine,
-                              weak_ptr_factory_.GetWeakPtr(), established_p),
-          base::BindOnce(&TorControl::GetCircuitEstablishedDone,
-                         weak_ptr_factory_.GetWeakPtr(), std::move(established),
-                         std::move(callback))));
-}
-
-void TorControl::GetCircuitEstablishedLine(std::string* established,
-                                           const std::string& status,
-                                           const std::string& reply) {
+    base::StringPiece status,
+    base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  if (status != "250" ||
-      !base::StartsWith(reply, kGetCircuitEstablishedReply,
-                        base::CompareCase::SENSITIVE) ||
-      !established->empty()) {
-    VLOG(0) << "tor: unexpected " << kGetCircuitEstablishedCmd << " reply";
-    return;
+  for (const auto& key : keys) {
+    if (!values->count(key))
+      error = true;
   }
-  *established = reply.substr(strlen(kGetCircuitEstablishedReply));
-}
-
-void TorControl::GetCircuitEstablishedDone(
-    std::unique_ptr<std::string> established,
-    base::OnceCallback<void(bool error, bool established)> callback,
-    bool error,
-    const std::string& status,
-    const std::string& reply) {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
-  bool result;
-  if (*established == "1")
-    result = true;
-  else if (*established == "0")
-    result = false;
-  else
-    error = true;
-  if (error || status != "250" || reply != "OK" || established->empty()) {
-    std::move(callback).Run(true, false);
+  if (error || status != "250" || reply != "OK") {
+    std::move(callback).Run(true, {});
     return;
   }
-  std::move(callback).Run(false, result);
+  std::move(callback).Run(false, *values);
 }
 
 void TorControl::SetupPluggableTransport(
@@ -601,8 +528,8 @@ void TorControl::SetupBridges(const std::vector<std::string>& bridges,
 void TorControl::OnPluggableTransportsConfigured(
     base::OnceCallback<void(bool error)> callback,
     bool error,
-    const std::string& status,
-    const std::string& reply) {
+    base::StringPiece status,
+    base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   VLOG(1) << __func__ << " " << reply;
   std::move(callback).Run(error || status != "250" || reply != "OK");
@@ -611,8 +538,8 @@ void TorControl::OnPluggableTransportsConfigured(
 void TorControl::OnBrigdesConfigured(
     base::OnceCallback<void(bool error)> callback,
     bool error,
-    const std::string& status,
-    const std::string& reply) {
+    base::StringPiece status,
+    base::StringPiece reply) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   VLOG(1) << __func__ << " " << reply;
   std::move(callback).Run(error || status != "250" || reply != "OK");
@@ -623,7 +550,10 @@ void TorControl::OnBrigdesConfigured(
 
 // StartWrite()
 //
-//      Pick a write off the queue and start an I/O buffer for it.
+//      Take all the writes off the queue and start an I/O buffer for
+//      them.  Commands queued while a write was in flight go out
+//      together, without waiting for each other's replies; those are
+//      matched up with cmdq_ in order as they come back.
 //
 //      Caller must ensure writing_ is true.
 //
@@ -632,9 +562,14 @@ void TorControl::StartWrite() {
   DCHECK(writing_);
   DCHECK(!writeq_.empty());
   DCHECK(!cmdq_.empty());
-  auto buf = base::MakeRefCounted<net::StringIOBuffer>(writeq_.front());
-  writeiobuf_ = base::MakeRefCounted<net::DrainableIOBuffer>(buf, buf->size());
+  std::string data = std::move(writeq_.front());
   writeq_.pop();
+  while (!writeq_.empty()) {
+    data += writeq_.front();
+    writeq_.pop();
+  }
+  auto buf = base::MakeRefCounted<net::StringIOBuffer>(std::move(data));
+  writeiobuf_ = base::MakeRefCounted<net::DrainableIOBuffer>(buf, buf->size());
 }
 
 // DoWrites()
@@ -799,39 +734,32 @@ void TorControl::ReadDone(int rv) {
     Error();
     return;
   }
-  const char* data = readiobuf_->data();
-  for (int i = 0; i < rv; i++) {
-    if (!read_cr_) {
-      // No CR yet.  Accept CR or non-LF; reject LF.
-      if (data[i] == 0x0d) {  // CR
-        read_cr_ = true;
-      } else if (data[i] == 0x0a) {  // LF
-        VLOG(1) << "tor: stray line feed";
-        Error();
-        return;
-      } else {
-        // Anything else: Just accept it and move on.
-      }
-    } else {
-      // CR seen.  Accept LF; reject all else.
-      if (data[i] == 0x0a) {  // LF
-        // CRLF seen, so we must have i >= 2.  Emit a line and advance
-        // to the next one, unless anything went wrong with the line.
-        assert(i >= 1);
-        std::string line(readiobuf_->StartOfBuffer() + read_start_,
-                         readiobuf_->offset() + i - 1 - read_start_);
-        read_start_ = readiobuf_->offset() + i + 1;
-        read_cr_ = false;
-        if (!ReadLine(line)) {
-          reading_ = false;
-          return;
-        }
-      } else {
-        // CR seen, but not LF.  Bad.
-        VLOG(1) << "tor: stray carriage return";
-        Error();
-        return;
-      }
+  // Only the bytes just read can hold a new line feed: everything
+  // before them up to read_start_ is the unterminated tail of a line.
+  // Each line is handed to ReadLine() in place, without copying it.
+  const char* const buffer = readiobuf_->StartOfBuffer();
+  const char* const data_end = readiobuf_->data() + rv;
+  const char* scan = readiobuf_->data();
+  while (const char* lf = static_cast<const char*>(
+             memchr(scan, 0x0a, data_end - scan))) {
+    base::StringPiece line(buffer + read_start_,
+                           lf - (buffer + read_start_));
+    if (line.empty() || line.back() != 0x0d) {
+      VLOG(1) << "tor: stray line feed";
+      Error();
+      return;
+    }
+    line.remove_suffix(1);
+    if (line.find(0x0d) != base::StringPiece::npos) {
+      VLOG(1) << "tor: stray carriage return";
+      Error();
+      return;
+    }
+    read_start_ = lf + 1 - buffer;
+    scan = lf + 1;
+    if (!ReadLine(line)) {
+      reading_ = false;
+      return;
     }
   }
 
@@ -865,7 +793,6 @@ void TorControl::ReadDone(int rv) {
     reading_ = false;
     readiobuf_.reset();
     read_start_ = 0;
-    read_cr_ = false;
     return;
   }
 }
@@ -875,7 +802,7 @@ void TorControl::ReadDone(int rv) {
 //      We have read a line of input; process it.  Return true on
 //      success, false on error.
 //
-bool TorControl::ReadLine(const std::string& line) {
+bool TorControl::ReadLine(base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
 
   if (line.size() < 4) {
@@ -890,9 +817,9 @@ bool TorControl::ReadLine(const std::string& line) {
   // intermediate reply and ` ' for a final reply.
   //
   // TODO(riastradh): parse or check syntax of status
-  std::string status(line, 0, 3);
-  char pos = line[3];
-  std::string reply(line, 4);
+  const base::StringPiece status = line.substr(0, 3);
+  const char pos = line[3];
+  const base::StringPiece reply = line.substr(4);
 
   // Determine whether it is an asynchronous reply, status 6yz.
   if (status[0] == '6') {
@@ -903,10 +830,8 @@ bool TorControl::ReadLine(const std::string& line) {
     if (!async_) {
       // Parse the keyword and the initial line.
       const size_t sp = reply.find(' ');
-      std::string event_name, initial;
-      if (sp == std::string::npos) {
-        event_name = reply;
-      } else {
+      base::StringPiece event_name = reply, initial;
+      if (sp != base::StringPiece::npos) {
         event_name = reply.substr(0, sp);
         initial = reply.substr(sp + 1);
       }
@@ -947,7 +872,7 @@ bool TorControl::ReadLine(const std::string& line) {
                                                      : (*found).second);
           async_ = std::make_unique<Async>();
           async_->event = event;
-          async_->initial = initial;
+          async_->initial = std::string(initial);
           async_->skip = (event == TorControlEvent::INVALID);
           return true;
         }
@@ -966,45 +891,33 @@ bool TorControl::ReadLine(const std::string& line) {
             async_->skip = true;
             async_->event = TorControlEvent::INVALID;
             async_->initial.clear();
-            async_->extra.clear();
+            async_->lines.clear();
             return true;
           }
-          std::string key, value;
-          if (!ParseKV(reply, &key, &value)) {
-            VLOG(1) << "tor: invalid async continuation line";
-            Error();
-            return false;
-          }
-          if (async_->extra.count(key)) {
-            VLOG(1) << "tor: duplicate key in async continuation line";
-            Error();
-            return false;
-          }
-          async_->extra[key] = value;
+          async_->lines.emplace_back(reply);
           return true;
         }
         case ' ': {
-          // End of an async reply.  Parse it and finish it, unless
-          // we're skipping.
-          if (!async_->skip) {
-            std::string key, value;
-            if (!ParseKV(reply, &key, &value)) {
-              VLOG(1) << "tor: invalid async event";
-              Error();
-              return false;
-            }
-            if (async_->extra.count(key)) {
-              VLOG(1) << "tor: duplicate key in async event";
-              Error();
-              return false;
-            }
-            async_->extra[key] = value;
-
-            // If we're still subscribed, notify the delegate of the
-            // parsed reply.
-            if (async_events_.count(async_->event)) {
-              NotifyTorEvent(async_->event, async_->initial, async_->extra);
+          // End of an async reply.  If we're still subscribed, parse
+          // the lines we held on to and notify the delegate.  Nothing
+          // is parsed for a reply we end up skipping.
+          if (!async_->skip && async_events_.count(async_->event)) {
+            async_->lines.emplace_back(reply);
+            std::map<std::string, std::string> extra;
+            for (const std::string& kv : async_->lines) {
+              std::string key, value;
+              if (!ParseKV(kv, &key, &value)) {
+                VLOG(1) << "tor: invalid async continuation line";
+                Error();
+                return false;
+              }
+              if (!extra.emplace(std::move(key), std::move(value)).second) {
+                VLOG(1) << "tor: duplicate key in async continuation line";
+                Error();
+                return false;
+              }
             }
+            NotifyTorEvent(async_->event, async_->initial, std::move(extra));
           }
           async_.reset();
           return true;
@@ -1069,7 +982,6 @@ void TorControl::Error() {
   reading_ = false;
   readiobuf_.reset();
   read_start_ = -1;
-  read_cr_ = false;
 
   // Clear write state.
   writeq_ = {};
@@ -1093,14 +1005,13 @@ void TorControl::NotifyTorControlClosed() {
       base::BindOnce(&Delegate::OnTorControlClosed, delegate_, running_));
 }
 
-void TorControl::NotifyTorEvent(
-    TorControlEvent event,
-    const std::string& initial,
-    const std::map<std::string, std::string>& extra) {
+void TorControl::NotifyTorEvent(TorControlEvent event,
+                                base::StringPiece initial,
+                                std::map<std::string, std::string> extra) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorEvent, delegate_, event, initial, extra));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorEvent, delegate_, event,
+                                std::string(initial), std::move(extra)));
 }
 
 void TorControl::NotifyTorRawCmd(const std::string& cmd) {
@@ -1109,28 +1020,28 @@ void TorControl::NotifyTorRawCmd(const std::string& cmd) {
       FROM_HERE, base::BindOnce(&Delegate::OnTorRawCmd, delegate_, cmd));
 }
 
-void TorControl::NotifyTorRawAsync(const std::string& status,
-                                   const std::string& line) {
+void TorControl::NotifyTorRawAsync(base::StringPiece status,
+                                   base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawAsync, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawAsync, delegate_,
+                                std::string(status), std::string(line)));
 }
 
-void TorControl::NotifyTorRawMid(const std::string& status,
-                                 const std::string& line) {
+void TorControl::NotifyTorRawMid(base::StringPiece status,
+                                 base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawMid, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawMid, delegate_,
+                                std::string(status), std::string(line)));
 }
 
-void TorControl::NotifyTorRawEnd(const std::string& status,
-                                 const std::string& line) {
+void TorControl::NotifyTorRawEnd(base::StringPiece status,
+                                 base::StringPiece line) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(io_sequence_checker_);
   owner_task_runner_->PostTask(
-      FROM_HERE,
-      base::BindOnce(&Delegate::OnTorRawEnd, delegate_, status, line));
+      FROM_HERE, base::BindOnce(&Delegate::OnTorRawEnd, delegate_,
+                                std::string(status), std::string(line)));
 }
 
 // ParseKV(string, key, value)
@@ -1140,7 +1051,7 @@ void TorControl::NotifyTorRawEnd(const std::string& status,
 //      success, false on failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value) {
   size_t end;
@@ -1155,21 +1066,21 @@ bool TorControl::ParseKV(const std::string& string,
 //      failure.
 //
 // static
-bool TorControl::ParseKV(const std::string& string,
+bool TorControl::ParseKV(base::StringPiece string,
                          std::string* key,
                          std::string* value,
                          size_t* end) {
   DCHECK(key && value && end);
   // Search for `=' -- it had better be there.
-  size_t eq = string.find("=");
-  if (eq == std::string::npos)
+  size_t eq = string.find('=');
+  if (eq == base::StringPiece::npos)
     return false;
   size_t vstart = eq + 1;
 
   // If we're at the end of the string, value is empt.
   if (vstart == string.size()) {
-    *key = string.substr(0, eq);
-    *value = "";
+    *key = std::string(string.substr(0, eq));
+    value->clear();
     *end = string.size();
     return true;
   }
@@ -1178,7 +1089,7 @@ bool TorControl::ParseKV(const std::string& string,
   if (string[vstart] != '"') {
     // Not quoted.  Check for a delimiter.
     size_t i, vend = string.size();
-    if ((i = string.find(" ", vstart)) != std::string::npos) {
+    if ((i = string.find(' ', vstart)) != base::StringPiece::npos) {
       // Delimited.  Stop at the delimiter, and consume it.
       vend = i;
       *end = vend + 1;
@@ -1187,26 +1098,66 @@ bool TorControl::ParseKV(const std::string& string,
       *end = vend;
     }
 
-    // Check for internal quotes; they are forbidden.
-    if (string.find("\"", vstart) != std::string::npos)
+    // Check for internal quotes; they are forbidden.  Only look at
+    // the value itself, later pairs may well be quoted.
+    if (string.substr(vstart, vend - vstart).find('"') !=
+        base::StringPiece::npos)
       return false;
 
     // Extract the key and value and we're done.
-    *key = string.substr(0, eq);
-    *value = string.substr(vstart, vend - vstart);
+    *key = std::string(string.substr(0, eq));
+    *value = std::string(string.substr(vstart, vend - vstart));
     return true;
   }
 
   // Quoted string.  Parse it, and consume trailing spaces.
   if (!ParseQuoted(string.substr(eq + 1), value, end))
     return false;
-  *key = string.substr(0, eq);
+  *key = std::string(string.substr(0, eq));
   *end += eq + 1;
   while (*end < string.size() && string[*end] == ' ')
     (*end)++;
   return true;
 }
 
+// ParseBootstrapStatus(initial, status)
+//
+//      Parse the initial line of a STATUS_CLIENT event of the form
+//      `SEVERITY BOOTSTRAP KEY=VALUE ...' into status.  Return true
+//      on success, false if it is not a bootstrap event or PROGRESS
+//      is missing or malformed.
+//
+// static
+bool TorControl::ParseBootstrapStatus(base::StringPiece initial,
+                                      BootstrapStatus* status) {
+  DCHECK(status);
+  constexpr base::StringPiece kBootstrap = "BOOTSTRAP ";
+  const size_t sp = initial.find(' ');
+  if (sp == base::StringPiece::npos ||
+      !base::StartsWith(initial.substr(sp + 1), kBootstrap))
+    return false;
+
+  base::StringPiece args = initial.substr(sp + 1 + kBootstrap.size());
+  bool have_progress = false;
+  *status = BootstrapStatus();
+  while (!args.empty()) {
+    std::string key, value;
+    size_t end;
+    if (!ParseKV(args, &key, &value, &end))
+      return false;
+    if (key == "PROGRESS") {
+      if (!base::StringToInt(value, &status->progress) ||
+          status->progress < 0 || status->progress > 100)
+        return false;
+      have_progress = true;
+    } else if (key == "SUMMARY") {
+      status->summary = std::move(value);
+    }
+    args = args.substr(end);
+  }
+  return have_progress;
+}
+
 // ParseQuoted(string, value, end)
 //
 //      Parse a quoted string starting _after_ the initial `"'.  Set
@@ -1215,7 +1166,7 @@ bool TorControl::ParseKV(const std::string& string,
 //      return false on failure.
 //
 // static
-bool TorControl::ParseQuoted(const std::string& string,
+bool TorControl::ParseQuoted(base::StringPiece string,
                              std::string* value,
                              size_t* end) {
   enum {
@@ -1340,7 +1291,8 @@ bool TorControl::ParseQuoted(const std::string& string,
       case REJECT:
         return false;
       case ACCEPT:
-        *value = buf.substr(0, pos);
+        buf.resize(pos);
+        *value = std::move(buf);
         *end = i + 1;
         return true;
       default:
@@ -17,6 +17,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/tor/tor_control_event.h"
 
 namespace base {
@@ -44,11 +45,13 @@ namespace tor {
 // sure callback will be ran on the dedicated thread.
 class TorControl {
  public:
+  // Replies point into the read buffer, and are only valid for the duration
+  // of the call.
   using PerLineCallback =
-      base::RepeatingCallback<void(const std::string& status,
-                                   const std::string& reply)>;
+      base::RepeatingCallback<void(base::StringPiece status,
+                                   base::StringPiece reply)>;
   using CmdCallback = base::OnceCallback<
-      void(bool error, const std::string& status, const std::string& reply)>;
+      void(bool error, base::StringPiece status, base::StringPiece reply)>;
 
   class Delegate : public base::SupportsWeakPtr<Delegate> {
    public:
@@ -80,18 +83,19 @@ class TorControl {
 
   void Subscribe(TorControlEvent event,
                  base::OnceCallback<void(bool error)> callback);
+  // Subscribes to all of |events| with a single SETEVENTS.
+  void Subscribe(std::vector<TorControlEvent> events,
+                 base::OnceCallback<void(bool error)> callback);
   void Unsubscribe(TorControlEvent event,
                    base::OnceCallback<void(bool error)> callback);
 
-  void GetVersion(
-      base::OnceCallback<void(bool error, const std::string& version)>
-          callback);
-  void GetSOCKSListeners(
+  // Queries all of |keys| with a single GETINFO.  |values| holds the raw
+  // value of every key unless there was an error.
+  void GetInfo(
+      std::vector<std::string> keys,
       base::OnceCallback<void(bool error,
-                              const std::vector<std::string>& listeners)>
+                              const std::map<std::string, std::string>& values)>
           callback);
-  void GetCircuitEstablished(
-      base::OnceCallback<void(bool error, bool established)> callback);
 
   void SetupPluggableTransport(const base::FilePath& snowflake,
                                const base::FilePath& obfs4,
@@ -99,21 +103,34 @@ class TorControl {
   void SetupBridges(const std::vector<std::string>& bridges,
                     base::OnceCallback<void(bool error)> callback);
 
+  // Typed form of a `STATUS_CLIENT <severity> BOOTSTRAP ...' event, parsed
+  // on demand from the event's initial line.
+  struct BootstrapStatus {
+    int progress = 0;
+    std::string summary;
+  };
+  static bool ParseBootstrapStatus(base::StringPiece initial,
+                                   BootstrapStatus* status);
+
  protected:
   friend class TorControlTest;
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseQuoted);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseKV);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ParseBootstrapStatus);
   FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadLine);
-  FRIEND_TEST_ALL_PREFIXES(TorControlTest, GetCircuitEstablishedDone);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReplayTranscript);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, ReadDoneFraming);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, GetInfoDone);
+  FRIEND_TEST_ALL_PREFIXES(TorControlTest, PipelinedCommands);
 
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value);
-  static bool ParseKV(const std::string& string,
+  static bool ParseKV(base::StringPiece string,
                       std::string* key,
                       std::string* value,
                       size_t* end);
-  static bool ParseQuoted(const std::string& string,
+  static bool ParseQuoted(base::StringPiece string,
                           std::string* value,
                           size_t* end);
 
@@ -122,77 +139,61 @@ class TorControl {
   void StopOnTaskRunner();
   void Connected(std::vector<uint8_t> cookie, int rv);
   void Authenticated(bool error,
-                     const std::string& status,
-                     const std::string& reply);
+                     base::StringPiece status,
+                     base::StringPiece reply);
 
   void DoCmd(std::string cmd, PerLineCallback perline, CmdCallback callback);
 
-  void GetVersionLine(std::string* version,
-                      const std::string& status,
-                      const std::string& line);
-  void GetVersionDone(
-      std::unique_ptr<std::string> version,
-      base::OnceCallback<void(bool error, const std::string& version)> callback,
-      bool error,
-      const std::string& status,
-      const std::string& reply);
-  void GetSOCKSListenersLine(std::vector<std::string>* listeners,
-                             const std::string& status,
-                             const std::string& reply);
-  void GetSOCKSListenersDone(
-      std::unique_ptr<std::vector<std::string>> listeners,
-      base::OnceCallback<
-          void(bool error, const std::vector<std::string>& listeners)> callback,
-      bool error,
-      const std::string& status,
-      const std::string& reply);
-  void GetCircuitEstablishedLine(std::string* established,
-                                 const std::string& status,
-                                 const std::string& reply);
-  void GetCircuitEstablishedDone(
-      std::unique_ptr<std::string> established,
-      base::OnceCallback<void(bool error, bool established)> callback,
+  void GetInfoLine(std::map<std::string, std::string>* values,
+                   base::StringPiece status,
+                   base::StringPiece reply);
+  void GetInfoDone(
+      std::vector<std::string> keys,
+      std::unique_ptr<std::map<std::string, std::string>> values,
+      base::OnceCallback<void(bool error,
+                              const std::map<std::string, std::string>& values)>
+          callback,
       bool error,
-      const std::string& status,
-      const std::string& reply);
+      base::StringPiece status,
+      base::StringPiece reply);
 
-  void DoSubscribe(TorControlEvent event,
+  void DoSubscribe(std::vector<TorControlEvent> events,
                    base::OnceCallback<void(bool error)> callback);
-  void Subscribed(TorControlEvent event,
+  void Subscribed(std::vector<TorControlEvent> events,
                   base::OnceCallback<void(bool error)> callback,
                   bool error,
-                  const std::string& status,
-                  const std::string& reply);
+                  base::StringPiece status,
+                  base::StringPiece reply);
   void DoUnsubscribe(TorControlEvent event,
                      base::OnceCallback<void(bool error)> callback);
   void Unsubscribed(TorControlEvent event,
                     base::OnceCallback<void(bool error)> callback,
                     bool error,
-                    const std::string& status,
-                    const std::string& reply);
+                    base::StringPiece status,
+                    base::StringPiece reply);
   std::string SetEventsCmd();
 
   void OnPluggableTransportsConfigured(
       base::OnceCallback<void(bool error)> callback,
       bool error,
-      const std::string& status,
-      const std::string& reply);
+      base::StringPiece status,
+      base::StringPiece reply);
   void OnBrigdesConfigured(base::OnceCallback<void(bool error)> callback,
                            bool error,
-                           const std::string& status,
-                           const std::string& reply);
+                           base::StringPiece status,
+                           base::StringPiece reply);
 
   // Notify delegate on UI thread
   void NotifyTorControlReady();
   void NotifyTorControlClosed();
 
   void NotifyTorEvent(TorControlEvent,
-                      const std::string& initial,
-                      const std::map<std::string, std::string>& extra);
+                      base::StringPiece initial,
+                      std::map<std::string, std::string> extra);
   void NotifyTorRawCmd(const std::string& cmd);
-  void NotifyTorRawAsync(const std::string& status, const std::string& line);
-  void NotifyTorRawMid(const std::string& status, const std::string& line);
-  void NotifyTorRawEnd(const std::string& status, const std::string& line);
+  void NotifyTorRawAsync(base::StringPiece status, base::StringPiece line);
+  void NotifyTorRawMid(base::StringPiece status, base::StringPiece line);
+  void NotifyTorRawEnd(base::StringPiece status, base::StringPiece line);
 
   void StartWrite();
   void DoWrites();
@@ -203,7 +204,7 @@ class TorControl {
   void DoReads();
   void ReadDoneAsync(int rv);
   void ReadDone(int rv);
-  bool ReadLine(const std::string& line);
+  bool ReadLine(base::StringPiece line);
 
   void Error();
 
@@ -229,7 +230,6 @@ class TorControl {
   bool reading_;
   scoped_refptr<net::GrowableIOBuffer> readiobuf_;
   int read_start_;  // offset where the current line starts
-  bool read_cr_;    // true if we have parsed a CR
 
   // Asynchronous command response callback state machine.
   std::map<TorControlEvent, size_t> async_events_;
@@ -238,7 +238,9 @@ class TorControl {
     ~Async();
     TorControlEvent event;
     std::string initial;
-    std::map<std::string, std::string> extra;
+    // Continuation lines, kept raw and only parsed into KEY=VALUE pairs
+    // once the reply is complete and still wanted.
+    std::vector<std::string> lines;
     bool skip;
   };
   std::unique_ptr<Async> async_;
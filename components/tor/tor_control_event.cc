@@ -7,7 +7,8 @@
 
 namespace tor {
 
-const std::map<std::string, TorControlEvent> kTorControlEventByName = {
+const base::flat_map<base::StringPiece, TorControlEvent>
+    kTorControlEventByName = {
 #define TOR_EVENT(N) {#N, TorControlEvent::N},
 #include "tor_control_event_list.h"  // NOLINT
 #undef TOR_EVENT
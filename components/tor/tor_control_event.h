@@ -9,6 +9,9 @@
 #include <map>
 #include <string>
 
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+
 namespace tor {
 
 enum class TorControlEvent {
@@ -18,7 +21,10 @@ enum class TorControlEvent {
 #undef TOR_EVENT
 };
 
-extern const std::map<std::string, TorControlEvent> kTorControlEventByName;
+// Keyed by StringPiece so that event names can be looked up straight out of
+// the control connection's read buffer.
+extern const base::flat_map<base::StringPiece, TorControlEvent>
+    kTorControlEventByName;
 extern const std::map<TorControlEvent, std::string> kTorControlEventByEnum;
 
 }  // namespace tor
@@ -3,15 +3,34 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "brave/components/tor/tor_control.h"
 
+#include "base/base_paths.h"
 #include "base/callback_helpers.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/path_service.h"
 #include "base/run_loop.h"
+#include "base/strings/string_util.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/test/bind.h"
+#include "base/test/gmock_callback_support.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/test/browser_task_environment.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/socket/stream_socket.h"
+#include "net/socket/tcp_server_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -30,6 +49,87 @@ class MockTorControlDelegate : public TorControl::Delegate {
   MOCK_METHOD2(OnTorRawMid, void(const std::string&, const std::string&));
   MOCK_METHOD2(OnTorRawEnd, void(const std::string&, const std::string&));
 };
+
+// Feeds |input| to |control| as if it had been read from the control port,
+// |chunk_size| bytes at a time.  Returns false if the control connection
+// stopped reading before all of the input was consumed.
+bool FeedControlInput(TorControl* control,
+                      const std::string& input,
+                      size_t chunk_size) {
+  for (size_t offset = 0; offset < input.size();) {
+    if (!control->reading_)
+      return false;
+    const size_t capacity = control->readiobuf_->RemainingCapacity();
+    const size_t size =
+        std::min({chunk_size, input.size() - offset, capacity});
+    memcpy(control->readiobuf_->data(), input.data() + offset, size);
+    control->ReadDone(size);
+    offset += size;
+  }
+  return control->reading_;
+}
+
+// A control port which tor would be listening on, played by the test.
+class FakeControlPort {
+ public:
+  FakeControlPort() : server_(nullptr, net::NetLogSource()) {
+    EXPECT_EQ(net::OK, server_.ListenWithAddressAndPort("127.0.0.1", 0, 1));
+    net::IPEndPoint address;
+    EXPECT_EQ(net::OK, server_.GetLocalAddress(&address));
+    port_ = address.port();
+  }
+
+  int port() const { return port_; }
+
+  void Accept() {
+    net::TestCompletionCallback callback;
+    int rv = server_.Accept(&socket_, callback.callback());
+    ASSERT_EQ(net::OK, callback.GetResult(rv));
+  }
+
+  // Waits for |count| commands to come in and returns them without their
+  // line endings.
+  std::vector<std::string> ReadCommands(size_t count) {
+    std::vector<std::string> commands;
+    while (commands.size() < count) {
+      const size_t crlf = pending_.find("\r\n");
+      if (crlf != std::string::npos) {
+        commands.push_back(pending_.substr(0, crlf));
+        pending_.erase(0, crlf + 2);
+        continue;
+      }
+      auto buffer = base::MakeRefCounted<net::IOBuffer>(1024);
+      net::TestCompletionCallback callback;
+      int rv = callback.GetResult(
+          socket_->Read(buffer.get(), 1024, callback.callback()));
+      if (rv <= 0) {
+        ADD_FAILURE() << "control port read failed: " << rv;
+        break;
+      }
+      pending_.append(buffer->data(), rv);
+    }
+    return commands;
+  }
+
+  void Write(const std::string& data) {
+    auto buffer = base::MakeRefCounted<net::DrainableIOBuffer>(
+        base::MakeRefCounted<net::StringIOBuffer>(data), data.size());
+    while (buffer->BytesRemaining()) {
+      net::TestCompletionCallback callback;
+      int rv = callback.GetResult(
+          socket_->Write(buffer.get(), buffer->BytesRemaining(),
+                         callback.callback(), TRAFFIC_ANNOTATION_FOR_TESTS));
+      ASSERT_GT(rv, 0);
+      buffer->DidConsume(rv);
+    }
+  }
+
+ private:
+  net::TCPServerSocket server_;
+  std::unique_ptr<net::StreamSocket> socket_;
+  std::string pending_;
+  int port_ = 0;
+};
 }  // namespace
 
 TEST(TorControlTest, ParseQuoted) {
@@ -79,6 +179,8 @@ TEST(TorControlTest, ParseKV) {
       {"foo=\"bar\\\"baz\"", "foo", "bar\"baz", 14},
       {"foo=\"bar\\\"baz\" quux=\"zot\"", "foo", "bar\"baz", 15},
       {"foo=barbaz quux=zot", "foo", "barbaz", 11},
+      {"foo=bar baz=\"q\"", "foo", "bar", 8},
+      {"foo=b\"ar baz=zot", nullptr, nullptr, static_cast<size_t>(-1)},
       {"foo=\"bar", nullptr, nullptr, static_cast<size_t>(-1)},
   };
   size_t i;
@@ -107,6 +209,43 @@ TEST(TorControlTest, ParseKV) {
   }
 }
 
+TEST(TorControlTest, ParseBootstrapStatus) {
+  const struct {
+    const char* input;
+    bool ok;
+    int progress;
+    const char* summary;
+  } cases[] = {
+      {"NOTICE BOOTSTRAP PROGRESS=10 TAG=conn_done "
+       "SUMMARY=\"Connected to a relay\"",
+       true, 10, "Connected to a relay"},
+      {"NOTICE BOOTSTRAP PROGRESS=100 TAG=done SUMMARY=\"Done\"", true, 100,
+       "Done"},
+      {"WARN BOOTSTRAP PROGRESS=5 TAG=conn SUMMARY=\"Connecting\" "
+       "WARNING=\"Connection refused\" REASON=CONNECTREFUSED COUNT=1",
+       true, 5, "Connecting"},
+      {"NOTICE BOOTSTRAP PROGRESS=0", true, 0, ""},
+      {"NOTICE CIRCUIT_ESTABLISHED", false, 0, nullptr},
+      {"NOTICE BOOTSTRAP TAG=done SUMMARY=\"Done\"", false, 0, nullptr},
+      {"NOTICE BOOTSTRAP PROGRESS=lots", false, 0, nullptr},
+      {"NOTICE BOOTSTRAP PROGRESS=101", false, 0, nullptr},
+      {"NOTICE BOOTSTRAP PROGRESS=1 SUMMARY=\"Done", false, 0, nullptr},
+      {"BOOTSTRAP", false, 0, nullptr},
+  };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    TorControl::BootstrapStatus status;
+    bool ok = TorControl::ParseBootstrapStatus(cases[i].input, &status);
+    EXPECT_EQ(ok, cases[i].ok) << i << ": " << cases[i].input;
+    if (cases[i].ok && ok) {
+      EXPECT_EQ(status.progress, cases[i].progress)
+          << i << ": " << cases[i].input;
+      EXPECT_EQ(status.summary, cases[i].summary)
+          << i << ": " << cases[i].input;
+    }
+  }
+}
+
 TEST(TorControlTest, ReadLine) {
   content::BrowserTaskEnvironment task_environment;
   scoped_refptr<base::SequencedTaskRunner> io_task_runner =
@@ -147,7 +286,9 @@ TEST(TorControlTest, ReadLine) {
   EXPECT_CALL(delegate, OnTorRawAsync("650", "END=FAKEVENT")).Times(1);
   EXPECT_CALL(delegate, OnTorRawAsync("650", "CIRC 1000 EXTENDED")).Times(1);
   EXPECT_CALL(delegate, OnTorRawAsync("650", "EXTRAMAGIC=99")).Times(1);
-  EXPECT_CALL(delegate, OnTorRawAsync("650", "ANONYMITY=high")).Times(1);
+  EXPECT_CALL(delegate, OnTorRawAsync("650", "ANONYMITY=high")).Times(2);
+  EXPECT_CALL(delegate, OnTorRawAsync("650", "CIRC 1001 EXTENDED")).Times(1);
+  EXPECT_CALL(delegate, OnTorRawAsync("650", "NOT A KV")).Times(1);
   EXPECT_CALL(delegate,
               OnTorEvent(TorControlEvent::NETWORK_LIVENESS, "DOWN", testing::_))
       .Times(1);
@@ -180,13 +321,163 @@ TEST(TorControlTest, ReadLine) {
             EXPECT_TRUE(control->ReadLine("650-EXTRAMAGIC=99"));
             EXPECT_TRUE(control->ReadLine("650 ANONYMITY=high"));
             EXPECT_FALSE(control->async_);
+            // Continuation lines are only parsed once the reply is
+            // complete and still wanted, so an unwanted one is dropped
+            // without looking at its content.
+            EXPECT_TRUE(control->ReadLine("650-CIRC 1001 EXTENDED"));
+            EXPECT_TRUE(control->ReadLine("650-NOT A KV"));
+            control->async_events_.erase(TorControlEvent::CIRC);
+            EXPECT_TRUE(control->ReadLine("650 ANONYMITY=high"));
+            EXPECT_FALSE(control->async_);
           },
           std::move(control)));
 
   base::RunLoop().RunUntilIdle();
 }
 
-TEST(TorControlTest, GetCircuitEstablishedDone) {
+TEST(TorControlTest, ReplayTranscript) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  base::FilePath transcript_path;
+  ASSERT_TRUE(base::PathService::Get(base::DIR_SOURCE_ROOT, &transcript_path));
+  transcript_path = transcript_path.Append(FILE_PATH_LITERAL("brave"))
+                        .Append(FILE_PATH_LITERAL("test"))
+                        .Append(FILE_PATH_LITERAL("data"))
+                        .AppendASCII("tor")
+                        .AppendASCII("tor_control")
+                        .AppendASCII("control_port_transcript");
+  std::string transcript;
+  ASSERT_TRUE(base::ReadFileToString(transcript_path, &transcript));
+  // Stored with plain line feeds; the control port speaks CRLF.
+  base::ReplaceSubstringsAfterOffset(&transcript, 0, "\n", "\r\n");
+
+  using tor::TorControlEvent;
+  const std::map<std::string, std::string> circ_extra = {
+      {"BUILD_FLAGS", "IS_INTERNAL,NEED_CAPACITY"},
+      {"PURPOSE", "HS_CLIENT_HSDIR"},
+      {"TIME_CREATED", "2022-10-01T00:00:01.000000"}};
+
+  // The transcript must be framed the same way however it is split up by
+  // the socket, including a byte at a time.
+  for (size_t chunk_size : {1, 7, 4096}) {
+    MockTorControlDelegate delegate;
+    EXPECT_CALL(delegate, OnTorRawMid("250", testing::_)).Times(1);
+    EXPECT_CALL(delegate, OnTorRawEnd("250", "OK")).Times(1);
+    EXPECT_CALL(delegate, OnTorRawAsync("650", testing::_)).Times(21);
+    EXPECT_CALL(delegate, OnTorEvent(TorControlEvent::STATUS_CLIENT,
+                                     testing::_, testing::IsEmpty()))
+        .Times(7);
+    EXPECT_CALL(delegate,
+                OnTorEvent(TorControlEvent::STATUS_CLIENT,
+                           "NOTICE BOOTSTRAP PROGRESS=100 TAG=done "
+                           "SUMMARY=\"Done\"",
+                           testing::_))
+        .Times(1);
+    EXPECT_CALL(delegate, OnTorEvent(TorControlEvent::CIRC, testing::_,
+                                     testing::IsEmpty()))
+        .Times(3);
+    EXPECT_CALL(delegate,
+                OnTorEvent(TorControlEvent::CIRC, "2 LAUNCHED", circ_extra))
+        .Times(1);
+    EXPECT_CALL(delegate, OnTorEvent(TorControlEvent::STREAM, testing::_,
+                                     testing::IsEmpty()))
+        .Times(4);
+    EXPECT_CALL(delegate,
+                OnTorEvent(TorControlEvent::NETWORK_LIVENESS, "UP", testing::_))
+        .Times(1);
+    EXPECT_CALL(delegate, OnTorControlClosed(testing::_)).Times(0);
+
+    std::unique_ptr<TorControl> control =
+        std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+    io_task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](std::unique_ptr<TorControl> control,
+               const std::string& transcript, size_t chunk_size) {
+              std::string version;
+              bool done = false;
+              control->cmdq_.push(std::make_pair(
+                  base::BindRepeating(
+                      [](std::string* version, base::StringPiece status,
+                         base::StringPiece reply) {
+                        *version = std::string(reply);
+                      },
+                      &version),
+                  base::BindOnce(
+                      [](bool* done, bool error, base::StringPiece status,
+                         base::StringPiece reply) {
+                        EXPECT_FALSE(error);
+                        EXPECT_EQ(reply, "OK");
+                        *done = true;
+                      },
+                      &done)));
+              for (auto event :
+                   {TorControlEvent::STATUS_CLIENT, TorControlEvent::CIRC,
+                    TorControlEvent::STREAM,
+                    TorControlEvent::NETWORK_LIVENESS}) {
+                control->async_events_[event] = 1;
+              }
+              control->reading_ = true;
+              control->StartRead();
+
+              EXPECT_TRUE(FeedControlInput(control.get(), transcript,
+                                           chunk_size))
+                  << chunk_size;
+              EXPECT_TRUE(done) << chunk_size;
+              EXPECT_EQ(version, "version=0.4.7.10 (git-0123456789abcdef)")
+                  << chunk_size;
+              EXPECT_FALSE(control->async_) << chunk_size;
+              EXPECT_EQ(control->read_start_, control->readiobuf_->offset())
+                  << chunk_size;
+            },
+            std::move(control), transcript, chunk_size));
+    base::RunLoop().RunUntilIdle();
+    testing::Mock::VerifyAndClearExpectations(&delegate);
+  }
+}
+
+TEST(TorControlTest, ReadDoneFraming) {
+  content::BrowserTaskEnvironment task_environment;
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  const struct {
+    const char* input;
+    bool ok;
+  } cases[] = {
+      {"250 OK\r\n", true},
+      {"250 O", true},
+      {"250 OK\n", false},
+      {"\n", false},
+      {"250 O\rK\r\n", false},
+  };
+
+  for (const auto& test_case : cases) {
+    MockTorControlDelegate delegate;
+    EXPECT_CALL(delegate, OnTorControlClosed(false))
+        .Times(test_case.ok ? 0 : 1);
+    std::unique_ptr<TorControl> control =
+        std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+    io_task_runner->PostTask(
+        FROM_HERE,
+        base::BindOnce(
+            [](std::unique_ptr<TorControl> control, const char* input,
+               bool ok) {
+              control->async_events_[TorControlEvent::CIRC] = 1;
+              control->reading_ = true;
+              control->StartRead();
+              EXPECT_EQ(FeedControlInput(control.get(), input, 4096), ok)
+                  << input;
+            },
+            std::move(control), test_case.input, test_case.ok));
+    base::RunLoop().RunUntilIdle();
+    testing::Mock::VerifyAndClearExpectations(&delegate);
+  }
+}
+
+TEST(TorControlTest, GetInfoDone) {
   content::BrowserTaskEnvironment task_environment;
   scoped_refptr<base::SequencedTaskRunner> io_task_runner =
       content::GetIOThreadTaskRunner({});
@@ -196,109 +487,174 @@ TEST(TorControlTest, GetCircuitEstablishedDone) {
       std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
 
   io_task_runner->PostTask(
-      FROM_HERE, base::BindOnce(
-                     [](std::unique_ptr<TorControl> control) {
-                       std::unique_ptr<std::string> established =
-                           std::make_unique<std::string>("0");
-                       bool is_called = false;
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_FALSE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           false, "250", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       is_called = false;
-                       established = std::make_unique<std::string>("1");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_FALSE(error);
-                                 EXPECT_TRUE(result);
-                               },
-                               &is_called),
-                           false, "250", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       // --- Error cases ---
-                       is_called = false;
-                       established = std::make_unique<std::string>("iambrave");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_TRUE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           false, "250", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       is_called = false;
-                       established = std::make_unique<std::string>("");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_TRUE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           false, "250", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       is_called = false;
-                       established = std::make_unique<std::string>("1");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_TRUE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           true, "250", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       is_called = false;
-                       established = std::make_unique<std::string>("1");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_TRUE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           false, "500", "OK");
-                       EXPECT_TRUE(is_called);
-
-                       is_called = false;
-                       established = std::make_unique<std::string>("1");
-                       control->GetCircuitEstablishedDone(
-                           std::move(established),
-                           base::BindOnce(
-                               [](bool* is_called, bool error, bool result) {
-                                 *is_called = true;
-                                 EXPECT_TRUE(error);
-                                 EXPECT_FALSE(result);
-                               },
-                               &is_called),
-                           false, "500", "NOT_OK");
-                       EXPECT_TRUE(is_called);
-                     },
-                     std::move(control)));
+      FROM_HERE,
+      base::BindOnce(
+          [](std::unique_ptr<TorControl> control) {
+            auto values =
+                std::make_unique<std::map<std::string, std::string>>();
+            control->GetInfoLine(values.get(), "250", "version=0.4.7.10");
+            control->GetInfoLine(values.get(), "250",
+                                 "status/circuit-established=1");
+            // Not a KEY=VALUE line, so it's ignored.
+            control->GetInfoLine(values.get(), "250", "version");
+            const std::map<std::string, std::string> expected = {
+                {"status/circuit-established", "1"}, {"version", "0.4.7.10"}};
+            EXPECT_EQ(*values, expected);
+
+            bool is_called = false;
+            control->GetInfoDone(
+                {"version", "status/circuit-established"},
+                std::make_unique<std::map<std::string, std::string>>(expected),
+                base::BindLambdaForTesting(
+                    [&](bool error,
+                        const std::map<std::string, std::string>& values) {
+                      is_called = true;
+                      EXPECT_FALSE(error);
+                      EXPECT_EQ(values, expected);
+                    }),
+                false, "250", "OK");
+            EXPECT_TRUE(is_called);
+
+            // --- Error cases ---
+            is_called = false;
+            control->GetInfoDone(
+                {"version", "net/listeners/socks"},
+                std::make_unique<std::map<std::string, std::string>>(expected),
+                base::BindLambdaForTesting(
+                    [&](bool error,
+                        const std::map<std::string, std::string>& values) {
+                      is_called = true;
+                      EXPECT_TRUE(error);
+                      EXPECT_TRUE(values.empty());
+                    }),
+                false, "250", "OK");
+            EXPECT_TRUE(is_called);
+
+            is_called = false;
+            control->GetInfoDone(
+                {"version"},
+                std::make_unique<std::map<std::string, std::string>>(expected),
+                base::BindLambdaForTesting(
+                    [&](bool error,
+                        const std::map<std::string, std::string>& values) {
+                      is_called = true;
+                      EXPECT_TRUE(error);
+                    }),
+                false, "552", "Unrecognized key \"version\"");
+            EXPECT_TRUE(is_called);
+          },
+          std::move(control)));
+  base::RunLoop().RunUntilIdle();
+}
+
+TEST(TorControlTest, PipelinedCommands) {
+  content::BrowserTaskEnvironment task_environment(
+      content::BrowserTaskEnvironment::IO_MAINLOOP);
+  scoped_refptr<base::SequencedTaskRunner> io_task_runner =
+      content::GetIOThreadTaskRunner({});
+
+  FakeControlPort control_port;
+  MockTorControlDelegate delegate;
+  std::unique_ptr<TorControl> control =
+      std::make_unique<TorControl>(delegate.AsWeakPtr(), io_task_runner);
+
+  base::RunLoop ready_loop;
+  EXPECT_CALL(delegate, OnTorControlReady())
+      .WillOnce(base::test::RunClosure(ready_loop.QuitClosure()));
+  control->Start({0xbe, 0xef}, control_port.port());
+  control_port.Accept();
+  EXPECT_EQ(control_port.ReadCommands(1),
+            std::vector<std::string>({"AUTHENTICATE BEEF"}));
+  control_port.Write("250 OK\r\n");
+  ready_loop.Run();
+
+  // None of these waits for the reply to the ones before it.
+  base::RunLoop done_loop;
+  bool info_error = true;
+  std::map<std::string, std::string> info;
+  control->GetInfo(
+      {"version", "net/listeners/socks", "status/circuit-established"},
+      base::BindLambdaForTesting(
+          [&](bool error, const std::map<std::string, std::string>& values) {
+            info_error = error;
+            info = values;
+          }));
+  bool subscribe_error = true;
+  control->Subscribe(
+      {TorControlEvent::CIRC, TorControlEvent::STREAM},
+      base::BindLambdaForTesting([&](bool error) { subscribe_error = error; }));
+  bool established_error = true;
+  std::map<std::string, std::string> established;
+  control->GetInfo(
+      {"status/circuit-established"},
+      base::BindLambdaForTesting(
+          [&](bool error, const std::map<std::string, std::string>& values) {
+            established_error = error;
+            established = values;
+            done_loop.Quit();
+          }));
+
+  EXPECT_EQ(control_port.ReadCommands(5),
+            std::vector<std::string>(
+                {"TAKEOWNERSHIP", "RESETCONF __OwningControllerProcess",
+                 "GETINFO version net/listeners/socks "
+                 "status/circuit-established",
+                 "SETEVENTS CIRC STREAM",
+                 "GETINFO status/circuit-established"}));
+
+  // Replies come back in the order the commands were sent, with an event
+  // in between.
+  EXPECT_CALL(delegate,
+              OnTorEvent(TorControlEvent::CIRC, "1 BUILT", testing::IsEmpty()))
+      .Times(1);
+  control_port.Write(
+      "250 OK\r\n"
+      "250 OK\r\n"
+      "250-version=0.4.7.10\r\n"
+      "250-net/listeners/socks=\"127.0.0.1:9050\"\r\n"
+      "250-status/circuit-established=0\r\n"
+      "250 OK\r\n"
+      "250 OK\r\n"
+      "650 CIRC 1 BUILT\r\n"
+      "250-status/circuit-established=1\r\n"
+      "250 OK\r\n");
+  done_loop.Run();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_FALSE(info_error);
+  const std::map<std::string, std::string> expected_info = {
+      {"net/listeners/socks", "\"127.0.0.1:9050\""},
+      {"status/circuit-established", "0"},
+      {"version", "0.4.7.10"}};
+  EXPECT_EQ(info, expected_info);
+  EXPECT_FALSE(subscribe_error);
+  EXPECT_FALSE(established_error);
+  EXPECT_EQ(established["status/circuit-established"], "1");
+
+  // A failed SETEVENTS leaves none of the batch subscribed, including the
+  // events which already were, since the caller won't unsubscribe from them.
+  base::RunLoop subscribe_loop;
+  control->Subscribe({TorControlEvent::CIRC, TorControlEvent::NOTICE},
+                     base::BindLambdaForTesting([&](bool error) {
+                       subscribe_error = error;
+                       subscribe_loop.Quit();
+                     }));
+  EXPECT_EQ(control_port.ReadCommands(1),
+            std::vector<std::string>({"SETEVENTS CIRC NOTICE STREAM"}));
+  control_port.Write("552 Unrecognized event\r\n");
+  subscribe_loop.Run();
+  EXPECT_TRUE(subscribe_error);
+  base::RunLoop check_loop;
+  io_task_runner->PostTaskAndReply(
+      FROM_HERE, base::BindLambdaForTesting([&]() {
+        const std::map<TorControlEvent, size_t> expected_events = {
+            {TorControlEvent::CIRC, 1}, {TorControlEvent::STREAM, 1}};
+        EXPECT_EQ(control->async_events_, expected_events);
+      }),
+      check_loop.QuitClosure());
+  check_loop.Run();
+
+  io_task_runner->DeleteSoon(FROM_HERE, std::move(control));
   base::RunLoop().RunUntilIdle();
 }
 
@@ -10,6 +10,7 @@
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/task/bind_post_task.h"
 #include "base/threading/sequenced_task_runner_handle.h"
 #include "brave/components/tor/tor_file_watcher.h"
@@ -23,11 +24,11 @@
 namespace {
 constexpr char kTorProxyScheme[] = "socks5://";
 // tor::TorControlEvent::STATUS_CLIENT response
-constexpr char kStatusClientBootstrap[] = "BOOTSTRAP";
-constexpr char kStatusClientBootstrapProgress[] = "PROGRESS=";
-constexpr char kStatusSummary[] = "SUMMARY=";
 constexpr char kStatusClientCircuitEstablished[] = "CIRCUIT_ESTABLISHED";
 constexpr char kStatusClientCircuitNotEstablished[] = "CIRCUIT_NOT_ESTABLISHED";
+constexpr char kInfoVersion[] = "version";
+constexpr char kInfoSOCKSListeners[] = "net/listeners/socks";
+constexpr char kInfoCircuitEstablished[] = "status/circuit-established";
 }  // namespace
 
 // static
@@ -227,36 +228,50 @@ void TorLauncherFactory::OnTorLaunched(bool result, int64_t pid) {
 void TorLauncherFactory::OnTorControlReady() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   VLOG(2) << "TOR CONTROL: Ready!";
-  control_->GetVersion(
-      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
-                         base::BindOnce(&TorLauncherFactory::GotVersion,
-                                        weak_ptr_factory_.GetWeakPtr())));
-  control_->GetSOCKSListeners(
-      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
-                         base::BindOnce(&TorLauncherFactory::GotSOCKSListeners,
-                                        weak_ptr_factory_.GetWeakPtr())));
   // A Circuit might have been established when Tor control is ready, in that
   // case we will not receive circuit established events. So we query the status
   // directly as fail safe, otherwise Tor window might stuck in disconnected
   // state while Tor circuit is ready.
-  control_->GetCircuitEstablished(base::BindPostTask(
-      base::SequencedTaskRunnerHandle::Get(),
-      base::BindOnce(&TorLauncherFactory::GotCircuitEstablished,
-                     weak_ptr_factory_.GetWeakPtr())));
-  control_->Subscribe(tor::TorControlEvent::NETWORK_LIVENESS,
-                      base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::STATUS_CLIENT, base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::STATUS_GENERAL, base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::STREAM, base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::NOTICE, base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::WARN, base::DoNothing());
-  control_->Subscribe(tor::TorControlEvent::ERR, base::DoNothing());
+  // Everything is asked for in one GETINFO, and the SETEVENTS goes out right
+  // behind it without waiting for the reply.
+  control_->GetInfo(
+      {kInfoVersion, kInfoSOCKSListeners, kInfoCircuitEstablished},
+      base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                         base::BindOnce(&TorLauncherFactory::GotInfo,
+                                        weak_ptr_factory_.GetWeakPtr())));
+  control_->Subscribe(
+      {tor::TorControlEvent::NETWORK_LIVENESS,
+       tor::TorControlEvent::STATUS_CLIENT,
+       tor::TorControlEvent::STATUS_GENERAL, tor::TorControlEvent::STREAM,
+       tor::TorControlEvent::NOTICE, tor::TorControlEvent::WARN,
+       tor::TorControlEvent::ERR},
+      base::DoNothing());
 
   for (auto& observer : observers_) {
     observer.OnTorControlReady();
   }
 }
 
+void TorLauncherFactory::GotInfo(
+    bool error,
+    const std::map<std::string, std::string>& values) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (error) {
+    GotVersion(error, std::string());
+    GotSOCKSListeners(error, std::vector<std::string>());
+    GotCircuitEstablished(error, false);
+    return;
+  }
+  GotVersion(false, values.at(kInfoVersion));
+  GotSOCKSListeners(false, {values.at(kInfoSOCKSListeners)});
+  const std::string& established = values.at(kInfoCircuitEstablished);
+  if (established != "1" && established != "0") {
+    GotCircuitEstablished(true, false);
+    return;
+  }
+  GotCircuitEstablished(false, established == "1");
+}
+
 void TorLauncherFactory::GotVersion(bool error, const std::string& version) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
   if (error) {
@@ -369,23 +384,12 @@ void TorLauncherFactory::OnTorEvent(
   for (auto& observer : observers_)
     observer.OnTorControlEvent(raw_event);
   if (event == tor::TorControlEvent::STATUS_CLIENT) {
-    if (initial.find(kStatusClientBootstrap) != std::string::npos) {
-      size_t progress_start = initial.find(kStatusClientBootstrapProgress);
-      size_t progress_length = initial.substr(progress_start).find(" ");
+    tor::TorControl::BootstrapStatus bootstrap;
+    if (tor::TorControl::ParseBootstrapStatus(initial, &bootstrap)) {
       // Dispatch progress
-      const std::string percentage = initial.substr(
-          progress_start + strlen(kStatusClientBootstrapProgress),
-          progress_length - strlen(kStatusClientBootstrapProgress));
-
-      std::string message;
-      size_t summary_start = initial.find(kStatusSummary);
-      if (summary_start != std::string::npos) {
-        summary_start += strlen(kStatusSummary) + 1;
-        const size_t summary_end = initial.find("\"", summary_start);
-        message = initial.substr(summary_start, summary_end - summary_start);
-      }
+      const std::string percentage = base::NumberToString(bootstrap.progress);
       for (auto& observer : observers_)
-        observer.OnTorInitializing(percentage, message);
+        observer.OnTorInitializing(percentage, bootstrap.summary);
     } else if (initial.find(kStatusClientCircuitEstablished) !=
                std::string::npos) {
       for (auto& observer : observers_)
@@ -83,6 +83,7 @@ class TorLauncherFactory : public tor::TorControl::Delegate {
   void OnTorCrashed(int64_t pid);
   void OnTorLaunched(bool result, int64_t pid);
 
+  void GotInfo(bool error, const std::map<std::string, std::string>& values);
   void GotVersion(bool error, const std::string& version);
   void GotSOCKSListeners(bool error, const std::vector<std::string>& listeners);
   void GotCircuitEstablished(bool error, bool established);
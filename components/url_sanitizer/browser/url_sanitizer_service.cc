@@ -6,15 +6,18 @@
 #include "brave/components/url_sanitizer/browser/url_sanitizer_service.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/containers/contains.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
-#include "base/strings/string_split.h"
-#include "base/strings/string_util.h"
+#include "base/ranges/algorithm.h"
+#include "base/strings/string_piece.h"
 #include "base/task/task_runner_util.h"
 #include "base/task/thread_pool.h"
 #include "base/values.h"
+#include "brave/components/query_filter/query_filter_util.h"
 #include "extensions/common/url_pattern.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "url/gurl.h"
@@ -48,8 +51,35 @@ absl::optional<base::flat_set<std::string>> CreateParamsList(
   return result;
 }
 
-base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
-    const std::string& json) {
+URLSanitizerService::MatcherIndex BuildIndex(
+    std::vector<std::unique_ptr<URLSanitizerService::MatchItem>> items) {
+  URLSanitizerService::MatcherIndex index;
+  std::vector<std::pair<std::string, size_t>> host_rules;
+  for (size_t i = 0; i < items.size(); ++i) {
+    for (const URLPattern& pattern : items[i]->include) {
+      if (pattern.host().empty()) {
+        index.any_host.push_back(i);
+        break;
+      }
+      host_rules.emplace_back(pattern.host(), i);
+    }
+  }
+  // Group the rules by host, keeping the indices for each host in rule order.
+  base::ranges::sort(host_rules);
+  host_rules.erase(base::ranges::unique(host_rules), host_rules.end());
+  std::vector<std::pair<std::string, std::vector<size_t>>> by_host;
+  for (auto& [host, rule] : host_rules) {
+    if (by_host.empty() || by_host.back().first != host)
+      by_host.emplace_back(std::move(host), std::vector<size_t>());
+    by_host.back().second.push_back(rule);
+  }
+  index.by_host = base::flat_map<std::string, std::vector<size_t>>(
+      base::sorted_unique, std::move(by_host));
+  index.items = std::move(items);
+  return index;
+}
+
+URLSanitizerService::MatcherIndex ParseFromJson(const std::string& json) {
   auto parsed_json = base::JSONReader::ReadAndReturnValueWithError(json);
   if (!parsed_json.has_value()) {
     VLOG(1) << "Error parsing feature JSON: " << parsed_json.error().message;
@@ -59,7 +89,7 @@ base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
   if (!list) {
     return {};
   }
-  base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> matchers;
+  std::vector<std::unique_ptr<URLSanitizerService::MatchItem>> matchers;
   for (const auto& it : *list) {
     const base::Value::Dict* items = it.GetIfDict();
     if (!items)
@@ -83,10 +113,10 @@ base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> ParseFromJson(
         std::move(include_matcher), std::move(exclude_matcher),
         std::move(*params));
 
-    matchers.insert(std::move(item));
+    matchers.push_back(std::move(item));
   }
 
-  return matchers;
+  return BuildIndex(std::move(matchers));
 }
 
 }  // namespace
@@ -103,6 +133,12 @@ URLSanitizerService::MatchItem::MatchItem(extensions::URLPatternSet in,
                                           base::flat_set<std::string> prm)
     : include(std::move(in)), exclude(std::move(ex)), params(std::move(prm)) {}
 
+URLSanitizerService::MatcherIndex::MatcherIndex() = default;
+URLSanitizerService::MatcherIndex::MatcherIndex(MatcherIndex&&) = default;
+URLSanitizerService::MatcherIndex&
+URLSanitizerService::MatcherIndex::operator=(MatcherIndex&&) = default;
+URLSanitizerService::MatcherIndex::~MatcherIndex() = default;
+
 void URLSanitizerService::Initialize(const std::string& json) {
   base::ThreadPool::PostTaskAndReplyWithResult(
       FROM_HERE, {base::MayBlock()}, base::BindOnce(&ParseFromJson, json),
@@ -110,24 +146,56 @@ void URLSanitizerService::Initialize(const std::string& json) {
                      weak_factory_.GetWeakPtr()));
 }
 
-void URLSanitizerService::UpdateMatchers(
-    base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> mappings) {
-  matchers_ = std::move(mappings);
+void URLSanitizerService::UpdateMatchers(MatcherIndex index) {
+  matchers_ = std::move(index);
   if (initialization_callback_for_testing_)
     std::move(initialization_callback_for_testing_).Run();
 }
 
 GURL URLSanitizerService::SanitizeURL(const GURL& initial_url) {
-  if (matchers_.empty())
+  if (matchers_.items.empty() || !initial_url.has_query())
+    return initial_url;
+
+  std::vector<size_t> candidates = matchers_.any_host;
+  base::StringPiece host = initial_url.host_piece();
+  if (!host.empty() && host.back() == '.')
+    host.remove_suffix(1);
+  // Look up the host and each of its parent domains, so that patterns like
+  // "*://*.twitter.com/*" are found for "mobile.twitter.com" as well.
+  while (!host.empty()) {
+    const auto it = matchers_.by_host.find(host);
+    if (it != matchers_.by_host.end()) {
+      candidates.insert(candidates.end(), it->second.begin(),
+                        it->second.end());
+    }
+    const size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  if (candidates.empty())
     return initial_url;
+  base::ranges::sort(candidates);
+  candidates.erase(base::ranges::unique(candidates), candidates.end());
+
+  // Rules are applied in order, each one matched against the URL left by the
+  // rules before it, since include and exclude patterns can look at the
+  // query. Only rules that actually remove something rewrite the URL.
   GURL url = initial_url;
-  for (const auto& it : matchers_) {
-    if (!it->include.MatchesURL(url) || it->exclude.MatchesURL(url))
+  for (size_t index : candidates) {
+    const MatchItem& item = *matchers_.items[index];
+    if (!item.include.MatchesURL(url) || item.exclude.MatchesURL(url))
+      continue;
+    const absl::optional<std::string> sanitized_query =
+        query_filter::StripQueryParameters(
+            url.query_piece(), [&item](base::StringPiece key) {
+              return base::Contains(item.params, key);
+            });
+    if (!sanitized_query)
       continue;
-    auto sanitized_query = StripQueryParameter(url.query(), it->params);
     GURL::Replacements replacements;
-    if (!sanitized_query.empty()) {
-      replacements.SetQueryStr(sanitized_query);
+    if (!sanitized_query->empty()) {
+      replacements.SetQueryStr(*sanitized_query);
     } else {
       replacements.ClearQuery();
     }
@@ -140,39 +208,15 @@ void URLSanitizerService::OnRulesReady(const std::string& json_content) {
   Initialize(json_content);
 }
 
-// FIXME: merge with
-// browser/net/brave_site_hacks_network_delegate_helper.cc::StripQueryParameter()
-// Remove tracking query parameters from a GURL, leaving all
-// other parts untouched.
 std::string URLSanitizerService::StripQueryParameter(
     const std::string& query,
     const base::flat_set<std::string>& trackers) {
-  // We are using custom query string parsing code here. See
-  // https://github.com/brave/brave-core/pull/13726#discussion_r897712350
-  // for more information on why this approach was selected.
-  //
-  // Split query string by ampersands, remove tracking parameters,
-  // then join the remaining query parameters, untouched, back into
-  // a single query string.
-  const std::vector<std::string> input_kv_strings =
-      SplitString(query, "&", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
-  std::vector<std::string> output_kv_strings;
-  int disallowed_count = 0;
-  for (const std::string& kv_string : input_kv_strings) {
-    const std::vector<std::string> pieces = SplitString(
-        kv_string, "=", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-    const std::string& key = pieces.empty() ? std::string() : pieces[0];
-    if (pieces.size() >= 2 && trackers.count(key) == 1) {
-      ++disallowed_count;
-    } else {
-      output_kv_strings.push_back(kv_string);
-    }
-  }
-  if (disallowed_count > 0) {
-    return base::JoinString(output_kv_strings, "&");
-  } else {
-    return query;
-  }
+  return query_filter::StripQueryParameters(
+             query,
+             [&trackers](base::StringPiece key) {
+               return base::Contains(trackers, key);
+             })
+      .value_or(query);
 }
 
 }  // namespace brave
@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/containers/flat_map.h"
@@ -41,6 +42,25 @@ class URLSanitizerService : public KeyedService,
     base::flat_set<std::string> params;
   };
 
+  // Rules grouped by the hosts named in their include patterns, so that
+  // SanitizeURL() only evaluates the URLPatternSets of rules that can
+  // possibly apply to a given URL.
+  struct MatcherIndex {
+    MatcherIndex();
+    MatcherIndex(MatcherIndex&&);
+    MatcherIndex& operator=(MatcherIndex&&);
+    ~MatcherIndex();
+
+    std::vector<std::unique_ptr<MatchItem>> items;
+    // Indices into |items| keyed by include pattern host. A pattern that also
+    // matches subdomains is still stored under its own host only; lookups
+    // walk up the parent domains of the URL host instead.
+    base::flat_map<std::string, std::vector<size_t>> by_host;
+    // Indices into |items| of rules with a host wildcard include pattern,
+    // e.g. "*://*/*". These are candidates for every URL.
+    std::vector<size_t> any_host;
+  };
+
   GURL SanitizeURL(const GURL& url);
 
   void SetInitializationCallbackForTesting(base::OnceClosure callback) {
@@ -52,14 +72,13 @@ class URLSanitizerService : public KeyedService,
  protected:
   friend class URLSanitizerServiceUnitTest;
 
-  void UpdateMatchers(
-      base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>>);
+  void UpdateMatchers(MatcherIndex index);
 
   std::string StripQueryParameter(const std::string& query,
                                   const base::flat_set<std::string>& trackers);
 
  private:
-  base::flat_set<std::unique_ptr<URLSanitizerService::MatchItem>> matchers_;
+  MatcherIndex matchers_;
   base::OnceClosure initialization_callback_for_testing_;
   base::WeakPtrFactory<URLSanitizerService> weak_factory_{this};
 };
@@ -5,11 +5,15 @@
 
 #include "brave/components/url_sanitizer/browser/url_sanitizer_service.h"
 
+#include <string>
 #include <vector>
 
 #include "base/containers/flat_set.h"
+#include "base/logging.h"
 #include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
 #include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "url/gurl.h"
 
@@ -51,6 +55,25 @@ const char kTestPatterns[] = R"(
   }
 ])";
 
+// A sample of real-world navigation URLs, with and without tracking
+// parameters.
+const char* const kNavigationURLs[] = {
+    "https://www.google.com/search?q=brave+browser&oq=brave+browser&aqs="
+    "chrome..69i57j0i512l9.2373j0j7&sourceid=chrome&ie=UTF-8",
+    "https://twitter.com/brave/status/1570417311213092864?s=20&t=8Hd1sQq0W",
+    "https://mobile.twitter.com/brave?t=8Hd1sQq0W&s=09",
+    "https://www.youtube.com/watch?v=dQw4w9WgXcQ&feature=share&utm_source="
+    "newsletter&utm_content=removethis",
+    "https://en.wikipedia.org/wiki/Brave_(web_browser)",
+    "https://www.amazon.com/dp/B08N5WRWNW/ref=cm_sw_r_tw_dp_?_encoding=UTF8&"
+    "psc=1&utm_affiliate=removethis",
+    "https://news.ycombinator.com/item?id=32878136",
+    "https://dev-pages.bravesoftware.com/clean-urls/?brave_testing1=foo&"
+    "brave_testing2=bar&brave_testing3=keep",
+    "https://github.com/brave/brave-browser/issues?q=is%3Aopen+label%3Abug",
+    "https://www.reddit.com/r/brave_browser/?utm_content=removethis",
+};
+
 }  // namespace
 
 class URLSanitizerServiceUnitTest : public testing::Test,
@@ -144,4 +167,82 @@ TEST_F(URLSanitizerServiceUnitTest, ClearURLS) {
       GURL("http://subpage.twitter.com/post/?utm_content=removethis&e=&=end"));
 }
 
+TEST_F(URLSanitizerServiceUnitTest, HostIndex) {
+  WaitInitialization(R"([
+    { "include": [ "https://example.com/*", "*://*.brave.com/*" ],
+      "params": ["a"] },
+    { "include": [ "*://*.example.com/*" ],
+      "exclude": [ "*://*.example.com/exempted/*" ],
+      "params": ["b"] },
+    { "include": [ "*://*.net/*" ], "params": ["c"] }
+  ])");
+
+  // Exact host and subdomain matches from the same rule.
+  EXPECT_EQ(SanitizeURL(GURL("https://example.com/?a=1&b=2&c=3")),
+            GURL("https://example.com/?c=3"));
+  EXPECT_EQ(SanitizeURL(GURL("https://search.brave.com/?a=1&b=2&c=3")),
+            GURL("https://search.brave.com/?b=2&c=3"));
+  // "https://example.com/*" doesn't match subdomains.
+  EXPECT_EQ(SanitizeURL(GURL("https://www.example.com/?a=1&b=2&c=3")),
+            GURL("https://www.example.com/?a=1&c=3"));
+  EXPECT_EQ(SanitizeURL(GURL("https://www.example.com/exempted/?a=1&b=2")),
+            GURL("https://www.example.com/exempted/?a=1&b=2"));
+  // Only the host labels are looked up, never a substring of them.
+  EXPECT_EQ(SanitizeURL(GURL("https://notexample.com/?a=1&b=2&c=3")),
+            GURL("https://notexample.com/?a=1&b=2&c=3"));
+  EXPECT_EQ(SanitizeURL(GURL("https://brave.net/?a=1&b=2&c=3")),
+            GURL("https://brave.net/?a=1&b=2"));
+}
+
+TEST_F(URLSanitizerServiceUnitTest, RulesMatchEarlierRewrites) {
+  WaitInitialization(R"([
+    { "include": [ "*://*/*" ], "params": ["a"] },
+    { "include": [ "*://example.com/*a=*" ], "params": ["b"] },
+    { "include": [ "*://example.org/*" ],
+      "exclude": [ "*://example.org/*a=*" ],
+      "params": ["c"] }
+  ])");
+
+  // Each rule is matched against the URL left by the rules before it, not
+  // against the initial one.
+  EXPECT_EQ(SanitizeURL(GURL("https://example.com/?a=1&b=2")),
+            GURL("https://example.com/?b=2"));
+  EXPECT_EQ(SanitizeURL(GURL("https://example.org/?a=1&c=3")),
+            GURL("https://example.org/"));
+}
+
+TEST_F(URLSanitizerServiceUnitTest, DISABLED_BenchmarkSanitizeURL) {
+  constexpr int kIterations = 10000;
+  constexpr int kHostRules = 500;
+
+  // The test patterns plus a few hundred single-host rules, roughly the shape
+  // of the component data.
+  std::string json = kTestPatterns;
+  json.resize(json.rfind(']'));
+  for (int i = 0; i < kHostRules; ++i) {
+    json += base::StringPrintf(
+        R"(,{ "include": [ "*://*.site%d.com/*" ], "params": [ "p%d" ] })", i,
+        i);
+  }
+  json += "]";
+  WaitInitialization(json);
+
+  std::vector<GURL> urls;
+  for (const char* url : kNavigationURLs)
+    urls.emplace_back(url);
+
+  size_t sanitized = 0;
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const GURL& url : urls) {
+      if (SanitizeURL(url) != url)
+        ++sanitized;
+    }
+  }
+  const base::TimeDelta elapsed = timer.Elapsed();
+  EXPECT_GT(sanitized, 0u);
+  LOG(INFO) << "SanitizeURL: " << elapsed / (kIterations * urls.size())
+            << " per URL with " << kHostRules << " host rules";
+}
+
 }  // namespace brave
@@ -0,0 +1,140 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/brave_audio_farbling_helper.h"
+
+#include "base/notreached.h"
+#include "brave/third_party/blink/renderer/brave_farbling_lfsr.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+inline float ConstantMultiplier(double fudge_factor, float value) {
+  return value * fudge_factor;
+}
+
+inline float PseudoRandomValue(uint64_t v) {
+  // pseudo-random float between 0 and 0.1
+  return (v / brave::kMaxUInt64AsDouble) / 10;
+}
+
+// Multiplies in double precision and rounds back to float, exactly as the
+// scalar ConstantMultiplier() does, two samples per 128-bit register.
+void ApplyConstantMultiplier(double fudge_factor, float* data, size_t size) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_FAMILY) && defined(__SSE2__)
+  const __m128d fudge = _mm_set1_pd(fudge_factor);
+  for (; i + 4 <= size; i += 4) {
+    __m128 samples = _mm_loadu_ps(data + i);
+    __m128d low = _mm_mul_pd(_mm_cvtps_pd(samples), fudge);
+    __m128d high =
+        _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(samples, samples)), fudge);
+    _mm_storeu_ps(data + i,
+                  _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)));
+  }
+#elif defined(ARCH_CPU_ARM64)
+  const float64x2_t fudge = vdupq_n_f64(fudge_factor);
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t samples = vld1q_f32(data + i);
+    float64x2_t low = vmulq_f64(vcvt_f64_f32(vget_low_f32(samples)), fudge);
+    float64x2_t high = vmulq_f64(vcvt_high_f64_f32(samples), fudge);
+    vst1q_f32(data + i, vcombine_f32(vcvt_f32_f64(low), vcvt_f32_f64(high)));
+  }
+#endif
+  for (; i < size; ++i)
+    data[i] = ConstantMultiplier(fudge_factor, data[i]);
+}
+
+}  // namespace
+
+namespace brave {
+
+// static
+AudioFarblingHelper AudioFarblingHelper::CreateConstantMultiplier(
+    double fudge_factor) {
+  return AudioFarblingHelper(Mode::kConstantMultiplier, fudge_factor, 0);
+}
+
+// static
+AudioFarblingHelper AudioFarblingHelper::CreatePseudoRandomSequence(
+    uint64_t seed) {
+  return AudioFarblingHelper(Mode::kPseudoRandomSequence, 1.0, seed);
+}
+
+AudioFarblingHelper::AudioFarblingHelper(Mode mode,
+                                         double fudge_factor,
+                                         uint64_t seed)
+    : mode_(mode),
+      fudge_factor_(fudge_factor),
+      seed_(seed),
+      prng_state_(seed) {}
+
+AudioFarblingHelper::AudioFarblingHelper(const AudioFarblingHelper&) = default;
+AudioFarblingHelper& AudioFarblingHelper::operator=(
+    const AudioFarblingHelper&) = default;
+AudioFarblingHelper::~AudioFarblingHelper() = default;
+
+void AudioFarblingHelper::FarbleAudioChannel(base::span<float> samples,
+                                             size_t start_index) {
+  if (samples.empty())
+    return;
+
+  switch (mode_) {
+    case Mode::kConstantMultiplier:
+      ApplyConstantMultiplier(fudge_factor_, samples.data(), samples.size());
+      break;
+    case Mode::kPseudoRandomSequence: {
+      // The LFSR carries a serial dependency from one sample to the next, so
+      // this stays a tight scalar loop; the win over the callback comes from
+      // dropping the indirect call and the per-sample state reload.
+      uint64_t v = SeekPseudoRandomState(start_index);
+      for (float& sample : samples) {
+        v = LfsrNext(v);
+        sample = PseudoRandomValue(v);
+      }
+      prng_state_ = v;
+      next_index_ = start_index + samples.size();
+      break;
+    }
+  }
+}
+
+float AudioFarblingHelper::FarbleSample(float value, size_t index) {
+  switch (mode_) {
+    case Mode::kConstantMultiplier:
+      return ConstantMultiplier(fudge_factor_, value);
+    case Mode::kPseudoRandomSequence: {
+      uint64_t v = LfsrNext(SeekPseudoRandomState(index));
+      prng_state_ = v;
+      next_index_ = index + 1;
+      return PseudoRandomValue(v);
+    }
+  }
+  NOTREACHED();
+  return value;
+}
+
+uint64_t AudioFarblingHelper::SeekPseudoRandomState(size_t index) {
+  if (index == next_index_)
+    return prng_state_;
+
+  uint64_t v = seed_;
+  size_t position = 0;
+  if (index > next_index_) {
+    v = prng_state_;
+    position = next_index_;
+  }
+  for (; position < index; ++position)
+    v = LfsrNext(v);
+  return v;
+}
+
+}  // namespace brave
@@ -0,0 +1,66 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_AUDIO_FARBLING_HELPER_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_AUDIO_FARBLING_HELPER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base/containers/span.h"
+#include "third_party/blink/public/platform/web_common.h"
+
+namespace brave {
+
+// Farbles Web Audio sample data in place. Unlike a per-sample callback this
+// lets the caller hand over a whole channel (or analyser frame) at once so the
+// inner loop can be vectorized and no indirect call is made per sample.
+//
+// The output for sample |i| is bit-identical to what the former per-sample
+// AudioFarblingCallback returned when invoked with indices 0, 1, 2, ... in
+// order:
+//  - BALANCED multiplies every sample by a per-domain fudge factor (computed
+//    in double precision, then rounded back to float).
+//  - MAXIMUM replaces every sample with a value in [0, 0.1) taken from an
+//    LFSR sequence seeded from the domain key.
+class BLINK_EXPORT AudioFarblingHelper {
+ public:
+  static AudioFarblingHelper CreateConstantMultiplier(double fudge_factor);
+  static AudioFarblingHelper CreatePseudoRandomSequence(uint64_t seed);
+
+  AudioFarblingHelper(const AudioFarblingHelper&);
+  AudioFarblingHelper& operator=(const AudioFarblingHelper&);
+  ~AudioFarblingHelper();
+
+  // Farbles |samples| in place. |start_index| is the index of |samples[0]|
+  // within the logical buffer, so a buffer may be processed in several
+  // consecutive chunks.
+  void FarbleAudioChannel(base::span<float> samples, size_t start_index);
+
+  // Single-sample variant for call sites that interleave farbling with other
+  // per-sample work (e.g. byte conversion in RealtimeAnalyser). Indices must
+  // be visited in increasing order starting from 0, as with the old callback.
+  float FarbleSample(float value, size_t index);
+
+ private:
+  enum class Mode { kConstantMultiplier, kPseudoRandomSequence };
+
+  AudioFarblingHelper(Mode mode, double fudge_factor, uint64_t seed);
+
+  // Returns the LFSR state that produces the value for |index|, reusing the
+  // cached state when |index| directly follows the previously farbled sample.
+  uint64_t SeekPseudoRandomState(size_t index);
+
+  Mode mode_;
+  double fudge_factor_ = 1.0;
+  uint64_t seed_ = 0;
+  // LFSR state after producing the sample at |next_index_| - 1.
+  uint64_t prng_state_ = 0;
+  size_t next_index_ = 0;
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_AUDIO_FARBLING_HELPER_H_
@@ -0,0 +1,170 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "brave/third_party/blink/renderer/brave_audio_farbling_helper.h"
+
+#include "base/callback.h"
+#include "base/containers/span.h"
+#include "base/logging.h"
+#include "base/numerics/math_constants.h"
+#include "base/timer/elapsed_timer.h"
+#include "brave/third_party/blink/renderer/brave_farbling_lfsr.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+constexpr size_t kSamplesPerSecond = 48000;
+constexpr uint64_t kSeed = 0x5eed5eed12345678;
+constexpr double kFudgeFactor = 0.99 + 0.0073;
+
+// Reference per-sample implementations, copied from the callback-based API
+// this helper replaced.
+float ConstantMultiplier(double fudge_factor, float value, size_t index) {
+  return value * fudge_factor;
+}
+
+float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
+  static uint64_t v;
+  if (index == 0)
+    v = seed;
+  v = brave::LfsrNext(v);
+  return (v / brave::kMaxUInt64AsDouble) / 10;
+}
+
+std::vector<float> MakeSineWave(size_t size) {
+  std::vector<float> samples(size);
+  for (size_t i = 0; i < size; ++i)
+    samples[i] =
+        std::sin(2 * base::kPiDouble * 440 * i / kSamplesPerSecond) * 0.8f;
+  // Odd values to exercise rounding in the SIMD path.
+  if (size > 3) {
+    samples[1] = 1e-40f;
+    samples[2] = -3.4e38f;
+    samples[3] = 0.1f;
+  }
+  return samples;
+}
+
+std::vector<float> ApplyCallback(
+    base::RepeatingCallback<float(float, size_t)> callback,
+    std::vector<float> samples) {
+  for (size_t i = 0; i < samples.size(); ++i)
+    samples[i] = callback.Run(samples[i], i);
+  return samples;
+}
+
+void ExpectBitIdentical(const std::vector<float>& expected,
+                        const std::vector<float>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  EXPECT_EQ(0, memcmp(expected.data(), actual.data(),
+                      expected.size() * sizeof(float)));
+}
+
+}  // namespace
+
+TEST(BraveAudioFarblingHelperTest, ConstantMultiplierMatchesPerSample) {
+  // Odd length so the scalar tail is covered too.
+  const std::vector<float> input = MakeSineWave(kSamplesPerSecond + 3);
+  const std::vector<float> expected = ApplyCallback(
+      base::BindRepeating(&ConstantMultiplier, kFudgeFactor), input);
+
+  std::vector<float> actual = input;
+  auto helper = brave::AudioFarblingHelper::CreateConstantMultiplier(
+      kFudgeFactor);
+  helper.FarbleAudioChannel(base::make_span(actual), 0);
+  ExpectBitIdentical(expected, actual);
+
+  std::vector<float> per_sample = input;
+  for (size_t i = 0; i < per_sample.size(); ++i)
+    per_sample[i] = helper.FarbleSample(per_sample[i], i);
+  ExpectBitIdentical(expected, per_sample);
+}
+
+TEST(BraveAudioFarblingHelperTest, PseudoRandomSequenceMatchesPerSample) {
+  const std::vector<float> input = MakeSineWave(kSamplesPerSecond);
+  const std::vector<float> expected = ApplyCallback(
+      base::BindRepeating(&PseudoRandomSequence, kSeed), input);
+
+  auto helper = brave::AudioFarblingHelper::CreatePseudoRandomSequence(kSeed);
+  // Run twice to make sure every call restarts the sequence at index 0.
+  for (int run = 0; run < 2; ++run) {
+    std::vector<float> actual = input;
+    helper.FarbleAudioChannel(base::make_span(actual), 0);
+    ExpectBitIdentical(expected, actual);
+  }
+
+  std::vector<float> per_sample = input;
+  for (size_t i = 0; i < per_sample.size(); ++i)
+    per_sample[i] = helper.FarbleSample(per_sample[i], i);
+  ExpectBitIdentical(expected, per_sample);
+}
+
+TEST(BraveAudioFarblingHelperTest, PseudoRandomSequenceInChunks) {
+  const std::vector<float> input = MakeSineWave(1000);
+  const std::vector<float> expected = ApplyCallback(
+      base::BindRepeating(&PseudoRandomSequence, kSeed), input);
+
+  // Contiguous chunks continue the sequence.
+  auto helper = brave::AudioFarblingHelper::CreatePseudoRandomSequence(kSeed);
+  std::vector<float> actual = input;
+  auto span = base::make_span(actual);
+  helper.FarbleAudioChannel(span.subspan(0, 128), 0);
+  helper.FarbleAudioChannel(span.subspan(128, 300), 128);
+  helper.FarbleAudioChannel(span.subspan(428), 428);
+  ExpectBitIdentical(expected, actual);
+
+  // Out of order chunks still land on the right position in the sequence.
+  auto other = brave::AudioFarblingHelper::CreatePseudoRandomSequence(kSeed);
+  std::vector<float> shuffled = input;
+  auto shuffled_span = base::make_span(shuffled);
+  other.FarbleAudioChannel(shuffled_span.subspan(500), 500);
+  other.FarbleAudioChannel(shuffled_span.subspan(0, 500), 0);
+  ExpectBitIdentical(expected, shuffled);
+}
+
+// Micro-benchmark over one second of 48 kHz audio. Run manually with
+// --gtest_also_run_disabled_tests.
+TEST(BraveAudioFarblingHelperTest, DISABLED_BenchmarkOneSecondAt48kHz) {
+  constexpr int kIterations = 200;
+  const std::vector<float> input = MakeSineWave(kSamplesPerSecond);
+  std::vector<float> buffer = input;
+
+  auto measure = [&](const char* name, auto farble) {
+    base::ElapsedTimer timer;
+    for (int i = 0; i < kIterations; ++i) {
+      buffer = input;
+      farble(buffer);
+    }
+    LOG(INFO) << name << ": " << timer.Elapsed().InMicrosecondsF() / kIterations
+              << " us per second of audio";
+  };
+
+  auto constant_callback =
+      base::BindRepeating(&ConstantMultiplier, kFudgeFactor);
+  measure("callback/constant", [&](std::vector<float>& samples) {
+    for (size_t i = 0; i < samples.size(); ++i)
+      samples[i] = constant_callback.Run(samples[i], i);
+  });
+  auto constant_helper =
+      brave::AudioFarblingHelper::CreateConstantMultiplier(kFudgeFactor);
+  measure("span/constant", [&](std::vector<float>& samples) {
+    constant_helper.FarbleAudioChannel(base::make_span(samples), 0);
+  });
+
+  auto random_callback = base::BindRepeating(&PseudoRandomSequence, kSeed);
+  measure("callback/pseudo-random", [&](std::vector<float>& samples) {
+    for (size_t i = 0; i < samples.size(); ++i)
+      samples[i] = random_callback.Run(samples[i], i);
+  });
+  auto random_helper =
+      brave::AudioFarblingHelper::CreatePseudoRandomSequence(kSeed);
+  measure("span/pseudo-random", [&](std::vector<float>& samples) {
+    random_helper.FarbleAudioChannel(base::make_span(samples), 0);
+  });
+}
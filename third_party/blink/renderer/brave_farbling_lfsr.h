@@ -0,0 +1,26 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_LFSR_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_LFSR_H_
+
+#include <cstdint>
+
+namespace brave {
+
+// Divisor mapping a 64-bit LFSR state to a double in [0, 1].
+constexpr double kMaxUInt64AsDouble = static_cast<double>(UINT64_MAX);
+
+// Advances the linear-feedback shift register the farbling code derives its
+// pseudo-random sequences from. Farbled output depends on the exact sequence,
+// so this must not change.
+inline uint64_t LfsrNext(uint64_t v) {
+  constexpr uint64_t zero = 0;
+  return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
+}
+
+}  // namespace brave
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_BRAVE_FARBLING_LFSR_H_
@@ -0,0 +1,152 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_FORMAT_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+// Compact binary encoding of a page graph, written by BinaryGraphWriter and
+// read back, e.g. converted to GraphML, by BinaryGraphReader.
+//
+// A stream is the header followed by any number of snapshots. Every snapshot
+// only carries what changed since the previous one, so a long-lived page can
+// be exported repeatedly and the results simply appended to each other:
+//
+//   stream   := kMagic varint(kFormatVersion) snapshot*
+//   snapshot := kSnapshot desc record* kEndSnapshot
+//   desc     := varint(is_root) str(version) str(about) str(frame_id)
+//               zigzag(end_time_ms)
+//   record   := kString str                 appends to the string table
+//             | kBlock varint(node_id) item* kEndBlock
+//             | item                         an edge of the graph
+//   item     := kNode varint(id) value* kEndItem
+//             | kEdge varint(id) varint(source) varint(target) value* kEndItem
+//   value    := kValueString varint(attr) varint(string_index)
+//             | kValueInlineString varint(attr) str
+//             | kValueInteger varint(attr) zigzag(value)
+//             | kValueUnsigned varint(attr) varint(value)
+//             | kValueBoolean varint(attr) byte
+//             | kValueDouble varint(attr) 8 bytes, little endian IEEE 754
+//   str      := varint(length) bytes
+//
+// varints are unsigned LEB128, and |attr| is an id from kAttrIds.
+//
+// A block holds a node followed by the edges it synthesizes on export (the
+// DOM structure and event listener edges of HTML elements). When a node that
+// was already exported changes, its block is written again and replaces the
+// earlier one in place, which keeps the node order of the first export.
+// Graph edges never change, so they are only written once.
+
+namespace brave_page_graph {
+namespace binary_graph {
+
+constexpr char kMagic[] = {'P', 'G', 'B', 'G'};
+// Must be bumped whenever the layout above changes.
+constexpr uint64_t kFormatVersion = 1;
+
+// Strings up to this length go into the string table; longer ones (mostly
+// script sources) are rarely repeated and are written inline instead.
+constexpr size_t kMaxInternedStringLength = 1024;
+
+enum Tag : uint8_t {
+  kSnapshot = 0x01,
+  kEndSnapshot = 0x02,
+  kString = 0x03,
+  kBlock = 0x04,
+  kEndBlock = 0x05,
+  kNode = 0x06,
+  kEdge = 0x07,
+  kEndItem = 0x08,
+  kValueString = 0x10,
+  kValueInlineString = 0x11,
+  kValueInteger = 0x12,
+  kValueUnsigned = 0x13,
+  kValueBoolean = 0x14,
+  kValueDouble = 0x15,
+};
+
+// The ids attributes are stored under. They are part of the format, so they
+// don't follow the order of GraphMLAttrDef: an id is never reused or changed,
+// and new attributes get the next free one.
+struct AttrId {
+  GraphMLAttrDef def;
+  uint64_t id;
+};
+
+constexpr AttrId kAttrIds[] = {
+    {kGraphMLAttrDefAttrName, 0},
+    {kGraphMLAttrDefBeforeNodeId, 1},
+    {kGraphMLAttrDefBinding, 2},
+    {kGraphMLAttrDefBindingEvent, 3},
+    {kGraphMLAttrDefBindingType, 4},
+    {kGraphMLAttrDefBlockType, 5},
+    {kGraphMLAttrDefCallArgs, 6},
+    {kGraphMLAttrDefEdgeType, 7},
+    {kGraphMLAttrDefEventListenerId, 8},
+    {kGraphMLAttrDefFrameId, 9},
+    {kGraphMLAttrDefHost, 10},
+    {kGraphMLAttrDefIncognito, 11},
+    {kGraphMLAttrDefIsDeleted, 12},
+    {kGraphMLAttrDefIsStyle, 13},
+    {kGraphMLAttrDefKey, 14},
+    {kGraphMLAttrDefMethodName, 15},
+    {kGraphMLAttrDefNodeId, 16},
+    {kGraphMLAttrDefNodeTag, 17},
+    {kGraphMLAttrDefNodeText, 18},
+    {kGraphMLAttrDefNodeType, 19},
+    {kGraphMLAttrDefPageGraphEdgeId, 20},
+    {kGraphMLAttrDefPageGraphNodeId, 21},
+    {kGraphMLAttrDefPageGraphEdgeTimestamp, 22},
+    {kGraphMLAttrDefPageGraphNodeTimestamp, 23},
+    {kGraphMLAttrDefParentNodeId, 24},
+    {kGraphMLAttrDefPrimaryPattern, 25},
+    {kGraphMLAttrDefRequestId, 26},
+    {kGraphMLAttrDefResourceType, 27},
+    {kGraphMLAttrDefResponseHash, 28},
+    {kGraphMLAttrDefRule, 29},
+    {kGraphMLAttrDefScriptIdForEdge, 30},
+    {kGraphMLAttrDefScriptIdForNode, 31},
+    {kGraphMLAttrDefScriptPosition, 32},
+    {kGraphMLAttrDefScriptType, 33},
+    {kGraphMLAttrDefSecondaryPattern, 34},
+    {kGraphMLAttrDefSource, 35},
+    {kGraphMLAttrDefStatus, 36},
+    {kGraphMLAttrDefSuccess, 37},
+    {kGraphMLAttrDefURL, 38},
+    {kGraphMLAttrDefValue, 39},
+    {kGraphMLAttrDefUnknown, 40},
+    {kGraphMLAttrDefSize, 41},
+    {kGraphMLAttrDefHeaders, 42},
+};
+
+static_assert(std::size(kAttrIds) == kGraphMLAttrDefHeaders + 1,
+              "Every GraphMLAttrDef needs an id in kAttrIds");
+
+constexpr absl::optional<uint64_t> GetAttrId(GraphMLAttrDef def) {
+  for (const AttrId& attr_id : kAttrIds) {
+    if (attr_id.def == def)
+      return attr_id.id;
+  }
+  return absl::nullopt;
+}
+
+constexpr absl::optional<GraphMLAttrDef> GetAttrDef(uint64_t id) {
+  for (const AttrId& attr_id : kAttrIds) {
+    if (attr_id.id == id)
+      return attr_id.def;
+  }
+  return absl::nullopt;
+}
+
+}  // namespace binary_graph
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_FORMAT_H_
@@ -0,0 +1,312 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_reader.h"
+
+#include <cstring>
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "base/strings/string_util.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_format.h"
+
+namespace brave_page_graph {
+
+class BinaryGraphReader::Cursor {
+ public:
+  explicit Cursor(base::StringPiece data) : data_(data) {}
+
+  bool AtEnd() const { return position_ == data_.size(); }
+
+  bool ReadByte(uint8_t* value) {
+    if (AtEnd())
+      return false;
+    *value = static_cast<uint8_t>(data_[position_++]);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadByte(&byte))
+        return false;
+      *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool ReadZigZag(int64_t* value) {
+    uint64_t encoded;
+    if (!ReadVarint(&encoded))
+      return false;
+    *value = static_cast<int64_t>(encoded >> 1) ^
+             -static_cast<int64_t>(encoded & 1);
+    return true;
+  }
+
+  bool ReadFixed64(uint64_t* value) {
+    if (data_.size() - position_ < 8)
+      return false;
+    *value = 0;
+    for (int i = 0; i < 8; ++i) {
+      *value |= static_cast<uint64_t>(static_cast<uint8_t>(data_[position_++]))
+                << (8 * i);
+    }
+    return true;
+  }
+
+  bool ReadBytes(base::StringPiece* value) {
+    uint64_t size;
+    if (!ReadVarint(&size) || size > data_.size() - position_)
+      return false;
+    *value = data_.substr(position_, size);
+    position_ += size;
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    base::StringPiece bytes;
+    if (!ReadBytes(&bytes))
+      return false;
+    value->assign(bytes.data(), bytes.size());
+    return true;
+  }
+
+ private:
+  const base::StringPiece data_;
+  size_t position_ = 0;
+};
+
+BinaryGraphReader::Item::Item() = default;
+BinaryGraphReader::Item::Item(Item&&) = default;
+BinaryGraphReader::Item& BinaryGraphReader::Item::operator=(Item&&) = default;
+BinaryGraphReader::Item::~Item() = default;
+
+BinaryGraphReader::BinaryGraphReader() = default;
+
+BinaryGraphReader::~BinaryGraphReader() = default;
+
+bool BinaryGraphReader::Read(base::StringPiece data) {
+  if (failed_)
+    return false;
+
+  if (!has_header_) {
+    const base::StringPiece magic(binary_graph::kMagic,
+                                  sizeof(binary_graph::kMagic));
+    if (!base::StartsWith(data, magic)) {
+      failed_ = true;
+      return false;
+    }
+    data.remove_prefix(magic.size());
+  }
+
+  Cursor cursor(data);
+  if (!has_header_) {
+    uint64_t version;
+    if (!cursor.ReadVarint(&version) ||
+        version != binary_graph::kFormatVersion) {
+      failed_ = true;
+      return false;
+    }
+    has_header_ = true;
+  }
+
+  while (!cursor.AtEnd()) {
+    if (!ReadSnapshot(cursor)) {
+      failed_ = true;
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::optional<std::string> BinaryGraphReader::ToGraphML() const {
+  if (failed_ || !desc_)
+    return absl::nullopt;
+
+  GraphMLTextWriter writer(*desc_);
+  for (const auto& block : blocks_) {
+    for (const Item& item : block) {
+      WriteItem(item, writer);
+    }
+  }
+  for (const Item& edge : edges_) {
+    WriteItem(edge, writer);
+  }
+  return writer.Finish();
+}
+
+bool BinaryGraphReader::ReadSnapshot(Cursor& cursor) {
+  uint8_t tag;
+  uint64_t is_root;
+  GraphMLDesc desc;
+  if (!cursor.ReadByte(&tag) || tag != binary_graph::kSnapshot ||
+      !cursor.ReadVarint(&is_root) || !cursor.ReadString(&desc.version) ||
+      !cursor.ReadString(&desc.about) || !cursor.ReadString(&desc.frame_id) ||
+      !cursor.ReadZigZag(&desc.end_time_ms)) {
+    return false;
+  }
+  desc.is_root = is_root != 0;
+
+  while (cursor.ReadByte(&tag)) {
+    switch (tag) {
+      case binary_graph::kEndSnapshot:
+        desc_ = std::move(desc);
+        return true;
+      case binary_graph::kString: {
+        std::string value;
+        if (!cursor.ReadString(&value))
+          return false;
+        strings_.push_back(std::move(value));
+        break;
+      }
+      case binary_graph::kBlock: {
+        uint64_t node_id;
+        if (!cursor.ReadVarint(&node_id))
+          return false;
+        std::vector<Item> block;
+        while (true) {
+          if (!cursor.ReadByte(&tag))
+            return false;
+          if (tag == binary_graph::kEndBlock)
+            break;
+          block.emplace_back();
+          if (!ReadItem(tag, cursor, block.back()))
+            return false;
+        }
+        auto result = block_indices_.emplace(node_id, blocks_.size());
+        if (result.second) {
+          blocks_.push_back(std::move(block));
+        } else {
+          blocks_[result.first->second] = std::move(block);
+        }
+        break;
+      }
+      case binary_graph::kEdge:
+        edges_.emplace_back();
+        if (!ReadItem(tag, cursor, edges_.back()))
+          return false;
+        break;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+bool BinaryGraphReader::ReadItem(uint8_t tag, Cursor& cursor, Item& item) {
+  if (tag != binary_graph::kNode && tag != binary_graph::kEdge)
+    return false;
+  item.is_edge = tag == binary_graph::kEdge;
+  if (!cursor.ReadVarint(&item.id))
+    return false;
+  if (item.is_edge &&
+      (!cursor.ReadVarint(&item.source) || !cursor.ReadVarint(&item.target))) {
+    return false;
+  }
+
+  while (true) {
+    uint64_t attr;
+    if (!cursor.ReadByte(&tag))
+      return false;
+    if (tag == binary_graph::kEndItem)
+      return true;
+    if (!cursor.ReadVarint(&attr))
+      return false;
+    const absl::optional<GraphMLAttrDef> def = binary_graph::GetAttrDef(attr);
+    if (!def || !base::Contains(GetGraphMLAttrs(), *def))
+      return false;
+
+    Value value = {*def, tag, 0};
+    switch (tag) {
+      case binary_graph::kValueString:
+        if (!cursor.ReadVarint(&value.bits) || value.bits >= strings_.size())
+          return false;
+        break;
+      case binary_graph::kValueInlineString: {
+        std::string text;
+        if (!cursor.ReadString(&text))
+          return false;
+        value.bits = inline_strings_.size();
+        inline_strings_.push_back(std::move(text));
+        break;
+      }
+      case binary_graph::kValueInteger: {
+        int64_t integer;
+        if (!cursor.ReadZigZag(&integer))
+          return false;
+        value.bits = static_cast<uint64_t>(integer);
+        break;
+      }
+      case binary_graph::kValueUnsigned:
+        if (!cursor.ReadVarint(&value.bits))
+          return false;
+        break;
+      case binary_graph::kValueBoolean: {
+        uint8_t boolean;
+        if (!cursor.ReadByte(&boolean))
+          return false;
+        value.bits = boolean;
+        break;
+      }
+      case binary_graph::kValueDouble:
+        if (!cursor.ReadFixed64(&value.bits))
+          return false;
+        break;
+      default:
+        return false;
+    }
+    item.values.push_back(value);
+  }
+}
+
+void BinaryGraphReader::WriteItem(const Item& item,
+                                  GraphMLWriter& writer) const {
+  if (item.is_edge) {
+    writer.StartEdge(item.id, item.source, item.target);
+  } else {
+    writer.StartNode(item.id);
+  }
+  for (const Value& value : item.values) {
+    const GraphMLAttr& attr = *GraphMLAttrDefForType(value.attr);
+    switch (value.type) {
+      case binary_graph::kValueString:
+        writer.AddStringValue(attr, strings_[value.bits]);
+        break;
+      case binary_graph::kValueInlineString:
+        writer.AddStringValue(attr, inline_strings_[value.bits]);
+        break;
+      case binary_graph::kValueInteger:
+        writer.AddIntegerValue(attr, static_cast<int64_t>(value.bits));
+        break;
+      case binary_graph::kValueUnsigned:
+        writer.AddUnsignedValue(attr, value.bits);
+        break;
+      case binary_graph::kValueBoolean:
+        writer.AddBooleanValue(attr, value.bits != 0);
+        break;
+      case binary_graph::kValueDouble: {
+        double number;
+        memcpy(&number, &value.bits, sizeof(number));
+        writer.AddDoubleValue(attr, number);
+        break;
+      }
+    }
+  }
+  writer.EndItem();
+}
+
+absl::optional<std::string> ConvertBinaryGraphToGraphML(
+    base::StringPiece data) {
+  BinaryGraphReader reader;
+  if (!reader.Read(data))
+    return absl::nullopt;
+  return reader.ToGraphML();
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,90 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_READER_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_READER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace brave_page_graph {
+
+// Rebuilds a page graph from the binary encoding written by
+// BinaryGraphWriter (see binary_graph_format.h), for tools that want GraphML
+// out of the snapshots collected from a page. It isn't part of the renderer;
+// see the binary_graph_reader target in BUILD.gn.
+class BinaryGraphReader {
+ public:
+  BinaryGraphReader();
+  ~BinaryGraphReader();
+
+  BinaryGraphReader(const BinaryGraphReader&) = delete;
+  BinaryGraphReader& operator=(const BinaryGraphReader&) = delete;
+
+  // Applies the snapshots in |data|, which must be a prefix of the stream
+  // (on the first call) or continue where the previous call stopped. Returns
+  // false if the data is malformed; the reader is unusable afterwards.
+  bool Read(base::StringPiece data);
+
+  // Returns the graph as of the last snapshot read, in the same form
+  // PageGraph::ToGraphML() produced at that time, or absl::nullopt if no
+  // snapshot has been read yet.
+  absl::optional<std::string> ToGraphML() const;
+
+ private:
+  struct Value {
+    GraphMLAttrDef attr;
+    uint8_t type;
+    // Integers and doubles are kept as their bits, strings as their index in
+    // |strings_| or |inline_strings_|.
+    uint64_t bits;
+  };
+
+  struct Item {
+    Item();
+    Item(Item&&);
+    Item& operator=(Item&&);
+    ~Item();
+
+    bool is_edge = false;
+    GraphItemId id = 0;
+    GraphItemId source = 0;
+    GraphItemId target = 0;
+    std::vector<Value> values;
+  };
+
+  class Cursor;
+
+  bool ReadSnapshot(Cursor& cursor);
+  bool ReadItem(uint8_t tag, Cursor& cursor, Item& item);
+  void WriteItem(const Item& item, GraphMLWriter& writer) const;
+
+  bool has_header_ = false;
+  bool failed_ = false;
+  absl::optional<GraphMLDesc> desc_;
+  std::vector<std::string> strings_;
+  std::vector<std::string> inline_strings_;
+  // Node blocks in the order they were first written, and where to find the
+  // block of every node.
+  std::vector<std::vector<Item>> blocks_;
+  std::unordered_map<GraphItemId, size_t> block_indices_;
+  std::vector<Item> edges_;
+};
+
+// Converts a complete binary stream to GraphML. Returns absl::nullopt if the
+// stream is malformed or holds no snapshot.
+absl::optional<std::string> ConvertBinaryGraphToGraphML(
+    base::StringPiece data);
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_READER_H_
@@ -0,0 +1,165 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_reader.h"
+
+#include <set>
+#include <string>
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_format.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_writer.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+const GraphMLAttr& Attr(GraphMLAttrDef def) {
+  return *GraphMLAttrDefForType(def);
+}
+
+GraphMLDesc MakeDesc(int64_t end_time_ms) {
+  GraphMLDesc desc;
+  desc.version = "0.2.4";
+  desc.about = "https://example.com/";
+  desc.is_root = true;
+  desc.frame_id = "6D3A8C1E";
+  desc.end_time_ms = end_time_ms;
+  return desc;
+}
+
+void WriteNode(GraphMLWriter& writer,
+               GraphItemId id,
+               base::StringPiece text,
+               bool is_deleted) {
+  writer.StartNode(id);
+  writer.AddStringValue(Attr(kGraphMLAttrDefNodeType), "DOM text node");
+  writer.AddUnsignedValue(Attr(kGraphMLAttrDefPageGraphNodeId), id);
+  writer.AddIntegerValue(Attr(kGraphMLAttrDefPageGraphNodeTimestamp), -42);
+  writer.AddStringValue(Attr(kGraphMLAttrDefNodeText), text);
+  writer.AddBooleanValue(Attr(kGraphMLAttrDefIsDeleted), is_deleted);
+  writer.EndItem();
+}
+
+void WriteEdge(GraphMLWriter& writer,
+               GraphItemId id,
+               GraphItemId source,
+               GraphItemId target) {
+  writer.StartEdge(id, source, target);
+  writer.AddStringValue(Attr(kGraphMLAttrDefEdgeType), "structure");
+  writer.AddDoubleValue(Attr(kGraphMLAttrDefPageGraphEdgeTimestamp), 1.5);
+  writer.EndItem();
+}
+
+}  // namespace
+
+TEST(BinaryGraphReaderTest, AttrIdsRoundTrip) {
+  std::set<uint64_t> ids;
+  for (const auto& graphml_attr : GetGraphMLAttrs()) {
+    const absl::optional<uint64_t> id =
+        binary_graph::GetAttrId(graphml_attr.first);
+    ASSERT_TRUE(id);
+    EXPECT_TRUE(ids.insert(*id).second) << "Duplicate attribute id " << *id;
+    EXPECT_EQ(binary_graph::GetAttrDef(*id), graphml_attr.first);
+  }
+  EXPECT_FALSE(binary_graph::GetAttrDef(ids.size()));
+}
+
+TEST(BinaryGraphReaderTest, ConvertsToSameGraphML) {
+  const std::string long_text(binary_graph::kMaxInternedStringLength + 1,
+                              'x');
+
+  BinaryGraphWriter binary;
+  binary.StartSnapshot(MakeDesc(1234));
+  binary.StartBlock(1);
+  WriteNode(binary, 1, "a < b && c", false);
+  WriteEdge(binary, 3, 1, 2);
+  binary.EndBlock();
+  binary.StartBlock(2);
+  WriteNode(binary, 2, long_text, true);
+  binary.EndBlock();
+  WriteEdge(binary, 4, 2, 1);
+  const std::string data = binary.FinishSnapshot();
+
+  // The reader writes blocks first, then the edges outside of any block.
+  GraphMLTextWriter text(MakeDesc(1234));
+  WriteNode(text, 1, "a < b && c", false);
+  WriteEdge(text, 3, 1, 2);
+  WriteNode(text, 2, long_text, true);
+  WriteEdge(text, 4, 2, 1);
+
+  EXPECT_EQ(ConvertBinaryGraphToGraphML(data), text.Finish());
+}
+
+TEST(BinaryGraphReaderTest, AppliesIncrementalSnapshots) {
+  BinaryGraphWriter binary;
+  BinaryGraphReader reader;
+
+  binary.StartSnapshot(MakeDesc(1000));
+  binary.StartBlock(1);
+  WriteNode(binary, 1, "first", false);
+  binary.EndBlock();
+  binary.StartBlock(2);
+  WriteNode(binary, 2, "second", false);
+  binary.EndBlock();
+  WriteEdge(binary, 3, 1, 2);
+  ASSERT_TRUE(reader.Read(binary.FinishSnapshot()));
+
+  GraphMLTextWriter first(MakeDesc(1000));
+  WriteNode(first, 1, "first", false);
+  WriteNode(first, 2, "second", false);
+  WriteEdge(first, 3, 1, 2);
+  EXPECT_EQ(reader.ToGraphML(), first.Finish());
+
+  // Rewriting node 1 replaces its block in place, and "second" is only
+  // referenced through the string table of the first snapshot.
+  binary.StartSnapshot(MakeDesc(2000));
+  binary.StartBlock(1);
+  WriteNode(binary, 1, "second", true);
+  binary.EndBlock();
+  WriteEdge(binary, 4, 2, 1);
+  ASSERT_TRUE(reader.Read(binary.FinishSnapshot()));
+
+  GraphMLTextWriter second(MakeDesc(2000));
+  WriteNode(second, 1, "second", true);
+  WriteNode(second, 2, "second", false);
+  WriteEdge(second, 3, 1, 2);
+  WriteEdge(second, 4, 2, 1);
+  EXPECT_EQ(reader.ToGraphML(), second.Finish());
+}
+
+TEST(BinaryGraphReaderTest, RejectsMalformedData) {
+  BinaryGraphWriter binary;
+  binary.StartSnapshot(MakeDesc(1000));
+  binary.StartBlock(1);
+  WriteNode(binary, 1, "node", false);
+  binary.EndBlock();
+  const std::string data = binary.FinishSnapshot();
+  ASSERT_TRUE(ConvertBinaryGraphToGraphML(data));
+
+  EXPECT_FALSE(ConvertBinaryGraphToGraphML(""));
+  // A header without any snapshot.
+  EXPECT_FALSE(ConvertBinaryGraphToGraphML(data.substr(0, 5)));
+
+  std::string bad_magic = data;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(ConvertBinaryGraphToGraphML(bad_magic));
+
+  std::string bad_version = data;
+  bad_version[sizeof(binary_graph::kMagic)] =
+      static_cast<char>(binary_graph::kFormatVersion + 1);
+  EXPECT_FALSE(ConvertBinaryGraphToGraphML(bad_version));
+
+  EXPECT_FALSE(ConvertBinaryGraphToGraphML(data.substr(0, data.size() - 1)));
+
+  // Once malformed data has been seen the reader stays unusable.
+  BinaryGraphReader reader;
+  EXPECT_FALSE(reader.Read(bad_version));
+  EXPECT_FALSE(reader.Read(data));
+  EXPECT_FALSE(reader.ToGraphML());
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,201 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_writer.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/check.h"
+#include "base/notreached.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/graph_edge.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/node/graph_node.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+void AppendVarint(uint64_t value, std::string& output) {
+  while (value >= 0x80) {
+    output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  output.push_back(static_cast<char>(value));
+}
+
+void AppendZigZag(int64_t value, std::string& output) {
+  AppendVarint((static_cast<uint64_t>(value) << 1) ^
+                   static_cast<uint64_t>(value >> 63),
+               output);
+}
+
+void AppendBytes(base::StringPiece value, std::string& output) {
+  AppendVarint(value.size(), output);
+  output.append(value.data(), value.size());
+}
+
+base::flat_map<const GraphMLAttr*, uint64_t> BuildAttrIds() {
+  std::vector<std::pair<const GraphMLAttr*, uint64_t>> attr_ids;
+  for (const auto& graphml_attr : GetGraphMLAttrs()) {
+    const absl::optional<uint64_t> id =
+        binary_graph::GetAttrId(graphml_attr.first);
+    DCHECK(id);
+    if (id)
+      attr_ids.emplace_back(graphml_attr.second, *id);
+  }
+  return base::flat_map<const GraphMLAttr*, uint64_t>(std::move(attr_ids));
+}
+
+}  // namespace
+
+BinaryGraphWriter::BinaryGraphWriter() : attr_ids_(BuildAttrIds()) {}
+
+BinaryGraphWriter::~BinaryGraphWriter() = default;
+
+void BinaryGraphWriter::StartSnapshot(const GraphMLDesc& desc) {
+  DCHECK(!in_snapshot_);
+  in_snapshot_ = true;
+  desc_.clear();
+  strings_.clear();
+  records_.clear();
+
+  desc_.push_back(binary_graph::kSnapshot);
+  AppendVarint(desc.is_root ? 1 : 0, desc_);
+  AppendBytes(desc.version, desc_);
+  AppendBytes(desc.about, desc_);
+  AppendBytes(desc.frame_id, desc_);
+  AppendZigZag(desc.end_time_ms, desc_);
+}
+
+void BinaryGraphWriter::AddNodeBlock(const GraphNode& node) {
+  StartBlock(node.GetId());
+  node.AddGraphMLTag(*this);
+  EndBlock();
+}
+
+void BinaryGraphWriter::StartBlock(GraphItemId node_id) {
+  DCHECK(in_snapshot_);
+  records_.push_back(binary_graph::kBlock);
+  AppendVarint(node_id, records_);
+}
+
+void BinaryGraphWriter::EndBlock() {
+  DCHECK(in_snapshot_);
+  records_.push_back(binary_graph::kEndBlock);
+}
+
+void BinaryGraphWriter::AddEdge(const GraphEdge& edge) {
+  DCHECK(in_snapshot_);
+  edge.AddGraphMLTag(*this);
+}
+
+std::string BinaryGraphWriter::FinishSnapshot() {
+  DCHECK(in_snapshot_);
+  in_snapshot_ = false;
+
+  std::string snapshot;
+  snapshot.reserve(sizeof(binary_graph::kMagic) + 1 + desc_.size() +
+                   strings_.size() + records_.size() + 1);
+  if (!header_written_) {
+    snapshot.append(binary_graph::kMagic, sizeof(binary_graph::kMagic));
+    AppendVarint(binary_graph::kFormatVersion, snapshot);
+    header_written_ = true;
+  }
+  snapshot.append(desc_);
+  snapshot.append(strings_);
+  snapshot.append(records_);
+  snapshot.push_back(binary_graph::kEndSnapshot);
+
+  desc_.clear();
+  strings_.clear();
+  records_.clear();
+  return snapshot;
+}
+
+void BinaryGraphWriter::StartNode(GraphItemId id) {
+  records_.push_back(binary_graph::kNode);
+  AppendVarint(id, records_);
+}
+
+void BinaryGraphWriter::StartEdge(GraphItemId id,
+                                  GraphItemId source,
+                                  GraphItemId target) {
+  records_.push_back(binary_graph::kEdge);
+  AppendVarint(id, records_);
+  AppendVarint(source, records_);
+  AppendVarint(target, records_);
+}
+
+void BinaryGraphWriter::EndItem() {
+  records_.push_back(binary_graph::kEndItem);
+}
+
+void BinaryGraphWriter::AddStringValue(const GraphMLAttr& attr,
+                                       base::StringPiece value) {
+  if (value.size() > binary_graph::kMaxInternedStringLength) {
+    if (StartValue(binary_graph::kValueInlineString, attr))
+      AppendBytes(value, records_);
+    return;
+  }
+  if (StartValue(binary_graph::kValueString, attr))
+    AppendVarint(InternString(value), records_);
+}
+
+void BinaryGraphWriter::AddIntegerValue(const GraphMLAttr& attr,
+                                        int64_t value) {
+  if (StartValue(binary_graph::kValueInteger, attr))
+    AppendZigZag(value, records_);
+}
+
+void BinaryGraphWriter::AddUnsignedValue(const GraphMLAttr& attr,
+                                         uint64_t value) {
+  if (StartValue(binary_graph::kValueUnsigned, attr))
+    AppendVarint(value, records_);
+}
+
+void BinaryGraphWriter::AddBooleanValue(const GraphMLAttr& attr, bool value) {
+  if (StartValue(binary_graph::kValueBoolean, attr))
+    records_.push_back(value ? 1 : 0);
+}
+
+void BinaryGraphWriter::AddDoubleValue(const GraphMLAttr& attr,
+                                       double value) {
+  if (!StartValue(binary_graph::kValueDouble, attr))
+    return;
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(value), "double must be 64 bits");
+  memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; ++i) {
+    records_.push_back(static_cast<char>(bits & 0xFF));
+    bits >>= 8;
+  }
+}
+
+bool BinaryGraphWriter::StartValue(binary_graph::Tag tag,
+                                   const GraphMLAttr& attr) {
+  auto it = attr_ids_.find(&attr);
+  if (it == attr_ids_.end()) {
+    // Every attribute comes from GetGraphMLAttrs(); one that doesn't can't
+    // be encoded, so its value is left out rather than corrupting the stream.
+    NOTREACHED();
+    return false;
+  }
+  records_.push_back(tag);
+  AppendVarint(it->second, records_);
+  return true;
+}
+
+uint64_t BinaryGraphWriter::InternString(base::StringPiece value) {
+  auto result = string_indices_.emplace(std::string(value),
+                                        string_indices_.size());
+  if (result.second) {
+    strings_.push_back(binary_graph::kString);
+    AppendBytes(value, strings_);
+  }
+  return result.first->second;
+}
+
+}  // namespace brave_page_graph
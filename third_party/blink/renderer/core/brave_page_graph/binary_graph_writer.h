@@ -0,0 +1,87 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_WRITER_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_format.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
+#include "third_party/blink/renderer/core/core_export.h"
+
+namespace brave_page_graph {
+
+class GraphEdge;
+class GraphNode;
+
+// Encodes graph items in the binary format described in
+// binary_graph_format.h. One writer is kept per graph for its whole lifetime:
+// it remembers the strings it has already put into the string table, so later
+// snapshots only carry the strings they introduce.
+class CORE_EXPORT BinaryGraphWriter final : public GraphMLWriter {
+ public:
+  BinaryGraphWriter();
+  ~BinaryGraphWriter() override;
+
+  BinaryGraphWriter(const BinaryGraphWriter&) = delete;
+  BinaryGraphWriter& operator=(const BinaryGraphWriter&) = delete;
+
+  void StartSnapshot(const GraphMLDesc& desc);
+  // Writes |node| along with the edges it synthesizes on export. Writing a
+  // node that is already part of the stream replaces its earlier block.
+  void AddNodeBlock(const GraphNode& node);
+  // Brackets the items of the block of node |node_id|, for callers that
+  // write them through the GraphMLWriter interface themselves.
+  void StartBlock(GraphItemId node_id);
+  void EndBlock();
+  void AddEdge(const GraphEdge& edge);
+  // Returns the encoded snapshot, preceded by the stream header if this was
+  // the first one.
+  std::string FinishSnapshot();
+
+  // GraphMLWriter:
+  void StartNode(GraphItemId id) override;
+  void StartEdge(GraphItemId id,
+                 GraphItemId source,
+                 GraphItemId target) override;
+  void EndItem() override;
+  void AddStringValue(const GraphMLAttr& attr,
+                      base::StringPiece value) override;
+  void AddIntegerValue(const GraphMLAttr& attr, int64_t value) override;
+  void AddUnsignedValue(const GraphMLAttr& attr, uint64_t value) override;
+  void AddBooleanValue(const GraphMLAttr& attr, bool value) override;
+  void AddDoubleValue(const GraphMLAttr& attr, double value) override;
+
+ private:
+  // Writes the tag and attribute of a value, or returns false if |attr| is
+  // unknown, in which case the value must be skipped.
+  bool StartValue(binary_graph::Tag tag, const GraphMLAttr& attr);
+  // Returns the string table index of |value|, adding it to the table (and a
+  // kString record to this snapshot) if it isn't there yet.
+  uint64_t InternString(base::StringPiece value);
+
+  // The binary_graph::kAttrIds id of every attribute in GetGraphMLAttrs().
+  const base::flat_map<const GraphMLAttr*, uint64_t> attr_ids_;
+  std::unordered_map<std::string, uint64_t> string_indices_;
+
+  bool header_written_ = false;
+  bool in_snapshot_ = false;
+  // The current snapshot is assembled from its desc, the strings it adds to
+  // the table and its records, so that every string is defined before the
+  // first record that refers to it.
+  std::string desc_;
+  std::string strings_;
+  std::string records_;
+};
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_BINARY_GRAPH_WRITER_H_
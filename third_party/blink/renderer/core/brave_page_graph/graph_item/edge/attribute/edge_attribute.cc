@@ -24,13 +24,11 @@ ItemDesc EdgeAttribute::GetItemDesc() const {
   return GraphEdge::GetItemDesc() + " [" + name_ + "]";
 }
 
-void EdgeAttribute::AddGraphMLAttributes(xmlDocPtr doc,
-                                         xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefKey)
-      ->AddValueNode(doc, parent_node, name_);
+void EdgeAttribute::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefKey)->AddValueNode(writer, name_);
   GraphMLAttrDefForType(kGraphMLAttrDefIsStyle)
-      ->AddValueNode(doc, parent_node, is_style_);
+      ->AddValueNode(writer, is_style_);
 }
 
 bool EdgeAttribute::IsEdgeAttribute() const {
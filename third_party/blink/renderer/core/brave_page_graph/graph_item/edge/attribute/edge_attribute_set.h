@@ -31,8 +31,7 @@ class EdgeAttributeSet final : public EdgeAttribute {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsEdgeAttributeSet() const override;
 
@@ -27,8 +27,7 @@ class EdgeBindingEvent : public GraphEdge {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsEdgeBindingEvent() const override;
 
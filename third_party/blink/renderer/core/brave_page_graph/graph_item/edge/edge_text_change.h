@@ -28,8 +28,7 @@ class EdgeTextChange : public GraphEdge {
   ItemName GetItemName() const override;
   ItemName GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsEdgeTextChange() const override;
 
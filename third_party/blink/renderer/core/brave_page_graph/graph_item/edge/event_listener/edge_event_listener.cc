@@ -32,13 +32,11 @@ ItemDesc EdgeEventListener::GetItemDesc() const {
          " [listener id: " + base::NumberToString(listener_id_) + "]";
 }
 
-void EdgeEventListener::AddGraphMLAttributes(xmlDocPtr doc,
-                                             xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefKey)
-      ->AddValueNode(doc, parent_node, event_type_);
+void EdgeEventListener::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefKey)->AddValueNode(writer, event_type_);
   GraphMLAttrDefForType(kGraphMLAttrDefEventListenerId)
-      ->AddValueNode(doc, parent_node, listener_id_);
+      ->AddValueNode(writer, listener_id_);
 }
 
 bool EdgeEventListener::IsEdgeEventListener() const {
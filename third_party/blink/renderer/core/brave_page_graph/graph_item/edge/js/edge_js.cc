@@ -16,8 +16,8 @@ EdgeJS::EdgeJS(GraphItemContext* context,
 
 EdgeJS::~EdgeJS() = default;
 
-void EdgeJS::AddGraphMLAttributes(xmlDocPtr doc, xmlNodePtr parent_node) const {
-  GraphEdge::AddGraphMLAttributes(doc, parent_node);
+void EdgeJS::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  GraphEdge::AddGraphMLAttributes(writer);
 }
 
 bool EdgeJS::IsEdgeJS() const {
@@ -54,13 +54,12 @@ ItemDesc EdgeJSCall::GetItemDesc() const {
          "]";
 }
 
-void EdgeJSCall::AddGraphMLAttributes(xmlDocPtr doc,
-                                      xmlNodePtr parent_node) const {
-  EdgeJS::AddGraphMLAttributes(doc, parent_node);
+void EdgeJSCall::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  EdgeJS::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefCallArgs)
-      ->AddValueNode(doc, parent_node, BuildArgumentsString(arguments_));
+      ->AddValueNode(writer, BuildArgumentsString(arguments_));
   GraphMLAttrDefForType(kGraphMLAttrDefScriptPosition)
-      ->AddValueNode(doc, parent_node, script_position_);
+      ->AddValueNode(writer, script_position_);
 }
 
 bool EdgeJSCall::IsEdgeJSCall() const {
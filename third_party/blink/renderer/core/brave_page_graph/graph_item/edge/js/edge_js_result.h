@@ -28,8 +28,7 @@ class EdgeJSResult final : public EdgeJS {
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   const std::string& GetResult() const;
   const MethodName& GetMethodName() const override;
@@ -59,16 +59,15 @@ ItemDesc EdgeNodeInsert::GetItemDesc() const {
   return builder.str();
 }
 
-void EdgeNodeInsert::AddGraphMLAttributes(xmlDocPtr doc,
-                                          xmlNodePtr parent_node) const {
-  EdgeNode::AddGraphMLAttributes(doc, parent_node);
+void EdgeNodeInsert::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  EdgeNode::AddGraphMLAttributes(writer);
   if (parent_node_) {
     GraphMLAttrDefForType(kGraphMLAttrDefParentNodeId)
-        ->AddValueNode(doc, parent_node, parent_node_->GetDOMNodeId());
+        ->AddValueNode(writer, parent_node_->GetDOMNodeId());
   }
   if (prior_sibling_node_) {
     GraphMLAttrDefForType(kGraphMLAttrDefBeforeNodeId)
-        ->AddValueNode(doc, parent_node, prior_sibling_node_->GetDOMNodeId());
+        ->AddValueNode(writer, prior_sibling_node_->GetDOMNodeId());
   }
 }
 
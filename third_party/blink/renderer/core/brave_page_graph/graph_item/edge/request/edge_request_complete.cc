@@ -40,13 +40,12 @@ ItemDesc EdgeRequestComplete::GetItemDesc() const {
   return EdgeRequestResponse::GetItemDesc() + " [" + resource_type_ + "]";
 }
 
-void EdgeRequestComplete::AddGraphMLAttributes(xmlDocPtr doc,
-                                               xmlNodePtr parent_node) const {
-  EdgeRequestResponse::AddGraphMLAttributes(doc, parent_node);
+void EdgeRequestComplete::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  EdgeRequestResponse::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefResourceType)
-      ->AddValueNode(doc, parent_node, resource_type_);
+      ->AddValueNode(writer, resource_type_);
   GraphMLAttrDefForType(kGraphMLAttrDefResponseHash)
-      ->AddValueNode(doc, parent_node, hash_);
+      ->AddValueNode(writer, hash_);
 }
 
 bool EdgeRequestComplete::IsEdgeRequestComplete() const {
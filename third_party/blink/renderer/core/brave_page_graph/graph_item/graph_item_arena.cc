@@ -0,0 +1,51 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "base/bits.h"
+#include "base/check.h"
+
+namespace brave_page_graph {
+
+namespace {
+
+// Big enough for a few hundred items of the larger kinds, and well above the
+// size of any single item.
+constexpr size_t kChunkSize = 64 * 1024;
+
+}  // namespace
+
+GraphItemArena::GraphItemArena() = default;
+
+GraphItemArena::~GraphItemArena() {
+  for (auto it = items_.rbegin(); it != items_.rend(); ++it) {
+    (*it)->~GraphItem();
+  }
+}
+
+void* GraphItemArena::Allocate(size_t size, size_t alignment) {
+  DCHECK(base::bits::IsPowerOfTwo(alignment));
+  uintptr_t start =
+      base::bits::AlignUp(reinterpret_cast<uintptr_t>(cursor_), alignment);
+  if (!cursor_ || start + size > reinterpret_cast<uintptr_t>(chunk_end_)) {
+    const size_t chunk_size = std::max(kChunkSize, size + alignment);
+    // Not value-initialized; every item is constructed in place anyway.
+    chunks_.emplace_back(new char[chunk_size]);
+    bytes_reserved_ += chunk_size;
+    cursor_ = chunks_.back().get();
+    chunk_end_ = cursor_ + chunk_size;
+    start =
+        base::bits::AlignUp(reinterpret_cast<uintptr_t>(cursor_), alignment);
+  }
+  cursor_ = reinterpret_cast<char*>(start + size);
+  bytes_used_ += size;
+  return reinterpret_cast<void*>(start);
+}
+
+}  // namespace brave_page_graph
@@ -0,0 +1,65 @@
+/* Copyright (c) 2022 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
+#define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item.h"
+
+namespace brave_page_graph {
+
+// Owns the graph items of a page graph. Items are never removed from a graph
+// before the graph itself goes away, so instead of a heap allocation per item
+// they are carved out of large chunks with a bump pointer, and all of them
+// are destroyed together, newest first, with the arena.
+class GraphItemArena {
+ public:
+  GraphItemArena();
+  ~GraphItemArena();
+
+  GraphItemArena(const GraphItemArena&) = delete;
+  GraphItemArena& operator=(const GraphItemArena&) = delete;
+
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    static_assert(std::is_base_of<GraphItem, T>::value,
+                  "GraphItemArena only holds graph items");
+    T* item = new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+    items_.push_back(item);
+    return item;
+  }
+
+  // Items in the order they were created.
+  const std::vector<GraphItem*>& items() const { return items_; }
+  // Bytes taken up by the items themselves, not counting what they allocate
+  // on their own (e.g. string contents).
+  size_t bytes_used() const { return bytes_used_; }
+  // Bytes of all the chunks allocated so far.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+ private:
+  void* Allocate(size_t size, size_t alignment);
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  // Free space left in the newest chunk.
+  char* cursor_ = nullptr;
+  char* chunk_end_ = nullptr;
+
+  std::vector<GraphItem*> items_;
+  size_t bytes_used_ = 0;
+  size_t bytes_reserved_ = 0;
+};
+
+}  // namespace brave_page_graph
+
+#endif  // BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPH_ITEM_GRAPH_ITEM_ARENA_H_
@@ -11,12 +11,17 @@
 
 namespace brave_page_graph {
 
+class GraphNode;
+
 class GraphItemContext {
  public:
   virtual ~GraphItemContext() = default;
 
   virtual base::TimeTicks GetGraphStartTime() const = 0;
   virtual GraphItemId GetNextGraphItemId() = 0;
+  // Called when a node's exported attributes, or the edges it synthesizes on
+  // export, change after the node was added to the graph.
+  virtual void OnGraphNodeChanged(const GraphNode* node) = 0;
 };
 
 }  // namespace brave_page_graph
@@ -24,13 +24,15 @@ class NodeScript : public NodeActor {
   const ScriptData& GetScriptData() const { return script_data_; }
 
   const std::string& GetURL() const { return url_; }
-  void SetURL(const std::string url) { url_ = url; }
+  void SetURL(const std::string url) {
+    url_ = url;
+    MarkChanged();
+  }
 
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsNodeScript() const override;
 
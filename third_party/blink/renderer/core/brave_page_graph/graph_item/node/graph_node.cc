@@ -7,6 +7,7 @@
 
 #include "base/strings/string_number_conversions.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/graph_edge.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item_context.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
 
 namespace brave_page_graph {
@@ -27,23 +28,20 @@ GraphMLId GraphNode::GetGraphMLId() const {
   return "n" + base::NumberToString(GetId());
 }
 
-void GraphNode::AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const {
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "node", nullptr);
-  xmlSetProp(new_node, BAD_CAST "id", BAD_CAST GetGraphMLId().c_str());
-  AddGraphMLAttributes(doc, new_node);
+void GraphNode::AddGraphMLTag(GraphMLWriter& writer) const {
+  writer.StartNode(GetId());
+  AddGraphMLAttributes(writer);
+  writer.EndItem();
 }
 
-void GraphNode::AddGraphMLAttributes(xmlDocPtr doc,
-                                     xmlNodePtr parent_node) const {
-  GraphItem::AddGraphMLAttributes(doc, parent_node);
+void GraphNode::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  GraphItem::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefNodeType)
-      ->AddValueNode(doc, parent_node, GetItemName());
+      ->AddValueNode(writer, GetItemName());
   GraphMLAttrDefForType(kGraphMLAttrDefPageGraphNodeId)
-      ->AddValueNode(doc, parent_node, GetId());
+      ->AddValueNode(writer, GetId());
   GraphMLAttrDefForType(kGraphMLAttrDefPageGraphNodeTimestamp)
-      ->AddValueNode(doc, parent_node,
-                     GetTimeDeltaSincePageStart().InMilliseconds());
+      ->AddValueNode(writer, GetTimeDeltaSincePageStart().InMilliseconds());
 }
 
 bool GraphNode::IsNode() const {
@@ -102,4 +100,8 @@ bool GraphNode::IsNodeStorageRoot() const {
   return false;
 }
 
+void GraphNode::MarkChanged() {
+  GetContext()->OnGraphNodeChanged(this);
+}
+
 }  // namespace brave_page_graph
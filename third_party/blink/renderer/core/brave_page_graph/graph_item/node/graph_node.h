@@ -26,9 +26,8 @@ class GraphNode : public GraphItem {
   virtual void AddOutEdge(const GraphEdge* out_edge);
 
   GraphMLId GetGraphMLId() const override;
-  void AddGraphMLTag(xmlDocPtr doc, xmlNodePtr parent_node) const override;
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLTag(GraphMLWriter& writer) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsNode() const override;
 
@@ -46,6 +45,10 @@ class GraphNode : public GraphItem {
   virtual bool IsNodeStorage() const;
   virtual bool IsNodeStorageRoot() const;
 
+ protected:
+  // Lets the context know that this node would now be exported differently.
+  void MarkChanged();
+
  private:
   // Reminder to self:
   //   out_edge -> node -> in_edge
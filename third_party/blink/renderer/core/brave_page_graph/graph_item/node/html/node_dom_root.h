@@ -19,14 +19,16 @@ class NodeDOMRoot final : public NodeHTMLElement {
               const blink::DOMNodeId dom_node_id,
               const std::string& tag_name);
 
-  void SetURL(const std::string& url) { url_ = url; }
+  void SetURL(const std::string& url) {
+    url_ = url;
+    MarkChanged();
+  }
   const std::string& GetURL() const { return url_; }
 
   ItemName GetItemName() const override;
   ItemDesc GetItemDesc() const override;
 
-  void AddGraphMLAttributes(xmlDocPtr doc,
-                            xmlNodePtr parent_node) const override;
+  void AddGraphMLAttributes(GraphMLWriter& writer) const override;
 
   bool IsNodeDOMRoot() const override;
 
@@ -25,6 +25,7 @@ NodeHTML::~NodeHTML() = default;
 void NodeHTML::MarkDeleted() {
   CHECK(is_deleted_ == false);
   is_deleted_ = true;
+  MarkChanged();
 }
 
 ItemDesc NodeHTML::GetItemDesc() const {
@@ -36,13 +37,12 @@ ItemDesc NodeHTML::GetItemDesc() const {
   return builder.str();
 }
 
-void NodeHTML::AddGraphMLAttributes(xmlDocPtr doc,
-                                    xmlNodePtr parent_node) const {
-  GraphNode::AddGraphMLAttributes(doc, parent_node);
+void NodeHTML::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  GraphNode::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefNodeId)
-      ->AddValueNode(doc, parent_node, dom_node_id_);
+      ->AddValueNode(writer, dom_node_id_);
   GraphMLAttrDefForType(kGraphMLAttrDefIsDeleted)
-      ->AddValueNode(doc, parent_node, is_deleted_);
+      ->AddValueNode(writer, is_deleted_);
 }
 
 void NodeHTML::AddInEdge(const GraphEdge* in_edge) {
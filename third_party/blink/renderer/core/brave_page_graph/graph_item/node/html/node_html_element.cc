@@ -57,14 +57,13 @@ ItemDesc NodeHTMLElement::GetItemDesc() const {
   return builder.str();
 }
 
-void NodeHTMLElement::AddGraphMLTag(xmlDocPtr doc,
-                                    xmlNodePtr parent_node) const {
-  NodeHTML::AddGraphMLTag(doc, parent_node);
+void NodeHTMLElement::AddGraphMLTag(GraphMLWriter& writer) const {
+  NodeHTML::AddGraphMLTag(writer);
 
   for (NodeHTML* child_node : child_nodes_) {
     EdgeStructure html_edge(GetContext(), const_cast<NodeHTMLElement*>(this),
                             child_node);
-    html_edge.AddGraphMLTag(doc, parent_node);
+    html_edge.AddGraphMLTag(writer);
   }
 
   // For each event listener, draw an edge from the listener script to the DOM
@@ -77,15 +76,14 @@ void NodeHTMLElement::AddGraphMLTag(xmlDocPtr doc,
     EdgeEventListener event_listener_edge(
         GetContext(), const_cast<NodeHTMLElement*>(this), listener_node,
         event_type, listener_id);
-    event_listener_edge.AddGraphMLTag(doc, parent_node);
+    event_listener_edge.AddGraphMLTag(writer);
   }
 }
 
-void NodeHTMLElement::AddGraphMLAttributes(xmlDocPtr doc,
-                                           xmlNodePtr parent_node) const {
-  NodeHTML::AddGraphMLAttributes(doc, parent_node);
+void NodeHTMLElement::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  NodeHTML::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefNodeTag)
-      ->AddValueNode(doc, parent_node, TagName());
+      ->AddValueNode(writer, TagName());
 }
 
 void NodeHTMLElement::PlaceChildNodeAfterSiblingNode(NodeHTML* child,
@@ -95,6 +93,7 @@ void NodeHTMLElement::PlaceChildNodeAfterSiblingNode(NodeHTML* child,
   if (child_nodes_.size() == 0) {
     CHECK(sibling == nullptr);
     child_nodes_.push_back(child);
+    MarkChanged();
     return;
   }
 
@@ -102,6 +101,7 @@ void NodeHTMLElement::PlaceChildNodeAfterSiblingNode(NodeHTML* child,
   // in the child nodes.
   if (sibling == nullptr) {
     child_nodes_.insert(child_nodes_.begin(), child);
+    MarkChanged();
     return;
   }
 
@@ -109,6 +109,7 @@ void NodeHTMLElement::PlaceChildNodeAfterSiblingNode(NodeHTML* child,
   const auto sib_pos = find(child_nodes_.begin(), child_nodes_.end(), sibling);
   CHECK(sib_pos != child_nodes_.end());
   child_nodes_.insert(sib_pos + 1, child);
+  MarkChanged();
 }
 
 void NodeHTMLElement::RemoveChildNode(NodeHTML* child_node) {
@@ -116,6 +117,7 @@ void NodeHTMLElement::RemoveChildNode(NodeHTML* child_node) {
       find(child_nodes_.begin(), child_nodes_.end(), child_node);
   CHECK(child_pos != child_nodes_.end());
   child_nodes_.erase(child_pos);
+  MarkChanged();
 }
 
 void NodeHTMLElement::MarkDeleted() {
@@ -131,9 +133,11 @@ void NodeHTMLElement::AddInEdge(const GraphEdge* in_edge) {
           DynamicTo<EdgeEventListenerAdd>(in_edge)) {
     event_listeners_.emplace(add_event_listener_in_edge->GetListenerId(),
                              add_event_listener_in_edge);
+    MarkChanged();
   } else if (const EdgeEventListenerRemove* remove_event_listener_in_edge =
                  DynamicTo<EdgeEventListenerRemove>(in_edge)) {
     event_listeners_.erase(remove_event_listener_in_edge->GetListenerId());
+    MarkChanged();
   } else if (const EdgeNodeRemove* remove_node_in_edge =
                  DynamicTo<EdgeNodeRemove>(in_edge)) {
     // Special case for when something (script) is removing an HTML element
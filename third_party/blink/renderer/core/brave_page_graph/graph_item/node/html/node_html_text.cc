@@ -37,11 +37,9 @@ ItemDesc NodeHTMLText::GetItemDesc() const {
          " [length: " + base::NumberToString(text_.size()) + "]";
 }
 
-void NodeHTMLText::AddGraphMLAttributes(xmlDocPtr doc,
-                                        xmlNodePtr parent_node) const {
-  NodeHTML::AddGraphMLAttributes(doc, parent_node);
-  GraphMLAttrDefForType(kGraphMLAttrDefNodeText)
-      ->AddValueNode(doc, parent_node, text_);
+void NodeHTMLText::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  NodeHTML::AddGraphMLAttributes(writer);
+  GraphMLAttrDefForType(kGraphMLAttrDefNodeText)->AddValueNode(writer, text_);
 }
 
 void NodeHTMLText::AddInEdge(const GraphEdge* in_edge) {
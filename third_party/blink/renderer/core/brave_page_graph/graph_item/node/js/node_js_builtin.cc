@@ -27,11 +27,10 @@ ItemDesc NodeJSBuiltin::GetItemDesc() const {
   return GraphNode::GetItemDesc() + " [" + builtin_ + "]";
 }
 
-void NodeJSBuiltin::AddGraphMLAttributes(xmlDocPtr doc,
-                                         xmlNodePtr parent_node) const {
-  NodeJS::AddGraphMLAttributes(doc, parent_node);
+void NodeJSBuiltin::AddGraphMLAttributes(GraphMLWriter& writer) const {
+  NodeJS::AddGraphMLAttributes(writer);
   GraphMLAttrDefForType(kGraphMLAttrDefMethodName)
-      ->AddValueNode(doc, parent_node, builtin_);
+      ->AddValueNode(writer, builtin_);
 }
 
 bool NodeJSBuiltin::IsNodeJSBuiltin() const {
@@ -5,13 +5,11 @@
 
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graphml.h"
 
-#include <libxml/entities.h>
-#include <libxml/tree.h>
-
-#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "base/check.h"
 #include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
@@ -19,104 +17,377 @@
 namespace brave_page_graph {
 
 namespace {
+
 uint32_t graphml_index = 0;
+
+constexpr char kXMLDeclaration[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+
+// libxml2's IS_CHAR(): the code points allowed in an XML document.
+bool IsXMLChar(uint32_t c) {
+  return (c == 0x9) || (c == 0xA) || (c == 0xD) ||
+         (c >= 0x20 && c <= 0xD7FF) || (c >= 0xE000 && c <= 0xFFFD) ||
+         (c >= 0x10000 && c <= 0x10FFFF);
+}
+
+// libxml2's xmlCopyCharMultiByte().
+void AppendCodePoint(uint32_t c, std::string& output) {
+  if (c < 0x80) {
+    output.push_back(static_cast<char>(c));
+  } else if (c < 0x800) {
+    output.push_back(static_cast<char>(0xC0 | (c >> 6)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else if (c < 0x10000) {
+    output.push_back(static_cast<char>(0xE0 | (c >> 12)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  } else {
+    output.push_back(static_cast<char>(0xF0 | (c >> 18)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    output.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+  }
+}
+
+// Escaping applied by libxml2 when saving attribute values.
+void AppendEscapedAttribute(base::StringPiece value, std::string& output) {
+  for (const char c : value) {
+    switch (c) {
+      case '<':
+        output.append("&lt;");
+        break;
+      case '>':
+        output.append("&gt;");
+        break;
+      case '&':
+        output.append("&amp;");
+        break;
+      case '"':
+        output.append("&quot;");
+        break;
+      case '\n':
+        output.append("&#10;");
+        break;
+      case '\r':
+        output.append("&#13;");
+        break;
+      case '\t':
+        output.append("&#9;");
+        break;
+      default:
+        output.push_back(c);
+    }
+  }
+}
+
+}  // namespace
+
+XMLWriter::XMLWriter() {
+  output_.append(kXMLDeclaration);
+}
+
+XMLWriter::~XMLWriter() = default;
+
+void XMLWriter::StartElement(base::StringPiece name) {
+  CloseStartTag();
+  output_.push_back('<');
+  output_.append(name.data(), name.size());
+  open_elements_.push_back(name);
+  start_tag_open_ = true;
+}
+
+void XMLWriter::AddAttribute(base::StringPiece name,
+                                 base::StringPiece value) {
+  DCHECK(start_tag_open_);
+  output_.push_back(' ');
+  output_.append(name.data(), name.size());
+  output_.append("=\"");
+  AppendEscapedAttribute(value, output_);
+  output_.push_back('"');
+}
+
+void XMLWriter::AddText(base::StringPiece text) {
+  // The old tree got a text child even for empty content, which is enough
+  // for libxml2 to write an explicit end tag.
+  CloseStartTag();
+  AppendEscapedText(text);
+}
+
+void XMLWriter::AddEncodedText(base::StringPiece text) {
+  // The value used to be handed to libxml2 as a C string.
+  text = text.substr(0, text.find('\0'));
+
+  // xmlEncodeEntitiesReentrant() turned every non-ASCII character into a
+  // character reference that xmlNewChild() then decoded again, so this only
+  // differs from AddText() for control characters, which are dropped, and
+  // malformed UTF-8, whose first byte is taken as a Latin-1 character.
+  // Overlong two byte sequences are accepted, as libxml2 does.
+  const auto* bytes = reinterpret_cast<const uint8_t*>(text.data());
+  const size_t size = text.size();
+  const auto byte_at = [&](size_t i) -> uint32_t {
+    return i < size ? bytes[i] : 0;
+  };
+  const auto is_plain = [&](uint8_t c) {
+    return (c >= 0x20 && c < 0x80) || c == '\t' || c == '\n' || c == '\r' ||
+           (c >= 0x80 && passthrough_non_ascii_);
+  };
+  size_t i = 0;
+  while (i < size) {
+    const uint8_t c = bytes[i];
+    if (is_plain(c)) {
+      size_t run_end = i + 1;
+      while (run_end < size && is_plain(bytes[run_end]))
+        ++run_end;
+      // Like libxml2, only close the start tag once there is content, so a
+      // value without any surviving characters still gives "<data .../>".
+      CloseStartTag();
+      AppendEscapedText(text.substr(i, run_end - i));
+      i = run_end;
+      continue;
+    }
+    if (c < 0x80) {
+      ++i;
+      continue;
+    }
+
+    size_t length = 1;
+    if (c >= 0xC0 && c < 0xE0) {
+      length = 2;
+    } else if (c >= 0xE0 && c < 0xF0) {
+      length = 3;
+    } else if (c >= 0xF0 && c < 0xF8) {
+      length = 4;
+    }
+    uint32_t code_point = length == 1 ? 0 : c & (0x7F >> length);
+    for (size_t k = 1; k < length; ++k) {
+      const uint32_t continuation = byte_at(i + k);
+      if ((continuation & 0xC0) != 0x80) {
+        length = 1;
+        break;
+      }
+      code_point = (code_point << 6) | (continuation & 0x3F);
+    }
+    CloseStartTag();
+    if (length == 1 || !IsXMLChar(code_point)) {
+      AppendCodePoint(c, output_);
+      passthrough_non_ascii_ = true;
+      ++i;
+      continue;
+    }
+    AppendCodePoint(code_point, output_);
+    i += length;
+  }
+}
+
+void XMLWriter::EndElement() {
+  DCHECK(!open_elements_.empty());
+  if (start_tag_open_) {
+    output_.append("/>");
+    start_tag_open_ = false;
+  } else {
+    output_.append("</");
+    output_.append(open_elements_.back().data(), open_elements_.back().size());
+    output_.push_back('>');
+  }
+  open_elements_.pop_back();
+}
+
+void XMLWriter::AddTextElement(base::StringPiece name,
+                                   base::StringPiece text) {
+  StartElement(name);
+  AddText(text);
+  EndElement();
+}
+
+std::string XMLWriter::Finish() {
+  while (!open_elements_.empty())
+    EndElement();
+  output_.push_back('\n');
+  return std::move(output_);
+}
+
+void XMLWriter::CloseStartTag() {
+  if (!start_tag_open_)
+    return;
+  output_.push_back('>');
+  start_tag_open_ = false;
+}
+
+void XMLWriter::AppendEscapedText(base::StringPiece text) {
+  for (const char c : text) {
+    switch (c) {
+      case '<':
+        output_.append("&lt;");
+        break;
+      case '>':
+        output_.append("&gt;");
+        break;
+      case '&':
+        output_.append("&amp;");
+        break;
+      case '\r':
+        output_.append("&#13;");
+        break;
+      default:
+        output_.push_back(c);
+    }
+  }
+}
+
+GraphMLDesc::GraphMLDesc() = default;
+GraphMLDesc::GraphMLDesc(const GraphMLDesc&) = default;
+GraphMLDesc& GraphMLDesc::operator=(const GraphMLDesc&) = default;
+GraphMLDesc::~GraphMLDesc() = default;
+
+GraphMLTextWriter::GraphMLTextWriter(const GraphMLDesc& desc) {
+  xml_.StartElement("graphml");
+  xml_.AddAttribute("xmlns", "http://graphml.graphdrawing.org/xmlns");
+  xml_.AddAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+  xml_.AddAttribute("xsi:schemaLocation",
+                    "http://graphml.graphdrawing.org/xmlns "
+                    "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
+
+  xml_.StartElement("desc");
+  xml_.AddTextElement("version", desc.version);
+  xml_.AddTextElement("about", desc.about);
+  xml_.AddTextElement("is_root", desc.is_root ? "true" : "false");
+  xml_.AddTextElement("frame_id", desc.frame_id);
+
+  xml_.StartElement("time");
+  xml_.AddTextElement("start", base::NumberToString(0));
+  xml_.AddTextElement("end", base::NumberToString(desc.end_time_ms));
+  xml_.EndElement();  // time
+  xml_.EndElement();  // desc
+
+  for (const auto& graphml_attr : GetGraphMLAttrs()) {
+    graphml_attr.second->AddDefinitionNode(xml_);
+  }
+
+  xml_.StartElement("graph");
+  xml_.AddAttribute("id", "G");
+  xml_.AddAttribute("edgedefault", "directed");
+}
+
+GraphMLTextWriter::~GraphMLTextWriter() = default;
+
+void GraphMLTextWriter::StartNode(GraphItemId id) {
+  xml_.StartElement("node");
+  xml_.AddAttribute("id", "n" + base::NumberToString(id));
+}
+
+void GraphMLTextWriter::StartEdge(GraphItemId id,
+                                  GraphItemId source,
+                                  GraphItemId target) {
+  xml_.StartElement("edge");
+  xml_.AddAttribute("id", "e" + base::NumberToString(id));
+  xml_.AddAttribute("source", "n" + base::NumberToString(source));
+  xml_.AddAttribute("target", "n" + base::NumberToString(target));
+}
+
+void GraphMLTextWriter::EndItem() {
+  xml_.EndElement();
+}
+
+void GraphMLTextWriter::AddStringValue(const GraphMLAttr& attr,
+                                       base::StringPiece value) {
+  xml_.StartElement("data");
+  xml_.AddAttribute("key", attr.GetGraphMLId());
+  xml_.AddEncodedText(value);
+  xml_.EndElement();
+}
+
+void GraphMLTextWriter::AddIntegerValue(const GraphMLAttr& attr,
+                                        int64_t value) {
+  AddTextValue(attr, base::NumberToString(value));
+}
+
+void GraphMLTextWriter::AddUnsignedValue(const GraphMLAttr& attr,
+                                         uint64_t value) {
+  AddTextValue(attr, base::NumberToString(value));
+}
+
+void GraphMLTextWriter::AddBooleanValue(const GraphMLAttr& attr, bool value) {
+  AddTextValue(attr, value ? "true" : "false");
+}
+
+void GraphMLTextWriter::AddDoubleValue(const GraphMLAttr& attr,
+                                       double value) {
+  AddTextValue(attr, base::NumberToString(value));
+}
+
+std::string GraphMLTextWriter::Finish() {
+  return xml_.Finish();
+}
+
+void GraphMLTextWriter::AddTextValue(const GraphMLAttr& attr,
+                                     base::StringPiece text) {
+  xml_.StartElement("data");
+  xml_.AddAttribute("key", attr.GetGraphMLId());
+  xml_.AddText(text);
+  xml_.EndElement();
 }
 
 GraphMLAttr::GraphMLAttr(const GraphMLAttrForType for_value,
                          const std::string& name,
                          const GraphMLAttrType type)
-    : id_(++graphml_index), for_(for_value), name_(name), type_(type) {}
+    : id_(++graphml_index),
+      graphml_id_("d" + base::NumberToString(id_)),
+      for_(for_value),
+      name_(name),
+      type_(type) {}
 
-GraphMLId GraphMLAttr::GetGraphMLId() const {
-  return "d" + base::NumberToString(id_);
+void GraphMLAttr::AddDefinitionNode(XMLWriter& writer) const {
+  writer.StartElement("key");
+  writer.AddAttribute("id", graphml_id_);
+  writer.AddAttribute("for", GraphMLForTypeToString(for_));
+  writer.AddAttribute("attr.name", name_);
+  writer.AddAttribute("attr.type", GraphMLAttrTypeToString(type_));
+  writer.EndElement();
 }
 
-void GraphMLAttr::AddDefinitionNode(xmlNodePtr parent_node) const {
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "key", nullptr);
-  xmlSetProp(new_node, BAD_CAST "id", BAD_CAST GetGraphMLId().c_str());
-  xmlSetProp(new_node, BAD_CAST "for",
-             BAD_CAST GraphMLForTypeToString(for_).c_str());
-  xmlSetProp(new_node, BAD_CAST "attr.name", BAD_CAST name_.c_str());
-  xmlSetProp(new_node, BAD_CAST "attr.type",
-             BAD_CAST GraphMLAttrTypeToString(type_).c_str());
-}
-
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const char* value) const {
-  AddValueNode(doc, parent_node, std::string(value));
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer, const char* value) const {
+  CHECK(type_ == kGraphMLAttrTypeString);
+  writer.AddStringValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer,
                                const std::string& value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlChar* encoded_content =
-      xmlEncodeEntitiesReentrant(doc, BAD_CAST value.c_str());
-  xmlNodePtr new_node =
-      xmlNewChild(parent_node, nullptr, BAD_CAST "data", encoded_content);
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
-  xmlFree(encoded_content);
+  writer.AddStringValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const int value) const {
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer, const int value) const {
   CHECK(type_ == kGraphMLAttrTypeInt);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddIntegerValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
-                               const bool value) const {
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer, const bool value) const {
   CHECK(type_ == kGraphMLAttrTypeBoolean);
-  xmlNodePtr new_node = xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                                        BAD_CAST(value ? "true" : "false"));
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddBooleanValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer,
                                const int64_t value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddIntegerValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer,
                                const uint64_t value) const {
   CHECK(type_ == kGraphMLAttrTypeString);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddUnsignedValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer,
                                const double value) const {
   CHECK(type_ == kGraphMLAttrTypeDouble);
-  xmlNodePtr new_node =
-      xmlNewTextChild(parent_node, nullptr, BAD_CAST "data",
-                      BAD_CAST base::NumberToString(value).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddDoubleValue(*this, value);
 }
 
-void GraphMLAttr::AddValueNode(xmlDocPtr doc,
-                               xmlNodePtr parent_node,
+void GraphMLAttr::AddValueNode(GraphMLWriter& writer,
                                const base::TimeDelta value) const {
   CHECK(type_ == kGraphMLAttrTypeInt);
-  xmlNodePtr new_node = xmlNewTextChild(
-      parent_node, nullptr, BAD_CAST "data",
-      BAD_CAST base::NumberToString(value.InMilliseconds()).c_str());
-  xmlSetProp(new_node, BAD_CAST "key", BAD_CAST GetGraphMLId().c_str());
+  writer.AddIntegerValue(*this, value.InMilliseconds());
 }
 
 const GraphMLAttrs& GetGraphMLAttrs() {
@@ -6,59 +6,160 @@
 #ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_BRAVE_PAGE_GRAPH_GRAPHML_H_
 
-#include <libxml/tree.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/types.h"
+#include "third_party/blink/renderer/core/core_export.h"
 
 namespace brave_page_graph {
 
+class GraphMLAttr;
+
+// Receives the nodes and edges of the graph, and their attribute values, as
+// the graph is walked. Graph items only describe themselves through this
+// interface, so the same walk can produce GraphML text or the compact binary
+// encoding (see binary_graph_writer.h).
+class GraphMLWriter {
+ public:
+  virtual ~GraphMLWriter() = default;
+
+  virtual void StartNode(GraphItemId id) = 0;
+  virtual void StartEdge(GraphItemId id,
+                         GraphItemId source,
+                         GraphItemId target) = 0;
+  virtual void EndItem() = 0;
+
+  virtual void AddStringValue(const GraphMLAttr& attr,
+                              base::StringPiece value) = 0;
+  virtual void AddIntegerValue(const GraphMLAttr& attr, int64_t value) = 0;
+  virtual void AddUnsignedValue(const GraphMLAttr& attr, uint64_t value) = 0;
+  virtual void AddBooleanValue(const GraphMLAttr& attr, bool value) = 0;
+  virtual void AddDoubleValue(const GraphMLAttr& attr, double value) = 0;
+};
+
+// The contents of the <desc> element that starts every document.
+struct CORE_EXPORT GraphMLDesc {
+  GraphMLDesc();
+  GraphMLDesc(const GraphMLDesc&);
+  GraphMLDesc& operator=(const GraphMLDesc&);
+  ~GraphMLDesc();
+
+  std::string version;
+  std::string about;
+  bool is_root = false;
+  std::string frame_id;
+  int64_t end_time_ms = 0;
+};
+
+// Serializes XML straight into a growable buffer while the graph is being
+// walked, instead of building a libxml2 tree of the whole graph first and
+// dumping it afterwards. The output is byte-for-byte what
+// xmlDocDumpMemoryEnc(doc, ..., "UTF-8") produced for the equivalent tree:
+// no indentation, self-closing tags for elements without content, and the
+// same escaping of text and attribute values.
+class CORE_EXPORT XMLWriter {
+ public:
+  XMLWriter();
+  ~XMLWriter();
+
+  XMLWriter(const XMLWriter&) = delete;
+  XMLWriter& operator=(const XMLWriter&) = delete;
+
+  // |name| must outlive the element; element names are string literals.
+  void StartElement(base::StringPiece name);
+  // Must be called before any content is added to the current element.
+  void AddAttribute(base::StringPiece name, base::StringPiece value);
+  // Text content as stored by xmlNewTextChild(), i.e. taken literally.
+  void AddText(base::StringPiece text);
+  // Text content as stored by xmlNewChild() after the value had been run
+  // through xmlEncodeEntitiesReentrant(). Valid UTF-8 round-trips unchanged.
+  void AddEncodedText(base::StringPiece text);
+  void EndElement();
+
+  // Shorthand for an element that only holds literal text.
+  void AddTextElement(base::StringPiece name, base::StringPiece text);
+
+  // Closes the document and hands out the serialized bytes.
+  std::string Finish();
+
+ private:
+  void CloseStartTag();
+  void AppendEscapedText(base::StringPiece text);
+
+  std::string output_;
+  std::vector<base::StringPiece> open_elements_;
+  // Whether the start tag of the innermost open element still lacks its '>'.
+  bool start_tag_open_ = false;
+  // libxml2 switches the document to ISO-8859-1 after the first malformed
+  // UTF-8 sequence it encodes, and copies all later non-ASCII bytes through.
+  bool passthrough_non_ascii_ = false;
+};
+
+// Writes a GraphML document. The constructor emits everything up to and
+// including the opening <graph> tag, so nodes and edges can be added right
+// away.
+class CORE_EXPORT GraphMLTextWriter final : public GraphMLWriter {
+ public:
+  explicit GraphMLTextWriter(const GraphMLDesc& desc);
+  ~GraphMLTextWriter() override;
+
+  GraphMLTextWriter(const GraphMLTextWriter&) = delete;
+  GraphMLTextWriter& operator=(const GraphMLTextWriter&) = delete;
+
+  // GraphMLWriter:
+  void StartNode(GraphItemId id) override;
+  void StartEdge(GraphItemId id,
+                 GraphItemId source,
+                 GraphItemId target) override;
+  void EndItem() override;
+  void AddStringValue(const GraphMLAttr& attr,
+                      base::StringPiece value) override;
+  void AddIntegerValue(const GraphMLAttr& attr, int64_t value) override;
+  void AddUnsignedValue(const GraphMLAttr& attr, uint64_t value) override;
+  void AddBooleanValue(const GraphMLAttr& attr, bool value) override;
+  void AddDoubleValue(const GraphMLAttr& attr, double value) override;
+
+  std::string Finish();
+
+ private:
+  void AddTextValue(const GraphMLAttr& attr, base::StringPiece text);
+
+  XMLWriter xml_;
+};
+
 class GraphMLAttr {
  public:
   GraphMLAttr(const GraphMLAttrForType for_value,
               const std::string& name,
               const GraphMLAttrType type = kGraphMLAttrTypeString);
 
-  GraphMLId GetGraphMLId() const;
-  void AddDefinitionNode(xmlNodePtr parent_node) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const char* value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const std::string& value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const bool value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const int64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const uint64_t value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const double value) const;
-  void AddValueNode(xmlDocPtr doc,
-                    xmlNodePtr parent_node,
-                    const base::TimeDelta value) const;
+  const GraphMLId& GetGraphMLId() const { return graphml_id_; }
+  void AddDefinitionNode(XMLWriter& writer) const;
+  void AddValueNode(GraphMLWriter& writer, const char* value) const;
+  void AddValueNode(GraphMLWriter& writer, const std::string& value) const;
+  void AddValueNode(GraphMLWriter& writer, const int value) const;
+  void AddValueNode(GraphMLWriter& writer, const bool value) const;
+  void AddValueNode(GraphMLWriter& writer, const int64_t value) const;
+  void AddValueNode(GraphMLWriter& writer, const uint64_t value) const;
+  void AddValueNode(GraphMLWriter& writer, const double value) const;
+  void AddValueNode(GraphMLWriter& writer, const base::TimeDelta value) const;
 
  protected:
   const uint64_t id_;
+  const GraphMLId graphml_id_;
   const GraphMLAttrForType for_;
   const std::string name_;
   const GraphMLAttrType type_;
 };
 
 using GraphMLAttrs = base::flat_map<GraphMLAttrDef, const GraphMLAttr*>;
-const GraphMLAttrs& GetGraphMLAttrs();
-const GraphMLAttr* GraphMLAttrDefForType(const GraphMLAttrDef type);
+CORE_EXPORT const GraphMLAttrs& GetGraphMLAttrs();
+CORE_EXPORT const GraphMLAttr* GraphMLAttrDefForType(const GraphMLAttrDef type);
 
 }  // namespace brave_page_graph
 
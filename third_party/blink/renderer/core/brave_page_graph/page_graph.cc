@@ -5,8 +5,6 @@
 
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph.h"
 
-#include <libxml/tree.h>
-
 #include <signal.h>
 #include <climits>
 #include <iostream>
@@ -20,8 +18,10 @@
 #include "base/debug/stack_trace.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/no_destructor.h"
+#include "base/ranges/algorithm.h"
 #include "brave/components/brave_page_graph/common/features.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/binary_graph_writer.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/attribute/edge_attribute_delete.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/attribute/edge_attribute_set.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/edge/binding/edge_binding.h"
@@ -127,6 +127,7 @@
 #include "url/gurl.h"
 #include "v8/include/v8.h"
 
+using brave_page_graph::BinaryGraphWriter;
 using brave_page_graph::DocumentRequest;
 using brave_page_graph::EdgeAttributeDelete;
 using brave_page_graph::EdgeAttributeSet;
@@ -157,7 +158,10 @@ using brave_page_graph::EdgeStorageSet;
 using brave_page_graph::EdgeStructure;
 using brave_page_graph::EdgeTextChange;
 using brave_page_graph::GraphItem;
+using brave_page_graph::GraphItemArena;
 using brave_page_graph::GraphItemId;
+using brave_page_graph::GraphMLDesc;
+using brave_page_graph::GraphMLTextWriter;
 using brave_page_graph::ItemName;
 using brave_page_graph::NodeActor;
 using brave_page_graph::NodeAdFilter;
@@ -866,18 +870,27 @@ GraphItemId PageGraph::GetNextGraphItemId() {
   return ++id_counter_;
 }
 
-void PageGraph::AddGraphItem(std::unique_ptr<GraphItem> graph_item) {
-  GraphItem* item = graph_item.get();
-  graph_items_.push_back(std::move(graph_item));
+void PageGraph::OnGraphNodeChanged(const GraphNode* node) {
+  // Only binary snapshots care, and there is nothing to update before the
+  // first one was taken.
+  if (binary_writer_) {
+    binary_changed_nodes_.push_back(node);
+  }
+}
 
+GraphItemArena& PageGraph::GetGraphItemArena() {
+  return graph_item_arena_;
+}
+
+void PageGraph::AddGraphItem(GraphItem* item) {
   if (auto* graph_node = DynamicTo<GraphNode>(item)) {
     nodes_.push_back(graph_node);
     if (auto* element_node = DynamicTo<NodeHTMLElement>(graph_node)) {
-      DCHECK(!base::Contains(element_nodes_, element_node->GetDOMNodeId()));
-      element_nodes_.emplace(element_node->GetDOMNodeId(), element_node);
+      DCHECK(!element_nodes_.Contains(element_node->GetDOMNodeId()));
+      element_nodes_.insert(element_node->GetDOMNodeId(), element_node);
     } else if (auto* text_node = DynamicTo<NodeHTMLText>(graph_node)) {
-      DCHECK(!base::Contains(text_nodes_, text_node->GetDOMNodeId()));
-      text_nodes_.emplace(text_node->GetDOMNodeId(), text_node);
+      DCHECK(!text_nodes_.Contains(text_node->GetDOMNodeId()));
+      text_nodes_.insert(text_node->GetDOMNodeId(), text_node);
     } else if (auto* resource_node = DynamicTo<NodeResource>(graph_node)) {
       resource_nodes_.emplace(resource_node->GetURL(), resource_node);
     } else if (auto* ad_filter_node = DynamicTo<NodeAdFilter>(graph_node)) {
@@ -912,11 +925,11 @@ void PageGraph::GenerateReportForNode(const blink::DOMNodeId node_id,
   const GraphNode* node;
   auto element_node_it = element_nodes_.find(node_id);
   if (element_node_it != element_nodes_.end()) {
-    node = element_node_it->second;
+    node = element_node_it->value;
   } else {
     auto text_node_it = text_nodes_.find(node_id);
     if (text_node_it != text_nodes_.end()) {
-      node = text_node_it->second;
+      node = text_node_it->value;
     } else {
       return;
     }
@@ -956,79 +969,90 @@ void PageGraph::GenerateReportForNode(const blink::DOMNodeId node_id,
 }
 
 String PageGraph::ToGraphML() const {
-  xmlDocPtr graphml_doc = xmlNewDoc(BAD_CAST "1.0");
-  xmlNodePtr graphml_root_node = xmlNewNode(nullptr, BAD_CAST "graphml");
-  xmlDocSetRootElement(graphml_doc, graphml_root_node);
-
-  xmlNewNs(graphml_root_node, BAD_CAST "http://graphml.graphdrawing.org/xmlns",
-           nullptr);
-  xmlNsPtr xsi_ns = xmlNewNs(
-      graphml_root_node, BAD_CAST "http://www.w3.org/2001/XMLSchema-instance",
-      BAD_CAST "xsi");
-  xmlNewNsProp(graphml_root_node, xsi_ns, BAD_CAST "schemaLocation",
-               BAD_CAST
-               "http://graphml.graphdrawing.org/xmlns "
-               "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd");
-
-  xmlNodePtr desc_container_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "desc", nullptr);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "version",
-                  BAD_CAST kPageGraphVersion);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "about",
-                  BAD_CAST kPageGraphUrl);
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "is_root",
-                  BAD_CAST(IsRootFrame() ? "true" : "false"));
-  xmlNewTextChild(desc_container_node, nullptr, BAD_CAST "frame_id",
-                  BAD_CAST frame_id_.c_str());
-
-  xmlNodePtr time_container_node =
-      xmlNewChild(desc_container_node, nullptr, BAD_CAST "time", nullptr);
-
-  xmlNewTextChild(time_container_node, nullptr, BAD_CAST "start",
-                  BAD_CAST base::NumberToString(0).c_str());
-
-  const base::TimeDelta end_time = base::TimeTicks::Now() - start_;
-  xmlNewTextChild(
-      time_container_node, nullptr, BAD_CAST "end",
-      BAD_CAST base::NumberToString(end_time.InMilliseconds()).c_str());
-
-  for (const auto& graphml_attr : brave_page_graph::GetGraphMLAttrs()) {
-    graphml_attr.second->AddDefinitionNode(graphml_root_node);
-  }
-
-  xmlNodePtr graph_node =
-      xmlNewChild(graphml_root_node, nullptr, BAD_CAST "graph", nullptr);
-  xmlSetProp(graph_node, BAD_CAST "id", BAD_CAST "G");
-  xmlSetProp(graph_node, BAD_CAST "edgedefault", BAD_CAST "directed");
+  if (VLOG_IS_ON(1)) {
+    const Stats stats = GetStats();
+    VLOG(1) << "ToGraphML) nodes: " << stats.node_count
+            << ", edges: " << stats.edge_count
+            << ", item bytes: " << stats.bytes_used << " of "
+            << stats.bytes_reserved;
+    for (const auto& [item_name, count] : stats.items_by_type) {
+      VLOG(1) << "ToGraphML) " << item_name << ": " << count;
+    }
+  }
 
+  GraphMLTextWriter writer(GetGraphMLDesc());
   for (const auto* node : nodes_) {
-    node->AddGraphMLTag(graphml_doc, graph_node);
+    node->AddGraphMLTag(writer);
   }
   for (const auto* edge : edges_) {
-    edge->AddGraphMLTag(graphml_doc, graph_node);
+    edge->AddGraphMLTag(writer);
   }
 
-  xmlChar* xml_string;
-  int size;
-  xmlDocDumpMemoryEnc(graphml_doc, &xml_string, &size, "UTF-8");
-  auto graphml_string = String::FromUTF8(xml_string, size);
+  const std::string graphml = writer.Finish();
+  auto graphml_string = String::FromUTF8(graphml.data(), graphml.size());
   DCHECK(!graphml_string.IsEmpty());
 
-  xmlFree(xml_string);
-  xmlFree(graphml_doc);
-
   return graphml_string;
 }
 
+std::string PageGraph::TakeBinarySnapshot() {
+  if (!binary_writer_) {
+    binary_writer_ = std::make_unique<BinaryGraphWriter>();
+  }
+  binary_writer_->StartSnapshot(GetGraphMLDesc());
+
+  // Nodes are added in id order, so anything up to the last node written so
+  // far is already part of the stream and has to be written again. The rest
+  // goes out with the new nodes below.
+  const GraphItemId last_written_node_id =
+      binary_node_count_ ? nodes_[binary_node_count_ - 1]->GetId() : 0;
+  base::ranges::sort(binary_changed_nodes_, {}, &GraphNode::GetId);
+  binary_changed_nodes_.erase(base::ranges::unique(binary_changed_nodes_),
+                              binary_changed_nodes_.end());
+  for (const GraphNode* node : binary_changed_nodes_) {
+    if (node->GetId() > last_written_node_id) {
+      break;
+    }
+    binary_writer_->AddNodeBlock(*node);
+  }
+  binary_changed_nodes_.clear();
+
+  for (; binary_node_count_ < nodes_.size(); ++binary_node_count_) {
+    binary_writer_->AddNodeBlock(*nodes_[binary_node_count_]);
+  }
+  for (; binary_edge_count_ < edges_.size(); ++binary_edge_count_) {
+    binary_writer_->AddEdge(*edges_[binary_edge_count_]);
+  }
+
+  return binary_writer_->FinishSnapshot();
+}
+
+PageGraph::Stats::Stats() = default;
+PageGraph::Stats::Stats(const Stats&) = default;
+PageGraph::Stats& PageGraph::Stats::operator=(const Stats&) = default;
+PageGraph::Stats::~Stats() = default;
+
+PageGraph::Stats PageGraph::GetStats() const {
+  Stats stats;
+  stats.node_count = nodes_.size();
+  stats.edge_count = edges_.size();
+  for (const GraphItem* item : graph_item_arena_.items()) {
+    ++stats.items_by_type[item->GetItemName()];
+  }
+  stats.bytes_used = graph_item_arena_.bytes_used();
+  stats.bytes_reserved = graph_item_arena_.bytes_reserved();
+  return stats;
+}
+
 NodeHTML* PageGraph::GetHTMLNode(const DOMNodeId node_id) const {
   VLOG(1) << "GetHTMLNode) node id: " << node_id;
   auto element_node_it = element_nodes_.find(node_id);
   if (element_node_it != element_nodes_.end()) {
-    return element_node_it->second;
+    return element_node_it->value;
   }
   auto text_node_it = text_nodes_.find(node_id);
   if (text_node_it != text_nodes_.end()) {
-    return text_node_it->second;
+    return text_node_it->value;
   }
   CHECK(false) << "HTMLNode not found: " << node_id;
   return nullptr;
@@ -1038,7 +1062,7 @@ NodeHTMLElement* PageGraph::GetHTMLElementNode(const DOMNodeId node_id) const {
   VLOG(1) << "GetHTMLElementNode) node id: " << node_id;
   auto element_node_it = element_nodes_.find(node_id);
   if (element_node_it != element_nodes_.end()) {
-    return element_node_it->second;
+    return element_node_it->value;
   }
   CHECK(false) << "HTMLElementNode not found: " << node_id;
   return nullptr;
@@ -1047,7 +1071,7 @@ NodeHTMLElement* PageGraph::GetHTMLElementNode(const DOMNodeId node_id) const {
 NodeHTMLText* PageGraph::GetHTMLTextNode(const DOMNodeId node_id) const {
   auto text_node_it = text_nodes_.find(node_id);
   if (text_node_it != text_nodes_.end()) {
-    return text_node_it->second;
+    return text_node_it->value;
   }
   CHECK(false) << "HTMLTextNode not found: " << node_id;
   return nullptr;
@@ -1974,4 +1998,14 @@ bool PageGraph::IsRootFrame() const {
   return GetSupplementable()->IsLocalRoot();
 }
 
+GraphMLDesc PageGraph::GetGraphMLDesc() const {
+  GraphMLDesc desc;
+  desc.version = kPageGraphVersion;
+  desc.about = kPageGraphUrl;
+  desc.is_root = IsRootFrame();
+  desc.frame_id = frame_id_;
+  desc.end_time_ms = (base::TimeTicks::Now() - start_).InMilliseconds();
+  return desc;
+}
+
 }  // namespace blink
@@ -9,10 +9,12 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/time/time.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/blink_probe_types.h"
+#include "brave/third_party/blink/renderer/core/brave_page_graph/graph_item/graph_item_arena.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/page_graph_context.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/requests/request_tracker.h"
 #include "brave/third_party/blink/renderer/core/brave_page_graph/scripts/script_tracker.h"
@@ -28,6 +30,7 @@
 #include "third_party/blink/renderer/platform/heap/garbage_collected.h"
 #include "third_party/blink/renderer/platform/heap/member.h"
 #include "third_party/blink/renderer/platform/supplementable.h"
+#include "third_party/blink/renderer/platform/wtf/hash_map.h"
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
 
 namespace base {
@@ -36,8 +39,10 @@ class UnguessableToken;
 
 namespace brave_page_graph {
 
+class BinaryGraphWriter;
 class GraphEdge;
 class GraphNode;
+struct GraphMLDesc;
 class NodeActor;
 class NodeAdFilter;
 class NodeBinding;
@@ -222,12 +227,35 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   // PageGraphContext:
   base::TimeTicks GetGraphStartTime() const override;
   brave_page_graph::GraphItemId GetNextGraphItemId() override;
-  void AddGraphItem(
-      std::unique_ptr<brave_page_graph::GraphItem> graph_item) override;
+  void AddGraphItem(brave_page_graph::GraphItem* graph_item) override;
+  void OnGraphNodeChanged(const brave_page_graph::GraphNode* node) override;
 
   void GenerateReportForNode(const blink::DOMNodeId node_id,
                              blink::protocol::Array<String>& report);
   String ToGraphML() const;
+  // Returns the binary encoding (see binary_graph_format.h) of the nodes and
+  // edges that were added or changed since the previous call. The first call
+  // also writes the stream header, so the results of all calls concatenated
+  // form a complete stream.
+  std::string TakeBinarySnapshot();
+
+  // What has been recorded so far and the memory it takes, for measuring the
+  // overhead of recording.
+  struct Stats {
+    Stats();
+    Stats(const Stats&);
+    Stats& operator=(const Stats&);
+    ~Stats();
+
+    size_t node_count = 0;
+    size_t edge_count = 0;
+    // Keyed by GraphItem::GetItemName().
+    std::map<std::string, size_t> items_by_type;
+    // Memory of the item objects, see GraphItemArena.
+    size_t bytes_used = 0;
+    size_t bytes_reserved = 0;
+  };
+  Stats GetStats() const;
 
  private:
 #define PAGE_GRAPH_USING_DECL(type) using type = brave_page_graph::type
@@ -239,7 +267,7 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   PAGE_GRAPH_USING_DECL(FingerprintingRule);
   PAGE_GRAPH_USING_DECL(GraphEdge);
   PAGE_GRAPH_USING_DECL(GraphItemId);
-  PAGE_GRAPH_USING_DECL(GraphItemUniquePtrList);
+  PAGE_GRAPH_USING_DECL(GraphItemArena);
   PAGE_GRAPH_USING_DECL(GraphNode);
   PAGE_GRAPH_USING_DECL(InspectorId);
   PAGE_GRAPH_USING_DECL(MethodName);
@@ -278,6 +306,9 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
     NodeExtensions* extensions_node;
   };
 
+  // PageGraphContext:
+  GraphItemArena& GetGraphItemArena() override;
+
   NodeHTML* GetHTMLNode(const blink::DOMNodeId node_id) const;
   NodeHTMLElement* GetHTMLElementNode(const blink::DOMNodeId node_id) const;
   NodeHTMLText* GetHTMLTextNode(const blink::DOMNodeId node_id) const;
@@ -426,6 +457,8 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   // frame tree.
   bool IsRootFrame() const;
 
+  brave_page_graph::GraphMLDesc GetGraphMLDesc() const;
+
   // The blink assigned frame id for the local root's frame.
   const std::string frame_id_;
   // Script tracker helper.
@@ -439,13 +472,22 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
   // the graph's construction if needed.
   GraphItemId id_counter_ = 0;
 
-  // These vectors own all of the items that are shared and indexed across
-  // the rest of the graph.  All the other pointers (the weak pointers)
-  // do not own their data.
-  GraphItemUniquePtrList graph_items_;
+  // The arena owns all of the items that are shared and indexed across the
+  // rest of the graph.  All the other pointers (the weak pointers) do not own
+  // their data.
+  GraphItemArena graph_item_arena_;
   EdgeList edges_;
   NodeList nodes_;
 
+  // Created by the first binary snapshot, and kept to encode the later ones.
+  std::unique_ptr<brave_page_graph::BinaryGraphWriter> binary_writer_;
+  // How many of |nodes_| and |edges_| the binary snapshots already hold.
+  size_t binary_node_count_ = 0;
+  size_t binary_edge_count_ = 0;
+  // Nodes that changed since the previous binary snapshot. May hold
+  // duplicates and nodes that haven't been written yet.
+  std::vector<const GraphNode*> binary_changed_nodes_;
+
   // Non-owning references to singleton items in the graph. (the owning
   // references will be in the above vectors).
   blink::HeapHashMap<blink::Member<ExecutionContext>, ExecutionContextNodes>
@@ -460,28 +502,28 @@ class CORE_EXPORT PageGraph : public GarbageCollected<PageGraph>,
 
   // Index structure for looking up HTML nodes.
   // This map does not own the references.
-  std::map<blink::DOMNodeId, NodeHTMLElement*> element_nodes_;
-  std::map<blink::DOMNodeId, NodeHTMLText*> text_nodes_;
+  HashMap<blink::DOMNodeId, NodeHTMLElement*> element_nodes_;
+  HashMap<blink::DOMNodeId, NodeHTMLText*> text_nodes_;
 
   // Makes sure we don't have more than one node in the graph representing
   // a single URL (not required for correctness, but keeps things tidier
   // and makes some kinds of queries nicer).
-  std::map<RequestURL, NodeResource*> resource_nodes_;
+  std::unordered_map<RequestURL, NodeResource*> resource_nodes_;
 
   // Index structure for looking up binding nodes.
   // This map does not own the references.
-  std::map<Binding, NodeBinding*> binding_nodes_;
+  std::unordered_map<Binding, NodeBinding*> binding_nodes_;
   // Index structure for storing and looking up webapi nodes.
   // This map does not own the references.
-  std::map<MethodName, NodeJSWebAPI*> js_webapi_nodes_;
+  std::unordered_map<MethodName, NodeJSWebAPI*> js_webapi_nodes_;
   // Index structure for storing and looking up nodes representing built
   // in JS funcs and methods. This map does not own the references.
-  std::map<MethodName, NodeJSBuiltin*> js_builtin_nodes_;
+  std::unordered_map<MethodName, NodeJSBuiltin*> js_builtin_nodes_;
 
   // Index structure for looking up filter nodes.
   // These maps do not own the references.
-  std::map<std::string, NodeAdFilter*> ad_filter_nodes_;
-  std::map<std::string, NodeTrackerFilter*> tracker_filter_nodes_;
+  std::unordered_map<std::string, NodeAdFilter*> ad_filter_nodes_;
+  std::unordered_map<std::string, NodeTrackerFilter*> tracker_filter_nodes_;
   std::map<FingerprintingRule, NodeFingerprintingFilter*>
       fingerprinting_filter_nodes_;
 
@@ -10,6 +10,7 @@
 #include "base/sequence_checker.h"
 #include "base/strings/string_number_conversions.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
+#include "brave/third_party/blink/renderer/brave_farbling_lfsr.h"
 #include "brave/third_party/blink/renderer/brave_font_whitelist.h"
 #include "build/build_config.h"
 #include "crypto/hmac.h"
@@ -35,38 +36,6 @@
 #include "third_party/blink/renderer/platform/wtf/text/wtf_string.h"
 #include "url/url_constants.h"
 
-namespace {
-
-constexpr uint64_t zero = 0;
-constexpr double maxUInt64AsDouble = static_cast<double>(UINT64_MAX);
-
-inline uint64_t lfsr_next(uint64_t v) {
-  return ((v >> 1) | (((v << 62) ^ (v << 61)) & (~(~zero << 63) << 62)));
-}
-
-float Identity(float value, size_t index) {
-  return value;
-}
-
-float ConstantMultiplier(double fudge_factor, float value, size_t index) {
-  return value * fudge_factor;
-}
-
-float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
-  static uint64_t v;
-  if (index == 0) {
-    // start of loop, reset to initial seed which was passed in and is based on
-    // the domain key
-    v = seed;
-  }
-  // get next value in PRNG sequence
-  v = lfsr_next(v);
-  // return pseudo-random float between 0 and 0.1
-  return (v / maxUInt64AsDouble) / 10;
-}
-
-}  // namespace
-
 namespace brave {
 
 const char kBraveSessionToken[] = "brave_session_token";
@@ -231,7 +200,7 @@ void BraveSessionCache::Init() {
   RegisterAllowFontFamilyCallback(base::BindRepeating(&brave::AllowFontFamily));
 }
 
-AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
+absl::optional<AudioFarblingHelper> BraveSessionCache::GetAudioFarblingHelper(
     blink::WebContentSettingsClient* settings) {
   if (farbling_enabled_ && settings) {
     switch (settings->GetBraveFarblingLevel()) {
@@ -240,18 +209,18 @@ AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
       }
       case BraveFarblingLevel::BALANCED: {
         const uint64_t* fudge = reinterpret_cast<const uint64_t*>(domain_key_);
-        double fudge_factor = 0.99 + ((*fudge / maxUInt64AsDouble) / 100);
+        double fudge_factor = 0.99 + ((*fudge / kMaxUInt64AsDouble) / 100);
         VLOG(1) << "audio fudge factor (based on session token) = "
                 << fudge_factor;
-        return base::BindRepeating(&ConstantMultiplier, fudge_factor);
+        return AudioFarblingHelper::CreateConstantMultiplier(fudge_factor);
       }
       case BraveFarblingLevel::MAXIMUM: {
         uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
-        return base::BindRepeating(&PseudoRandomSequence, seed);
+        return AudioFarblingHelper::CreatePseudoRandomSequence(seed);
       }
     }
   }
-  return base::BindRepeating(&Identity);
+  return absl::nullopt;
 }
 
 void BraveSessionCache::PerturbPixels(blink::WebContentSettingsClient* settings,
@@ -311,7 +280,7 @@ void BraveSessionCache::PerturbPixelsInternal(const unsigned char* data,
       pixels[pixel_index] = pixels[pixel_index] ^ (bit & 0x1);
       bit = bit >> 1;
       // find next pixel to perturb
-      v = lfsr_next(v);
+      v = LfsrNext(v);
     }
   }
 }
@@ -330,7 +299,7 @@ WTF::String BraveSessionCache::GenerateRandomString(std::string seed,
   for (wtf_size_t i = 0; i < length; i++) {
     destination[i] =
         kLettersForRandomStrings[v % kLettersForRandomStringsLength];
-    v = lfsr_next(v);
+    v = LfsrNext(v);
   }
   return value;
 }
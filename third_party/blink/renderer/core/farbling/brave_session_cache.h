@@ -10,8 +10,10 @@
 #include <string>
 
 #include "base/callback.h"
+#include "brave/third_party/blink/renderer/brave_audio_farbling_helper.h"
 #include "brave/third_party/blink/renderer/brave_farbling_constants.h"
 #include "third_party/abseil-cpp/absl/random/random.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/renderer/core/core_export.h"
 #include "third_party/blink/renderer/core/execution_context/execution_context.h"
 #include "third_party/blink/renderer/core/frame/dom_window.h"
@@ -41,7 +43,6 @@ enum FarbleKey : uint64_t {
 };
 
 typedef absl::randen_engine<uint64_t> FarblingPRNG;
-typedef base::RepeatingCallback<float(float, size_t)> AudioFarblingCallback;
 
 CORE_EXPORT blink::WebContentSettingsClient* GetContentSettingsClientFor(
     ExecutionContext* context);
@@ -74,7 +75,8 @@ class CORE_EXPORT BraveSessionCache final
   static BraveSessionCache& From(ExecutionContext&);
   static void Init();
 
-  AudioFarblingCallback GetAudioFarblingCallback(
+  // Returns absl::nullopt when audio should be left untouched.
+  absl::optional<AudioFarblingHelper> GetAudioFarblingHelper(
       blink::WebContentSettingsClient* settings);
   void PerturbPixels(blink::WebContentSettingsClient* settings,
                      const unsigned char* data,
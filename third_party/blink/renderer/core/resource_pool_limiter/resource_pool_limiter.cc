@@ -58,8 +58,9 @@ int GetResourceLimit(ResourcePoolLimiter::ResourceType resource_type) {
 }  // namespace
 
 ResourcePoolLimiter::ResourceInUseTracker::ResourceInUseTracker(
-    String resource_id)
-    : resource_id_(std::move(resource_id)) {}
+    String resource_id,
+    size_t shard_index)
+    : resource_id_(std::move(resource_id)), shard_index_(shard_index) {}
 
 ResourcePoolLimiter::ResourceInUseTracker::~ResourceInUseTracker() {
   ResourcePoolLimiter::GetInstance().DropResourceInUse(this);
@@ -77,6 +78,9 @@ ResourcePoolLimiter& ResourcePoolLimiter::GetInstance() {
 ResourcePoolLimiter::ResourcePoolLimiter() = default;
 ResourcePoolLimiter::~ResourcePoolLimiter() = default;
 
+ResourcePoolLimiter::Shard::Shard() = default;
+ResourcePoolLimiter::Shard::~Shard() = default;
+
 std::unique_ptr<ResourcePoolLimiter::ResourceInUseTracker>
 ResourcePoolLimiter::IssueResourceInUseTracker(
     ExecutionContext* context,
@@ -85,26 +89,33 @@ ResourcePoolLimiter::IssueResourceInUseTracker(
   String resource_id = GetResourceIdInUse(
       GetTopFrameOrContextSecurityOrigin(context), resource_type);
 
-  base::AutoLock locker(resources_in_use_lock_);
+  // The hash is cached in the string, so the lookup below doesn't compute it
+  // again.
+  const size_t shard_index = StringHash::GetHash(resource_id) % kShardCount;
+  Shard& shard = shards_[shard_index];
+
+  base::AutoLock locker(shard.lock);
   // `insert` doesn't change the value if it already exists.
   int& resource_in_use_count =
-      resources_in_use_.insert(resource_id, 0).stored_value->value;
+      shard.resources_in_use.insert(resource_id, 0).stored_value->value;
   if (resource_in_use_count >= GetResourceLimit(resource_type)) {
     return nullptr;
   }
 
   ++resource_in_use_count;
-  return std::make_unique<ResourceInUseTracker>(resource_id.IsolatedCopy());
+  return std::make_unique<ResourceInUseTracker>(resource_id.IsolatedCopy(),
+                                                shard_index);
 }
 
 void ResourcePoolLimiter::DropResourceInUse(
     const ResourceInUseTracker* resource_in_use_tracker) {
-  base::AutoLock locker(resources_in_use_lock_);
+  Shard& shard = shards_[resource_in_use_tracker->shard_index()];
+  base::AutoLock locker(shard.lock);
   auto resource_in_use_it =
-      resources_in_use_.find(resource_in_use_tracker->resource_id());
-  DCHECK(resource_in_use_it != resources_in_use_.end());
+      shard.resources_in_use.find(resource_in_use_tracker->resource_id());
+  DCHECK(resource_in_use_it != shard.resources_in_use.end());
   if (--resource_in_use_it->value == 0) {
-    resources_in_use_.erase(resource_in_use_it);
+    shard.resources_in_use.erase(resource_in_use_it);
   }
 }
 
@@ -6,6 +6,7 @@
 #ifndef BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_RESOURCE_POOL_LIMITER_RESOURCE_POOL_LIMITER_H_
 #define BRAVE_THIRD_PARTY_BLINK_RENDERER_CORE_RESOURCE_POOL_LIMITER_RESOURCE_POOL_LIMITER_H_
 
+#include <array>
 #include <memory>
 #include <utility>
 
@@ -27,13 +28,15 @@ class CORE_EXPORT ResourcePoolLimiter {
 
   class CORE_EXPORT ResourceInUseTracker {
    public:
-    explicit ResourceInUseTracker(String resource_id);
+    ResourceInUseTracker(String resource_id, size_t shard_index);
     ~ResourceInUseTracker();
 
     const String& resource_id() const { return resource_id_; }
+    size_t shard_index() const { return shard_index_; }
 
    private:
     String resource_id_;
+    size_t shard_index_;
   };
 
   static ResourcePoolLimiter& GetInstance();
@@ -49,10 +52,22 @@ class CORE_EXPORT ResourcePoolLimiter {
  private:
   ResourcePoolLimiter();
 
+  // Resources in use are spread over independently locked shards by the hash
+  // of their id, so windows and workers of unrelated sites don't contend on
+  // a single lock.
+  static constexpr size_t kShardCount = 16;
+
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    base::Lock lock;
+    HashMap<String, int> resources_in_use GUARDED_BY(lock);
+  };
+
   void DropResourceInUse(const ResourceInUseTracker* resource_in_use_tracker);
 
-  base::Lock resources_in_use_lock_;
-  HashMap<String, int> resources_in_use_ GUARDED_BY(resources_in_use_lock_);
+  std::array<Shard, kShardCount> shards_;
 };
 
 }  // namespace blink